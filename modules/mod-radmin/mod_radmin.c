@@ -301,6 +301,9 @@ axlDoc * mod_radmin_command_status (const char * line, axlPointer user_data, axl
 	int             running_threads;
 	int             waiting_threads;
 	int             pending_tasks;
+	int             cache_hits;
+	int             cache_misses;
+	int             cache_items;
 	struct timeval  tv;
 
 	/* signal command returned proper status */
@@ -309,6 +312,9 @@ axlDoc * mod_radmin_command_status (const char * line, axlPointer user_data, axl
 	/* get pool stats */
 	vortex_thread_pool_stats (TBC_VORTEX_CTX (ctx), &running_threads, &waiting_threads, &pending_tasks);
 
+	/* get profile path selection cache stats */
+	turbulence_ppath_cache_stats (ctx, &cache_hits, &cache_misses, &cache_items);
+
 	/* get time of day */
 	gettimeofday (&tv, NULL);
  
@@ -332,6 +338,9 @@ axlDoc * mod_radmin_command_status (const char * line, axlPointer user_data, axl
 		axl_node_set_child (node, axl_node_parse (NULL, "<row><d>Waiting threads</d><d>%d</d></row>", waiting_threads));
 		axl_node_set_child (node, axl_node_parse (NULL, "<row><d>Pending tasks</d><d>%d</d></row>", pending_tasks));
 		axl_node_set_child (node, axl_node_parse (NULL, "<row><d>Secs. running</d><d>%ld</d></row>", (tv.tv_sec - ctx->running_stamp)));
+		axl_node_set_child (node, axl_node_parse (NULL, "<row><d>Profile path cache hits</d><d>%d</d></row>", cache_hits));
+		axl_node_set_child (node, axl_node_parse (NULL, "<row><d>Profile path cache misses</d><d>%d</d></row>", cache_misses));
+		axl_node_set_child (node, axl_node_parse (NULL, "<row><d>Profile path cache entries</d><d>%d</d></row>", cache_items));
 	} /* end if */
 
 	return doc;
@@ -101,6 +101,9 @@ int  main_init_exarg (int argc, char ** argv)
 	exarg_install_arg ("child", NULL, EXARG_STRING,
 			   "Internal flag used to create childs by the master process.");
 
+	exarg_install_arg ("zygote", NULL, EXARG_STRING,
+			   "Internal flag used to start the child zygote process by the master process.");
+
 	exarg_install_arg ("child-cmd-prefix", NULL, EXARG_STRING,
 			   "Allows to configure an optional command prefix appended to the child starting command");
 
@@ -296,17 +299,22 @@ int main (int argc, char ** argv)
 	char          * config;
 	VortexCtx     * vortex_ctx;
 	int             temp_fds[2];
+	char          * child_path = NULL;
 
 	/*** init exarg library ***/
 	if (! main_init_exarg (argc, argv))
 		return 0;
 
+	/* get child control path (if running as child) */
+	if (exarg_is_defined ("child"))
+		child_path = axl_strdup (exarg_get_string ("child"));
+
 	/* create the turbulence and vortex context */
 	ctx        = turbulence_ctx_new ();
 	vortex_ctx = vortex_ctx_new ();
 
-	/* check for child flag */
-	if (exarg_is_defined ("child")) {
+	/* check for child flag (zygote is configured the same way) */
+	if (child_path || exarg_is_defined ("zygote")) {
 		/* reconfigure signals */
 		turbulence_signal_install (ctx, 
 					   /* disable sigint */
@@ -338,30 +346,42 @@ int main (int argc, char ** argv)
 	vortex_close_socket (temp_fds[0]);
 	vortex_close_socket (temp_fds[1]);
 
+	/* check and get config location */
+	config = main_common_get_config_location (ctx, vortex_ctx);
+
+	/* check for zygote flag: the function only returns inside
+	 * childs created (with their control path) */
+	if (exarg_is_defined ("zygote")) {
+		child_path = turbulence_process_zygote_run (ctx, exarg_get_string ("zygote"), config);
+		if (child_path == NULL) {
+			/* zygote finished */
+			axl_free (config);
+			exarg_end ();
+			return 0;
+		} /* end if */
+	} /* end if */
+
 	/* show some debug info */
-	if (exarg_is_defined ("child")) {
-		msg ("CHILD: starting child with control path: %s", exarg_get_string ("child"));
+	if (child_path) {
+		msg ("CHILD: starting child with control path: %s", child_path);
 
 		/* recover child information: to see about the format
 		   about this child init string, look at the function
 		   turbulence_process_connection_status_string, inside
 		   turbulence-process.c */
-		if (! turbulence_child_build_from_init_string (ctx, exarg_get_string ("child"))) {
+		if (! turbulence_child_build_from_init_string (ctx, child_path)) {
 			error ("Failed to recover child information from init child string received");
 			return -1;
 		}
  	}
 
-	/* check and get config location */
-	config = main_common_get_config_location (ctx, vortex_ctx);
-
 	/* check detach operation */
 	if (exarg_is_defined ("detach")) {
 		turbulence_detach_process ();
 		/* caller do not follow */
 	}
 
-	if (! exarg_is_defined ("child")) {
+	if (! child_path) {
 		/* check here if the user has asked to place the pidfile */
 		turbulence_place_pidfile ();
 	}
@@ -405,7 +425,7 @@ int main (int argc, char ** argv)
 	}
 
 	/* post init child operations */
-	if (exarg_is_defined ("child")) {
+	if (child_path) {
 		if (! turbulence_child_post_init (ctx)) {
 			error ("Failed to complete post init child operations, unable to start child process, killing: %d", getpid ());
 			goto release_resources;
@@ -413,7 +433,7 @@ int main (int argc, char ** argv)
 	}
 
 	/* drop a log */
-	msg ("%sTurbulence STARTED OK (pid: %d, vortex ctx refs: %d)", exarg_is_defined ("child") ? "CHILD: " : "", getpid (),
+	msg ("%sTurbulence STARTED OK (pid: %d, vortex ctx refs: %d)", child_path ? "CHILD: " : "", getpid (),
 	     vortex_ctx_ref_count (vortex_ctx));
 
 	/* look main thread until finished */
@@ -421,7 +441,7 @@ int main (int argc, char ** argv)
 	vortex_listener_wait (vortex_ctx);
 
 	msg ("   %sFinishing turbulence process, vortex_listener_wait unlocked (pid: %d, vortex ctx refs: %d)", 
-	     exarg_is_defined ("child") ? "CHILD: " : "",
+	     child_path ? "CHILD: " : "",
 	     getpid (),
 	     vortex_ctx_ref_count (vortex_ctx));
 	
@@ -436,12 +456,13 @@ int main (int argc, char ** argv)
 	/* free context (the very last operation) */
 	vortex_ctx_free (vortex_ctx);
 
-	if (! exarg_is_defined ("child")) {
+	if (! child_path) {
 		/* remote pid state file */
 		turbulence_remove_pidfile ();
 	} /* end if */
 
 	turbulence_ctx_free (ctx);
+	axl_free (child_path);
 
 	return 0;
 }
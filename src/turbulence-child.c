@@ -36,10 +36,18 @@
  */
 #include <turbulence-child.h>
 #include <syslog.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
 
 /* local private include */
 #include <turbulence-ctx-private.h>
 
+/** 
+ * @internal Number of items of the child init string sent by the
+ * parent (see __turbulence_process_send_child_init_string).
+ */
+#define TBC_CHILD_INIT_ITEMS 17
+
 /** 
  * @internal Creates a object that will represents a child object and
  * initialize internal data structures for its function.
@@ -58,6 +66,9 @@ TurbulenceChild * turbulence_child_new (TurbulenceCtx * ctx, TurbulencePPathDef
 	/* get current time */
 	gettimeofday (&now, NULL);
 
+	/* no stats slot assigned yet */
+	result->stats_slot = -1;
+
 	/* create socket path: socket used to transfer file descriptors from parent to child */
 	result->socket_control_path = axl_strdup_printf ("%s%s%s%s%p%d%d.tbc",
 							 turbulence_runtime_datadir (ctx),
@@ -88,9 +99,11 @@ TurbulenceChild * turbulence_child_new (TurbulenceCtx * ctx, TurbulencePPathDef
 	/* free temporal directory */
 	axl_free (temp_dir);
 	
-	/* set profile path and context */
+	/* set profile path and context (the profile path is kept
+	 * until the child is released) */
 	result->ppath = def;
 	result->ctx   = ctx;
+	__turbulence_ppath_ref (ctx, def);
 
 	/* create listener connection used for child management */
 	result->conn_mgr = vortex_listener_new_full (ctx->vortex_ctx, "0.0.0.0", "0", NULL, NULL);
@@ -99,6 +112,7 @@ TurbulenceChild * turbulence_child_new (TurbulenceCtx * ctx, TurbulencePPathDef
 
 		/* shutdown connection to be child by the child */
 		vortex_connection_close (result->conn_mgr);
+		__turbulence_ppath_unref (ctx, def);
 		axl_free (result);
 
 		return NULL;
@@ -173,6 +187,10 @@ void              turbulence_child_unref (TurbulenceChild * child)
 	/* get reference to the context */
 	ctx = child->ctx;
 
+	/* release stats slot (parent) */
+	if (ctx && ! ctx->child && child->stats_slot >= 0)
+		__turbulence_process_stats_release (ctx, child);
+
 #if defined(AXL_OS_UNIX)
 	/* unlink (child->socket_control_path);*/
 	axl_free (child->socket_control_path);
@@ -196,12 +214,20 @@ void              turbulence_child_unref (TurbulenceChild * child)
 	/* finish child conn loop */
 	turbulence_loop_close (child->child_conn_loop, axl_true);
 
+	/* release connections not sent to the child */
+	axl_list_free (child->handoff_queue);
+	child->handoff_queue = NULL;
+
 	/* nullify */
 	child->conn_mgr = NULL;
 
 	/* release server name */
 	axl_free (child->serverName);
 
+	/* release profile path */
+	__turbulence_ppath_unref (ctx, child->ppath);
+	child->ppath = NULL;
+
 	/* destroy mutex */
 	vortex_mutex_destroy (&child->mutex);
 
@@ -269,6 +295,134 @@ axl_bool __turbulence_child_post_init_openlogs (TurbulenceCtx  * ctx,
 	return axl_true;
 }
 
+/** 
+ * @internal Maps the slot of the stats segment where this child
+ * publishes its counters (positions 14 and 15 of the init
+ * string). Only the page(s) of its own slot are mapped so a child
+ * cannot change counters published by other childs. Done before
+ * changing root or user.
+ */
+void __turbulence_child_stats_map (TurbulenceCtx * ctx, TurbulenceChild * child)
+{
+	char        ** items = child->init_string_items;
+	int            slot;
+	int            fd;
+	size_t         slot_size = TBC_STATS_SLOT_SIZE ();
+	struct stat    info;
+	void         * segment;
+
+	child->stats_slot = -1;
+	if (items[13] == NULL || items[14] == NULL || items[15] == NULL || axl_cmp (items[14], "-"))
+		return;
+	slot = atoi (items[15]);
+	if (slot < 0)
+		return;
+
+	fd = open (items[14], O_RDWR);
+	if (fd < 0) {
+		wrn ("CHILD: unable to open stats segment %s, counters will not be published, errno: %d", items[14], errno);
+		return;
+	} /* end if */
+	if (fstat (fd, &info) != 0 || info.st_size < (off_t) ((slot + 1) * slot_size)) {
+		wrn ("CHILD: stats segment %s is smaller than expected for slot %d, counters will not be published", items[14], slot);
+		close (fd);
+		return;
+	} /* end if */
+
+	segment = mmap (NULL, slot_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, (off_t) (slot * slot_size));
+	close (fd);
+	if (segment == MAP_FAILED) {
+		wrn ("CHILD: unable to map stats segment %s, errno: %d", items[14], errno);
+		return;
+	} /* end if */
+
+	child->stats_slot = slot;
+	child->stats      = segment;
+	return;
+}
+
+/** 
+ * @internal Adds channels and bytes of a connection handled to the
+ * counters published.
+ */
+axl_bool __turbulence_child_stats_foreach (axlPointer key, axlPointer data, axlPointer user_data)
+{
+	TurbulenceConnMgrState * state = data;
+	TurbulenceChildStats   * stats = user_data;
+	long                     bytes_in;
+	long                     bytes_out;
+	long                     stamp;
+
+	stats->channels += vortex_connection_channels_count (state->conn);
+	vortex_connection_get_receive_stamp (state->conn, &bytes_in, &bytes_out, &stamp);
+	stats->bytes_in  += bytes_in;
+	stats->bytes_out += bytes_out;
+
+	return axl_false; /* keep foreach looping */
+}
+
+/** 
+ * @internal Event (every second) used by the child to publish its
+ * counters into its slot of the stats segment. The child is the only
+ * writer of the slot, so no lock is shared with the parent.
+ */
+axl_bool __turbulence_child_stats_publish (VortexCtx * vortex_ctx, axlPointer user_data, axlPointer user_data2)
+{
+	TurbulenceCtx        * ctx   = user_data;
+	TurbulenceStatsSlot  * slot;
+	TurbulenceChildStats   stats;
+	struct rusage          usage;
+	FILE                 * file;
+	unsigned long          size;
+	unsigned long          resident;
+	TurbulenceConnMgrShard * shard;
+	int                    iterator;
+
+	if (ctx->is_exiting || ctx->child == NULL || ctx->child->stats == NULL)
+		return axl_true; /* remove event */
+
+	memset (&stats, 0, sizeof (TurbulenceChildStats));
+	stats.pid      = getpid ();
+	stats.ppath_id = turbulence_ppath_get_id (ctx->child->ppath);
+
+	/* connections and channels (one shard at a time) */
+	for (iterator = 0; iterator < TBC_CONN_MGR_SHARDS; iterator++) {
+		shard = &(ctx->conn_mgr_shards[iterator]);
+		vortex_mutex_lock (&shard->mutex);
+		if (shard->hash) {
+			stats.connections += axl_hash_items (shard->hash);
+			axl_hash_foreach (shard->hash, __turbulence_child_stats_foreach, &stats);
+		} /* end if */
+		stats.connections_total += shard->conns_total;
+		stats.channels_total    += shard->channels_total;
+		stats.bytes_in          += shard->bytes_in;
+		stats.bytes_out         += shard->bytes_out;
+		vortex_mutex_unlock (&shard->mutex);
+	} /* end for */
+
+	/* cpu and memory */
+	if (getrusage (RUSAGE_SELF, &usage) == 0)
+		stats.cpu_time = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000 + 
+			(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000;
+	file = fopen ("/proc/self/statm", "r");
+	if (file) {
+		if (fscanf (file, "%lu %lu", &size, &resident) == 2)
+			stats.rss = (long) ((resident * sysconf (_SC_PAGESIZE)) / 1024);
+		fclose (file);
+	} /* end if */
+	stats.updated = (long) time (NULL);
+
+	/* publish */
+	slot = ctx->child->stats;
+	slot->seq++;
+	TBC_MEMORY_BARRIER ();
+	memcpy (&slot->stats, &stats, sizeof (TurbulenceChildStats));
+	TBC_MEMORY_BARRIER ();
+	slot->seq++;
+
+	return axl_false; /* keep event */
+}
+
 /** 
  * @internal Function used to recover child status from the provided
  * init string.
@@ -280,6 +434,7 @@ axl_bool          turbulence_child_build_from_init_string (TurbulenceCtx * ctx,
 	char                child_init_string[4096];
 	char                child_init_length[30];
 	int                 iterator;
+	int                 count;
 	int                 size;
 	axl_bool            found;
 	char             ** items;
@@ -338,10 +493,24 @@ axl_bool          turbulence_child_build_from_init_string (TurbulenceCtx * ctx,
 	if (child->init_string_items == NULL)
 		return axl_false;
 
+	/* check all items sent by the parent are present (positions
+	 * are accessed without further checks) */
+	count = 0;
+	while (child->init_string_items[count])
+		count++;
+	if (count < TBC_CHILD_INIT_ITEMS) {
+		error ("CHILD: received child init string with %d items but expected %d, finishing child", count, TBC_CHILD_INIT_ITEMS);
+		return axl_false;
+	} /* end if */
+
 	/* set child on context */
 	ctx->child = child;
 	child->ctx = ctx;
 
+	/* number profile paths as the parent does (ids change after
+	 * each profile path reload) */
+	ctx->ppath_next_id = atoi (child->init_string_items[16]);
+
 	/* get a reference to the serverName this child represents */
 	items = axl_split (child->init_string_items[11], 1, ";-;");
 	if (items == NULL)
@@ -358,6 +527,9 @@ axl_bool          turbulence_child_build_from_init_string (TurbulenceCtx * ctx,
 	if (! __turbulence_child_post_init_openlogs (ctx, child->init_string_items)) 
 		return axl_false;
 
+	/* map stats slot (before changing root or user) */
+	__turbulence_child_stats_map (ctx, child);
+
 	/* return child structure properly recovered */
 	return axl_true;
 }
@@ -404,6 +576,7 @@ axl_bool          turbulence_child_post_init (TurbulenceCtx * ctx)
 	}
 	msg ("  Set profile path: '%s'", turbulence_ppath_get_name (def));
 	ctx->child->ppath = def;
+	__turbulence_ppath_ref (ctx, def);
 
 	/* check here to change root path, in the case it is defined
 	 * now we still have priviledges */
@@ -456,6 +629,13 @@ axl_bool          turbulence_child_post_init (TurbulenceCtx * ctx)
 			return axl_false;
 		} /* end if */
 	} /* end if */
+
+	/* publish counters to the parent */
+	if (child->stats) {
+		__turbulence_child_stats_publish (ctx->vortex_ctx, ctx, NULL);
+		vortex_thread_pool_new_event (ctx->vortex_ctx, 1000000, __turbulence_child_stats_publish, ctx, NULL);
+	} /* end if */
+
 	msg ("CHILD: post init phase done, child running (vortex.ctx refs: %d)", vortex_ctx_ref_count (child->ctx->vortex_ctx));
 	return axl_true;
 }
@@ -71,7 +71,11 @@ axl_bool turbulence_config_find_include_nodes (axlNode    * node,
 			  * visited */
 }
 
-void turbulence_config_load_expand_nodes (TurbulenceCtx * ctx)
+/** 
+ * @internal Expands <include> nodes found on the provided
+ * configuration document.
+ */
+void __turbulence_config_expand_doc (TurbulenceCtx * ctx, axlDoc * doc)
 {
 	axlList    * include_nodes;
 	int          iterator;
@@ -89,7 +93,7 @@ void turbulence_config_load_expand_nodes (TurbulenceCtx * ctx)
 
 	/* create the list and iterate over all nodes */
 	include_nodes = axl_list_new (axl_list_always_return_1, NULL);
-	axl_doc_iterate (ctx->config, DEEP_ITERATION, turbulence_config_find_include_nodes, include_nodes);
+	axl_doc_iterate (doc, DEEP_ITERATION, turbulence_config_find_include_nodes, include_nodes);
 	msg ("Found include nodes %d, expanding..", axl_list_length (include_nodes));
 
 	/* next position */
@@ -186,6 +190,12 @@ void turbulence_config_load_expand_nodes (TurbulenceCtx * ctx)
 	return;
 }
 
+void turbulence_config_load_expand_nodes (TurbulenceCtx * ctx)
+{
+	__turbulence_config_expand_doc (ctx, ctx->config);
+	return;
+}
+
 
 /** 
  * @internal Loads the turbulence main file, which has all definitions to make
@@ -260,6 +270,63 @@ axl_bool  turbulence_config_load (TurbulenceCtx * ctx, const char * config)
 	return axl_true;
 }
 
+/** 
+ * @brief Loads and validates the provided configuration file (with
+ * its <include> nodes expanded) without replacing the configuration
+ * currently used by the context. Used to reload parts of the
+ * configuration (like profile paths) at runtime.
+ *
+ * @param ctx The turbulence context where the operation takes place.
+ *
+ * @param config The configuration file to load. 
+ *
+ * @return A newly allocated document that must be released with
+ * axl_doc_free or NULL if it fails.
+ */
+axlDoc  * turbulence_config_parse (TurbulenceCtx * ctx, const char * config)
+{
+	axlError   * error;
+	axlDtd     * dtd_file;
+	axlDoc     * doc;
+
+	/* check null value */
+	if (config == NULL) {
+		error ("config file not defined, unable to load it");
+		return NULL;
+	} /* end if */
+
+	doc = axl_doc_parse_from_file (config, &error);
+	if (doc == NULL) {
+		error ("unable to load file (%s), it seems a xml error: %s", 
+		       config, axl_error_get (error));
+		axl_error_free (error);
+		return NULL;
+	} /* end if */
+
+	/* now process inclusions */
+	__turbulence_config_expand_doc (ctx, doc);
+
+	dtd_file = axl_dtd_parse (TURBULENCE_CONFIG_DTD, -1, &error);
+	if (dtd_file == NULL) {
+		error ("unable to load DTD to validate turbulence configuration, error: %s", axl_error_get (error));
+		axl_error_free (error);
+		axl_doc_free (doc);
+		return NULL;
+	} /* end if */
+
+	if (! axl_dtd_validate (doc, dtd_file, &error)) {
+		error ("unable to validate server configuration (%s), something is wrong: %s", 
+		       config, axl_error_get (error));
+		axl_error_free (error);
+		axl_dtd_free (dtd_file);
+		axl_doc_free (doc);
+		return NULL;
+	} /* end if */
+
+	axl_dtd_free (dtd_file);
+	return doc;
+}
+
 /** 
  * @brief Allows to get the configuration loaded at the startup. The
  * function will always return a configuration object. 
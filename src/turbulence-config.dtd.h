@@ -23,7 +23,11 @@
                     server-backlog?,                                                      \
                     max-incoming-complete-frame-limit?,                                   \
                     thread-pool?,                                                         \
-                    close-conn-on-start-failure?)>                                        \
+                    close-conn-on-start-failure?,                                         \
+                    child-zygote?,                                                        \
+                    child-spawn-rate?,                                                    \
+                    proxy-loops?,                                                         \
+                    connection-timeouts?)>                                                \
                                                                                           \
 <!ELEMENT ports           (port+)>                                                        \
 <!ELEMENT port            (#PCDATA)>                                                      \
@@ -79,6 +83,20 @@
 <!ELEMENT global-child-limit   EMPTY>                                                     \
 <!ATTLIST global-child-limit   value  CDATA #REQUIRED>                                    \
                                                                                           \
+<!ELEMENT child-zygote   EMPTY>                                                           \
+<!ATTLIST child-zygote   value  (yes|no) #REQUIRED>                                       \
+                                                                                          \
+<!ELEMENT child-spawn-rate   EMPTY>                                                       \
+<!ATTLIST child-spawn-rate   value  CDATA #REQUIRED                                       \
+                             burst  CDATA #IMPLIED>                                       \
+                                                                                          \
+<!ELEMENT proxy-loops   EMPTY>                                                            \
+<!ATTLIST proxy-loops   value  CDATA #REQUIRED>                                           \
+                                                                                          \
+<!ELEMENT connection-timeouts   EMPTY>                                                    \
+<!ATTLIST connection-timeouts   greeting  CDATA #IMPLIED                                  \
+                                idle      CDATA #IMPLIED>                                 \
+                                                                                          \
 <!ELEMENT server-backlog   EMPTY>                                                         \
 <!ATTLIST server-backlog   value  CDATA #REQUIRED>                                        \
                                                                                           \
@@ -149,6 +167,19 @@
    separate       CDATA #IMPLIED                                                          \
    child-limit    CDATA #IMPLIED                                                          \
    reuse          CDATA #IMPLIED                                                          \
+   min-spare-childs CDATA #IMPLIED                                                        \
+   max-spare-childs CDATA #IMPLIED                                                        \
+   children-per-ppath CDATA #IMPLIED                                                      \
+   balance-cpu    (yes|no) #IMPLIED                                                       \
+   admission-queue CDATA #IMPLIED                                                         \
+   admission-timeout CDATA #IMPLIED                                                       \
+   spawn-rate     CDATA #IMPLIED                                                          \
+   spawn-burst    CDATA #IMPLIED                                                          \
+   recycle-conns  CDATA #IMPLIED                                                          \
+   recycle-age    CDATA #IMPLIED                                                          \
+   recycle-rss    CDATA #IMPLIED                                                          \
+   greeting-timeout CDATA #IMPLIED                                                        \
+   idle-timeout   CDATA #IMPLIED                                                          \
    chroot         CDATA #IMPLIED                                                          \
           work-dir       CDATA #IMPLIED>                                                  \
                                                                                           \
@@ -44,6 +44,9 @@ axl_bool        turbulence_config_load     (TurbulenceCtx * ctx,
 
 void            turbulence_config_cleanup  (TurbulenceCtx * ctx);
 
+axlDoc        * turbulence_config_parse    (TurbulenceCtx * ctx, 
+					    const char    * config);
+
 axlDoc        * turbulence_config_get      (TurbulenceCtx * ctx);
 
 axl_bool        turbulence_config_set      (TurbulenceCtx * ctx,
@@ -35,11 +35,110 @@
  *         info@aspl.es - http://www.aspl.es/turbulence
  */
 
+#if defined(__linux__) && ! defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #include <turbulence.h>
 
 /* local include */
 #include <turbulence-ctx-private.h>
 
+#if defined(__linux__)
+#include <fcntl.h>
+#if defined(SPLICE_F_MOVE)
+#define TBC_PROXY_HAVE_SPLICE 1
+#endif
+#endif
+
+/** 
+ * @internal Pending bytes (not yet written into the destination)
+ * above which reading the source is paused, and below which it is
+ * resumed (both directions).
+ */
+#define TBC_PROXY_QUEUE_HIGH 262144
+#define TBC_PROXY_QUEUE_LOW  65536
+
+/** 
+ * @internal Max bytes held by a proxy queue. Reads are paused at
+ * TBC_PROXY_QUEUE_HIGH so only content already read can go past it:
+ * the connection is closed if the destination doesn't read it.
+ */
+#define TBC_PROXY_QUEUE_MAX  1048576
+
+/** 
+ * @internal Channels sent by each broadcast batch and max number of
+ * thread pool tasks helping the caller with a broadcast.
+ */
+#define TBC_BROADCAST_BATCH   256
+#define TBC_BROADCAST_WORKERS 4
+
+#if defined(MSG_DONTWAIT)
+#define TBC_PROXY_SEND_FLAGS MSG_DONTWAIT
+#else
+#define TBC_PROXY_SEND_FLAGS 0
+#endif
+
+/** 
+ * @internal Content read from a proxied connection that is pending
+ * to be written into the child socket ("tbc:proxy:queue"), or read
+ * from the child socket pending to be written into the connection
+ * ("tbc:proxy:conn-queue", only used from the proxy loop).
+ */
+typedef struct _TurbulenceProxyQueue {
+	VortexMutex   mutex;
+
+	/* content pending (copy path) */
+	char        * buffer;
+	int           size;
+	int           start;
+	int           used;
+
+	/* kernel pipe holding content pending (splice path) */
+	int         * pipe_fds;
+	int           pipe_pending;
+
+	/* content vortex already read for the connection was passed
+	 * (splice is only used after it) */
+	axl_bool      drained;
+
+	/* reading the source is paused */
+	axl_bool      blocked;
+	/* write notification requested to the proxy loop */
+	axl_bool      watching;
+} TurbulenceProxyQueue;
+
+void __turbulence_conn_mgr_proxy_queue_free (axlPointer _queue)
+{
+	TurbulenceProxyQueue * queue = _queue;
+
+	vortex_mutex_destroy (&queue->mutex);
+	axl_free (queue->buffer);
+	axl_free (queue);
+	return;
+}
+
+#if defined(TBC_PROXY_HAVE_SPLICE)
+/** 
+ * @internal Max bytes moved by each splice operation.
+ */
+#define TBC_PROXY_SPLICE_SIZE 65536
+
+/** 
+ * @internal Kernel pipes used to move content of raw proxied
+ * connections (see "tbc:proxy:raw") without copying it to user
+ * space.
+ */
+typedef struct _TurbulenceProxySplice {
+	/* remote conn -> child */
+	int to_child[2];
+	/* child -> remote conn (and bytes the connection didn't
+	 * accept yet, only used from the proxy loop) */
+	int to_conn[2];
+	int to_conn_pending;
+} TurbulenceProxySplice;
+#endif
+
 /** 
  * \defgroup turbulence_conn_mgr Turbulence Connection Manager: a module that controls all connections created under the turbulence execution
  */
@@ -49,6 +148,372 @@
  * @{
  */
 
+/** 
+ * @internal Gets greeting and idle timeouts (seconds, 0: disabled)
+ * that applies to the provided connection.
+ */
+void __turbulence_conn_mgr_timeouts (TurbulenceCtx    * ctx, 
+				     VortexConnection * conn, 
+				     int              * greeting, 
+				     int              * idle)
+{
+	TurbulencePPathDef * ppath = turbulence_ppath_selected (conn);
+
+	/* global values */
+	(*greeting) = ctx->conn_mgr_greeting_timeout;
+	(*idle)     = ctx->conn_mgr_idle_timeout;
+
+	/* on childs, the profile path is the one that started it */
+	if (ppath == NULL && ctx->child)
+		ppath = ctx->child->ppath;
+	if (ppath == NULL)
+		return;
+
+	/* profile path values (if defined) */
+	if (ppath->greeting_timeout >= 0)
+		(*greeting) = ppath->greeting_timeout;
+	if (ppath->idle_timeout >= 0)
+		(*idle) = ppath->idle_timeout;
+	return;
+}
+
+axl_bool __turbulence_conn_mgr_reap (TurbulenceLoop * loop, 
+				     TurbulenceCtx  * ctx, 
+				     int              timer_id,
+				     axlPointer       ptr, 
+				     axlPointer       ptr2);
+
+/** 
+ * @internal Returns the loop used to handle greeting and idle
+ * timeouts (created on first use).
+ */
+TurbulenceLoop * __turbulence_conn_mgr_reaper (TurbulenceCtx * ctx)
+{
+	if (ctx->conn_mgr_reaper == NULL) {
+		vortex_mutex_lock (&ctx->conn_mgr_reaper_mutex);
+		if (ctx->conn_mgr_reaper == NULL)
+			ctx->conn_mgr_reaper = turbulence_loop_create (ctx);
+		vortex_mutex_unlock (&ctx->conn_mgr_reaper_mutex);
+		if (ctx->conn_mgr_reaper == NULL)
+			error ("Unable to create loop to handle greeting and idle timeouts");
+	} /* end if */
+	return ctx->conn_mgr_reaper;
+}
+
+/** 
+ * @internal Installs the greeting or idle timer for the provided
+ * connection state. Must be called with the shard mutex acquired.
+ */
+void __turbulence_conn_mgr_reaper_arm (TurbulenceCtx          * ctx, 
+				       TurbulenceConnMgrState * state, 
+				       axl_bool                 idle, 
+				       long                     seconds)
+{
+	/* create loop on first use */
+	if (__turbulence_conn_mgr_reaper (ctx) == NULL)
+		return;
+
+	/* connections are tracked by id so a timer expiring after the
+	 * connection is unregistered finds nothing */
+	state->reap_idle  = idle;
+	state->reap_timer = turbulence_loop_add_timer (ctx->conn_mgr_reaper, seconds * 1000, axl_false, 
+						       __turbulence_conn_mgr_reap, 
+						       INT_TO_PTR (vortex_connection_get_id (state->conn)), NULL);
+	return;
+}
+
+/** 
+ * @internal Timer handler called when a connection reaches its
+ * greeting or idle timeout. The idle case is checked against the
+ * last content received to re-arm the timer if there was activity.
+ */
+axl_bool __turbulence_conn_mgr_reap (TurbulenceLoop * loop, 
+				     TurbulenceCtx  * ctx, 
+				     int              timer_id,
+				     axlPointer       ptr, 
+				     axlPointer       ptr2)
+{
+	TurbulenceConnMgrShard * shard = TBC_CONN_MGR_SHARD (ctx, PTR_TO_INT (ptr));
+	TurbulenceConnMgrState * state;
+	VortexConnection       * conn;
+	int                      greeting;
+	int                      idle;
+	long                     bytes_in;
+	long                     bytes_out;
+	long                     stamp;
+	long                     now;
+
+	vortex_mutex_lock (&shard->mutex);
+	if (shard->hash == NULL) {
+		vortex_mutex_unlock (&shard->mutex);
+		return axl_false;
+	} /* end if */
+
+	/* get state (connection may be already unregistered) and
+	 * skip timers cancelled or replaced while they were about to
+	 * be called */
+	state = axl_hash_get (shard->hash, ptr);
+	if (state == NULL || state->conn == NULL || state->reap_timer != timer_id) {
+		vortex_mutex_unlock (&shard->mutex);
+		return axl_false;
+	} /* end if */
+	state->reap_timer = -1;
+	conn              = state->conn;
+
+	if (state->reap_idle) {
+		/* skip connections proxied on parent (their content is
+		 * not read by vortex so no activity is recorded) */
+		__turbulence_conn_mgr_timeouts (ctx, conn, &greeting, &idle);
+		if (idle <= 0 || turbulence_conn_mgr_proxy_on_parent (conn)) {
+			vortex_mutex_unlock (&shard->mutex);
+			return axl_false;
+		} /* end if */
+
+		/* check last activity */
+		vortex_connection_get_receive_stamp (conn, &bytes_in, &bytes_out, &stamp);
+		if (stamp < state->registered)
+			stamp = state->registered;
+		now = time (NULL);
+		if ((now - stamp) < idle) {
+			/* activity found, check again once the remaining time expires */
+			__turbulence_conn_mgr_reaper_arm (ctx, state, axl_true, idle - (now - stamp));
+			vortex_mutex_unlock (&shard->mutex);
+			return axl_false;
+		} /* end if */
+
+		shard->reaped_idle++;
+		wrn ("Closing connection id=%d (%s:%s), idle for %ld seconds", 
+		     vortex_connection_get_id (conn), vortex_connection_get_host (conn), vortex_connection_get_port (conn), now - stamp);
+	} else {
+		shard->reaped_greeting++;
+		wrn ("Closing connection id=%d (%s:%s), no channel was opened after greetings", 
+		     vortex_connection_get_id (conn), vortex_connection_get_host (conn), vortex_connection_get_port (conn));
+	} /* end if */
+
+	/* acquire a reference to shutdown the connection outside the
+	 * lock (on close handlers acquire the shard mutex) */
+	if (! vortex_connection_ref (conn, "turbulence-conn-mgr reaper")) {
+		vortex_mutex_unlock (&shard->mutex);
+		return axl_false;
+	} /* end if */
+	vortex_mutex_unlock (&shard->mutex);
+
+	vortex_connection_shutdown (conn);
+	vortex_connection_unref (conn, "turbulence-conn-mgr reaper");
+
+	return axl_false;
+}
+
+/** 
+ * @internal Timer handler called when a connection accepted reaches
+ * its greeting timeout. The connection is closed if it is still
+ * waiting to complete greetings (it wasn't registered yet).
+ */
+axl_bool __turbulence_conn_mgr_reap_accepted (TurbulenceLoop * loop, 
+					      TurbulenceCtx  * ctx, 
+					      int              timer_id,
+					      axlPointer       ptr, 
+					      axlPointer       ptr2)
+{
+	TurbulenceConnMgrShard * shard = TBC_CONN_MGR_SHARD (ctx, PTR_TO_INT (ptr));
+	VortexConnection       * conn;
+
+	vortex_mutex_lock (&shard->mutex);
+	conn = shard->accepted ? axl_hash_get (shard->accepted, ptr) : NULL;
+	if (conn == NULL) {
+		vortex_mutex_unlock (&shard->mutex);
+		return axl_false;
+	} /* end if */
+	axl_hash_remove (shard->accepted, ptr);
+
+	/* acquire a reference to shutdown the connection outside the
+	 * lock (on close handlers acquire the shard mutex) */
+	if (! vortex_connection_ref (conn, "turbulence-conn-mgr reaper")) {
+		vortex_mutex_unlock (&shard->mutex);
+		return axl_false;
+	} /* end if */
+	shard->reaped_greeting++;
+	vortex_mutex_unlock (&shard->mutex);
+
+	wrn ("Closing connection id=%d (%s:%s), greetings weren't completed", 
+	     vortex_connection_get_id (conn), vortex_connection_get_host (conn), vortex_connection_get_port (conn));
+	vortex_connection_shutdown (conn);
+	vortex_connection_unref (conn, "turbulence-conn-mgr reaper");
+
+	return axl_false;
+}
+
+/** 
+ * @internal Removes the connection from the accepted connections
+ * waiting greetings. Returns when the connection was accepted
+ * (seconds since epoch) or 0 if it wasn't found.
+ */
+long __turbulence_conn_mgr_accepted_remove (TurbulenceCtx * ctx, VortexConnection * conn)
+{
+	TurbulenceConnMgrShard * shard = TBC_CONN_MGR_SHARD (ctx, vortex_connection_get_id (conn));
+	long                     accepted;
+
+	vortex_mutex_lock (&shard->mutex);
+	accepted = 0;
+	if (shard->accepted && axl_hash_get (shard->accepted, INT_TO_PTR (vortex_connection_get_id (conn)))) {
+		axl_hash_remove (shard->accepted, INT_TO_PTR (vortex_connection_get_id (conn)));
+		accepted = PTR_TO_INT (vortex_connection_get_data (conn, "tbc:conn:accepted"));
+	} /* end if */
+	vortex_mutex_unlock (&shard->mutex);
+
+	return accepted;
+}
+
+/** 
+ * @internal On close handler for connections closed before
+ * completing greetings.
+ */
+void __turbulence_conn_mgr_accepted_on_close (VortexConnection * conn, axlPointer user_data)
+{
+	__turbulence_conn_mgr_accepted_remove (user_data, conn);
+	return;
+}
+
+/** 
+ * @internal Arms the greeting timeout for a connection just accepted
+ * (before greetings are exchanged), so peers that connect and never
+ * send their greetings are also closed. Once the connection is
+ * registered, the remaining time is handled by the connection
+ * state timer.
+ *
+ * @param ctx The turbulence context where the connection was accepted.
+ *
+ * @param conn The connection accepted.
+ */
+void __turbulence_conn_mgr_accepted (TurbulenceCtx * ctx, VortexConnection * conn)
+{
+	TurbulenceConnMgrShard * shard = TBC_CONN_MGR_SHARD (ctx, vortex_connection_get_id (conn));
+	TurbulenceLoop         * reaper;
+	int                      greeting;
+	int                      idle;
+
+	__turbulence_conn_mgr_timeouts (ctx, conn, &greeting, &idle);
+	if (greeting <= 0)
+		return;
+	reaper = __turbulence_conn_mgr_reaper (ctx);
+	if (reaper == NULL)
+		return;
+
+	/* record the connection (no reference: it is removed by the
+	 * on close handler) */
+	vortex_connection_set_data (conn, "tbc:conn:accepted", INT_TO_PTR (time (NULL)));
+	vortex_mutex_lock (&shard->mutex);
+	if (shard->accepted == NULL)
+		shard->accepted = axl_hash_new (axl_hash_int, axl_hash_equal_int);
+	axl_hash_insert (shard->accepted, INT_TO_PTR (vortex_connection_get_id (conn)), conn);
+	vortex_mutex_unlock (&shard->mutex);
+	vortex_connection_set_on_close_full (conn, __turbulence_conn_mgr_accepted_on_close, ctx);
+
+	/* connections are tracked by id so a timer expiring after
+	 * greetings finds nothing */
+	turbulence_loop_add_timer (reaper, greeting * 1000, axl_false, 
+				   __turbulence_conn_mgr_reap_accepted, 
+				   INT_TO_PTR (vortex_connection_get_id (conn)), NULL);
+	return;
+}
+
+/** 
+ * @internal Hash and equal functions used to index channels by
+ * pointer.
+ */
+unsigned int __turbulence_conn_mgr_hash_ptr (axlPointer key)
+{
+	return (unsigned int) (((unsigned long) key) >> 4);
+}
+
+int __turbulence_conn_mgr_equal_ptr (axlPointer keya, axlPointer keyb)
+{
+	return (keya == keyb) ? 0 : 1;
+}
+
+/** 
+ * @internal Adds the provided channel to the shard profile
+ * index. Must be called with the shard mutex acquired.
+ */
+void __turbulence_conn_mgr_index_add (TurbulenceConnMgrState * state, VortexChannel * channel)
+{
+	TurbulenceConnMgrShard * shard   = state->shard;
+	const char             * profile = vortex_channel_get_profile (channel);
+	axlHash                * channels;
+
+	/* skip administrative channel */
+	if (profile == NULL || vortex_channel_get_number (channel) == 0 || shard->channels == NULL)
+		return;
+
+	/* get or create the profile entry */
+	channels = axl_hash_get (shard->channels, (axlPointer) profile);
+	if (channels == NULL) {
+		channels = axl_hash_new (__turbulence_conn_mgr_hash_ptr, __turbulence_conn_mgr_equal_ptr);
+		axl_hash_insert_full (shard->channels, axl_strdup (profile), axl_free, channels, (axlDestroyFunc) axl_hash_free);
+	} /* end if */
+	axl_hash_insert (channels, channel, channel);
+
+	/* record profile to remove the channel later */
+	axl_hash_insert_full (state->indexed, channel, NULL, axl_strdup (profile), axl_free);
+	return;
+}
+
+/** 
+ * @internal Removes the provided channel from the shard profile
+ * index (without updating state->indexed). Must be called with the
+ * shard mutex acquired.
+ */
+axl_bool __turbulence_conn_mgr_index_unlink (axlPointer key, axlPointer data, axlPointer user_data)
+{
+	TurbulenceConnMgrShard * shard   = user_data;
+	axlHash                * channels;
+
+	if (shard->channels == NULL)
+		return axl_false;
+	channels = axl_hash_get (shard->channels, data);
+	if (channels == NULL)
+		return axl_false;
+
+	/* remove the channel and the profile entry once empty */
+	axl_hash_remove (channels, key);
+	if (axl_hash_items (channels) == 0)
+		axl_hash_remove (shard->channels, data);
+
+	return axl_false; /* keep foreach looping */
+}
+
+/** 
+ * @internal Removes the provided channel from the shard profile
+ * index. Must be called with the shard mutex acquired.
+ */
+void __turbulence_conn_mgr_index_remove (TurbulenceConnMgrState * state, VortexChannel * channel)
+{
+	char * profile = axl_hash_get (state->indexed, channel);
+
+	if (profile == NULL)
+		return;
+	__turbulence_conn_mgr_index_unlink (channel, profile, state->shard);
+	axl_hash_remove (state->indexed, channel);
+	return;
+}
+
+/** 
+ * @internal Removes the provided connection id from the shard. Must
+ * be called with the shard mutex acquired.
+ */
+void __turbulence_conn_mgr_remove (TurbulenceConnMgrShard * shard, int conn_id)
+{
+	/* do not remove if hash is not defined */
+	if (shard->hash == NULL || ! axl_hash_exists (shard->hash, INT_TO_PTR (conn_id)))
+		return;
+
+	/* update count before removing so the state release sees the
+	 * connection as unregistered */
+	shard->items--;
+	axl_hash_remove (shard->hash, INT_TO_PTR (conn_id));
+	return;
+}
+
 /** 
  * @internal Handler called once the connection is about to be closed.
  * 
@@ -59,23 +524,21 @@ void turbulence_conn_mgr_on_close (VortexConnection * conn,
 {
 	/* get turbulence context */
 	TurbulenceCtx          * ctx = user_data;
+	TurbulenceConnMgrShard * shard;
 
 	/* check if we are the last reference */
 	if (vortex_connection_ref_count (conn) == 1)
 		return;
 
-	/* do not remove if hash is not defined */
-	if (ctx->conn_mgr_hash == NULL)
-		return;
-
 	/* new connection created: configure it */
-	vortex_mutex_lock (&ctx->conn_mgr_mutex);
+	shard = TBC_CONN_MGR_SHARD (ctx, vortex_connection_get_id (conn));
+	vortex_mutex_lock (&shard->mutex);
 
 	/* remove from the hash */
-	axl_hash_remove (ctx->conn_mgr_hash, INT_TO_PTR (vortex_connection_get_id (conn)));
+	__turbulence_conn_mgr_remove (shard, vortex_connection_get_id (conn));
 
 	/* unlock */
-	vortex_mutex_unlock (&ctx->conn_mgr_mutex);
+	vortex_mutex_unlock (&shard->mutex);
 
 
 	return;
@@ -106,9 +569,23 @@ void turbulence_conn_mgr_unref (axlPointer data)
 	/* get a reference to the state */
 	TurbulenceConnMgrState * state = data;
 	TurbulenceCtx          * ctx   = state->ctx;
+	TurbulenceConnMgrShard * shard;
+	long                     bytes_in;
+	long                     bytes_out;
+	long                     stamp;
 
 	/* check connection status */
 	if (state->conn) {
+		/* account bytes of the connection closed */
+		shard = TBC_CONN_MGR_SHARD (ctx, vortex_connection_get_id (state->conn));
+		vortex_connection_get_receive_stamp (state->conn, &bytes_in, &bytes_out, &stamp);
+		shard->bytes_in  += bytes_in;
+		shard->bytes_out += bytes_out;
+
+		/* remove greeting or idle timer */
+		if (state->reap_timer != -1 && ctx->conn_mgr_reaper)
+			turbulence_loop_cancel_timer (ctx->conn_mgr_reaper, state->reap_timer);
+
 		/* remove installed handlers */
 		vortex_connection_remove_handler (state->conn, CONNECTION_CHANNEL_ADD_HANDLER, state->added_channel_id);
 		vortex_connection_remove_handler (state->conn, CONNECTION_CHANNEL_REMOVE_HANDLER, state->removed_channel_id);
@@ -125,8 +602,12 @@ void turbulence_conn_mgr_unref (axlPointer data)
 		vortex_connection_unref ((VortexConnection*) state->conn, "turbulence-conn-mgr");
 	} /* end if */
 
-	/* finish profiles running hash */
+	/* finish profiles running hash and remove channels indexed */
 	axl_hash_free (state->profiles_running);
+	if (state->indexed) {
+		axl_hash_foreach (state->indexed, __turbulence_conn_mgr_index_unlink, state->shard);
+		axl_hash_free (state->indexed);
+	} /* end if */
 
 	/* nullify and free */
 	memset (state, 0, sizeof (TurbulenceConnMgrState));
@@ -135,8 +616,8 @@ void turbulence_conn_mgr_unref (axlPointer data)
 	/* check if we have to initiate child process termination */
 	if (ctx->child && ctx->started) {
 		/* msg ("CHILD: Checking for process termination, current connections are: %d",
-		   axl_hash_items (ctx->conn_mgr_hash)); */
-		if (axl_hash_items (ctx->conn_mgr_hash) == 0) {
+		   turbulence_conn_mgr_count (ctx)); */
+		if (turbulence_conn_mgr_count (ctx) == 0) {
 			wrn ("CHILD: Starting finishing process, current connections are: 0");
 			turbulence_process_check_for_finish (ctx);
 		}
@@ -156,21 +637,22 @@ void turbulence_conn_mgr_added_handler (VortexChannel * channel, axlPointer user
 	 * running in the connection. */
 	char                   * running_profile;
 	int                      count;
+	int                      greeting;
+	int                      idle;
+	TurbulenceConnMgrShard * shard;
 
-	/* check if hash is finished */
-	if (ctx->conn_mgr_hash == NULL) 
-		return;
-
+	/* get the shard where the connection is registered */
+	conn  = vortex_channel_get_connection (channel);
+	shard = TBC_CONN_MGR_SHARD (ctx, vortex_connection_get_id (conn));
 
 	/* get the lock */
-	vortex_mutex_lock (&ctx->conn_mgr_mutex);
+	vortex_mutex_lock (&shard->mutex);
 
 	/* get state */
-	conn  = vortex_channel_get_connection (channel);
-	state = axl_hash_get (ctx->conn_mgr_hash, INT_TO_PTR (vortex_connection_get_id (conn)));
+	state = shard->hash ? axl_hash_get (shard->hash, INT_TO_PTR (vortex_connection_get_id (conn))) : NULL;
 	if (state == NULL) {
 		/* get the lock */
-		vortex_mutex_unlock (&ctx->conn_mgr_mutex);
+		vortex_mutex_unlock (&shard->mutex);
 		return;
 	}
 	
@@ -182,12 +664,26 @@ void turbulence_conn_mgr_added_handler (VortexChannel * channel, axlPointer user
 	count++;
 
 	axl_hash_insert_full (state->profiles_running, (axlPointer) running_profile, axl_free, INT_TO_PTR (count), NULL);
+	state->profiles_version++;
+	shard->channels_total++;
+
+	/* index the channel by profile for broadcast operations */
+	__turbulence_conn_mgr_index_add (state, channel);
 
 	/* configure here channel complete flag limit */
 	vortex_channel_set_complete_frame_limit (channel, ctx->max_complete_flag_limit);
 
+	/* first channel opened: replace greeting timer with the idle one */
+	if (vortex_channel_get_number (channel) != 0 && state->reap_timer != -1 && ! state->reap_idle) {
+		turbulence_loop_cancel_timer (ctx->conn_mgr_reaper, state->reap_timer);
+		state->reap_timer = -1;
+		__turbulence_conn_mgr_timeouts (ctx, conn, &greeting, &idle);
+		if (idle > 0)
+			__turbulence_conn_mgr_reaper_arm (ctx, state, axl_true, idle);
+	} /* end if */
+
 	/* release the lock */
-	vortex_mutex_unlock (&ctx->conn_mgr_mutex);
+	vortex_mutex_unlock (&shard->mutex);
 
 	return;
 }
@@ -199,22 +695,26 @@ void turbulence_conn_mgr_removed_handler (VortexChannel * channel, axlPointer us
 	const char             * running_profile = vortex_channel_get_profile (channel);
 	int                      count;
 	VortexConnection       * conn;
+	TurbulenceConnMgrShard * shard;
 
-	/* check if hash is finished */
-	if (ctx->conn_mgr_hash == NULL) 
-		return;
+	/* get the shard where the connection is registered */
+	conn  = vortex_channel_get_connection (channel);
+	shard = TBC_CONN_MGR_SHARD (ctx, vortex_connection_get_id (conn));
 
 	/* get the lock */
-	vortex_mutex_lock (&ctx->conn_mgr_mutex);
+	vortex_mutex_lock (&shard->mutex);
 
 	/* get the state and check reference */
-	conn  = vortex_channel_get_connection (channel);
-	state = axl_hash_get (ctx->conn_mgr_hash, INT_TO_PTR (vortex_connection_get_id (conn)));
+	state = shard->hash ? axl_hash_get (shard->hash, INT_TO_PTR (vortex_connection_get_id (conn))) : NULL;
 	if (state == NULL) {
 		/* get the lock */
-		vortex_mutex_unlock (&ctx->conn_mgr_mutex);
+		vortex_mutex_unlock (&shard->mutex);
 		return;
 	}
+
+	/* remove the channel from the profile index */
+	__turbulence_conn_mgr_index_remove (state, channel);
+	state->profiles_version++;
 	
 	/* get channel count for the profile */
 	count = PTR_TO_INT (axl_hash_get (state->profiles_running, (axlPointer) running_profile));
@@ -225,7 +725,7 @@ void turbulence_conn_mgr_removed_handler (VortexChannel * channel, axlPointer us
 		axl_hash_remove (state->profiles_running, (axlPointer) running_profile);
 
 		/* release the lock */
-		vortex_mutex_unlock (&ctx->conn_mgr_mutex);		
+		vortex_mutex_unlock (&shard->mutex);		
 		return;
 	} /* end if */
 
@@ -239,7 +739,7 @@ void turbulence_conn_mgr_removed_handler (VortexChannel * channel, axlPointer us
 	axl_hash_insert_full (state->profiles_running, (axlPointer) running_profile, axl_free, INT_TO_PTR (count), NULL);
 
 	/* release the lock */
-	vortex_mutex_unlock (&ctx->conn_mgr_mutex);
+	vortex_mutex_unlock (&shard->mutex);
 
 	return;
 }
@@ -265,6 +765,10 @@ int turbulence_conn_mgr_notify (VortexCtx               * vortex_ctx,
 	 * process is done on a child process */
 	TurbulenceChild        * child = ctx->child;
 	VortexConnection       * temp;
+	TurbulenceConnMgrShard * shard;
+	int                      greeting;
+	int                      idle;
+	long                     accepted;
 
 	/* skip connection that should be registered at conn mgr */
 	if (vortex_connection_get_data (conn, "tbc:conn:mgr:!")) 
@@ -303,6 +807,12 @@ int turbulence_conn_mgr_notify (VortexCtx               * vortex_ctx,
 		} /* end if */
 	} /* end if */
 
+	/* greetings completed: stop the greeting timer armed on
+	 * accept (the state timer handles the remaining time) */
+	accepted = __turbulence_conn_mgr_accepted_remove (ctx, conn);
+	if (accepted > 0)
+		vortex_connection_remove_on_close_full (conn, __turbulence_conn_mgr_accepted_on_close, ctx);
+
 	/* create state */
 	state       = axl_new (TurbulenceConnMgrState, 1);
 	if (state == NULL)
@@ -312,8 +822,10 @@ int turbulence_conn_mgr_notify (VortexCtx               * vortex_ctx,
 		axl_free (state);
 		return -1;
 	} /* end if */
-	state->conn = conn;
-	state->ctx  = ctx;
+	state->conn    = conn;
+	state->ctx     = ctx;
+	state->shard   = TBC_CONN_MGR_SHARD (ctx, vortex_connection_get_id (conn));
+	state->indexed = axl_hash_new (__turbulence_conn_mgr_hash_ptr, __turbulence_conn_mgr_equal_ptr);
 
 	/* store in the hash */
 	msg ("Registering connection: %d (%p, refs: %d, channels: %d, socket: %d)", 
@@ -321,13 +833,17 @@ int turbulence_conn_mgr_notify (VortexCtx               * vortex_ctx,
 	     vortex_connection_channels_count (conn), vortex_connection_get_socket (conn));
 
 	/* new connection created: configure it */
-	vortex_mutex_lock (&ctx->conn_mgr_mutex);
+	shard = state->shard;
+	vortex_mutex_lock (&shard->mutex);
 
-	axl_hash_insert_full (ctx->conn_mgr_hash, 
+	if (! axl_hash_exists (shard->hash, INT_TO_PTR (vortex_connection_get_id (conn))))
+		shard->items++;
+	axl_hash_insert_full (shard->hash, 
 			      /* key to store */
 			      INT_TO_PTR (vortex_connection_get_id (conn)), NULL,
 			      /* data to store */
 			      state, turbulence_conn_mgr_unref);
+	shard->conns_total++;
 
 	/* configure on close */
 	vortex_connection_set_on_close_full (conn, turbulence_conn_mgr_on_close, ctx);
@@ -337,8 +853,26 @@ int turbulence_conn_mgr_notify (VortexCtx               * vortex_ctx,
 	state->added_channel_id   = vortex_connection_set_channel_added_handler (conn, turbulence_conn_mgr_added_handler, ctx);
 	state->removed_channel_id = vortex_connection_set_channel_removed_handler (conn, turbulence_conn_mgr_removed_handler, ctx);
 
+	/* install greeting timer (or idle timer if greeting timeout is
+	 * disabled) for connections accepted, counting the time since
+	 * the connection was accepted */
+	state->reap_timer = -1;
+	state->registered = time (NULL);
+	if (vortex_connection_get_role (conn) == VortexRoleListener) {
+		__turbulence_conn_mgr_timeouts (ctx, conn, &greeting, &idle);
+		if (greeting > 0 && accepted > 0) {
+			greeting -= (state->registered - accepted);
+			if (greeting < 1)
+				greeting = 1;
+		} /* end if */
+		if (greeting > 0)
+			__turbulence_conn_mgr_reaper_arm (ctx, state, axl_false, greeting);
+		else if (idle > 0)
+			__turbulence_conn_mgr_reaper_arm (ctx, state, axl_true, idle);
+	} /* end if */
+
 	/* unlock */
-	vortex_mutex_unlock (&ctx->conn_mgr_mutex);
+	vortex_mutex_unlock (&shard->mutex);
 
 	/* signal no error was found and the rest of handler can be
 	 * executed */
@@ -352,9 +886,14 @@ axlDoc * turbulence_conn_mgr_show_connections (const char * line,
 	TurbulenceCtx          * ctx = (TurbulenceCtx *) user_data;
 	axlDoc                 * doc;
 	axlHashCursor          * cursor;
+	TurbulenceConnMgrShard * shard;
 	TurbulenceConnMgrState * state;
 	axlNode                * parent;
 	axlNode                * node;
+	char                   * description;
+	int                      iterator;
+	int                      reaped_greeting = 0;
+	int                      reaped_idle     = 0;
 
 	/* signal command completed ok */
 	(* status) = axl_true;
@@ -369,36 +908,52 @@ axlDoc * turbulence_conn_mgr_show_connections (const char * line,
 	/* get parent node */
 	parent = axl_doc_get (doc, "/table/content");
 
-	/* lock connections */
-	vortex_mutex_lock (&ctx->conn_mgr_mutex);
+	/* lock one shard at a time */
+	for (iterator = 0; iterator < TBC_CONN_MGR_SHARDS; iterator++) {
+		shard = &(ctx->conn_mgr_shards[iterator]);
+		vortex_mutex_lock (&shard->mutex);
+		reaped_greeting += shard->reaped_greeting;
+		reaped_idle     += shard->reaped_idle;
+
+		/* module already finished */
+		if (shard->hash == NULL) {
+			vortex_mutex_unlock (&shard->mutex);
+			continue;
+		} /* end if */
 	
-	/* create cursor */
-	cursor = axl_hash_cursor_new (ctx->conn_mgr_hash);
-
-	while (axl_hash_cursor_has_item (cursor)) {
-		/* get connection */
-		state = axl_hash_cursor_get_value (cursor);
-
-		/* build connection status information */
-		node  = axl_node_parse (NULL, "<row id='%d' host='%s' port='%s' local-addr='%s' local-port='%s' />",
-					vortex_connection_get_id (state->conn),
-					vortex_connection_get_host (state->conn),
-					vortex_connection_get_port (state->conn),
-					vortex_connection_get_local_addr (state->conn),
-					vortex_connection_get_local_port (state->conn));
-
-		/* set node to result document */
-		axl_node_set_child (parent, node);
-
-		/* next cursor */
-		axl_hash_cursor_next (cursor);
-	} /* end while */
+		/* create cursor */
+		cursor = axl_hash_cursor_new (shard->hash);
+
+		while (axl_hash_cursor_has_item (cursor)) {
+			/* get connection */
+			state = axl_hash_cursor_get_value (cursor);
+
+			/* build connection status information */
+			node  = axl_node_parse (NULL, "<row id='%d' host='%s' port='%s' local-addr='%s' local-port='%s' />",
+						vortex_connection_get_id (state->conn),
+						vortex_connection_get_host (state->conn),
+						vortex_connection_get_port (state->conn),
+						vortex_connection_get_local_addr (state->conn),
+						vortex_connection_get_local_port (state->conn));
+
+			/* set node to result document */
+			axl_node_set_child (parent, node);
+
+			/* next cursor */
+			axl_hash_cursor_next (cursor);
+		} /* end while */
 	
-	/* free cursor */
-	axl_hash_cursor_free (cursor);
+		/* free cursor */
+		axl_hash_cursor_free (cursor);
 
-	/* unlock connections */
-	vortex_mutex_unlock (&ctx->conn_mgr_mutex);
+		/* unlock connections */
+		vortex_mutex_unlock (&shard->mutex);
+	} /* end for */
+
+	/* report connections closed by greeting and idle timeouts */
+	description = axl_strdup_printf ("The following is a list of peers connected (closed by greeting timeout: %d, closed by idle timeout: %d)",
+					 reaped_greeting, reaped_idle);
+	axl_node_set_content_ref (axl_doc_get (doc, "/table/description"), description, -1);
 	
 	return doc;
 }
@@ -421,28 +976,48 @@ void turbulence_conn_mgr_module_registered (TurbulenceMediatorObject * object)
  */
 void turbulence_conn_mgr_init (TurbulenceCtx * ctx, axl_bool reinit)
 {
-	VortexCtx  * vortex_ctx = turbulence_ctx_get_vortex_ctx (ctx);
+	VortexCtx              * vortex_ctx = turbulence_ctx_get_vortex_ctx (ctx);
+	TurbulenceConnMgrShard * shard;
+	int                      iterator;
 
-	/* init mutex */
-	vortex_mutex_create (&ctx->conn_mgr_mutex);
+	/* init mutexes */
+	for (iterator = 0; iterator < TBC_CONN_MGR_SHARDS; iterator++)
+		vortex_mutex_create (&ctx->conn_mgr_shards[iterator].mutex);
+	vortex_mutex_create (&ctx->conn_mgr_reaper_mutex);
 
 	/* check for reinit operation */
 	if (reinit) {
-		/* lock during update */
-		vortex_mutex_lock (&ctx->conn_mgr_mutex);
-
-		axl_hash_free (ctx->conn_mgr_hash);
-		ctx->conn_mgr_hash = axl_hash_new (axl_hash_int, axl_hash_equal_int);
-
-		/* release */
-		vortex_mutex_unlock (&ctx->conn_mgr_mutex);
+		for (iterator = 0; iterator < TBC_CONN_MGR_SHARDS; iterator++) {
+			/* lock during update */
+			shard = &(ctx->conn_mgr_shards[iterator]);
+			vortex_mutex_lock (&shard->mutex);
+
+			axl_hash_free (shard->hash);
+			axl_hash_free (shard->channels);
+			axl_hash_free (shard->accepted);
+			shard->accepted        = NULL;
+			shard->hash            = axl_hash_new (axl_hash_int, axl_hash_equal_int);
+			shard->channels        = axl_hash_new (axl_hash_string, axl_hash_equal_string);
+			shard->items           = 0;
+			shard->reaped_greeting = 0;
+			shard->reaped_idle     = 0;
+
+			/* release */
+			vortex_mutex_unlock (&shard->mutex);
+		} /* end for */
+
+		/* reaper loop thread isn't available after fork */
+		ctx->conn_mgr_reaper = NULL;
 		return;
 	}
 
-	/* init connection list hash */
-	if (ctx->conn_mgr_hash == NULL) {
+	/* init connection list hashes */
+	if (ctx->conn_mgr_shards[0].hash == NULL) {
 		
-		ctx->conn_mgr_hash = axl_hash_new (axl_hash_int, axl_hash_equal_int);
+		for (iterator = 0; iterator < TBC_CONN_MGR_SHARDS; iterator++) {
+			ctx->conn_mgr_shards[iterator].hash     = axl_hash_new (axl_hash_int, axl_hash_equal_int);
+			ctx->conn_mgr_shards[iterator].channels = axl_hash_new (axl_hash_string, axl_hash_equal_string);
+		} /* end for */
 
 		/* configure notification handlers */
 		vortex_connection_set_connection_actions (vortex_ctx,
@@ -468,7 +1043,7 @@ void turbulence_conn_mgr_register (TurbulenceCtx * ctx, VortexConnection * conn)
 	msg ("Registering connection at child process (%d) conn id: %d (status: %d), refs: %d", 
 	     getpid (), vortex_connection_get_id (conn), vortex_connection_is_ok (conn, axl_false), vortex_connection_ref_count (conn));
 	turbulence_conn_mgr_notify (TBC_VORTEX_CTX (ctx), conn, NULL, CONNECTION_STAGE_POST_CREATED, ctx);
-	msg ("After register, connections are: %d", axl_hash_items (ctx->conn_mgr_hash));
+	msg ("After register, connections are: %d", turbulence_conn_mgr_count (ctx));
 	return;
 }
 
@@ -480,173 +1055,423 @@ void turbulence_conn_mgr_register (TurbulenceCtx * ctx, VortexConnection * conn)
 void turbulence_conn_mgr_unregister    (TurbulenceCtx    * ctx, 
 					VortexConnection * conn)
 {
+	TurbulenceConnMgrShard * shard = TBC_CONN_MGR_SHARD (ctx, vortex_connection_get_id (conn));
+
 	/* new connection created: configure it */
-	vortex_mutex_lock (&ctx->conn_mgr_mutex);
+	vortex_mutex_lock (&shard->mutex);
 
 	/* remove from the hash */
-	axl_hash_remove (ctx->conn_mgr_hash, INT_TO_PTR (vortex_connection_get_id (conn)));
+	__turbulence_conn_mgr_remove (shard, vortex_connection_get_id (conn));
 
 	/* unlock */
-	vortex_mutex_unlock (&ctx->conn_mgr_mutex);
+	vortex_mutex_unlock (&shard->mutex);
 
 	return;
 }
 
-typedef struct _TurbulenceBroadCastMsg {
-	const void      * message;
-	int               message_size;
-	const char      * profile;
-	TurbulenceCtx   * ctx;
-} TurbulenceBroadCastMsg;
+/** 
+ * @internal Broadcast operation shared by the caller and the thread
+ * pool tasks sending batches of channels.
+ */
+typedef struct _TurbulenceBroadcast {
+	VortexMutex        mutex;
+	int                refs;
+
+	/* content to send */
+	const void       * message;
+	int                message_size;
+
+	/* channels selected (referenced), next one to be taken and
+	 * batches being sent */
+	VortexChannel   ** channels;
+	int                count;
+	int                next;
+	int                running;
+
+	/* connections where sending failed (indexed by connection
+	 * id to record each one once) and queue used to notify
+	 * batches finished */
+	axlList          * failed;
+	axlHash          * failed_ids;
+	VortexAsyncQueue * done;
+} TurbulenceBroadcast;
+
+/** 
+ * @internal Collects channels found at the profile index.
+ */
+typedef struct _TurbulenceBroadcastSelect {
+	VortexChannel   ** channels;
+	int                count;
+	int                size;
+} TurbulenceBroadcastSelect;
 
-int  _turbulence_conn_mgr_broadcast_msg_foreach (axlPointer key, axlPointer data, axlPointer user_data)
+axl_bool __turbulence_conn_mgr_broadcast_select (axlPointer key, axlPointer data, axlPointer user_data)
 {
-	VortexChannel          * channel   = data;
-	TurbulenceBroadCastMsg * broadcast = user_data;
-#if ! defined(SHOW_FORMAT_BUGS)
-	TurbulenceCtx          * ctx       = broadcast->ctx; 
-#endif
+	TurbulenceBroadcastSelect * selection = user_data;
+	VortexChannel             * channel = data;
 
-	/* check the channel profile */
-	if (! axl_cmp (vortex_channel_get_profile (channel), broadcast->profile)) 
-		return axl_false;
+	/* grow array */
+	if (selection->count == selection->size) {
+		selection->size     = selection->size ? selection->size * 2 : 64;
+		selection->channels = axl_realloc (selection->channels, sizeof (VortexChannel *) * selection->size);
+	} /* end if */
 
-	/* channel found send the message */
-	msg2 ("sending notification on channel=%d, conn=%d running profile: %s", 
-	      vortex_channel_get_number (channel), vortex_connection_get_id (vortex_channel_get_connection (channel)),
-	      broadcast->profile); 
-	vortex_channel_send_msg (channel, broadcast->message, broadcast->message_size, NULL);
+	/* acquire a reference to send outside the shard lock */
+	if (vortex_channel_ref (channel)) {
+		selection->channels[selection->count] = channel;
+		selection->count++;
+	} /* end if */
 
-	/* always return axl_true to make the process to continue */
-	return axl_false;
+	return axl_false; /* keep foreach looping */
 }
 
-/** 
- * @brief General purpose function that allows to broadcast the
- * provided message (and size), over all channel, running the profile
- * provided, on all connections registered. 
- *
- * The function is really useful if it is required to perform a
- * general broadcast to all BEEP peers connected running a particular
- * profile. The function produces a MSG frame with the content
- * provided.
- *
- * The function also allows to configure the connections that aren't
- * broadcasted. To do so, pass the function (filter_conn) that
- * configures which connections receives the notification and which
- * not.
- * 
- * @param ctx Turbulence context where the operation will take place.
- * 
- * @param message The message that is being broadcasted. This
- * parameter is not optional. For empty messages use "" instead of
- * NULL.
- *
- * @param message_size The message size to broadcast. This parameter
- * is not optional. For empty messages use 0.
- *
- * @param profile The profile to search for in all connections
- * registered. If a channel is found running this profile, then a
- * message is sent. This attribute is not optional.
- *
- * @param filter_conn Connection filtering function. If it returns
- * axl_true, the connection is filter. Optional parameter.
- *
- * @param filter_data User defined data provided to the filter
- * function. Optional parameter.
- * 
- * @return axl_true if the broadcast message was sent to all
- * connections. The function could return axl_false but it has no support
- * to notify which was the connection(s) or channel(s) that failed.
- */
-axl_bool  turbulence_conn_mgr_broadcast_msg (TurbulenceCtx            * ctx,
-					     const void               * message,
-					     int                        message_size,
-					     const char               * profile,
-					     TurbulenceConnMgrFilter    filter_conn,
-					     axlPointer                 filter_data)
+void __turbulence_conn_mgr_broadcast_unref (TurbulenceBroadcast * broadcast)
 {
+	axl_bool last;
 
-	/* get turbulence context */
-	axlHashCursor          * cursor;
-	VortexConnection       * conn;
-	TurbulenceBroadCastMsg * broadcast;
-	TurbulenceConnMgrState * state;
-	axl_bool                 should_filter;
+	vortex_mutex_lock (&broadcast->mutex);
+	broadcast->refs--;
+	last = (broadcast->refs == 0);
+	vortex_mutex_unlock (&broadcast->mutex);
 
-	v_return_val_if_fail (message, axl_false);
-	v_return_val_if_fail (message_size >= 0, axl_false);
-	v_return_val_if_fail (profile, axl_false);
+	if (! last)
+		return;
 
-	/* lock and send */
-	vortex_mutex_lock (&ctx->conn_mgr_mutex);
-	
-	/* create the cursor */
-	cursor = axl_hash_cursor_new (ctx->conn_mgr_hash);
+	vortex_async_queue_unref (broadcast->done);
+	vortex_mutex_destroy (&broadcast->mutex);
+	axl_free (broadcast);
+	return;
+}
 
-	/* create the broadcast data */
-	broadcast               = axl_new (TurbulenceBroadCastMsg, 1);
-	broadcast->message      = message;
-	broadcast->message_size = message_size;
-	broadcast->profile      = profile;
-	broadcast->ctx          = ctx;
+/** 
+ * @internal Takes batches of pending channels and sends the
+ * broadcast content on them until no batch is left. Called by the
+ * broadcast caller and by thread pool tasks (tasks started once all
+ * batches were taken just finish).
+ */
+axlPointer __turbulence_conn_mgr_broadcast_worker (axlPointer _broadcast)
+{
+	TurbulenceBroadcast * broadcast = _broadcast;
+	VortexChannel       * channel;
+	VortexConnection    * conn;
+	int                   iterator;
+	int                   end;
+
+	vortex_mutex_lock (&broadcast->mutex);
+	while (broadcast->next < broadcast->count) {
+		/* take next batch */
+		iterator         = broadcast->next;
+		end              = iterator + TBC_BROADCAST_BATCH;
+		if (end > broadcast->count)
+			end = broadcast->count;
+		broadcast->next  = end;
+		broadcast->running++;
+		vortex_mutex_unlock (&broadcast->mutex);
+
+		while (iterator < end) {
+			channel = broadcast->channels[iterator];
+			if (! vortex_channel_send_msg (channel, broadcast->message, broadcast->message_size, NULL)) {
+				/* record connection failed */
+				conn = vortex_channel_get_connection (channel);
+				vortex_mutex_lock (&broadcast->mutex);
+				if (! axl_hash_exists (broadcast->failed_ids, INT_TO_PTR (vortex_connection_get_id (conn))) &&
+				    vortex_connection_ref (conn, "conn-mgr-list")) {
+					axl_hash_insert (broadcast->failed_ids, INT_TO_PTR (vortex_connection_get_id (conn)), conn);
+					axl_list_append (broadcast->failed, conn);
+				} /* end if */
+				vortex_mutex_unlock (&broadcast->mutex);
+			} /* end if */
+			vortex_channel_unref (channel);
+			iterator++;
+		} /* end while */
+
+		/* notify batch finished */
+		vortex_mutex_lock (&broadcast->mutex);
+		broadcast->running--;
+		vortex_async_queue_push (broadcast->done, INT_TO_PTR (1));
+	} /* end while */
+	vortex_mutex_unlock (&broadcast->mutex);
 
-	while (axl_hash_cursor_has_item (cursor)) {
-		
-		/* get data */
-		state   = axl_hash_cursor_get_value (cursor);
-		conn    = state->conn;
+	__turbulence_conn_mgr_broadcast_unref (broadcast);
+	return NULL;
+}
 
-		/* check if connection is nullified */
-		if (conn == NULL) {
-			/* connection filtered */
-			axl_hash_cursor_next (cursor);
-			continue;
-		} /* end if */
+void turbulence_conn_mgr_conn_list_free_item (axlPointer _conn)
+{
+	vortex_connection_unref ((VortexConnection *) _conn, "conn-mgr-list");
+	return;
+}
 
-		/* check filter function */
+/** 
+ * @internal Returns a list with a reference to each connection
+ * registered with the provided role (-1 for all roles). Shards are
+ * locked one at a time, so connections can be registered and
+ * unregistered on the rest of shards while the list is built.
+ */
+axlList * __turbulence_conn_mgr_snapshot (TurbulenceCtx * ctx, VortexPeerRole role)
+{
+	axlList                * result;
+	axlHashCursor          * cursor;
+	TurbulenceConnMgrShard * shard;
+	TurbulenceConnMgrState * state;
+	int                      iterator;
 
-		if (filter_conn) {
-			/* unlock during the filter call to allow
-			 * conn-mgr reentrancy from inside filter
-			 * handler */
-			vortex_mutex_unlock (&ctx->conn_mgr_mutex); 
+	result = axl_list_new (axl_list_always_return_1, turbulence_conn_mgr_conn_list_free_item);
+	if (result == NULL)
+		return NULL;
 
-			/* get filtering result */
-			should_filter = filter_conn (conn, filter_data);
+	for (iterator = 0; iterator < TBC_CONN_MGR_SHARDS; iterator++) {
+		shard = &(ctx->conn_mgr_shards[iterator]);
+		vortex_mutex_lock (&shard->mutex);
 
-			/* lock */
-			vortex_mutex_lock (&ctx->conn_mgr_mutex); 
+		/* module already finished */
+		if (shard->hash == NULL) {
+			vortex_mutex_unlock (&shard->mutex);
+			continue;
+		} /* end if */
 
-			if (should_filter) {
-				/* connection filtered */
-				axl_hash_cursor_next (cursor);
-				continue;
+		/* create the cursor */
+		cursor = axl_hash_cursor_new (shard->hash);
+		while (axl_hash_cursor_has_item (cursor)) {
+			/* get data */
+			state = axl_hash_cursor_get_value (cursor);
+
+			/* check connection role to add it to the result
+			   list (skipping nullified connections) */
+			if (state->conn && ((role == -1) || vortex_connection_get_role (state->conn) == role)) {
+				/* update reference and add the connection */
+				if (vortex_connection_ref (state->conn, "conn-mgr-list"))
+					axl_list_append (result, state->conn);
 			} /* end if */
-		} /* end if */
 
-		/* search for channels running the profile provided */
-		if (! vortex_connection_foreach_channel (conn, _turbulence_conn_mgr_broadcast_msg_foreach, broadcast))
-			error ("failed to broacast message over connection id=%d", vortex_connection_get_id (conn));
+			/* next cursor */
+			axl_hash_cursor_next (cursor);
+		} /* end while */
+		axl_hash_cursor_free (cursor);
 
-		/* next cursor */
-		axl_hash_cursor_next (cursor);
-	}
+		vortex_mutex_unlock (&shard->mutex);
+	} /* end for */
 
-	/* unlock */
-	vortex_mutex_unlock (&ctx->conn_mgr_mutex);
+	return result;
+}
 
-	/* free cursor hash and broadcast message */
-	axl_hash_cursor_free (cursor);
-	axl_free (broadcast);
+/** 
+ * @brief General purpose function that allows to broadcast the
+ * provided message (and size), over all channel, running the profile
+ * provided, on all connections registered. 
+ *
+ * The function is really useful if it is required to perform a
+ * general broadcast to all BEEP peers connected running a particular
+ * profile. The function produces a MSG frame with the content
+ * provided.
+ *
+ * The function also allows to configure the connections that aren't
+ * broadcasted. To do so, pass the function (filter_conn) that
+ * configures which connections receives the notification and which
+ * not.
+ * 
+ * @param ctx Turbulence context where the operation will take place.
+ * 
+ * @param message The message that is being broadcasted. This
+ * parameter is not optional. For empty messages use "" instead of
+ * NULL.
+ *
+ * @param message_size The message size to broadcast. This parameter
+ * is not optional. For empty messages use 0.
+ *
+ * @param profile The profile to search for in all connections
+ * registered. If a channel is found running this profile, then a
+ * message is sent. This attribute is not optional.
+ *
+ * @param filter_conn Connection filtering function. If it returns
+ * axl_true, the connection is filter. Optional parameter.
+ *
+ * @param filter_data User defined data provided to the filter
+ * function. Optional parameter.
+ * 
+ * @return axl_true if the broadcast message was sent to all
+ * connections. The function could return axl_false but it has no support
+ * to notify which was the connection(s) or channel(s) that failed.
+ * Currently axl_false is only returned on wrong parameters: failures
+ * on particular connections are logged (use \ref
+ * turbulence_conn_mgr_broadcast_msg_full to get them).
+ */
+axl_bool  turbulence_conn_mgr_broadcast_msg (TurbulenceCtx            * ctx,
+					     const void               * message,
+					     int                        message_size,
+					     const char               * profile,
+					     TurbulenceConnMgrFilter    filter_conn,
+					     axlPointer                 filter_data)
+{
+	axlList          * failed = NULL;
+	axlListCursor    * cursor;
+	VortexConnection * conn;
+
+	v_return_val_if_fail (ctx, axl_false);
+	v_return_val_if_fail (message, axl_false);
+	v_return_val_if_fail (message_size >= 0, axl_false);
+	v_return_val_if_fail (profile, axl_false);
+
+	if (turbulence_conn_mgr_broadcast_msg_full (ctx, message, message_size, profile, 
+						    filter_conn, filter_data, &failed)) {
+		axl_list_free (failed);
+		return axl_true;
+	} /* end if */
+
+	/* report failed connections */
+	cursor = axl_list_cursor_new (failed);
+	while (axl_list_cursor_has_item (cursor)) {
+		conn = axl_list_cursor_get (cursor);
+		error ("failed to broacast message over connection id=%d", vortex_connection_get_id (conn));
+		axl_list_cursor_next (cursor);
+	} /* end while */
+	axl_list_cursor_free (cursor);
+	axl_list_free (failed);
 
 	return axl_true;
 }
 
-void turbulence_conn_mgr_conn_list_free_item (axlPointer _conn)
+/** 
+ * @brief Same as \ref turbulence_conn_mgr_broadcast_msg but
+ * reporting connections where the message couldn't be sent.
+ *
+ * Channels running the profile are found through an index maintained
+ * as channels are added and removed (so connections not running the
+ * profile aren't checked) and the message is sent, from the same
+ * buffer, by the caller and by up to 4 thread pool tasks, each one
+ * handling batches of 256 channels. No connection manager lock is
+ * held while filtering and sending.
+ *
+ * @param ctx Turbulence context where the operation will take place.
+ * 
+ * @param message The message that is being broadcasted. 
+ *
+ * @param message_size The message size to broadcast.
+ *
+ * @param profile The profile that channels must run to receive the message.
+ *
+ * @param filter_conn Optional connection filtering function (called once per connection). 
+ *
+ * @param filter_data User defined data provided to the filter function.
+ *
+ * @param failed Optional reference to get a list of connections
+ * (VortexConnection references) where sending failed. The list must
+ * be released with axl_list_free. The list is not defined if the
+ * function fails because of wrong parameters.
+ * 
+ * @return axl_true if the message was sent on all channels selected,
+ * otherwise axl_false.
+ */
+axl_bool  turbulence_conn_mgr_broadcast_msg_full (TurbulenceCtx            * ctx,
+						  const void               * message,
+						  int                        message_size,
+						  const char               * profile,
+						  TurbulenceConnMgrFilter    filter_conn,
+						  axlPointer                 filter_data,
+						  axlList               ** failed)
 {
-	vortex_connection_unref ((VortexConnection *) _conn, "conn-mgr-list");
-	return;
+	TurbulenceBroadcastSelect   selection;
+	TurbulenceBroadcast       * broadcast;
+	TurbulenceConnMgrShard    * shard;
+	axlHash                   * channels;
+	axlHash                   * filtered = NULL;
+	VortexConnection          * conn;
+	int                         iterator;
+	int                         count;
+	int                         workers;
+	int                         status;
+	axl_bool                    result;
+
+	v_return_val_if_fail (ctx, axl_false);
+	v_return_val_if_fail (message, axl_false);
+	v_return_val_if_fail (message_size >= 0, axl_false);
+	v_return_val_if_fail (profile, axl_false);
+
+	/* get a reference to channels running the profile, one shard
+	 * at a time */
+	memset (&selection, 0, sizeof (TurbulenceBroadcastSelect));
+	for (iterator = 0; iterator < TBC_CONN_MGR_SHARDS; iterator++) {
+		shard = &(ctx->conn_mgr_shards[iterator]);
+		vortex_mutex_lock (&shard->mutex);
+		channels = shard->channels ? axl_hash_get (shard->channels, (axlPointer) profile) : NULL;
+		if (channels)
+			axl_hash_foreach (channels, __turbulence_conn_mgr_broadcast_select, &selection);
+		vortex_mutex_unlock (&shard->mutex);
+	} /* end for */
+
+	/* apply filter (once per connection) outside any lock to
+	 * allow conn-mgr reentrancy from inside filter handler */
+	if (filter_conn && selection.count > 0) {
+		filtered = axl_hash_new (axl_hash_int, axl_hash_equal_int);
+		count    = 0;
+		for (iterator = 0; iterator < selection.count; iterator++) {
+			conn   = vortex_channel_get_connection (selection.channels[iterator]);
+			status = PTR_TO_INT (axl_hash_get (filtered, INT_TO_PTR (vortex_connection_get_id (conn))));
+			if (status == 0) {
+				/* 1: filtered, 2: not filtered */
+				status = filter_conn (conn, filter_data) ? 1 : 2;
+				axl_hash_insert (filtered, INT_TO_PTR (vortex_connection_get_id (conn)), INT_TO_PTR (status));
+			} /* end if */
+
+			if (status == 1) {
+				vortex_channel_unref (selection.channels[iterator]);
+				continue;
+			} /* end if */
+			selection.channels[count] = selection.channels[iterator];
+			count++;
+		} /* end for */
+		selection.count = count;
+		axl_hash_free (filtered);
+	} /* end if */
+
+	/* create the broadcast operation */
+	broadcast               = axl_new (TurbulenceBroadcast, 1);
+	broadcast->message      = message;
+	broadcast->message_size = message_size;
+	broadcast->channels     = selection.channels;
+	broadcast->count        = selection.count;
+	broadcast->failed       = axl_list_new (axl_list_always_return_1, turbulence_conn_mgr_conn_list_free_item);
+	broadcast->failed_ids   = axl_hash_new (axl_hash_int, axl_hash_equal_int);
+	broadcast->done         = vortex_async_queue_new ();
+	vortex_mutex_create (&broadcast->mutex);
+
+	/* start thread pool tasks for the rest of batches (the caller
+	 * sends the first one) */
+	workers = ((selection.count + TBC_BROADCAST_BATCH - 1) / TBC_BROADCAST_BATCH) - 1;
+	if (workers > TBC_BROADCAST_WORKERS)
+		workers = TBC_BROADCAST_WORKERS;
+	if (workers < 0)
+		workers = 0;
+	msg2 ("broadcasting on %d channels running profile %s (%d workers)", selection.count, profile, workers);
+
+	/* one reference for each task, one for the caller as worker
+	 * and one to wait */
+	broadcast->refs = workers + 2;
+	for (iterator = 0; iterator < workers; iterator++)
+		vortex_thread_pool_new_task (ctx->vortex_ctx, __turbulence_conn_mgr_broadcast_worker, broadcast);
+	__turbulence_conn_mgr_broadcast_worker (broadcast);
+
+	/* all batches were taken, wait for batches still being sent */
+	vortex_mutex_lock (&broadcast->mutex);
+	while (broadcast->running > 0) {
+		vortex_mutex_unlock (&broadcast->mutex);
+		vortex_async_queue_pop (broadcast->done);
+		vortex_mutex_lock (&broadcast->mutex);
+	} /* end while */
+	vortex_mutex_unlock (&broadcast->mutex);
+
+	/* report result */
+	result = (axl_list_length (broadcast->failed) == 0);
+	axl_hash_free (broadcast->failed_ids);
+	if (failed)
+		(*failed) = broadcast->failed;
+	else
+		axl_list_free (broadcast->failed);
+
+	axl_free (selection.channels);
+	__turbulence_conn_mgr_broadcast_unref (broadcast);
+
+	return result;
 }
 
 /** 
@@ -671,45 +1496,12 @@ axlList *  turbulence_conn_mgr_conn_list   (TurbulenceCtx            * ctx,
 					    const char               * filter)
 {
 	axlList                * result;
-	VortexConnection       * conn;
-	axlHashCursor          * cursor;
-	TurbulenceConnMgrState * state;
 
 	v_return_val_if_fail (ctx, NULL);
 
-	/* lock and send */
-	vortex_mutex_lock (&ctx->conn_mgr_mutex);
-	
-	/* create the cursor */
-	cursor = axl_hash_cursor_new (ctx->conn_mgr_hash);
-	result = axl_list_new (axl_list_always_return_1, turbulence_conn_mgr_conn_list_free_item);
-
-	msg ("connections registered: %d..", axl_hash_items (ctx->conn_mgr_hash));
-
-	while (axl_hash_cursor_has_item (cursor)) {
-		
-		/* get data */
-		state   = axl_hash_cursor_get_value (cursor);
-		conn    = state->conn;
-
-		/* check connection role to add it to the result
-		   list */
-		msg ("Checking connection role %d == %d", vortex_connection_get_role (conn), role);
-		if ((role == -1) || vortex_connection_get_role (conn) == role) {
-			/* update reference and add the connection */
-			vortex_connection_ref (conn, "conn-mgr-list");
-			axl_list_append (result, conn);
-		} /* end if */
-		
-		/* next cursor */
-		axl_hash_cursor_next (cursor);
-	}
-
-	/* unlock */
-	vortex_mutex_unlock (&ctx->conn_mgr_mutex);
-
-	/* free cursor */
-	axl_hash_cursor_free (cursor);
+	/* get connections without blocking the whole manager */
+	result = __turbulence_conn_mgr_snapshot (ctx, role);
+	msg ("connections selected: %d..", result ? axl_list_length (result) : 0);
 
 	/* return list */
 	return result;
@@ -723,18 +1515,15 @@ axlList *  turbulence_conn_mgr_conn_list   (TurbulenceCtx            * ctx,
  */
 int        turbulence_conn_mgr_count       (TurbulenceCtx            * ctx)
 {
-	int result;
+	int result = 0;
+	int iterator;
 
 	v_return_val_if_fail (ctx, -1);
 
-	/* lock and send */
-	vortex_mutex_lock (&ctx->conn_mgr_mutex);
-
-	/* get hash list */
-	result = axl_hash_items (ctx->conn_mgr_hash);
-
-	/* unlock */
-	vortex_mutex_unlock (&ctx->conn_mgr_mutex);	
+	/* sum shard counters without locking (each one is only
+	 * updated by its shard owner) */
+	for (iterator = 0; iterator < TBC_CONN_MGR_SHARDS; iterator++)
+		result += ctx->conn_mgr_shards[iterator].items;
 
 	return result;
 }
@@ -770,6 +1559,19 @@ int        turbulence_conn_mgr_count       (TurbulenceCtx            * ctx)
  * vortex_connection_set_data (conn, "tbc:proxy:conn", INT_TO_PTR (axl_true));
  * \endcode
  *
+ * In the case the module doesn't transform content read/written on
+ * the connection (no TLS, websocket or similar), it can also flag
+ * it as raw. On Linux, raw proxied connections are served with
+ * splice(2), moving bytes between both sockets without copying
+ * them to user space. This is opt-in: no module shipped with
+ * Turbulence sets it (mod-websocket transforms content), and it is
+ * ignored for TLS connections and where splice(2) isn't available:
+ *
+ * \code
+ * // content is passed as is
+ * vortex_connection_set_data (conn, "tbc:proxy:raw", INT_TO_PTR (axl_true));
+ * \endcode
+ *
  */
 axl_bool   turbulence_conn_mgr_proxy_on_parent (VortexConnection * conn)
 {
@@ -777,6 +1579,298 @@ axl_bool   turbulence_conn_mgr_proxy_on_parent (VortexConnection * conn)
 	return PTR_TO_INT (vortex_connection_get_data (conn, "tbc:proxy:conn"));
 }
 
+#if defined(TBC_PROXY_HAVE_SPLICE)
+/** 
+ * @internal Creates kernel pipes used to splice a raw proxied
+ * connection.
+ */
+TurbulenceProxySplice * __turbulence_conn_mgr_proxy_splice_new (void)
+{
+	TurbulenceProxySplice * splice_pipes;
+
+	splice_pipes = axl_new (TurbulenceProxySplice, 1);
+	if (pipe (splice_pipes->to_child) != 0) {
+		axl_free (splice_pipes);
+		return NULL;
+	} /* end if */
+	if (pipe (splice_pipes->to_conn) != 0) {
+		close (splice_pipes->to_child[0]);
+		close (splice_pipes->to_child[1]);
+		axl_free (splice_pipes);
+		return NULL;
+	} /* end if */
+
+	return splice_pipes;
+}
+
+void __turbulence_conn_mgr_proxy_splice_free (axlPointer _splice_pipes)
+{
+	TurbulenceProxySplice * splice_pipes = _splice_pipes;
+
+	close (splice_pipes->to_child[0]);
+	close (splice_pipes->to_child[1]);
+	close (splice_pipes->to_conn[0]);
+	close (splice_pipes->to_conn[1]);
+	axl_free (splice_pipes);
+	return;
+}
+
+/** 
+ * @internal Writes content held on the pipe into <b>to</b> without
+ * blocking, updating the bytes still pending.
+ *
+ * @return Bytes written or -1 if the destination failed.
+ */
+int __turbulence_conn_mgr_proxy_splice_flush (int to, int * pipe_fds, int * pending)
+{
+	int total = 0;
+	int written;
+
+	while ((*pending) > 0) {
+		written = splice (pipe_fds[0], NULL, to, NULL, *pending, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+		if (written > 0) {
+			(*pending) -= written;
+			total      += written;
+			continue;
+		} /* end if */
+		if (written < 0 && errno == EINTR)
+			continue;
+		if (written < 0 && errno == EAGAIN)
+			break;
+		return -1;
+	} /* end while */
+
+	return total;
+}
+
+/** 
+ * @internal Moves content available on <b>from</b> into <b>to</b>
+ * through the provided pipe. Content <b>to</b> doesn't accept stays
+ * on the pipe (see pending).
+ *
+ * @return Bytes read, 0 if no content was available or -1 if the
+ * source was closed or some socket failed.
+ */
+int __turbulence_conn_mgr_proxy_splice (int from, int to, int * pipe_fds, int * pending)
+{
+	int bytes_read;
+
+	/* move available content into the pipe */
+	bytes_read = splice (from, NULL, pipe_fds[1], NULL, TBC_PROXY_SPLICE_SIZE, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+	if (bytes_read < 0 && (errno == EAGAIN || errno == EINTR))
+		return 0;
+	if (bytes_read <= 0)
+		return -1;
+
+	/* and from the pipe into the destination */
+	(*pending) += bytes_read;
+	if (__turbulence_conn_mgr_proxy_splice_flush (to, pipe_fds, pending) < 0)
+		return -1;
+
+	return bytes_read;
+}
+#endif
+
+/** 
+ * @internal Appends content to the queue (queue mutex locked).
+ *
+ * @return axl_false if the queue would hold more than
+ * TBC_PROXY_QUEUE_MAX bytes (content is not appended).
+ */
+axl_bool __turbulence_conn_mgr_proxy_queue_append (TurbulenceProxyQueue * queue, const char * content, int size)
+{
+	if (queue->used + queue->pipe_pending + size > TBC_PROXY_QUEUE_MAX)
+		return axl_false;
+
+	/* move pending content to the start of the buffer */
+	if (queue->start + queue->used + size > queue->size && queue->start > 0) {
+		memmove (queue->buffer, queue->buffer + queue->start, queue->used);
+		queue->start = 0;
+	} /* end if */
+
+	/* grow buffer */
+	if (queue->used + size > queue->size) {
+		queue->size   = queue->used + size;
+		queue->buffer = axl_realloc (queue->buffer, queue->size);
+	} /* end if */
+
+	memcpy (queue->buffer + queue->start + queue->used, content, size);
+	queue->used += size;
+	return axl_true;
+}
+
+/** 
+ * @internal Writes as much pending content as possible into the
+ * child socket without blocking (queue mutex locked).
+ *
+ * @return axl_false if the child socket failed.
+ */
+axl_bool __turbulence_conn_mgr_proxy_queue_flush (TurbulenceProxyQueue * queue, 
+						  TurbulenceProxyLoop  * proxy, 
+						  int                    _socket)
+{
+	int written;
+
+	/* content copied (read before splice was used) goes first */
+	while (queue->used > 0) {
+		written = send (_socket, queue->buffer + queue->start, queue->used, TBC_PROXY_SEND_FLAGS);
+		if (written > 0) {
+			queue->start += written;
+			queue->used  -= written;
+			TBC_ATOMIC_ADD (proxy->bytes_to_child, written);
+			continue;
+		} /* end if */
+		if (written < 0 && errno == EINTR)
+			continue;
+		return written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+	} /* end while */
+
+	/* reset buffer */
+	queue->start = 0;
+
+#if defined(TBC_PROXY_HAVE_SPLICE)
+	if (queue->pipe_pending > 0) {
+		written = __turbulence_conn_mgr_proxy_splice_flush (_socket, queue->pipe_fds, &queue->pipe_pending);
+		if (written < 0)
+			return axl_false;
+		TBC_ATOMIC_ADD (proxy->bytes_to_child, written);
+	} /* end if */
+#endif
+
+	return axl_true;
+}
+
+/** 
+ * @internal Loop handler called when the child socket can be
+ * written, to flush content queued.
+ */
+axl_bool __turbulence_conn_mgr_proxy_queue_ready (TurbulenceLoop * loop, 
+						  TurbulenceCtx  * ctx,
+						  int              descriptor, 
+						  axlPointer       ptr, 
+						  axlPointer       ptr2)
+{
+	VortexConnection     * conn  = ptr;
+	TurbulenceProxyLoop  * proxy = ptr2;
+	TurbulenceProxyQueue * queue = vortex_connection_get_data (conn, "tbc:proxy:queue");
+	axl_bool               result;
+	int                    low   = TBC_PROXY_QUEUE_LOW;
+
+	vortex_mutex_lock (&queue->mutex);
+	if (! __turbulence_conn_mgr_proxy_queue_flush (queue, proxy, descriptor)) {
+		queue->watching = axl_false;
+		vortex_mutex_unlock (&queue->mutex);
+
+		wrn ("PROXY-beep: closing conn-id=%d because socket=%d isn't working", 
+		     vortex_connection_get_id (conn), descriptor); 
+		vortex_connection_shutdown (conn);
+		return axl_false;
+	} /* end if */
+
+	/* resume reading the proxied connection (raw connections
+	 * only splice again once the pipe is empty) */
+	if (queue->pipe_fds)
+		low = 0;
+	if (queue->blocked && (queue->used + queue->pipe_pending) <= low) {
+		queue->blocked = axl_false;
+		vortex_connection_block (conn, axl_false);
+	} /* end if */
+
+	/* keep on being notified while content is pending */
+	result          = (queue->used + queue->pipe_pending) > 0;
+	queue->watching = result;
+	vortex_mutex_unlock (&queue->mutex);
+
+	return result;
+}
+
+/** 
+ * @internal Writes (or queues) content read from the proxied
+ * connection into the child socket, pausing reads on the connection
+ * if too much content is pending. For raw connections, content is
+ * spliced (content == NULL).
+ *
+ * @return axl_false if the connection must be closed.
+ */
+axl_bool __turbulence_conn_mgr_proxy_queue_send (VortexConnection     * conn, 
+						 TurbulenceProxyQueue * queue, 
+						 TurbulenceProxyLoop  * proxy, 
+						 int                    _socket,
+						 const char           * content,
+						 int                    size)
+{
+	int written;
+	int high = TBC_PROXY_QUEUE_HIGH;
+
+	vortex_mutex_lock (&queue->mutex);
+
+#if defined(TBC_PROXY_HAVE_SPLICE)
+	/* pipe works as queue: pause reading as soon as the child
+	 * doesn't accept all content */
+	if (queue->pipe_fds)
+		high = 1;
+
+	if (queue->pipe_fds && content == NULL) {
+		/* splice only once content copied was written */
+		if (queue->pipe_pending == 0 && queue->used == 0) {
+			written = splice (vortex_connection_get_socket (conn), NULL, queue->pipe_fds[1], NULL, 
+					  TBC_PROXY_SPLICE_SIZE, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+			if (written < 0 && (errno == EAGAIN || errno == EINTR)) {
+				vortex_mutex_unlock (&queue->mutex);
+				return axl_true;
+			} /* end if */
+			if (written <= 0) {
+				vortex_mutex_unlock (&queue->mutex);
+				return axl_false;
+			} /* end if */
+			queue->pipe_pending = written;
+		} /* end if */
+	} else
+#endif
+	{
+		/* send directly if nothing is pending */
+		if (queue->used == 0 && queue->pipe_pending == 0) {
+			written = send (_socket, content, size, TBC_PROXY_SEND_FLAGS);
+			if (written < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+				vortex_mutex_unlock (&queue->mutex);
+				return axl_false;
+			} /* end if */
+			if (written > 0) {
+				TBC_ATOMIC_ADD (proxy->bytes_to_child, written);
+				content += written;
+				size    -= written;
+			} /* end if */
+		} /* end if */
+
+		/* queue the rest */
+		if (size > 0 && ! __turbulence_conn_mgr_proxy_queue_append (queue, content, size)) {
+			vortex_mutex_unlock (&queue->mutex);
+			return axl_false;
+		} /* end if */
+	}
+
+	/* write pending content */
+	if (! __turbulence_conn_mgr_proxy_queue_flush (queue, proxy, _socket)) {
+		vortex_mutex_unlock (&queue->mutex);
+		return axl_false;
+	} /* end if */
+
+	/* ask the loop to notify when the child socket is writable */
+	if ((queue->used + queue->pipe_pending) > 0 && ! queue->watching) {
+		queue->watching = axl_true;
+		turbulence_loop_watch_write (proxy->loop, _socket, __turbulence_conn_mgr_proxy_queue_ready, conn, proxy);
+	} /* end if */
+
+	/* pause reading the connection */
+	if ((queue->used + queue->pipe_pending) >= high && ! queue->blocked) {
+		queue->blocked = axl_true;
+		vortex_connection_block (conn, axl_true);
+	} /* end if */
+
+	vortex_mutex_unlock (&queue->mutex);
+	return axl_true;
+}
+
 /** 
  * Function used to read content from the connection and write that
  * content into the child socket.
@@ -794,14 +1888,26 @@ void __turbulence_conn_mgr_proxy_reads (VortexConnection * conn)
 	/* get socket associated */
 	int                _socket          = PTR_TO_INT (vortex_connection_get_data (conn, "tbc:proxy:fd"));
 	int                try_read_pending = 0;
+	TurbulenceProxyLoop  * proxy        = vortex_connection_get_data (conn, "tbc:proxy:loop");
+	TurbulenceProxyQueue * queue        = vortex_connection_get_data (conn, "tbc:proxy:queue");
 
 	/* check connection status */
 	if (! vortex_connection_is_ok (conn, axl_false)) 
 		return;
 
+	/* raw connection: splice content into the child socket
+	 * (once content vortex already read was passed) */
+	if (queue->pipe_fds && queue->drained) {
+		if (! __turbulence_conn_mgr_proxy_queue_send (conn, queue, proxy, _socket, NULL, 0)) {
+			wrn ("PROXY-beep: closing conn-id=%d because it was closed or socket=%d isn't working", 
+			     vortex_connection_get_id (conn), _socket); 
+			vortex_connection_shutdown (conn);
+		} /* end if */
+		return;
+	} /* end if */
+
 	/* check status and close the other connection if found that */
  read_more:
-	memset (buffer, 0, 4096);
 	bytes_read = vortex_frame_receive_raw (conn, buffer, 4096);
 
 	/* msg ("PROXY-beep: Read %d bytes from conn-id=%d, sending them to child socket=%d (refs: %d, status: %d, errno=%d%s%s)",
@@ -811,8 +1917,9 @@ void __turbulence_conn_mgr_proxy_reads (VortexConnection * conn)
 	     errno != 0 ? strerror (errno) : "");  */
 
 	if (bytes_read > 0) {
-		/* send content */
-		if (send (_socket, buffer, bytes_read, 0) != bytes_read) {
+		/* send content (queuing what the child can't accept
+		 * now) */
+		if (! __turbulence_conn_mgr_proxy_queue_send (conn, queue, proxy, _socket, buffer, bytes_read)) {
 			wrn ("PROXY-beep: closing conn-id=%d because socket=%d isn't working", 
 			     vortex_connection_get_id (conn), _socket); 
 
@@ -831,9 +1938,165 @@ void __turbulence_conn_mgr_proxy_reads (VortexConnection * conn)
 	if (try_read_pending > 0) 
 	        goto read_more;
 
+	/* raw connection: content vortex held was drained, next
+	 * reads are spliced from the socket */
+	if (queue->pipe_fds)
+		queue->drained = axl_true;
+
 	return;
 }
 
+#if defined(TBC_PROXY_HAVE_SPLICE)
+/** 
+ * @internal Loop handler called when the socket of a raw proxied
+ * connection can be written, to flush content spliced from the child
+ * (resuming reads from the child once all was written).
+ */
+axl_bool __turbulence_conn_mgr_proxy_splice_ready (TurbulenceLoop * loop, 
+						   TurbulenceCtx  * ctx,
+						   int              descriptor, 
+						   axlPointer       ptr, 
+						   axlPointer       ptr2)
+{
+	VortexConnection      * conn         = ptr;
+	TurbulenceProxySplice * splice_pipes = vortex_connection_get_data (conn, "tbc:proxy:splice");
+	int                     _socket      = PTR_TO_INT (vortex_connection_get_data (conn, "tbc:proxy:fd"));
+
+	if (__turbulence_conn_mgr_proxy_splice_flush (descriptor, splice_pipes->to_conn, &splice_pipes->to_conn_pending) < 0) {
+		wrn ("PROXY-fd: closing conn-id=%d because its socket=%d isn't working", 
+		     vortex_connection_get_id (conn), descriptor); 
+		if (vortex_connection_is_ok (conn, axl_false))
+			vortex_connection_shutdown (conn);
+		return axl_false;
+	} /* end if */
+
+	/* keep on being notified while content is pending */
+	if (splice_pipes->to_conn_pending > 0)
+		return axl_true;
+
+	/* read the child socket again */
+	turbulence_loop_block_descriptor (loop, _socket, axl_false);
+	return axl_false;
+}
+#endif
+
+/** 
+ * @internal Writes as much content pending as possible into the
+ * proxied connection without blocking.
+ *
+ * @return axl_false if the connection failed.
+ */
+axl_bool __turbulence_conn_mgr_proxy_conn_flush (VortexConnection     * conn,
+						 TurbulenceProxyQueue * queue,
+						 TurbulenceProxyLoop  * proxy)
+{
+	int written;
+
+	while (queue->used > 0) {
+		written = vortex_connection_invoke_send (conn, queue->buffer + queue->start, queue->used);
+		if (written > 0) {
+			queue->start += written;
+			queue->used  -= written;
+			TBC_ATOMIC_ADD (proxy->bytes_to_conn, written);
+			continue;
+		} /* end if */
+		if (written < 0 && errno == EINTR)
+			continue;
+		return written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+	} /* end while */
+
+	/* reset buffer */
+	queue->start = 0;
+	return axl_true;
+}
+
+/** 
+ * @internal Loop handler called when the proxied connection can be
+ * written, to flush content read from the child (resuming reads from
+ * the child once below the low mark).
+ */
+axl_bool __turbulence_conn_mgr_proxy_conn_ready (TurbulenceLoop * loop, 
+						 TurbulenceCtx  * ctx,
+						 int              descriptor, 
+						 axlPointer       ptr, 
+						 axlPointer       ptr2)
+{
+	VortexConnection     * conn    = ptr;
+	TurbulenceProxyLoop  * proxy   = ptr2;
+	TurbulenceProxyQueue * queue   = vortex_connection_get_data (conn, "tbc:proxy:conn-queue");
+	int                    _socket = PTR_TO_INT (vortex_connection_get_data (conn, "tbc:proxy:fd"));
+
+	if (! __turbulence_conn_mgr_proxy_conn_flush (conn, queue, proxy)) {
+		queue->watching = axl_false;
+		wrn ("PROXY-fd: closing conn-id=%d because its socket=%d isn't working", 
+		     vortex_connection_get_id (conn), descriptor); 
+		if (vortex_connection_is_ok (conn, axl_false))
+			vortex_connection_shutdown (conn);
+		return axl_false;
+	} /* end if */
+
+	/* read the child socket again */
+	if (queue->blocked && queue->used <= TBC_PROXY_QUEUE_LOW) {
+		queue->blocked = axl_false;
+		turbulence_loop_block_descriptor (loop, _socket, axl_false);
+	} /* end if */
+
+	/* keep on being notified while content is pending */
+	queue->watching = queue->used > 0;
+	return queue->watching;
+}
+
+/** 
+ * @internal Writes (or queues) content read from the child socket
+ * into the proxied connection without blocking the proxy loop,
+ * pausing reads on the child socket if too much content is pending.
+ *
+ * @return axl_false if the connection must be closed.
+ */
+axl_bool __turbulence_conn_mgr_proxy_conn_send (TurbulenceLoop       * loop,
+						VortexConnection     * conn, 
+						TurbulenceProxyQueue * queue, 
+						TurbulenceProxyLoop  * proxy, 
+						int                    _socket,
+						const char           * content,
+						int                    size)
+{
+	int written;
+
+	/* send directly if nothing is pending */
+	if (queue->used == 0) {
+		written = vortex_connection_invoke_send (conn, content, size);
+		if (written < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+			return axl_false;
+		if (written > 0) {
+			TBC_ATOMIC_ADD (proxy->bytes_to_conn, written);
+			content += written;
+			size    -= written;
+		} /* end if */
+	} /* end if */
+
+	/* queue the rest */
+	if (size > 0 && ! __turbulence_conn_mgr_proxy_queue_append (queue, content, size))
+		return axl_false;
+	if (! __turbulence_conn_mgr_proxy_conn_flush (conn, queue, proxy))
+		return axl_false;
+
+	/* ask the loop to notify when the connection is writable */
+	if (queue->used > 0 && ! queue->watching) {
+		queue->watching = axl_true;
+		turbulence_loop_watch_write (loop, vortex_connection_get_socket (conn), 
+					     __turbulence_conn_mgr_proxy_conn_ready, conn, proxy);
+	} /* end if */
+
+	/* pause reading the child socket */
+	if (queue->used >= TBC_PROXY_QUEUE_HIGH && ! queue->blocked) {
+		queue->blocked = axl_true;
+		turbulence_loop_block_descriptor (loop, _socket, axl_true);
+	} /* end if */
+
+	return axl_true;
+}
+
 /** 
  * Function used to read content from the socket in the loop into the
  * connection proxied.
@@ -847,18 +2110,49 @@ axl_bool __turbulence_conn_proxy_reads_loop (TurbulenceLoop * loop,
 					     axlPointer       ptr, 
 					     axlPointer       ptr2)
 {
-	VortexConnection * conn = ptr;
+	VortexConnection    * conn  = ptr;
+	TurbulenceProxyLoop * proxy = ptr2;
 	char buffer[4096];
 	int  bytes_read;
+	axl_bool sent;
+#if defined(TBC_PROXY_HAVE_SPLICE)
+	TurbulenceProxySplice * splice_pipes = vortex_connection_get_data (conn, "tbc:proxy:splice");
+
+	/* raw connection: splice content into the connection socket */
+	if (splice_pipes) {
+		bytes_read = __turbulence_conn_mgr_proxy_splice (descriptor, vortex_connection_get_socket (conn), 
+								 splice_pipes->to_conn, &splice_pipes->to_conn_pending);
+		if (bytes_read == 0)
+			return axl_true; /* nothing to read yet */
+		sent = bytes_read > 0;
+
+		/* connection socket full: stop reading the child
+		 * until the content pending is written */
+		if (sent && splice_pipes->to_conn_pending > 0) {
+			turbulence_loop_block_descriptor (loop, descriptor, axl_true);
+			turbulence_loop_watch_write (loop, vortex_connection_get_socket (conn), 
+						     __turbulence_conn_mgr_proxy_splice_ready, conn, proxy);
+		} /* end if */
 
-	/* read content */
-	bytes_read = recv (descriptor, buffer, 4096, 0);
-	/* msg ("PROXY: reading from socket=%d (bytes read=%d, errno=%d)", descriptor, bytes_read, errno);  */
+		/* update stats */
+		if (sent)
+			TBC_ATOMIC_ADD (proxy->bytes_to_conn, bytes_read);
+	} else
+#endif
+	{
+		/* read content */
+		bytes_read = recv (descriptor, buffer, 4096, 0);
+		/* msg ("PROXY: reading from socket=%d (bytes read=%d, errno=%d)", descriptor, bytes_read, errno);  */
+
+		/* send content (queuing what the connection can't
+		 * accept now, stats updated as written) */
+		sent = bytes_read > 0 && 
+			vortex_connection_is_ok (conn, axl_false) &&
+			__turbulence_conn_mgr_proxy_conn_send (loop, conn, vortex_connection_get_data (conn, "tbc:proxy:conn-queue"),
+							       proxy, descriptor, buffer, bytes_read);
+	}
 
-	/* send content */
-	if (bytes_read <= 0 || 
-	    ! vortex_connection_is_ok (conn, axl_false) || 
-	    ! vortex_frame_send_raw (conn, buffer, bytes_read)) {
+	if (! sent) {
 
 		/* close socket and unregister it and close associated conn */
 		wrn ("PROXY-fd: connection-id=%d is falling (wasn't able to send %d bytes, is zero?), closing associated socket=%d", 
@@ -881,10 +2175,11 @@ axlPointer __turbulence_conn_mgr_release_proxy_conn (axlPointer conn)
 	return NULL;
 }
 
-void __turbulence_conn_mgr_proxy_on_close (VortexConnection * conn, axlPointer _loop)
+void __turbulence_conn_mgr_proxy_on_close (VortexConnection * conn, axlPointer _proxy)
 {
-	TurbulenceLoop  * loop = _loop;
-	/* TurbulenceCtx   * ctx  = turbulence_loop_ctx (loop); */
+	TurbulenceProxyLoop * proxy = _proxy;
+	TurbulenceLoop      * loop  = proxy->loop;
+	TurbulenceCtx       * ctx   = turbulence_loop_ctx (loop);
 
 	/* get socket associated */
 	int               _socket = PTR_TO_INT (vortex_connection_get_data (conn, "tbc:proxy:fd"));	
@@ -897,8 +2192,17 @@ void __turbulence_conn_mgr_proxy_on_close (VortexConnection * conn, axlPointer _
 	turbulence_loop_unwatch_descriptor (loop, _socket, axl_true);
 	/* msg ("PROXY: calling to unwatch descriptor from loop _socket=%d (finished watching=%d)", _socket, turbulence_loop_watching (loop)); */
 
+	/* connection socket may be watched for write (content from
+	 * the child pending): it is not closed by the loop */
+	turbulence_loop_unwatch_descriptor (loop, vortex_connection_get_socket (conn), axl_true);
+
 	/* close socket */
 	vortex_close_socket (_socket);
+
+	/* update loop load */
+	vortex_mutex_lock (&ctx->proxy_mutex);
+	proxy->active--;
+	vortex_mutex_unlock (&ctx->proxy_mutex);
 	
 	/* release and shutdown */
 	vortex_connection_set_preread_handler (conn, NULL);
@@ -909,6 +2213,46 @@ void __turbulence_conn_mgr_proxy_on_close (VortexConnection * conn, axlPointer _
 	return;
 }
 
+/** 
+ * @internal Selects the proxy loop with less connections (creating
+ * loops on first use). Must be called with ctx->proxy_mutex locked.
+ */
+TurbulenceProxyLoop * __turbulence_conn_mgr_proxy_select_loop (TurbulenceCtx * ctx)
+{
+	TurbulenceProxyLoop * proxy = NULL;
+	int                   iterator;
+
+	/* create loops table */
+	if (ctx->proxy_loops == NULL) {
+		if (ctx->proxy_loops_count <= 0)
+			ctx->proxy_loops_count = sysconf (_SC_NPROCESSORS_ONLN);
+		if (ctx->proxy_loops_count <= 0)
+			ctx->proxy_loops_count = 1;
+		ctx->proxy_loops = axl_new (TurbulenceProxyLoop, ctx->proxy_loops_count);
+		msg ("PROXY: using %d proxy loops", ctx->proxy_loops_count);
+	} /* end if */
+
+	/* least loaded loop */
+	iterator = 0;
+	while (iterator < ctx->proxy_loops_count) {
+		if (proxy == NULL || ctx->proxy_loops[iterator].active < proxy->active)
+			proxy = &(ctx->proxy_loops[iterator]);
+		iterator++;
+	} /* end while */
+
+	/* create the proxy loop watcher if it wasn't created yet */
+	if (proxy->loop == NULL) 
+		proxy->loop = turbulence_loop_create (ctx);
+	if (proxy->loop == NULL)
+		return NULL;
+
+	/* update load */
+	proxy->active++;
+	proxy->total++;
+
+	return proxy;
+}
+
 /** 
  * @brief Setups the necessary configuration to start proxing content
  * of that connection passing all bytes into the returned socket.
@@ -924,6 +2268,11 @@ void __turbulence_conn_mgr_proxy_on_close (VortexConnection * conn, axlPointer _
 int        turbulence_conn_mgr_setup_proxy_on_parent (TurbulenceCtx * ctx, VortexConnection * conn)
 {
 	int                     descf[2];
+	TurbulenceProxyLoop   * proxy;
+	TurbulenceProxyQueue  * queue;
+#if defined(TBC_PROXY_HAVE_SPLICE)
+	TurbulenceProxySplice * splice_pipes;
+#endif
 
 	/* here you have the diagram about what is about to happen:
 	 *
@@ -961,23 +2310,56 @@ int        turbulence_conn_mgr_setup_proxy_on_parent (TurbulenceCtx * ctx, Vorte
 		return -1;
 	} /* end if */
 
-	/* create the proxy loop watcher if it wasn't created yet */
-	if (ctx->proxy_loop == NULL) 
-		ctx->proxy_loop = turbulence_loop_create (ctx);
-
-	/* watch the socket */
-	turbulence_loop_watch_descriptor (ctx->proxy_loop, descf[1], __turbulence_conn_proxy_reads_loop, conn, NULL);
+	/* select the proxy loop that will handle this connection */
+	vortex_mutex_lock (&ctx->proxy_mutex);
+	proxy = __turbulence_conn_mgr_proxy_select_loop (ctx);
+	vortex_mutex_unlock (&ctx->proxy_mutex);
+	if (proxy == NULL) {
+		error ("Failed to create proxy loop to proxy connection on the parent");
+		vortex_connection_unref (conn, "proxy-on-parent");
+		vortex_close_socket (descf[0]);
+		vortex_close_socket (descf[1]);
+		return -1;
+	} /* end if */
 
 	/* configure links between both connections */
 	vortex_connection_set_data (conn,       "tbc:proxy:fd", INT_TO_PTR (descf[1]));
+	vortex_connection_set_data (conn,       "tbc:proxy:loop", proxy);
 	vortex_connection_set_data (conn,       "tbc:ctx", ctx);
 
+	/* queue used to hold content the child doesn't accept yet */
+	queue = axl_new (TurbulenceProxyQueue, 1);
+	vortex_mutex_create (&queue->mutex);
+	vortex_connection_set_data_full (conn, "tbc:proxy:queue", queue, NULL, __turbulence_conn_mgr_proxy_queue_free);
+
+	/* queue used to hold content the connection doesn't accept
+	 * yet (child -> remote conn) */
+	queue = axl_new (TurbulenceProxyQueue, 1);
+	vortex_mutex_create (&queue->mutex);
+	vortex_connection_set_data_full (conn, "tbc:proxy:conn-queue", queue, NULL, __turbulence_conn_mgr_proxy_queue_free);
+
+#if defined(TBC_PROXY_HAVE_SPLICE)
+	/* raw connections (content not transformed by vortex) are
+	 * proxied with splice */
+	if (PTR_TO_INT (vortex_connection_get_data (conn, "tbc:proxy:raw")) && ! vortex_connection_is_tlsficated (conn)) {
+		splice_pipes = __turbulence_conn_mgr_proxy_splice_new ();
+		if (splice_pipes) {
+			vortex_connection_set_data_full (conn, "tbc:proxy:splice", splice_pipes, NULL, __turbulence_conn_mgr_proxy_splice_free);
+			queue->pipe_fds = splice_pipes->to_child;
+		} else
+			wrn ("PROXY: unable to create splice pipes for conn-id=%d (errno=%d), using copy", vortex_connection_get_id (conn), errno);
+	} /* end if */
+#endif
+
+	/* watch the socket */
+	turbulence_loop_watch_descriptor (proxy->loop, descf[1], __turbulence_conn_proxy_reads_loop, conn, proxy);
+
 	/* now configure preread handlers to pass data from both
 	 * connections */
 	vortex_connection_set_preread_handler (conn, __turbulence_conn_mgr_proxy_reads);
 
 	/* setup connection close to cleanup */
-	vortex_connection_set_on_close_full (conn, __turbulence_conn_mgr_proxy_on_close, ctx->proxy_loop);
+	vortex_connection_set_on_close_full (conn, __turbulence_conn_mgr_proxy_on_close, proxy);
 	
 	/* return the socket that will be using the child process */
 	msg ("PROXY: Activated proxy on parent conn-id=%d (socket: %d), parent socket %d <--> child socket: %d", 
@@ -985,6 +2367,76 @@ int        turbulence_conn_mgr_setup_proxy_on_parent (TurbulenceCtx * ctx, Vorte
 	return descf[0];
 }
 
+/** 
+ * @brief Allows to get the number of loops used to proxy connections
+ * on the parent (see \ref turbulence_conn_mgr_setup_proxy_on_parent).
+ *
+ * @param ctx The turbulence context to check.
+ *
+ * @return Number of proxy loops or 0 if no connection was proxied
+ * yet (loops are not created until required).
+ */
+int        turbulence_conn_mgr_proxy_loops (TurbulenceCtx * ctx)
+{
+	int count;
+
+	v_return_val_if_fail (ctx, 0);
+
+	vortex_mutex_lock (&ctx->proxy_mutex);
+	count = ctx->proxy_loops ? ctx->proxy_loops_count : 0;
+	vortex_mutex_unlock (&ctx->proxy_mutex);
+
+	return count;
+}
+
+/** 
+ * @brief Allows to get statistics about the provided proxy loop.
+ *
+ * @param ctx The turbulence context to check.
+ *
+ * @param index The proxy loop to check (from 0 up to \ref turbulence_conn_mgr_proxy_loops - 1).
+ *
+ * @param active Optional reference to get connections currently proxied by the loop.
+ *
+ * @param total Optional reference to get total connections proxied by the loop.
+ *
+ * @param bytes_to_child Optional reference to get bytes moved from remote peers to childs.
+ *
+ * @param bytes_to_conn Optional reference to get bytes moved from childs to remote peers.
+ *
+ * @return axl_true if stats were reported, otherwise axl_false (wrong index).
+ */
+axl_bool   turbulence_conn_mgr_proxy_loop_stats (TurbulenceCtx * ctx, 
+						 int             index,
+						 int           * active,
+						 int           * total,
+						 long          * bytes_to_child,
+						 long          * bytes_to_conn)
+{
+	TurbulenceProxyLoop * proxy;
+
+	v_return_val_if_fail (ctx, axl_false);
+
+	vortex_mutex_lock (&ctx->proxy_mutex);
+	if (ctx->proxy_loops == NULL || index < 0 || index >= ctx->proxy_loops_count) {
+		vortex_mutex_unlock (&ctx->proxy_mutex);
+		return axl_false;
+	} /* end if */
+
+	proxy = &(ctx->proxy_loops[index]);
+	if (active)
+		(*active) = proxy->active;
+	if (total)
+		(*total) = proxy->total;
+	if (bytes_to_child)
+		(*bytes_to_child) = TBC_ATOMIC_GET (proxy->bytes_to_child);
+	if (bytes_to_conn)
+		(*bytes_to_conn) = TBC_ATOMIC_GET (proxy->bytes_to_conn);
+	vortex_mutex_unlock (&ctx->proxy_mutex);
+
+	return axl_true;
+}
+
 /** 
  * @brief Allows to get a reference to the registered connection with
  * the provided id. The function will return a reference to a
@@ -1000,15 +2452,17 @@ VortexConnection * turbulence_conn_mgr_find_by_id (TurbulenceCtx * ctx,
 						   int             conn_id)
 {
 	VortexConnection       * conn = NULL;
+	TurbulenceConnMgrShard * shard;
 	TurbulenceConnMgrState * state;
 
 	v_return_val_if_fail (ctx, NULL);
 
-	/* lock and send */
-	vortex_mutex_lock (&ctx->conn_mgr_mutex);
+	/* lock only the shard where the connection is registered */
+	shard = TBC_CONN_MGR_SHARD (ctx, conn_id);
+	vortex_mutex_lock (&shard->mutex);
 	
 	/* get the connection */
-	state = axl_hash_get (ctx->conn_mgr_hash, INT_TO_PTR (conn_id));
+	state = shard->hash ? axl_hash_get (shard->hash, INT_TO_PTR (conn_id)) : NULL;
 	
 	/* set conection */
 	/* msg ("Connection find_by_id for conn id=%d returned pointer %p (conn: %p)", conn_id, state, state ? state->conn : NULL); */
@@ -1016,12 +2470,51 @@ VortexConnection * turbulence_conn_mgr_find_by_id (TurbulenceCtx * ctx,
 		conn = state->conn;
 
 	/* unlock */
-	vortex_mutex_unlock (&ctx->conn_mgr_mutex);
+	vortex_mutex_unlock (&shard->mutex);
 
 	/* return list */
 	return conn;
 }
 
+/** 
+ * @brief Allows to get the number of connections closed because they
+ * reached their greeting timeout (greetings not completed or no
+ * channel opened since accepted) or their idle timeout (no content
+ * received). See greeting-timeout and idle-timeout profile path
+ * attributes.
+ *
+ * @param ctx The turbulence context to check.
+ *
+ * @param greeting Optional reference to get connections closed by greeting timeout.
+ *
+ * @param idle Optional reference to get connections closed by idle timeout.
+ */
+void       turbulence_conn_mgr_reaped (TurbulenceCtx * ctx, 
+				       int           * greeting, 
+				       int           * idle)
+{
+	TurbulenceConnMgrShard * shard;
+	int                      iterator;
+
+	v_return_if_fail (ctx);
+
+	if (greeting)
+		(*greeting) = 0;
+	if (idle)
+		(*idle) = 0;
+	for (iterator = 0; iterator < TBC_CONN_MGR_SHARDS; iterator++) {
+		shard = &(ctx->conn_mgr_shards[iterator]);
+		vortex_mutex_lock (&shard->mutex);
+		if (greeting)
+			(*greeting) += shard->reaped_greeting;
+		if (idle)
+			(*idle) += shard->reaped_idle;
+		vortex_mutex_unlock (&shard->mutex);
+	} /* end for */
+
+	return;
+}
+
 axl_bool count_channels (axlPointer key, axlPointer _value, axlPointer user_data, axlPointer _ctx)
 {
 	int           * count  = user_data;
@@ -1053,24 +2546,26 @@ axl_bool count_channels (axlPointer key, axlPointer _value, axlPointer user_data
 axlHashCursor    * turbulence_conn_mgr_profiles_stats (TurbulenceCtx    * ctx,
 						       VortexConnection * conn)
 {
+	TurbulenceConnMgrShard * shard;
 	TurbulenceConnMgrState * state;
 	axlHashCursor          * cursor;
 	int                      total_count;
 
 	v_return_val_if_fail (ctx && conn, NULL);
 	
-	/* new connection created: configure it */
-	vortex_mutex_lock (&ctx->conn_mgr_mutex);
+	/* lock the shard holding the connection state */
+	shard = TBC_CONN_MGR_SHARD (ctx, vortex_connection_get_id (conn));
+	vortex_mutex_lock (&shard->mutex);
 
 	/* get state */
-	state = axl_hash_get (ctx->conn_mgr_hash, INT_TO_PTR (vortex_connection_get_id (conn)));
+	state = shard->hash ? axl_hash_get (shard->hash, INT_TO_PTR (vortex_connection_get_id (conn))) : NULL;
 	if (state == NULL) {
 		if (vortex_connection_channels_count (conn) > 1) {
 			error ("Failed to find connection manager internal state associated to connection id=%d but it has channels %d, failed to return stats..",
 			       vortex_connection_channels_count (conn), vortex_connection_get_id (conn));
 		} /* end if */
 		/* unlock the mutex */
-		vortex_mutex_unlock (&ctx->conn_mgr_mutex);
+		vortex_mutex_unlock (&shard->mutex);
 		return NULL;
 	}
 
@@ -1080,7 +2575,7 @@ axlHashCursor    * turbulence_conn_mgr_profiles_stats (TurbulenceCtx    * ctx,
 	axl_hash_foreach2 (state->profiles_running, count_channels, &total_count, ctx);
 	if (total_count != (vortex_connection_channels_count (conn) -1)) {
 		/* release current mutex */
-		vortex_mutex_unlock (&ctx->conn_mgr_mutex);
+		vortex_mutex_unlock (&shard->mutex);
 		msg2 ("  Found inconsistent channel count (%d != %d) for profile stats, unlock and wait", 
 		      total_count, (vortex_connection_channels_count (conn) - 1));
 		
@@ -1096,11 +2591,37 @@ axlHashCursor    * turbulence_conn_mgr_profiles_stats (TurbulenceCtx    * ctx,
 	cursor = axl_hash_cursor_new (state->profiles_running);
 
 	/* unlock the mutex */
-	vortex_mutex_unlock (&ctx->conn_mgr_mutex);
+	vortex_mutex_unlock (&shard->mutex);
 
 	return cursor;
 }
 
+/** 
+ * @internal Returns a value that changes each time a channel is added
+ * or removed on the provided connection, allowing to memoize
+ * decisions taken with the profiles running (see
+ * turbulence_conn_mgr_profiles_stats).
+ *
+ * @return The current value or -1 if the connection is not
+ * registered.
+ */
+int                 __turbulence_conn_mgr_profiles_version (TurbulenceCtx    * ctx,
+							    VortexConnection * conn)
+{
+	TurbulenceConnMgrShard * shard;
+	TurbulenceConnMgrState * state;
+	int                      version = -1;
+
+	shard = TBC_CONN_MGR_SHARD (ctx, vortex_connection_get_id (conn));
+	vortex_mutex_lock (&shard->mutex);
+	state = shard->hash ? axl_hash_get (shard->hash, INT_TO_PTR (vortex_connection_get_id (conn))) : NULL;
+	if (state != NULL)
+		version = state->profiles_version;
+	vortex_mutex_unlock (&shard->mutex);
+
+	return version;
+}
+
 /** 
  * @internal Ensure we close all active connections before existing...
  */
@@ -1136,24 +2657,47 @@ axl_bool turbulence_conn_mgr_shutdown_connections (axlPointer key, axlPointer da
  */
 void turbulence_conn_mgr_cleanup (TurbulenceCtx * ctx)
 {
-	axlHash * conn_hash;
+	TurbulenceConnMgrShard * shard;
+	axlHash                * conn_hash;
+	int                      iterator;
+
+	/* stop greeting and idle timers */
+	if (ctx->conn_mgr_reaper) {
+		turbulence_loop_close (ctx->conn_mgr_reaper, axl_true);
+		ctx->conn_mgr_reaper = NULL;
+	} /* end if */
 
 	/* shutdown all pending connections */
-	msg ("calling to cleanup registered connections that are still opened: %d", axl_hash_items (ctx->conn_mgr_hash));
-
-	/* nullify hash to be the only owner */
-	vortex_mutex_lock (&ctx->conn_mgr_mutex);
-	conn_hash          = ctx->conn_mgr_hash;
-	ctx->conn_mgr_hash = NULL;
-	vortex_mutex_unlock (&ctx->conn_mgr_mutex);
-
-	/* finish the hash */
-	axl_hash_foreach (conn_hash, turbulence_conn_mgr_shutdown_connections, NULL);
-
-	/* destroy mutex */
-	axl_hash_free (conn_hash);
-
-	vortex_mutex_destroy (&ctx->conn_mgr_mutex);
+	msg ("calling to cleanup registered connections that are still opened: %d", turbulence_conn_mgr_count (ctx));
+
+	for (iterator = 0; iterator < TBC_CONN_MGR_SHARDS; iterator++) {
+		shard = &(ctx->conn_mgr_shards[iterator]);
+
+		/* nullify hash to be the only owner */
+		vortex_mutex_lock (&shard->mutex);
+		conn_hash   = shard->hash;
+		shard->hash = NULL;
+		vortex_mutex_unlock (&shard->mutex);
+
+		/* finish the hash */
+		axl_hash_foreach (conn_hash, turbulence_conn_mgr_shutdown_connections, NULL);
+		axl_hash_free (conn_hash);
+		shard->items = 0;
+
+		/* finish profile index (empty at this point) */
+		axl_hash_free (shard->channels);
+		shard->channels = NULL;
+
+		/* connections waiting greetings (no reference is held) */
+		vortex_mutex_lock (&shard->mutex);
+		axl_hash_free (shard->accepted);
+		shard->accepted = NULL;
+		vortex_mutex_unlock (&shard->mutex);
+
+		/* destroy mutex */
+		vortex_mutex_destroy (&shard->mutex);
+	} /* end for */
+	vortex_mutex_destroy (&ctx->conn_mgr_reaper_mutex);
 
 	return;
 }
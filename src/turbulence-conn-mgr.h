@@ -57,6 +57,14 @@ axl_bool  turbulence_conn_mgr_broadcast_msg (TurbulenceCtx            * ctx,
 					     TurbulenceConnMgrFilter    filter_conn,
 					     axlPointer                 filter_data);
 
+axl_bool  turbulence_conn_mgr_broadcast_msg_full (TurbulenceCtx            * ctx,
+						  const void               * message,
+						  int                        message_size,
+						  const char               * profile,
+						  TurbulenceConnMgrFilter    filter_conn,
+						  axlPointer                 filter_data,
+						  axlList               ** failed);
+
 axlList *  turbulence_conn_mgr_conn_list   (TurbulenceCtx            * ctx, 
 					    VortexPeerRole             role,
 					    const char               * filter);
@@ -71,6 +79,19 @@ axl_bool   turbulence_conn_mgr_proxy_on_parent (VortexConnection * conn);
 
 int        turbulence_conn_mgr_setup_proxy_on_parent (TurbulenceCtx * ctx, VortexConnection * conn);
 
+int        turbulence_conn_mgr_proxy_loops (TurbulenceCtx * ctx);
+
+axl_bool   turbulence_conn_mgr_proxy_loop_stats (TurbulenceCtx * ctx, 
+						 int             index,
+						 int           * active,
+						 int           * total,
+						 long          * bytes_to_child,
+						 long          * bytes_to_conn);
+
+void       turbulence_conn_mgr_reaped (TurbulenceCtx * ctx, 
+				       int           * greeting, 
+				       int           * idle);
+
 VortexConnection * turbulence_conn_mgr_find_by_id (TurbulenceCtx * ctx,
 						   int             conn_id);
 
@@ -83,5 +104,11 @@ axlHashCursor    * turbulence_conn_mgr_profiles_stats (TurbulenceCtx    * ctx,
 void turbulence_conn_mgr_on_close (VortexConnection * conn, 
 				   axlPointer         user_data);
 
+int  __turbulence_conn_mgr_profiles_version (TurbulenceCtx    * ctx,
+					     VortexConnection * conn);
+
+void __turbulence_conn_mgr_accepted (TurbulenceCtx    * ctx,
+				     VortexConnection * conn);
+
 
 #endif 
@@ -37,6 +37,133 @@
 #ifndef __TURBULENCE_CTX_PRIVATE_H__
 #define __TURBULENCE_CTX_PRIVATE_H__
 
+/** 
+ * @internal Slot of the shared memory segment where a child
+ * publishes its counters. The child is the only writer: seq is odd
+ * while counters are being updated, so readers retry until they get
+ * the same even value before and after copying them.
+ */
+typedef struct _TurbulenceStatsSlot {
+	volatile int         seq;
+	TurbulenceChildStats stats;
+} TurbulenceStatsSlot;
+
+/** 
+ * @internal Room used by each slot of the stats segment: rounded up
+ * to a page so every child maps its own slot only.
+ */
+#define TBC_STATS_SLOT_SIZE() ((size_t) (((sizeof (TurbulenceStatsSlot) + sysconf (_SC_PAGESIZE) - 1) / sysconf (_SC_PAGESIZE)) * sysconf (_SC_PAGESIZE)))
+
+/** 
+ * @internal Returns the slot at the provided position of the stats
+ * segment.
+ */
+#define TBC_STATS_SLOT(segment, position) ((TurbulenceStatsSlot *) (((char *) (segment)) + (size_t) (position) * TBC_STATS_SLOT_SIZE ()))
+
+/** 
+ * @internal Memory barrier used to publish child counters.
+ */
+#if defined(__GNUC__)
+#define TBC_MEMORY_BARRIER() __sync_synchronize ()
+#else
+#define TBC_MEMORY_BARRIER()
+#endif
+
+/** 
+ * @internal Atomic add and read used by counters updated from
+ * several threads without a mutex.
+ */
+#if defined(__GNUC__)
+#define TBC_ATOMIC_ADD(counter, value) __sync_fetch_and_add (&(counter), (value))
+#define TBC_ATOMIC_GET(counter)        __sync_fetch_and_add (&(counter), 0)
+#else
+#define TBC_ATOMIC_ADD(counter, value) ((counter) += (value))
+#define TBC_ATOMIC_GET(counter)        (counter)
+#endif
+
+/** 
+ * @internal Token bucket used to limit how fast childs are created
+ * (child-spawn-rate and spawn-rate). Protected by
+ * child_process_mutex.
+ */
+typedef struct _TurbulenceSpawnBucket {
+	/* childs per second allowed (0: no limit) and max childs
+	 * created at once */
+	double          rate;
+	double          burst;
+
+	/* tokens available and last time they were refilled */
+	double          tokens;
+	struct timeval  last;
+
+	/* number of child creations delayed or sent to an existing
+	 * child because no token was available */
+	int             throttled;
+} TurbulenceSpawnBucket;
+
+/** 
+ * @internal Proxy on parent loop: each loop runs its own thread
+ * handling part of the proxied connections.
+ */
+typedef struct _TurbulenceProxyLoop {
+	/* loop (created when first connection is assigned) */
+	TurbulenceLoop     * loop;
+
+	/* connections currently proxied and total proxied */
+	int                  active;
+	int                  total;
+
+	/* bytes moved: remote conn -> child (written by the vortex
+	 * reader) and child -> remote conn (written by the loop
+	 * thread), updated with TBC_ATOMIC_ADD */
+	long                 bytes_to_child;
+	long                 bytes_to_conn;
+} TurbulenceProxyLoop;
+
+/** 
+ * @internal Number of shards used by the connection manager to
+ * register connections (must be a power of 2).
+ */
+#define TBC_CONN_MGR_SHARDS 16
+
+/** 
+ * @internal Returns the connection manager shard where the provided
+ * connection id is registered.
+ */
+#define TBC_CONN_MGR_SHARD(ctx, conn_id) (&((ctx)->conn_mgr_shards[(conn_id) & (TBC_CONN_MGR_SHARDS - 1)]))
+
+/** 
+ * @internal Connection manager shard: connections are registered on
+ * the shard selected by their id so register, unregister and lookups
+ * on different shards do not wait each other.
+ */
+typedef struct _TurbulenceConnMgrShard {
+	VortexMutex          mutex;
+	axlHash            * hash;
+
+	/* channels running on connections of this shard indexed by
+	 * profile (profile -> hash of channels) to broadcast without
+	 * checking all channels */
+	axlHash            * channels;
+
+	/* connections accepted that didn't complete greetings yet
+	 * (connection id -> connection, without reference), checked
+	 * by the greeting timer armed on accept */
+	axlHash            * accepted;
+
+	/* connections registered on the shard, updated with the
+	 * mutex acquired but read without it to count connections */
+	volatile int         items;
+
+	/* totals published to the parent when running as a child and
+	 * connections closed by greeting and idle timeouts */
+	int                  conns_total;
+	int                  channels_total;
+	long                 bytes_in;
+	long                 bytes_out;
+	int                  reaped_greeting;
+	int                  reaped_idle;
+} TurbulenceConnMgrShard;
 
 struct _TurbulenceCtx {
 	/* Reference to the turbulence vortex context associated.
@@ -85,6 +212,12 @@ struct _TurbulenceCtx {
 	int                  ppath_next_id;
 	TurbulencePPath    * paths;
 	axl_bool             all_rules_address_based;
+	/* protects paths replacement and profile path tables
+	 * reference counting */
+	VortexMutex          ppath_mutex;
+	/* set by the HUP signal handler: profile paths are reloaded
+	 * later from a vortex thread pool event */
+	volatile int         ppath_reload_pending;
 	/* profile_attr_alias: this hash allows to establish a set of
 	 * alias that is used by profile path module to check for a
 	 * particular attribute found on the connection instead of the
@@ -113,8 +246,15 @@ struct _TurbulenceCtx {
 	VortexMutex          registered_modules_mutex;
 
 	/* turbulence connection manager module */
-	VortexMutex          conn_mgr_mutex;
-	axlHash            * conn_mgr_hash; 
+	TurbulenceConnMgrShard conn_mgr_shards[TBC_CONN_MGR_SHARDS];
+
+	/* loop used to run greeting and idle timers (created on first
+	 * use with conn_mgr_reaper_mutex acquired) and default
+	 * timeouts (seconds) */
+	TurbulenceLoop     * conn_mgr_reaper;
+	VortexMutex          conn_mgr_reaper_mutex;
+	int                  conn_mgr_greeting_timeout;
+	int                  conn_mgr_idle_timeout;
 
 	/* turbulence stored data */
 	axlHash            * data;
@@ -134,13 +274,45 @@ struct _TurbulenceCtx {
 	/*** turbulence process module ***/
 	axlHash                 * child_process;
 	VortexMutex               child_process_mutex;
+	TurbulenceLoop          * child_notify_loop;
+
+	/* childs being created outside child_process_mutex, counted
+	 * against global-child-limit until registered */
+	int                       childs_starting;
+
+	/* connections waiting in admission queues (all profile
+	 * paths) and event installed to check them, protected by
+	 * child_process_mutex */
+	axlList                 * admissions;
+	axl_bool                  admission_event;
+
+	/* global child creation rate limit (child-spawn-rate) */
+	TurbulenceSpawnBucket     spawn_bucket;
+
+	/* shared memory segment where childs publish their counters
+	 * (one slot per child, stats_used tracks slots assigned,
+	 * protected by stats_mutex) */
+	TurbulenceStatsSlot     * stats_segment;
+	int                       stats_slots;
+	char                    * stats_used;
+	char                    * stats_path;
+	VortexMutex               stats_mutex;
+
+	/* zygote process used to create childs (child-zygote) */
+	int                       zygote_pid;
+	int                       zygote_connection;
+	VortexMutex               zygote_mutex;
 
 	/*** turbulence mediator module ***/
 	axlHash            * mediator_hash;
 	VortexMutex          mediator_hash_mutex;
 	
 	/*** support for proxy on parent ***/
-	TurbulenceLoop     * proxy_loop;
+	TurbulenceProxyLoop * proxy_loops;
+	/* number of proxy loops (configured value until loops are
+	 * created, 0 means one per core) */
+	int                   proxy_loops_count;
+	VortexMutex           proxy_mutex;
 };
 
 /** 
@@ -167,11 +339,99 @@ struct _TurbulenceChild {
 	/* connection management */
 	VortexConnection   * conn_mgr;
 
+	/** 
+	 * @internal Signals that this child was pre-forked to be
+	 * part of the spare pool of its profile path and no
+	 * connection has been sent to it yet.
+	 */
+	axl_bool             spare;
+
+	/** 
+	 * @internal Number of connections currently handled by this
+	 * child (only tracked by the parent when children-per-ppath is
+	 * configured).
+	 */
+	int                  conn_count;
+
+	/** 
+	 * @internal Recent CPU usage of the child (1.0 = one core
+	 * busy), computed from the CPU ticks consumed since the last
+	 * sample taken (only when balance-cpu is configured).
+	 */
+	double               cpu_load;
+	long                 cpu_ticks;
+	struct timeval       cpu_sample;
+
+	/** 
+	 * @internal Values used to recycle the child (see
+	 * recycle-conns, recycle-age and recycle-rss): connections sent
+	 * to the child, when it was registered, its resident memory
+	 * (KB) sampled from /proc and whether it is draining (no new
+	 * connections are sent to it, it finishes once its connections
+	 * are closed).
+	 */
+	int                  conns_served;
+	long                 started;
+	long                 rss;
+	struct timeval       rss_sample;
+	axl_bool             draining;
+
+	/** 
+	 * @internal Slot assigned to the child in the stats shared
+	 * memory segment (-1 if none) and, inside the child, the
+	 * slot mapped.
+	 */
+	int                  stats_slot;
+	TurbulenceStatsSlot * stats;
+
+	/** 
+	 * @internal Connections queued by the parent to be sent to
+	 * the child, and whether a thread is currently sending them
+	 * (protected by mutex). Connections queued while a send is in
+	 * progress are sent together in one message.
+	 */
+	axlList            * handoff_queue;
+	axl_bool             handoff_flushing;
+
+	/** 
+	 * @internal Inside the child, connection closed notifications
+	 * not sent yet to the parent because the control connection
+	 * was full, and whether the child loop is waiting to send
+	 * them (protected by mutex).
+	 */
+	int                  closes_pending;
+	axl_bool             closes_watching;
+
 	/* ref counting and mutex */
 	int                  ref_count;
 	VortexMutex          mutex;
 };
 
+/** 
+ * @internal State of a BEEP session handed off to a child process,
+ * used to restore the connection at the child (see
+ * turbulence_process_connection_status_encode). Strings point into
+ * the record decoded.
+ */
+struct _TurbulenceConnStatus {
+	axl_bool             handle_start_reply;
+	int                  channel_num;
+	const char         * profile;
+	const char         * profile_content;
+	VortexEncoding       encoding;
+	const char         * serverName;
+	int                  msg_no;
+	int                  seq_no;
+	int                  seq_no_expected;
+	int                  ppath_id;
+	int                  has_tls;
+	int                  fix_server_name;
+	const char         * remote_host;
+	const char         * remote_port;
+	const char         * remote_host_ip;
+	axl_bool             skip_conn_recover;
+};
+
 typedef enum {
 	PROFILE_ALLOW, 
 	PROFILE_IF
@@ -200,6 +460,10 @@ struct _TurbulencePPathItem {
 	/* Another list for all profile path item found inside this
 	 * profile path item. This is only used by PROFILE_IF items */
 	TurbulencePPathItem ** ppath_items;
+
+	/* position of this PROFILE_IF item inside its profile path
+	 * if_items (bit on the set of active profiles) */
+	int    if_index;
 	
 };
 
@@ -228,6 +492,14 @@ struct _TurbulencePPathDef {
 	 * xml level of <allow> and <if-sucess> nodes). */
 	TurbulencePPathItem ** ppath_items;
 
+	/* all <if-success> items found under ppath_items (indexed by
+	 * their if_index) and the distinct connmark/preconnmark names
+	 * they use, both NULL terminated. Used to memoize channel
+	 * start decisions per connection. */
+	TurbulencePPathItem ** if_items;
+	int                    if_count;
+	char                ** marks;
+
 #if defined(AXL_OS_UNIX)
 	/* user id to that must be used to run the process */
 	int  user_id;
@@ -266,11 +538,102 @@ struct _TurbulencePPathDef {
 	 */
 	int childs_running;
 
+	/** 
+	 * allows to configure the number of idle child processes
+	 * (already started and waiting for connections) that are
+	 * kept for this profile path (min-spare-childs), and the
+	 * number of idle childs to create when a connection finds the
+	 * pool empty (max-spare-childs). Both are 0 by default (no
+	 * pool).
+	 */
+	int min_spare_childs;
+	int max_spare_childs;
+
+	/** 
+	 * Flags used by the parent to track spare pool refill
+	 * (protected by child_process_mutex).
+	 */
+	axl_bool spare_refilling;
+	axl_bool spare_burst;
+
+	/** 
+	 * allows to configure the number of childs that are created
+	 * for a profile path with reuse="yes" (children-per-ppath),
+	 * dispatching each connection to the child with fewer
+	 * connections (optionally weighted by its recent CPU usage,
+	 * balance-cpu="yes"). By default 1.
+	 */
+	int      children_per_ppath;
+	axl_bool balance_cpu;
+
+	/** 
+	 * allows to configure the number of connections that can
+	 * wait for a child when child-limit or global-child-limit is
+	 * reached (admission-queue), and how long each one waits
+	 * (admission-timeout, milliseconds). By default 0: the
+	 * connection is closed.
+	 */
+	int      admission_limit;
+	int      admission_timeout;
+
+	/** 
+	 * Connections waiting for a child (TurbulenceAdmission
+	 * items, first is next to be admitted, also on
+	 * ctx->admissions) and queue stats
+	 * (protected by child_process_mutex).
+	 */
+	axlList * admission_list;
+	int       admission_max_depth;
+	int       admission_queued;
+	int       admission_timeouts;
+	int       admission_rejected;
+	long      admission_wait_total;
+	long      admission_wait_max;
+
+	/** 
+	 * allows to limit how fast childs are created for this
+	 * profile path (spawn-rate childs per second, up to
+	 * spawn-burst at once). By default no limit.
+	 */
+	TurbulenceSpawnBucket spawn_bucket;
+
+	/** 
+	 * allows to recycle childs of a profile path with reuse="yes"
+	 * after serving recycle-conns connections, running
+	 * recycle-age seconds or reaching recycle-rss MB of resident
+	 * memory. 0 (default) disables each threshold.
+	 */
+	int      recycle_conns;
+	int      recycle_age;
+	int      recycle_rss;
+
+	/** 
+	 * Seconds a connection may stay without opening a channel
+	 * and without sending content (-1: use global value, 0:
+	 * disabled).
+	 */
+	int      greeting_timeout;
+	int      idle_timeout;
+
+	/** 
+	 * Mutex used by the parent to serialize child creation for
+	 * this profile path (childs for different profile paths are
+	 * created in parallel). Always acquired before
+	 * child_process_mutex.
+	 */
+	VortexMutex create_mutex;
+
 	/** 
 	 * reference to the <ppath-def> that where this profile path was loaded.
 	 */
 	axlNode * node;
 
+	/** 
+	 * Profile path table holding this definition (see
+	 * __turbulence_ppath_ref).
+	 */
+	TurbulencePPath * paths;
+
 	/** 
 	 * In the case profile <path-def> has search nodes configured,
 	 * this flag signal if they were loaded previously (to avoid
@@ -286,13 +649,31 @@ typedef struct _TurbulenceConnMgrState {
 	VortexConnection * conn;
 	TurbulenceCtx    * ctx;
 
+	/* shard where the connection is registered */
+	TurbulenceConnMgrShard * shard;
+
 	/* a hash that contains the set of profiles running on this
 	 * connection and how many times */
 	axlHash          * profiles_running;
 
+	/* increased each time a channel is added or removed, used to
+	 * invalidate decisions computed with the profiles running */
+	int                profiles_version;
+
+	/* channels of this connection added to the shard profile
+	 * index (channel -> profile) */
+	axlHash          * indexed;
+
 	/* reference to handler ids to be removed */
 	axlPointer         added_channel_id;
 	axlPointer         removed_channel_id;
+
+	/* greeting or idle timer installed on the reaper loop (-1:
+	 * none), signal if the timer running is the idle one and
+	 * when the connection was registered */
+	int                reap_timer;
+	axl_bool           reap_idle;
+	long               registered;
 } TurbulenceConnMgrState;
 
 #endif
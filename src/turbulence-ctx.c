@@ -82,6 +82,8 @@ TurbulenceCtx * turbulence_ctx_new ()
 	/* create hash */
 	ctx->data  = axl_hash_new (axl_hash_string, axl_hash_equal_string);
 	vortex_mutex_create (&ctx->data_mutex);
+	vortex_mutex_create (&ctx->proxy_mutex);
+	vortex_mutex_create (&ctx->ppath_mutex);
 
 	/* set log descriptors to something not usable */
 	ctx->general_log = -1;
@@ -121,6 +123,8 @@ void           turbulence_ctx_reinit (TurbulenceCtx * ctx, TurbulenceChild * chi
 	vortex_mutex_create (&ctx->db_list_mutex);
 	vortex_mutex_create (&ctx->data_mutex);
 	vortex_mutex_create (&ctx->registered_modules_mutex);
+	vortex_mutex_create (&ctx->proxy_mutex);
+	vortex_mutex_create (&ctx->ppath_mutex);
 
 	/* mutex on child object */
 	vortex_mutex_create (&ctx->child->mutex);
@@ -128,6 +132,9 @@ void           turbulence_ctx_reinit (TurbulenceCtx * ctx, TurbulenceChild * chi
 	/* clean child process list: reinit = axl_true */
 	turbulence_process_init (ctx, axl_true);
 
+	/* drop profile path selections cached by the parent */
+	__turbulence_ppath_cache_reinit (ctx);
+
 	return;
 }
 
@@ -338,6 +345,8 @@ void            turbulence_ctx_free (TurbulenceCtx * ctx)
 	axl_hash_free (ctx->data);
 	ctx->data = NULL;
 	vortex_mutex_destroy (&ctx->data_mutex);
+	vortex_mutex_destroy (&ctx->proxy_mutex);
+	vortex_mutex_destroy (&ctx->ppath_mutex);
 
 	/* release wait queue */
 	vortex_async_queue_unref (ctx->wait_queue);
@@ -37,6 +37,10 @@
 #include <turbulence-expr.h>
 
 #include <pcre.h>
+#include <ctype.h>
+#if defined(AXL_OS_UNIX)
+#include <arpa/inet.h>
+#endif
 
 /** 
  * \defgroup turbulence_expr Turbulence expr: regular expression support.
@@ -47,12 +51,299 @@
  * @{
  */
 
+/** 
+ * @internal Binary radix trie node used to match addresses against
+ * CIDR, prefix and range rules: each level consumes one address bit
+ * and a node flagged as terminal covers every address below it.
+ */
+typedef struct _TurbulenceAddrNode TurbulenceAddrNode;
+struct _TurbulenceAddrNode {
+	TurbulenceAddrNode * child[2];
+	axl_bool             terminal;
+};
+
+/** 
+ * @internal Set of address rules compiled from an expression like
+ * "10.0.0.0/8, 192.168.1.10-192.168.1.50, 2001:db8::/32".
+ */
+typedef struct _TurbulenceAddrSet {
+	TurbulenceAddrNode * ipv4;
+	TurbulenceAddrNode * ipv6;
+} TurbulenceAddrSet;
+
 struct _TurbulenceExpr {
 	pcre * expr;
 	int    negative;
 	char * string_expression;
+	/* value to compare against when the expression only matches
+	 * one literal string (NULL otherwise) */
+	char * literal;
+	/* address rules when the expression is a list of addresses,
+	 * networks or ranges (NULL otherwise) */
+	TurbulenceAddrSet * addresses;
 };
 
+/** 
+ * @internal Parses the provided address into its binary form (16
+ * bytes buffer). IPv4 mapped IPv6 addresses are translated into IPv4.
+ *
+ * @return Address bits (32 or 128) or -1 if it is not an address.
+ */
+int       turbulence_expr_address_parse (const char * address, unsigned char * bytes)
+{
+	char aux[INET6_ADDRSTRLEN + 1];
+	int  length;
+
+	/* skip white spaces */
+	while (*address == ' ')
+		address++;
+	length = strlen (address);
+	while (length > 0 && address[length - 1] == ' ')
+		length--;
+	if (length == 0 || length > INET6_ADDRSTRLEN)
+		return -1;
+	memcpy (aux, address, length);
+	aux[length] = 0;
+
+	if (inet_pton (AF_INET, aux, bytes) == 1)
+		return 32;
+	if (inet_pton (AF_INET6, aux, bytes) != 1)
+		return -1;
+
+	/* ::ffff:a.b.c.d */
+	if (memcmp (bytes, "\0\0\0\0\0\0\0\0\0\0\xff\xff", 12) == 0) {
+		memmove (bytes, bytes + 12, 4);
+		return 32;
+	} /* end if */
+	return 128;
+}
+
+#define TBC_ADDR_BIT(bytes, bit) (((bytes)[(bit) / 8] >> (7 - ((bit) % 8))) & 1)
+
+void      turbulence_expr_address_node_free (TurbulenceAddrNode * node)
+{
+	if (node == NULL)
+		return;
+	turbulence_expr_address_node_free (node->child[0]);
+	turbulence_expr_address_node_free (node->child[1]);
+	axl_free (node);
+	return;
+}
+
+/** 
+ * @internal Flags as covered all addresses between low and high
+ * (inclusive) below the provided node. Subtrees fully covered by the
+ * range are flagged at their root so a range is stored in O(address
+ * bits) nodes.
+ */
+void      turbulence_expr_address_insert (TurbulenceAddrNode  * node, 
+					  int                   depth,
+					  int                   bits,
+					  const unsigned char * low,
+					  const unsigned char * high,
+					  axl_bool              low_bound,
+					  axl_bool              high_bound)
+{
+	int bit;
+
+	/* already covered */
+	if (node->terminal)
+		return;
+
+	if (depth == bits || (! low_bound && ! high_bound)) {
+		/* whole subtree covered: release nodes below */
+		node->terminal = axl_true;
+		turbulence_expr_address_node_free (node->child[0]);
+		turbulence_expr_address_node_free (node->child[1]);
+		node->child[0] = NULL;
+		node->child[1] = NULL;
+		return;
+	} /* end if */
+
+	for (bit = 0; bit < 2; bit++) {
+		/* skip branches out of the range */
+		if (low_bound && bit < TBC_ADDR_BIT (low, depth))
+			continue;
+		if (high_bound && bit > TBC_ADDR_BIT (high, depth))
+			continue;
+
+		if (node->child[bit] == NULL)
+			node->child[bit] = axl_new (TurbulenceAddrNode, 1);
+		turbulence_expr_address_insert (node->child[bit], depth + 1, bits, low, high,
+						low_bound && bit == TBC_ADDR_BIT (low, depth),
+						high_bound && bit == TBC_ADDR_BIT (high, depth));
+	} /* end for */
+
+	return;
+}
+
+void      turbulence_expr_address_set_free (TurbulenceAddrSet * set)
+{
+	if (set == NULL)
+		return;
+	turbulence_expr_address_node_free (set->ipv4);
+	turbulence_expr_address_node_free (set->ipv6);
+	axl_free (set);
+	return;
+}
+
+/** 
+ * @internal Adds one rule (address, address/prefix or low-high range)
+ * to the set.
+ */
+axl_bool  turbulence_expr_address_add (TurbulenceAddrSet * set, char * rule)
+{
+	unsigned char         low[16];
+	unsigned char         high[16];
+	int                   bits;
+	int                   bits2;
+	int                   prefix;
+	int                   iterator;
+	char                * separator;
+	TurbulenceAddrNode ** root;
+
+	if ((separator = strchr (rule, '/')) != NULL) {
+		/* network/prefix */
+		*separator = 0;
+		bits       = turbulence_expr_address_parse (rule, low);
+		*separator = '/';
+		if (bits < 0)
+			return axl_false;
+		separator++;
+		while (*separator == ' ')
+			separator++;
+		if (! isdigit ((unsigned char) *separator))
+			return axl_false;
+		prefix = atoi (separator);
+		/* prefixes written for IPv4 mapped networks */
+		if (bits == 32 && prefix > 32 && strchr (rule, ':'))
+			prefix -= 96;
+		if (prefix < 0 || prefix > bits)
+			return axl_false;
+
+		/* clear host bits and set them on high bound */
+		memcpy (high, low, 16);
+		for (iterator = prefix; iterator < bits; iterator++) {
+			low[iterator / 8]  &= ~(1 << (7 - (iterator % 8)));
+			high[iterator / 8] |=  (1 << (7 - (iterator % 8)));
+		} /* end for */
+	} else if ((separator = strchr (rule, '-')) != NULL) {
+		/* low-high range */
+		*separator = 0;
+		bits       = turbulence_expr_address_parse (rule, low);
+		*separator = '-';
+		bits2      = turbulence_expr_address_parse (separator + 1, high);
+		if (bits < 0 || bits != bits2 || memcmp (low, high, bits / 8) > 0)
+			return axl_false;
+	} else {
+		/* single address */
+		bits = turbulence_expr_address_parse (rule, low);
+		if (bits < 0)
+			return axl_false;
+		memcpy (high, low, 16);
+	} /* end if */
+
+	root = (bits == 32) ? &set->ipv4 : &set->ipv6;
+	if (*root == NULL)
+		*root = axl_new (TurbulenceAddrNode, 1);
+	turbulence_expr_address_insert (*root, 0, bits, low, high, axl_true, axl_true);
+	return axl_true;
+}
+
+/** 
+ * @internal Compiles the expression as a list of address rules
+ * separated by commas.
+ *
+ * @return A new address set or NULL if any item of the list is not an
+ * address, network or range (so the expression must be handled as a
+ * regular expression).
+ */
+TurbulenceAddrSet * turbulence_expr_address_compile (const char * expression)
+{
+	TurbulenceAddrSet * set;
+	char             ** strv;
+	int                 iterator;
+
+	/* only check expressions that looks like addresses */
+	if (strspn (expression, "0123456789abcdefABCDEF.:/-, ") != strlen (expression))
+		return NULL;
+
+	strv = axl_stream_split (expression, 1, ",");
+	if (strv == NULL)
+		return NULL;
+
+	set      = axl_new (TurbulenceAddrSet, 1);
+	iterator = 0;
+	while (strv[iterator]) {
+		if (! turbulence_expr_address_add (set, strv[iterator])) {
+			turbulence_expr_address_set_free (set);
+			set = NULL;
+			break;
+		} /* end if */
+
+		/* next position */
+		iterator++;
+	} /* end while */
+
+	axl_stream_freev (strv);
+	return set;
+}
+
+/** 
+ * @internal Checks if the provided address is covered by the set:
+ * O(address bits) no matter how many rules were added.
+ */
+axl_bool  turbulence_expr_address_match (TurbulenceAddrSet * set, const char * subject)
+{
+	unsigned char        bytes[16];
+	int                  bits;
+	int                  depth;
+	TurbulenceAddrNode * node;
+
+	bits = turbulence_expr_address_parse (subject, bytes);
+	if (bits < 0)
+		return axl_false;
+
+	node = (bits == 32) ? set->ipv4 : set->ipv6;
+	for (depth = 0; node != NULL; depth++) {
+		if (node->terminal)
+			return axl_true;
+		if (depth == bits)
+			break;
+		node = node->child[TBC_ADDR_BIT (bytes, depth)];
+	} /* end for */
+
+	return axl_false;
+}
+
+/** 
+ * @internal Checks if the provided expression (already without
+ * negative prefix) only matches one literal string once expanded by
+ * turbulence_expr_copy_and_escape (that is, host names or addresses
+ * like "www.aspl.es" or "192.168.0.1" which are anchored and have
+ * their dots escaped).
+ */
+axl_bool  turbulence_expr_is_literal (const char * expression)
+{
+	int iterator = 0;
+
+	/* first char must be alphanumeric: a leading dot is not
+	 * escaped */
+	if (expression == NULL || ! isalnum ((unsigned char) expression[0]))
+		return axl_false;
+
+	while (expression[iterator]) {
+		if (! isalnum ((unsigned char) expression[iterator]) &&
+		    expression[iterator] != '.' && expression[iterator] != '-' &&
+		    expression[iterator] != '_' && expression[iterator] != ':' &&
+		    expression[iterator] != '@')
+			return axl_false;
+		iterator++;
+	} /* end while */
+
+	return axl_true;
+}
+
 /** 
  * @internal Function used to check if the string provided have
  * content that must be revised to help its clarity.
@@ -296,7 +587,20 @@ TurbulenceExpr * turbulence_expr_compile (TurbulenceCtx * ctx,
 	expression = turbulence_expr_check_negative_expr (expression, &expr->negative);
 	if (expr->negative) {
 		msg ("  found, updated expression to: not %s", expression);
-	}
+	} /* end if */
+
+	/* check for address rules (address lists, networks or
+	 * ranges) which are matched using a radix trie rather than
+	 * pcre. Single addresses are handled as literals. */
+	if (strpbrk (expression, ",/-") && (expr->addresses = turbulence_expr_address_compile (expression)) != NULL) {
+		msg ("NOTE: expression handled as address rules: %s", expression);
+		return expr;
+	} /* end if */
+
+	if (! expr->negative && turbulence_expr_is_literal (expression)) {
+		/* record literal value to skip pcre on match */
+		expr->literal = axl_strdup (expression);
+	} /* end if */
 
 	/* check for , in inside the string to translate into | */
 	if (strstr (expression, ",")) {
@@ -389,6 +693,17 @@ axl_bool  turbulence_expr_match (TurbulenceExpr * expr, const char * subject)
 	if (subject == NULL || expr == NULL)
 		return axl_false;
 
+	/* address rules are matched by the radix trie */
+	if (expr->addresses) {
+		if (expr->negative)
+			return ! turbulence_expr_address_match (expr->addresses, subject);
+		return turbulence_expr_address_match (expr->addresses, subject);
+	} /* end if */
+
+	/* literal expressions are matched by plain comparison */
+	if (expr->literal)
+		return axl_cmp (expr->literal, subject);
+
 	/* check against the pcre expression */
 	if (expr->negative) {
 		return ! (pcre_exec (expr->expr, NULL, subject, strlen (subject), 0, 0, NULL, 0) >= 0);
@@ -417,6 +732,24 @@ const char     * turbulence_expr_get_expression (TurbulenceExpr * expr)
 	return expr->string_expression;
 }
 
+/** 
+ * @brief Allows to check if the provided expression only matches one
+ * literal string (for example "www.aspl.es" or "192.168.0.1"), which
+ * allows callers to index expressions by that value instead of
+ * evaluating them one by one.
+ *
+ * @param expr The turbulence expression to check.
+ *
+ * @return The only string matched by the expression or NULL if the
+ * expression is a wildcard, negative or a list of values.
+ */
+const char     * turbulence_expr_get_literal (TurbulenceExpr * expr)
+{
+	if (expr == NULL)
+		return NULL;
+	return expr->literal;
+}
+
 /** 
  * @brief Terminate the regular expression compiled by \ref
  * turbulence_expr_compile.
@@ -428,7 +761,10 @@ void turbulence_expr_free (TurbulenceExpr * expr)
 
 	/* free the expression and then the node itself */
 	axl_free (expr->string_expression);
-	pcre_free (expr->expr);
+	axl_free (expr->literal);
+	turbulence_expr_address_set_free (expr->addresses);
+	if (expr->expr)
+		pcre_free (expr->expr);
 	axl_free (expr);
 	
 	return;
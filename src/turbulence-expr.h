@@ -66,6 +66,8 @@ axl_bool         turbulence_expr_match   (TurbulenceExpr * expr,
 #define __TBC_EXP_STR__(expr) turbulence_expr_get_expression(expr)
 const char     * turbulence_expr_get_expression (TurbulenceExpr * expr);
 
+const char     * turbulence_expr_get_literal    (TurbulenceExpr * expr);
+
 void             turbulence_expr_free    (TurbulenceExpr * expr);
 
 #endif /* __TURBULENCE_EXPR_H__ */
@@ -113,6 +113,47 @@ typedef axl_bool (*TurbulenceLoopOnRead) (TurbulenceLoop * loop,
 					  axlPointer       ptr, 
 					  axlPointer       ptr2);
 
+/** 
+ * @brief Handler definition used by turbulence_loop_watch_write to
+ * notify that the descriptor can be written without blocking.
+ *
+ * @param loop The loop wher the notification was found.
+ * @param ctx The Turbulence context where the loop is running.
+ * @param descriptor The descriptor that is ready to be written.
+ * @param ptr User defined pointer defined at \ref turbulence_loop_watch_write and passed to this handler.
+ * @param ptr2 User defined pointer defined at \ref turbulence_loop_watch_write and passed to this handler.
+ *
+ * @return The function return axl_true to keep on being notified
+ * (there is still pending content to write). Otherwise axl_false is
+ * returned to stop write notifications (the descriptor is not
+ * closed and it is still watched for reading).
+ */
+typedef axl_bool (*TurbulenceLoopOnWrite) (TurbulenceLoop * loop, 
+					   TurbulenceCtx  * ctx,
+					   int              descriptor, 
+					   axlPointer       ptr, 
+					   axlPointer       ptr2);
+
+/** 
+ * @brief Handler definition used by turbulence_loop_add_timer to
+ * notify that a timer expired. The handler is called from the loop
+ * thread so it must not block.
+ *
+ * @param loop The loop where the timer was installed.
+ * @param ctx The Turbulence context where the loop is running.
+ * @param timer_id The timer identifier returned by \ref turbulence_loop_add_timer.
+ * @param ptr User defined pointer defined at \ref turbulence_loop_add_timer and passed to this handler.
+ * @param ptr2 User defined pointer defined at \ref turbulence_loop_add_timer and passed to this handler.
+ *
+ * @return For periodic timers, axl_true to keep the timer installed
+ * or axl_false to cancel it. Ignored for one-shot timers.
+ */
+typedef axl_bool (*TurbulenceLoopOnTimer) (TurbulenceLoop * loop, 
+					   TurbulenceCtx  * ctx,
+					   int              timer_id,
+					   axlPointer       ptr, 
+					   axlPointer       ptr2);
+
 #endif
 
 /**
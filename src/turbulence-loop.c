@@ -36,6 +36,65 @@
  */
 #include <turbulence.h>
 
+#if defined(__linux__)
+#include <sys/epoll.h>
+#define TBC_LOOP_HAVE_EPOLL 1
+#endif
+
+/** 
+ * @internal Max number of descriptors notified by each epoll_wait
+ * call, and time (milliseconds) to wait before checking pending
+ * registrations when no timer expires before (same wait used by the
+ * select(2) implementation).
+ */
+#define TBC_LOOP_EPOLL_EVENTS  64
+#define TBC_LOOP_EPOLL_TIMEOUT 500
+
+/** 
+ * @internal Timer wheel: resolution (milliseconds per tick), levels
+ * and slots per level (6 bits). With 4 levels, timers up to 46 hours
+ * are placed directly; longer timers are moved down when their slot
+ * is reached.
+ */
+#define TBC_LOOP_TIMER_TICK   10
+#define TBC_LOOP_TIMER_LEVELS 4
+#define TBC_LOOP_TIMER_BITS   6
+#define TBC_LOOP_TIMER_SLOTS  (1 << TBC_LOOP_TIMER_BITS)
+#define TBC_LOOP_TIMER_MASK   (TBC_LOOP_TIMER_SLOTS - 1)
+
+/** 
+ * @internal Queue item used to wake up the loop when timers are
+ * installed.
+ */
+#define TBC_LOOP_TIMER_WAKEUP -5
+
+/** 
+ * @internal Timer installed on a loop.
+ */
+typedef struct _TurbulenceLoopTimer TurbulenceLoopTimer;
+struct _TurbulenceLoopTimer {
+	int                    id;
+
+	/* tick when the timer expires and period (in ticks) */
+	long                   expires;
+	long                   period;
+	axl_bool               periodic;
+
+	/* handler and user pointers */
+	TurbulenceLoopOnTimer  on_timer;
+	axlPointer             ptr;
+	axlPointer             ptr2;
+
+	/* timer was cancelled while it was about to be called */
+	axl_bool               cancelled;
+
+	/* wheel slot where the timer is (NULL if it is about to be
+	 * called) and links inside that slot */
+	TurbulenceLoopTimer ** slot;
+	TurbulenceLoopTimer  * prev;
+	TurbulenceLoopTimer  * next;
+};
+
 /** 
  * \defgroup turbulence_loop Turbulence Loop: socket descriptor watcher
  */
@@ -50,9 +109,36 @@ struct _TurbulenceLoop {
 	VortexThread         thread;
 	axlList            * list;
 	axlListCursor      * cursor;
-	axlPointer           fileset;
+
+	/* sets used by the select(2) implementation: descriptors
+	 * with a write handler are also added to the write set */
+	fd_set               read_set;
+	fd_set               write_set;
 	VortexAsyncQueue   * queue;
 
+	/* epoll descriptor (-1 when the select(2) implementation is
+	 * used). With epoll, descriptors are registered once when
+	 * added rather building the watch set on each wait. */
+	int                  epoll_fd;
+
+	/* descriptor -> TurbulenceLoopDescriptor (owner of the
+	 * descriptors watched when epoll is used, so additions and
+	 * removals do not walk the list) */
+	axlHash            * watched;
+
+	/* pipe used to wake up the loop when new registrations are
+	 * queued (only used with epoll) */
+	int                  wakeup[2];
+
+	/* timers: hierarchical wheel, timers installed (id ->
+	 * TurbulenceLoopTimer), current tick and time for tick 0 */
+	VortexMutex           timer_mutex;
+	TurbulenceLoopTimer * timer_wheel[TBC_LOOP_TIMER_LEVELS][TBC_LOOP_TIMER_SLOTS];
+	axlHash             * timers;
+	long                  timer_tick;
+	int                   timer_next_id;
+	struct timeval        timer_base;
+
 	/* read handler */
 	TurbulenceLoopOnRead on_read;
 
@@ -83,6 +169,29 @@ typedef struct _TurbulenceLoopDescriptor {
 	   passed to the handler */
 	axlPointer           ptr2;
 
+	/* write handler and its pointers (only defined while the
+	 * descriptor must be notified when writable) */
+	TurbulenceLoopOnWrite on_write;
+	axlPointer           write_ptr;
+	axlPointer           write_ptr2;
+
+	/* descriptor only watched for write: it is owned by the
+	 * caller, so it isn't closed when removed */
+	axl_bool             write_only;
+
+	/* reads on the descriptor are not notified */
+	axl_bool             blocked;
+
+	/* if set to axl_true, it is a request to watch for write the
+	 * descriptor.
+	 */
+	axl_bool             write;
+
+	/* if set to axl_true, it is a request to block (or unblock)
+	 * reads on the descriptor (see blocked).
+	 */
+	axl_bool             block;
+
 	/* if set to axl_true, it is a request to remove this
 	 * descriptor.
 	 */
@@ -90,40 +199,610 @@ typedef struct _TurbulenceLoopDescriptor {
 	VortexAsyncQueue   * queue_reply;
 } TurbulenceLoopDescriptor;
 
+void __turbulence_loop_descriptor_free (axlPointer __loop_descriptor)
+{
+	TurbulenceLoopDescriptor * loop_descriptor = __loop_descriptor;
+	if (! loop_descriptor->write_only)
+		vortex_close_socket (loop_descriptor->descriptor);
+	axl_free (loop_descriptor);
+	return;
+}
+
+/** 
+ * @internal Finds the loop descriptor watching the provided
+ * descriptor.
+ */
+TurbulenceLoopDescriptor * __turbulence_loop_find (TurbulenceLoop * loop, int descriptor)
+{
+	TurbulenceLoopDescriptor * loop_descriptor;
+
+#if defined(TBC_LOOP_HAVE_EPOLL)
+	if (loop->epoll_fd >= 0)
+		return axl_hash_get (loop->watched, INT_TO_PTR (descriptor));
+#endif
+
+	axl_list_cursor_first (loop->cursor);
+	while (axl_list_cursor_has_item (loop->cursor)) {
+		loop_descriptor = axl_list_cursor_get (loop->cursor);
+		if (loop_descriptor && loop_descriptor->descriptor == descriptor)
+			return loop_descriptor;
+		axl_list_cursor_next (loop->cursor);
+	} /* end while */
+
+	return NULL;
+}
+
+#if defined(TBC_LOOP_HAVE_EPOLL)
+/** 
+ * @internal Updates the events the epoll set watches for the
+ * provided descriptor (removing it from the set while nothing must
+ * be watched).
+ *
+ * @return 0 if the epoll set was updated, otherwise -1 (errno set).
+ */
+int __turbulence_loop_epoll_update (TurbulenceLoop * loop, TurbulenceLoopDescriptor * loop_descriptor, axl_bool add)
+{
+	struct epoll_event event;
+
+	/* level triggered: handlers may read only part of the
+	 * content available, as done with select(2) */
+	memset (&event, 0, sizeof (struct epoll_event));
+	if (! loop_descriptor->write_only && ! loop_descriptor->blocked)
+		event.events |= EPOLLIN;
+	if (loop_descriptor->on_write)
+		event.events |= EPOLLOUT;
+	event.data.ptr = loop_descriptor;
+
+	/* nothing to watch (errors and hangups are always reported) */
+	if (event.events == 0) {
+		if (add)
+			return 0;
+		epoll_ctl (loop->epoll_fd, EPOLL_CTL_DEL, loop_descriptor->descriptor, &event);
+		return 0;
+	} /* end if */
+
+	if (add)
+		return epoll_ctl (loop->epoll_fd, EPOLL_CTL_ADD, loop_descriptor->descriptor, &event);
+	if (epoll_ctl (loop->epoll_fd, EPOLL_CTL_MOD, loop_descriptor->descriptor, &event) == 0)
+		return 0;
+	/* removed from the set while nothing was watched */
+	if (errno == ENOENT)
+		return epoll_ctl (loop->epoll_fd, EPOLL_CTL_ADD, loop_descriptor->descriptor, &event);
+	return -1;
+}
+#endif
+
+/** 
+ * @internal Adds the descriptor to the watch list (and to the epoll
+ * set when used).
+ */
+void __turbulence_loop_add (TurbulenceLoop * loop, TurbulenceLoopDescriptor * loop_descriptor)
+{
+	TurbulenceLoopDescriptor * current;
+#if defined(TBC_LOOP_HAVE_EPOLL)
+#if ! defined(SHOW_FORMAT_BUGS)
+	TurbulenceCtx            * ctx = loop->ctx;
+#endif
+
+	if (loop->epoll_fd >= 0) {
+		/* descriptor already watched: just update its
+		 * handlers (do not close it) */
+		current = axl_hash_get (loop->watched, INT_TO_PTR (loop_descriptor->descriptor));
+		if (current != NULL) {
+			current->on_read = loop_descriptor->on_read;
+			current->ptr     = loop_descriptor->ptr;
+			current->ptr2    = loop_descriptor->ptr2;
+			if (current->write_only && ! loop_descriptor->write_only) {
+				/* it was only watched for write: now
+				 * watch it for read too */
+				current->write_only = axl_false;
+				__turbulence_loop_epoll_update (loop, current, axl_false);
+			} /* end if */
+			axl_free (loop_descriptor);
+			return;
+		} /* end if */
+
+		if (__turbulence_loop_epoll_update (loop, loop_descriptor, axl_true) != 0) {
+			error ("Discarding descriptor %d because it can't be watched (epoll_ctl errno=%d)", 
+			       loop_descriptor->descriptor, errno);
+			__turbulence_loop_descriptor_free (loop_descriptor);
+			return;
+		} /* end if */
+
+		/* register loop_descriptor on the index */
+		axl_hash_insert_full (loop->watched, 
+				      INT_TO_PTR (loop_descriptor->descriptor), NULL, 
+				      loop_descriptor, __turbulence_loop_descriptor_free);
+		return;
+	} /* end if */
+#endif
+
+	/* descriptor already on the list: update its handlers as
+	 * done with epoll rather adding a second entry */
+	current = __turbulence_loop_find (loop, loop_descriptor->descriptor);
+	if (current != NULL) {
+		current->on_read = loop_descriptor->on_read;
+		current->ptr     = loop_descriptor->ptr;
+		current->ptr2    = loop_descriptor->ptr2;
+		/* it was only watched for write: now watch it for
+		 * read too (read set is built on each iteration) */
+		if (! loop_descriptor->write_only)
+			current->write_only = axl_false;
+		axl_free (loop_descriptor);
+		return;
+	} /* end if */
+
+	/* register loop_descriptor on the list */
+	axl_list_append (loop->list, loop_descriptor);
+	return;
+}
+
+#if defined(TBC_LOOP_HAVE_EPOLL)
+/** 
+ * @internal Removes the descriptor from the epoll set and from the
+ * index (closing it).
+ */
+void __turbulence_loop_del (TurbulenceLoop * loop, int descriptor)
+{
+	struct epoll_event event;
+
+	if (axl_hash_get (loop->watched, INT_TO_PTR (descriptor)) == NULL)
+		return;
+
+	epoll_ctl (loop->epoll_fd, EPOLL_CTL_DEL, descriptor, &event);
+	axl_hash_remove (loop->watched, INT_TO_PTR (descriptor));
+	return;
+}
+
+/** 
+ * @internal Wakes up the loop thread blocked on epoll_wait so queued
+ * registrations are applied without waiting for the timeout.
+ */
+void __turbulence_loop_wakeup (TurbulenceLoop * loop)
+{
+	char byte = 0;
+
+	if (loop->epoll_fd < 0 || loop->wakeup[1] < 0)
+		return;
+
+	/* pipe is non blocking: if full, the loop is already
+	 * signaled */
+	if (write (loop->wakeup[1], &byte, 1) < 0) {
+		/* nothing to do */
+	} /* end if */
+	return;
+}
+
+/** 
+ * @internal Drains the wakeup pipe.
+ */
+void __turbulence_loop_wakeup_drain (TurbulenceLoop * loop)
+{
+	char bytes[64];
+
+	while (read (loop->wakeup[0], bytes, sizeof (bytes)) > 0);
+	return;
+}
+#endif
+
+/** 
+ * @internal Returns the number of descriptors currently watched.
+ */
+int __turbulence_loop_count (TurbulenceLoop * loop)
+{
+#if defined(TBC_LOOP_HAVE_EPOLL)
+	if (loop->epoll_fd >= 0)
+		return axl_hash_items (loop->watched);
+#endif
+	return axl_list_length (loop->list);
+}
+
+/** 
+ * @internal Configures (or removes if on_write is NULL) the write
+ * handler of the provided loop descriptor.
+ */
+void __turbulence_loop_set_write (TurbulenceLoop           * loop, 
+				  TurbulenceLoopDescriptor * loop_descriptor,
+				  TurbulenceLoopOnWrite      on_write,
+				  axlPointer                 ptr,
+				  axlPointer                 ptr2)
+{
+	loop_descriptor->on_write   = on_write;
+	loop_descriptor->write_ptr  = ptr;
+	loop_descriptor->write_ptr2 = ptr2;
+
+#if defined(TBC_LOOP_HAVE_EPOLL)
+	if (loop->epoll_fd >= 0)
+		__turbulence_loop_epoll_update (loop, loop_descriptor, axl_false);
+#endif
+	return;
+}
+
+/** 
+ * @internal Handles a request to watch for write a descriptor
+ * (received through the loop queue).
+ */
+void __turbulence_loop_watch_write_request (TurbulenceLoop * loop, TurbulenceLoopDescriptor * request)
+{
+	TurbulenceLoopDescriptor * loop_descriptor;
+
+	loop_descriptor = __turbulence_loop_find (loop, request->descriptor);
+	if (loop_descriptor == NULL) {
+		/* descriptor not watched: watch it only for write
+		 * until the handler finishes */
+		request->write      = axl_false;
+		request->write_only = axl_true;
+		__turbulence_loop_add (loop, request);
+		return;
+	} /* end if */
+
+	__turbulence_loop_set_write (loop, loop_descriptor, request->on_write, request->write_ptr, request->write_ptr2);
+	axl_free (request);
+	return;
+}
+
+/** 
+ * @internal Handles a request to block (or unblock) reads on a
+ * descriptor (received through the loop queue).
+ */
+void __turbulence_loop_block_request (TurbulenceLoop * loop, TurbulenceLoopDescriptor * request)
+{
+	TurbulenceLoopDescriptor * loop_descriptor;
+
+	loop_descriptor = __turbulence_loop_find (loop, request->descriptor);
+	if (loop_descriptor != NULL && loop_descriptor->blocked != request->blocked) {
+		loop_descriptor->blocked = request->blocked;
+#if defined(TBC_LOOP_HAVE_EPOLL)
+		if (loop->epoll_fd >= 0)
+			__turbulence_loop_epoll_update (loop, loop_descriptor, axl_false);
+#endif
+	} /* end if */
+
+	axl_free (request);
+	return;
+}
+
+/** 
+ * @internal Calls the write handler of the provided descriptor,
+ * removing it if the handler is not interested anymore.
+ *
+ * @return axl_false if the descriptor must be removed from the watch
+ * set (it was only watched for write).
+ */
+axl_bool __turbulence_loop_notify_write (TurbulenceLoop * loop, TurbulenceLoopDescriptor * loop_descriptor)
+{
+	if (loop_descriptor->on_write == NULL)
+		return axl_true;
+
+	if (! loop_descriptor->on_write (loop, loop->ctx, loop_descriptor->descriptor, 
+					 loop_descriptor->write_ptr, loop_descriptor->write_ptr2)) {
+		if (loop_descriptor->write_only)
+			return axl_false;
+		__turbulence_loop_set_write (loop, loop_descriptor, NULL, NULL, NULL);
+	} /* end if */
+	return axl_true;
+}
+
+/** 
+ * @internal Returns current tick of the provided loop.
+ */
+long __turbulence_loop_timer_now (TurbulenceLoop * loop)
+{
+	struct timeval now;
+
+	gettimeofday (&now, NULL);
+	return ((now.tv_sec - loop->timer_base.tv_sec) * 1000 + 
+		(now.tv_usec - loop->timer_base.tv_usec) / 1000) / TBC_LOOP_TIMER_TICK;
+}
+
+/** 
+ * @internal Places the timer into the wheel slot for its expiration
+ * (timer mutex locked).
+ */
+void __turbulence_loop_timer_insert (TurbulenceLoop * loop, TurbulenceLoopTimer * timer)
+{
+	long                   delta   = timer->expires - loop->timer_tick;
+	long                   expires = timer->expires;
+	int                    level   = 0;
+	TurbulenceLoopTimer ** slot;
+
+	if (delta < 0) {
+		/* already expired: next tick */
+		delta   = 0;
+		expires = loop->timer_tick;
+	} /* end if */
+
+	/* find the level covering the delta (longer timers are
+	 * placed at the last slot reachable and moved again) */
+	while (level < (TBC_LOOP_TIMER_LEVELS - 1) && delta >= (1L << (TBC_LOOP_TIMER_BITS * (level + 1))))
+		level++;
+	if (delta >= (1L << (TBC_LOOP_TIMER_BITS * TBC_LOOP_TIMER_LEVELS)))
+		expires = loop->timer_tick + (1L << (TBC_LOOP_TIMER_BITS * TBC_LOOP_TIMER_LEVELS)) - 1;
+
+	slot = &(loop->timer_wheel[level][(expires >> (TBC_LOOP_TIMER_BITS * level)) & TBC_LOOP_TIMER_MASK]);
+
+	/* link at the head of the slot */
+	timer->slot = slot;
+	timer->prev = NULL;
+	timer->next = (*slot);
+	if (*slot)
+		(*slot)->prev = timer;
+	(*slot) = timer;
+	return;
+}
+
+/** 
+ * @internal Removes the timer from its wheel slot (timer mutex
+ * locked).
+ */
+void __turbulence_loop_timer_unlink (TurbulenceLoopTimer * timer)
+{
+	if (timer->slot == NULL)
+		return;
+
+	if (timer->prev)
+		timer->prev->next = timer->next;
+	else
+		(*timer->slot) = timer->next;
+	if (timer->next)
+		timer->next->prev = timer->prev;
+
+	timer->slot = NULL;
+	timer->prev = NULL;
+	timer->next = NULL;
+	return;
+}
+
+/** 
+ * @internal Moves timers of a higher level slot to lower levels
+ * (timer mutex locked).
+ *
+ * @return The slot index cascaded.
+ */
+int __turbulence_loop_timer_cascade (TurbulenceLoop * loop, int level)
+{
+	int                   index = (loop->timer_tick >> (TBC_LOOP_TIMER_BITS * level)) & TBC_LOOP_TIMER_MASK;
+	TurbulenceLoopTimer * timer;
+	TurbulenceLoopTimer * next;
+
+	timer = loop->timer_wheel[level][index];
+	loop->timer_wheel[level][index] = NULL;
+	while (timer) {
+		next        = timer->next;
+		timer->slot = NULL;
+		__turbulence_loop_timer_insert (loop, timer);
+		timer       = next;
+	} /* end while */
+
+	return index;
+}
+
+/** 
+ * @internal Returns milliseconds to wait until the next timer
+ * expires (up to TBC_LOOP_EPOLL_TIMEOUT) or -1 if there are no
+ * timers.
+ */
+long __turbulence_loop_timers_wait (TurbulenceLoop * loop)
+{
+	long wait = -1;
+	long now;
+	int  iterator;
+
+	vortex_mutex_lock (&loop->timer_mutex);
+	if (loop->timers == NULL || axl_hash_items (loop->timers) == 0) {
+		vortex_mutex_unlock (&loop->timer_mutex);
+		return -1;
+	} /* end if */
+
+	/* wait until next level 0 slot with timers or until upper
+	 * levels are moved down */
+	now      = __turbulence_loop_timer_now (loop);
+	wait     = ((loop->timer_tick | TBC_LOOP_TIMER_MASK) + 1 - now) * TBC_LOOP_TIMER_TICK;
+	iterator = 0;
+	while (iterator < TBC_LOOP_TIMER_SLOTS) {
+		if (loop->timer_wheel[0][(loop->timer_tick + iterator) & TBC_LOOP_TIMER_MASK]) {
+			if ((loop->timer_tick + iterator - now) * TBC_LOOP_TIMER_TICK < wait)
+				wait = (loop->timer_tick + iterator - now) * TBC_LOOP_TIMER_TICK;
+			break;
+		} /* end if */
+		iterator++;
+	} /* end while */
+	vortex_mutex_unlock (&loop->timer_mutex);
+
+	if (wait < 0)
+		return 0;
+	if (wait > TBC_LOOP_EPOLL_TIMEOUT)
+		return TBC_LOOP_EPOLL_TIMEOUT;
+	return wait;
+}
+
+/** 
+ * @internal Advances the wheel up to current time, calling handlers
+ * of expired timers (from the loop thread).
+ */
+void __turbulence_loop_timers_run (TurbulenceLoop * loop)
+{
+	TurbulenceLoopTimer * expired = NULL;
+	TurbulenceLoopTimer * timer;
+	TurbulenceLoopTimer * next;
+	long                  now;
+	int                   index;
+	int                   level;
+	axl_bool              result;
+
+	vortex_mutex_lock (&loop->timer_mutex);
+	now = __turbulence_loop_timer_now (loop);
+	if (loop->timers == NULL || axl_hash_items (loop->timers) == 0) {
+		loop->timer_tick = now;
+		vortex_mutex_unlock (&loop->timer_mutex);
+		return;
+	} /* end if */
+
+	while (loop->timer_tick <= now) {
+		/* move down timers from upper levels */
+		index = loop->timer_tick & TBC_LOOP_TIMER_MASK;
+		level = 1;
+		while (index == 0 && level < TBC_LOOP_TIMER_LEVELS) {
+			index = __turbulence_loop_timer_cascade (loop, level);
+			level++;
+		} /* end while */
+
+		/* collect timers expired */
+		timer = loop->timer_wheel[0][loop->timer_tick & TBC_LOOP_TIMER_MASK];
+		loop->timer_wheel[0][loop->timer_tick & TBC_LOOP_TIMER_MASK] = NULL;
+		while (timer) {
+			next        = timer->next;
+			timer->slot = NULL;
+			if (timer->expires > loop->timer_tick) {
+				/* timer longer than wheel range */
+				__turbulence_loop_timer_insert (loop, timer);
+			} else {
+				timer->next = expired;
+				expired     = timer;
+			} /* end if */
+			timer = next;
+		} /* end while */
+
+		loop->timer_tick++;
+	} /* end while */
+	vortex_mutex_unlock (&loop->timer_mutex);
+
+	/* call handlers */
+	while (expired) {
+		timer   = expired;
+		expired = timer->next;
+
+		result = axl_false;
+		if (! timer->cancelled)
+			result = timer->on_timer (loop, loop->ctx, timer->id, timer->ptr, timer->ptr2);
+
+		vortex_mutex_lock (&loop->timer_mutex);
+		if (timer->periodic && result && ! timer->cancelled) {
+			/* schedule next expiration */
+			timer->expires += timer->period;
+			if (timer->expires <= loop->timer_tick)
+				timer->expires = loop->timer_tick + timer->period;
+			__turbulence_loop_timer_insert (loop, timer);
+		} else {
+			/* release timer */
+			axl_hash_remove (loop->timers, INT_TO_PTR (timer->id));
+		} /* end if */
+		vortex_mutex_unlock (&loop->timer_mutex);
+	} /* end while */
+
+	return;
+}
+
+/** 
+ * @internal Applies a registration received through the loop queue
+ * (new descriptor, removal, write or block request).
+ */
+void __turbulence_loop_apply (TurbulenceLoop * loop, TurbulenceLoopDescriptor * loop_descriptor)
+{
+	TurbulenceLoopDescriptor * aux;
+
+	/* support for removing loop descriptor */
+	if (loop_descriptor->remove) {
+#if defined(TBC_LOOP_HAVE_EPOLL)
+		/* remove from the index */
+		if (loop->epoll_fd >= 0) {
+			__turbulence_loop_del (loop, loop_descriptor->descriptor);
+			goto notify_removed;
+		} /* end if */
+#endif
+		/* reset cursor to the first position */
+		axl_list_cursor_first (loop->cursor);
+		while (axl_list_cursor_has_item (loop->cursor)) {
+			/* get current descriptor */
+			aux = axl_list_cursor_get (loop->cursor);
+			if (aux && aux->descriptor == loop_descriptor->descriptor) {
+				/* element found, remove item */
+				axl_list_cursor_remove (loop->cursor);
+				break;
+			} /* end if */
+
+			/* next cursor */
+			axl_list_cursor_next (loop->cursor);
+		} /* end if */
+
+#if defined(TBC_LOOP_HAVE_EPOLL)
+	notify_removed:
+#endif
+		/* notify caller if he is waiting */
+		if (loop_descriptor->queue_reply)
+			vortex_async_queue_push (loop_descriptor->queue_reply, INT_TO_PTR (axl_true));
+
+		axl_free (loop_descriptor);
+		return;
+	} /* end if */
+
+	/* support for write requests */
+	if (loop_descriptor->write) {
+		__turbulence_loop_watch_write_request (loop, loop_descriptor);
+		return;
+	} /* end if */
+
+	/* support for block requests */
+	if (loop_descriptor->block) {
+		__turbulence_loop_block_request (loop, loop_descriptor);
+		return;
+	} /* end if */
+
+	/* register loop_descriptor on the list */
+	__turbulence_loop_add (loop, loop_descriptor);
+	return;
+}
+
 axl_bool __turbulence_loop_read_first (TurbulenceLoop * loop)
 {
 	TurbulenceLoopDescriptor * loop_descriptor;
+	long                       wait;
 
-	loop_descriptor = vortex_async_queue_pop (loop->queue);
+ read_next:
+	/* wait for a registration (or until next timer expires) */
+	wait = __turbulence_loop_timers_wait (loop);
+	if (wait < 0) 
+		loop_descriptor = vortex_async_queue_pop (loop->queue);
+	else
+		loop_descriptor = vortex_async_queue_timedpop (loop->queue, (wait > 0 ? wait : 1) * 1000);
+
+	/* run timers expired (or check timers installed) */
+	if (loop_descriptor == NULL || PTR_TO_INT (loop_descriptor) == TBC_LOOP_TIMER_WAKEUP) {
+		__turbulence_loop_timers_run (loop);
+		goto read_next;
+	} /* end if */
 
 	/* check item received: if null received terminate loop */
 	if (PTR_TO_INT (loop_descriptor) == -4)
 		return axl_false;
 
-	/* register loop_descriptor on the list */
-	axl_list_append (loop->list, loop_descriptor);       
+	/* apply the request (removals and blocks of descriptors not
+	 * watched leave the loop empty) */
+	__turbulence_loop_apply (loop, loop_descriptor);
+	if (__turbulence_loop_count (loop) == 0)
+		goto read_next;
 
 	return axl_true;
 }
 
 void __turbulence_loop_discard_broken (TurbulenceCtx * ctx, TurbulenceLoop * loop)
 {
-	int  loop_descriptor;
-	int  result = -1;
-	char bytes[4];
+	TurbulenceLoopDescriptor * loop_descriptor;
+	int                        result = -1;
+	char                       bytes[4];
 
 	/* reset cursor */
 	axl_list_cursor_first (loop->cursor);
 	while (axl_list_cursor_has_item (loop->cursor)) {
 		/* get loop descriptor */
-		loop_descriptor = PTR_TO_INT (axl_list_cursor_get (loop->cursor));
+		loop_descriptor = axl_list_cursor_get (loop->cursor);
 
 		/* now add to the waiting socket */
-		result = recv (loop_descriptor, bytes, 1, MSG_PEEK);
+		result = recv (loop_descriptor->descriptor, bytes, 1, MSG_PEEK);
 		if (result == -1 && errno == EBADF) {
 			
 			/* failed to add descriptor, close it and remove from wait list */
-			error ("Discarding descriptor %d because it is broken/invalid (EBADF/%d)", loop_descriptor, errno);
+			error ("Discarding descriptor %d because it is broken/invalid (EBADF/%d)", loop_descriptor->descriptor, errno);
 
 			/* remove cursor */
 			axl_list_cursor_remove (loop->cursor);
@@ -139,7 +818,7 @@ void __turbulence_loop_discard_broken (TurbulenceCtx * ctx, TurbulenceLoop * loo
 
 axl_bool __turbulence_loop_read_pending (TurbulenceLoop * loop)
 {
-	TurbulenceLoopDescriptor * loop_descriptor, * aux;
+	TurbulenceLoopDescriptor * loop_descriptor;
 
 	while (axl_true) {
 		/* check if there are no pending items */
@@ -153,54 +832,25 @@ axl_bool __turbulence_loop_read_pending (TurbulenceLoop * loop)
 		if (PTR_TO_INT (loop_descriptor) == -4)
 			return axl_false;
 
-		/* support for removing loop descriptor */
-		if (loop_descriptor->remove) {
-			/* reset cursor to the first position */
-			axl_list_cursor_first (loop->cursor);
-			while (axl_list_cursor_has_item (loop->cursor)) {
-				/* get current descriptor */
-				aux = axl_list_cursor_get (loop->cursor);
-				if (aux && aux->descriptor == loop_descriptor->descriptor) {
-					/* element found, remove item */
-					axl_list_cursor_remove (loop->cursor);
-					break;
-				} /* end if */
-
-				/* next cursor */
-				axl_list_cursor_next (loop->cursor);
-			} /* end if */
-
-			/* notify caller if he is waiting */
-			if (loop_descriptor->queue_reply)
-				vortex_async_queue_push (loop_descriptor->queue_reply, INT_TO_PTR (axl_true));
-
-			axl_free (loop_descriptor);
+		/* timers installed (they are checked after this) */
+		if (PTR_TO_INT (loop_descriptor) == TBC_LOOP_TIMER_WAKEUP)
 			continue;
-		} /* end if */
 
-		/* register loop_descriptor on the list */
-		axl_list_append (loop->list, loop_descriptor);       
+		__turbulence_loop_apply (loop, loop_descriptor);
 	} /* end if */
 
 	return axl_true;
 }
 
-void __turbulence_loop_descriptor_free (axlPointer __loop_descriptor)
-{
-	TurbulenceLoopDescriptor * loop_descriptor = __loop_descriptor;
-	vortex_close_socket (loop_descriptor->descriptor);
-	axl_free (loop_descriptor);
-	return;
-}
-
 /* build file set to watch */
 int __turbulence_loop_build_watch_set (TurbulenceLoop * loop)
 {
 	int                        max_fds = 0;
 	TurbulenceLoopDescriptor * loop_descriptor;
 
-	/* reset descriptor set */
-	__vortex_io_waiting_default_clear (loop->fileset);
+	/* reset descriptor sets */
+	FD_ZERO (&loop->read_set);
+	FD_ZERO (&loop->write_set);
 	
 	/* reset cursor */
 	axl_list_cursor_first (loop->cursor);
@@ -208,16 +858,20 @@ int __turbulence_loop_build_watch_set (TurbulenceLoop * loop)
 		/* get loop descriptor */
 		loop_descriptor = axl_list_cursor_get (loop->cursor);
 
-		/* now add to the waiting socket */
-		if (! __vortex_io_waiting_default_add_to (loop_descriptor->descriptor, 
-							  NULL, 
-							  loop->fileset)) {
+		/* check the descriptor can be watched */
+		if (loop_descriptor->descriptor < 0 || loop_descriptor->descriptor >= FD_SETSIZE) {
 			
 			/* failed to add descriptor, close it and remove from wait list */
 			axl_list_cursor_remove (loop->cursor);
 			continue;
 		} /* end if */
 
+		/* now add to the waiting sets */
+		if (! loop_descriptor->write_only && ! loop_descriptor->blocked)
+			FD_SET (loop_descriptor->descriptor, &loop->read_set);
+		if (loop_descriptor->on_write != NULL)
+			FD_SET (loop_descriptor->descriptor, &loop->write_set);
+
 		/* compute max_fds */
 		max_fds    = (loop_descriptor->descriptor > max_fds) ? loop_descriptor->descriptor: max_fds;
 		
@@ -228,12 +882,43 @@ int __turbulence_loop_build_watch_set (TurbulenceLoop * loop)
 	return max_fds;
 }
 
+/** 
+ * @internal Calls the read handler configured for the provided
+ * descriptor (or the loop default handler).
+ *
+ * @return axl_false if the descriptor must be removed from the watch
+ * set.
+ */
+axl_bool __turbulence_loop_notify (TurbulenceLoop * loop, TurbulenceLoopDescriptor * loop_descriptor)
+{
+	TurbulenceLoopOnRead       read_handler = NULL;
+	axlPointer                 ptr          = NULL;
+	axlPointer                 ptr2         = NULL;
+
+	/* configure the read handler to be used. If
+	   it is defined the default handler use it */
+	if (loop->on_read != NULL) {
+		read_handler = loop->on_read;
+		ptr          = loop->ptr;
+		ptr2         = loop->ptr2;
+	}
+	/* in the case a particular on read handler is
+	   defined, use it instead of default one */
+	if (loop_descriptor->on_read != NULL) {
+		read_handler = loop_descriptor->on_read;
+		ptr          = loop_descriptor->ptr;
+		ptr2         = loop_descriptor->ptr2;
+	}
+
+	/* call to notify descriptor (if no handler close descriptor to avoid infinite loops) */
+	if (read_handler == NULL)
+		return axl_false;
+	return read_handler (loop, loop->ctx, loop_descriptor->descriptor, ptr, ptr2);
+}
+
 void turbulence_loop_handle_descriptors (TurbulenceLoop * loop)
 {
 	TurbulenceLoopDescriptor * loop_descriptor;
-	TurbulenceLoopOnRead       read_handler;
-	axlPointer                 ptr;
-	axlPointer                 ptr2;
 
 	/* reset cursor */
 	axl_list_cursor_first (loop->cursor);
@@ -242,30 +927,8 @@ void turbulence_loop_handle_descriptors (TurbulenceLoop * loop)
 		loop_descriptor = axl_list_cursor_get (loop->cursor);
 
 		/* check if the loop descriptor is set */
-		if (__vortex_io_waiting_default_is_set (loop_descriptor->descriptor, loop->fileset, NULL)) {
-			/* reset handlers and user pointers */
-			read_handler = NULL;
-			ptr          = NULL;
-			ptr2         = NULL;
-
-			/* configure the read handler to be used. If
-			   it is defined the default handler use it */
-			if (loop->on_read != NULL) {
-				read_handler = loop->on_read;
-				ptr          = loop->ptr;
-				ptr2         = loop->ptr2;
-			}
-			/* in the case a particular on read handler is
-			   defined, use it instead of default one */
-			if (loop_descriptor->on_read != NULL) {
-				read_handler = loop_descriptor->on_read;
-				ptr          = loop_descriptor->ptr;
-				ptr2         = loop_descriptor->ptr2;
-			}
-
-			/* call to notify descriptor (if no handler close descriptor to avoid infinite loops) */
-			if (read_handler == NULL || 
-			    (! read_handler (loop, loop->ctx, loop_descriptor->descriptor, ptr, ptr2))) {
+		if (FD_ISSET (loop_descriptor->descriptor, &loop->read_set)) {
+			if (! __turbulence_loop_notify (loop, loop_descriptor)) {
 				/* function returned axl_false, remove
 				   descriptor from watch set */
 				axl_list_cursor_remove (loop->cursor);
@@ -273,6 +936,13 @@ void turbulence_loop_handle_descriptors (TurbulenceLoop * loop)
 			} /* end if */
 
 		} /* end if */
+
+		/* descriptor writable */
+		if (FD_ISSET (loop_descriptor->descriptor, &loop->write_set) &&
+		    ! __turbulence_loop_notify_write (loop, loop_descriptor)) {
+			axl_list_cursor_remove (loop->cursor);
+			continue;
+		} /* end if */
 		
 		/* get the next item */
 		axl_list_cursor_next (loop->cursor);
@@ -281,22 +951,115 @@ void turbulence_loop_handle_descriptors (TurbulenceLoop * loop)
 	return;
 }
 
+#if defined(TBC_LOOP_HAVE_EPOLL)
+/** 
+ * @internal epoll(7) based loop: only descriptors with content are
+ * returned, so each wakeup costs the number of descriptors ready
+ * rather the number watched, and there is no FD_SETSIZE limit.
+ */
+axlPointer __turbulence_loop_run_epoll (TurbulenceLoop * loop)
+{
+	struct epoll_event         events[TBC_LOOP_EPOLL_EVENTS];
+	TurbulenceLoopDescriptor * loop_descriptor;
+	int                        result;
+	int                        iterator;
+	int                        ready;
+	long                       wait;
+#if ! defined(SHOW_FORMAT_BUGS)
+	TurbulenceCtx            * ctx = loop->ctx;
+#endif
+
+wait_for_first_item:
+	if (! __turbulence_loop_read_first (loop))
+		return NULL;
+
+	while (axl_true) {
+		/* check if no descriptor must be watch */
+		if (axl_hash_items (loop->watched) == 0) {
+			msg ("no more loop descriptors found to be watched, putting thread to sleep");
+			goto wait_for_first_item;
+		} /* end if */
+
+		/* perform IO wait operation (up to next timer) */
+		wait   = __turbulence_loop_timers_wait (loop);
+		result = epoll_wait (loop->epoll_fd, events, TBC_LOOP_EPOLL_EVENTS, wait < 0 ? TBC_LOOP_EPOLL_TIMEOUT : wait);
+		if (result < 0 && errno != EINTR) {
+			error ("fatal error received from epoll_wait, errno=%d, finishing turbulence loop manager..", errno);
+			return NULL;
+		} /* end if */
+
+		/* call handlers only for descriptors ready */
+		iterator = 0;
+		while (iterator < result) {
+			loop_descriptor = events[iterator].data.ptr;
+			ready           = events[iterator].events;
+			iterator++;
+
+			/* wakeup pipe: pending registrations */
+			if (loop_descriptor == NULL) {
+				__turbulence_loop_wakeup_drain (loop);
+				continue;
+			} /* end if */
+
+			/* descriptor only watched for write: errors are
+			 * reported to the write handler */
+			if (loop_descriptor->write_only) {
+				if ((ready & (EPOLLOUT | EPOLLERR | EPOLLHUP)) &&
+				    ! __turbulence_loop_notify_write (loop, loop_descriptor))
+					__turbulence_loop_del (loop, loop_descriptor->descriptor);
+				continue;
+			} /* end if */
+
+			if ((ready & (EPOLLIN | EPOLLERR | EPOLLHUP)) && ! loop_descriptor->blocked &&
+			    ! __turbulence_loop_notify (loop, loop_descriptor)) {
+				/* function returned axl_false, remove
+				   descriptor from watch set */
+				__turbulence_loop_del (loop, loop_descriptor->descriptor);
+				continue;
+			} /* end if */
+
+			/* descriptor writable */
+			if (ready & EPOLLOUT)
+				__turbulence_loop_notify_write (loop, loop_descriptor);
+		} /* end while */
+
+		/* check for pending descriptors and stop the loop if
+		 * found a signal for this */
+		if (! __turbulence_loop_read_pending (loop))
+			return NULL;
+
+		/* call timers expired */
+		__turbulence_loop_timers_run (loop);
+	} /* end while */
+
+	return NULL;
+}
+#endif
+
 
 axlPointer __turbulence_loop_run (TurbulenceLoop * loop)
 {
 	int                       max_fds;
 	int                       result;
+	long                      wait;
+	struct timeval            timeout;
 #if ! defined(SHOW_FORMAT_BUGS)
 	TurbulenceCtx           * ctx = loop->ctx;
 #endif
 
-	/* init here list, its cursor, the fileset to watch fd for
-	 * changes and a queue to receive new registrations */
+	/* init here list and its cursor (the queue to receive new
+	 * registrations is created with the loop) */
 	loop->list    = axl_list_new (axl_list_always_return_1, __turbulence_loop_descriptor_free);
 	loop->cursor  = axl_list_cursor_new (loop->list);
 
-	/* force to use always default select(2) based implementation */
-	loop->fileset  = __vortex_io_waiting_default_create (turbulence_ctx_get_vortex_ctx (loop->ctx), READ_OPERATIONS);
+#if defined(TBC_LOOP_HAVE_EPOLL)
+	/* use epoll(7) when available */
+	if (loop->epoll_fd >= 0)
+		return __turbulence_loop_run_epoll (loop);
+#endif
+
+	/* otherwise, use select(2) watching descriptors for read
+	 * and, those with a write handler, for write */
 	
 	/* now loop watching content from the list */
 wait_for_first_item:
@@ -313,21 +1076,25 @@ wait_for_first_item:
 			goto wait_for_first_item;
 		} /* end if */
 		
-		/* perform IO wait operation */
-		result = __vortex_io_waiting_default_wait_on (loop->fileset, max_fds, READ_OPERATIONS);
+		/* perform IO wait operation (up to next timer) */
+		wait            = __turbulence_loop_timers_wait (loop);
+		if (wait < 0)
+			wait    = TBC_LOOP_EPOLL_TIMEOUT;
+		timeout.tv_sec  = wait / 1000;
+		timeout.tv_usec = (wait % 1000) * 1000;
+		result = select (max_fds + 1, &loop->read_set, &loop->write_set, NULL, &timeout);
 		
 		/* check for timeout and errors */
-		if (result == -1 || result == -2) {
+		if (result < 0) {
 			if (errno == EBADF) {
 				error ("error received from wait on operation, result=%d, errno=%d (discarding broken descriptors)", result, errno);
 				__turbulence_loop_discard_broken (ctx, loop);
+			} else if (errno != EINTR) {
+				error ("fatal error received from select, errno=%d, finishing turbulence loop manager..", errno);
+				return NULL;
 			} /* end if */
 
 			goto process_pending;
-		}
-		if (result == -3) {
-			error ("fatal error received from io-wait function, finishing turbulence loop manager..");
-			return NULL;
 		} /* end if */
 
 		/* transfer content found */
@@ -341,6 +1108,9 @@ wait_for_first_item:
 		 * found a signal for this */
 		if (! __turbulence_loop_read_pending (loop))
 			return NULL;
+
+		/* call timers expired */
+		__turbulence_loop_timers_run (loop);
 	} /* end if */
 	
 
@@ -354,19 +1124,61 @@ wait_for_first_item:
  */
 TurbulenceLoop * turbulence_loop_create (TurbulenceCtx * ctx)
 {
-	TurbulenceLoop * loop;
+	TurbulenceLoop     * loop;
+#if defined(TBC_LOOP_HAVE_EPOLL)
+	struct epoll_event   event;
+	int                  iterator;
+#endif
 
 	/* create loop instance */
 	loop              = axl_new (TurbulenceLoop, 1);
 	loop->ctx         = ctx;
 	loop->queue       = vortex_async_queue_new ();
+	loop->epoll_fd    = -1;
+	loop->wakeup[0]   = -1;
+	loop->wakeup[1]   = -1;
+
+	/* timers support */
+	vortex_mutex_create (&loop->timer_mutex);
+	loop->timers        = axl_hash_new (axl_hash_int, axl_hash_equal_int);
+	loop->timer_next_id = 1;
+	gettimeofday (&loop->timer_base, NULL);
+
+#if defined(TBC_LOOP_HAVE_EPOLL)
+	/* create epoll descriptor (if it fails, select(2) is used) */
+	loop->epoll_fd    = epoll_create (TBC_LOOP_EPOLL_EVENTS);
+	if (loop->epoll_fd < 0)
+		wrn ("unable to create epoll descriptor (errno=%d), loop will use select(2)", errno);
+	else {
+		fcntl (loop->epoll_fd, F_SETFD, fcntl (loop->epoll_fd, F_GETFD) | FD_CLOEXEC);
+		loop->watched = axl_hash_new (axl_hash_int, axl_hash_equal_int);
+
+		/* wakeup pipe, registered with a NULL descriptor */
+		if (pipe (loop->wakeup) == 0) {
+			iterator = 0;
+			while (iterator < 2) {
+				fcntl (loop->wakeup[iterator], F_SETFL, fcntl (loop->wakeup[iterator], F_GETFL) | O_NONBLOCK);
+				fcntl (loop->wakeup[iterator], F_SETFD, fcntl (loop->wakeup[iterator], F_GETFD) | FD_CLOEXEC);
+				iterator++;
+			} /* end while */
+			memset (&event, 0, sizeof (struct epoll_event));
+			event.events   = EPOLLIN;
+			event.data.ptr = NULL;
+			epoll_ctl (loop->epoll_fd, EPOLL_CTL_ADD, loop->wakeup[0], &event);
+		} else {
+			wrn ("unable to create loop wakeup pipe (errno=%d), registrations will be applied on timeout", errno);
+			loop->wakeup[0] = -1;
+			loop->wakeup[1] = -1;
+		} /* end if */
+	} /* end if */
+#endif
 
 	/* crear manager */
 	if (! vortex_thread_create (&loop->thread, 
 				    (VortexThreadFunc) __turbulence_loop_run,
 				    loop,
 				    VORTEX_THREAD_CONF_END)) {
-		axl_free (loop);
+		turbulence_loop_close (loop, axl_false);
 		error ("unable to start loop manager, checking clean start..");
 		return NULL;
 	} /* end if */
@@ -456,6 +1268,94 @@ void             turbulence_loop_watch_descriptor (TurbulenceLoop        * loop,
 
 	/* notify loop_descriptor */
 	vortex_async_queue_push (loop->queue, loop_descriptor);
+#if defined(TBC_LOOP_HAVE_EPOLL)
+	__turbulence_loop_wakeup (loop);
+#endif
+
+	return;
+}
+
+/** 
+ * @brief Allows to be notified when the provided descriptor can be
+ * written without blocking. The handler is called (from the loop
+ * thread) until it returns axl_false, which is usually done once all
+ * pending content was written.
+ *
+ * The descriptor is usually already watched (see \ref
+ * turbulence_loop_watch_descriptor). Otherwise, it is only watched for
+ * write until the handler returns axl_false, and it is not closed by
+ * the loop (it is still owned by the caller, who must unwatch it
+ * before closing it).
+ *
+ * @param loop The loop where the descriptor is watched.
+ *
+ * @param descriptor The descriptor to be notified when writable.
+ *
+ * @param on_write The on write handler to be executed.
+ *
+ * @param ptr The user defined pointer to be passed to the on write handler.
+ *
+ * @param ptr2 Second user defined pointer to be passed to the on write handler.
+ */
+void             turbulence_loop_watch_write (TurbulenceLoop        * loop,
+					      int                     descriptor,
+					      TurbulenceLoopOnWrite   on_write,
+					      axlPointer              ptr,
+					      axlPointer              ptr2)
+{
+	TurbulenceLoopDescriptor * loop_descriptor;
+
+	v_return_if_fail (loop && on_write);
+
+	/* build write request */
+	loop_descriptor = axl_new (TurbulenceLoopDescriptor, 1);
+	loop_descriptor->descriptor = descriptor; 
+	loop_descriptor->on_write   = on_write;
+	loop_descriptor->write_ptr  = ptr;
+	loop_descriptor->write_ptr2 = ptr2;
+	loop_descriptor->write      = axl_true;
+
+	/* notify loop_descriptor */
+	vortex_async_queue_push (loop->queue, loop_descriptor);
+#if defined(TBC_LOOP_HAVE_EPOLL)
+	__turbulence_loop_wakeup (loop);
+#endif
+
+	return;
+}
+
+/** 
+ * @brief Allows to stop (and resume) read notifications of a
+ * descriptor watched by the loop, without unwatching it. It is used
+ * to stop reading a descriptor while the content already read can't
+ * be written, resuming reads from a write handler (see \ref
+ * turbulence_loop_watch_write).
+ *
+ * @param loop The loop where the descriptor is watched.
+ *
+ * @param descriptor The descriptor to be blocked or unblocked.
+ *
+ * @param block axl_true to stop read notifications, axl_false to resume them.
+ */
+void             turbulence_loop_block_descriptor (TurbulenceLoop        * loop,
+						   int                     descriptor,
+						   axl_bool                block)
+{
+	TurbulenceLoopDescriptor * loop_descriptor;
+
+	v_return_if_fail (loop);
+
+	/* build block request */
+	loop_descriptor = axl_new (TurbulenceLoopDescriptor, 1);
+	loop_descriptor->descriptor = descriptor; 
+	loop_descriptor->blocked    = block;
+	loop_descriptor->block      = axl_true;
+
+	/* notify loop_descriptor */
+	vortex_async_queue_push (loop->queue, loop_descriptor);
+#if defined(TBC_LOOP_HAVE_EPOLL)
+	__turbulence_loop_wakeup (loop);
+#endif
 
 	return;
 }
@@ -497,6 +1397,9 @@ void             turbulence_loop_unwatch_descriptor (TurbulenceLoop        * loo
 
 	/* notify loop_descriptor */
 	vortex_async_queue_push (loop->queue, loop_descriptor);
+#if defined(TBC_LOOP_HAVE_EPOLL)
+	__turbulence_loop_wakeup (loop);
+#endif
 
 	if (queue && wait_until_unwatched) {
 		/* wait for reply */
@@ -507,6 +1410,139 @@ void             turbulence_loop_unwatch_descriptor (TurbulenceLoop        * loo
 	return;
 }
 
+/** 
+ * @brief Installs a timer on the provided loop. The handler is called
+ * from the loop thread (so it must not block) once the provided time
+ * has elapsed, and then every period for periodic timers (until the
+ * timer is cancelled or the handler returns axl_false). Timers have a
+ * resolution of 10 milliseconds.
+ *
+ * @param loop The loop where the timer will be installed.
+ *
+ * @param milliseconds Time to wait until the handler is called (and
+ * period for periodic timers).
+ *
+ * @param periodic axl_true to call the handler periodically, axl_false to call it once.
+ *
+ * @param on_timer The handler to be called.
+ *
+ * @param ptr The user defined pointer to be passed to the handler.
+ *
+ * @param ptr2 Second user defined pointer to be passed to the handler.
+ *
+ * @return The timer id (to be used with \ref turbulence_loop_cancel_timer) or -1 if it fails.
+ */
+int              turbulence_loop_add_timer (TurbulenceLoop        * loop,
+					    long                    milliseconds,
+					    axl_bool                periodic,
+					    TurbulenceLoopOnTimer   on_timer,
+					    axlPointer              ptr,
+					    axlPointer              ptr2)
+{
+	TurbulenceLoopTimer * timer;
+	long                  now;
+	axl_bool              wakeup;
+	int                   id;
+
+	v_return_val_if_fail (loop && on_timer && milliseconds >= 0, -1);
+
+	timer           = axl_new (TurbulenceLoopTimer, 1);
+	timer->period   = milliseconds / TBC_LOOP_TIMER_TICK;
+	if (timer->period < 1)
+		timer->period = 1;
+	timer->periodic = periodic;
+	timer->on_timer = on_timer;
+	timer->ptr      = ptr;
+	timer->ptr2     = ptr2;
+
+	vortex_mutex_lock (&loop->timer_mutex);
+	now = __turbulence_loop_timer_now (loop);
+
+	/* wake up the loop if it wasn't checking timers or it will
+	 * wait longer than this timer */
+	wakeup = (axl_hash_items (loop->timers) == 0) || (milliseconds < TBC_LOOP_EPOLL_TIMEOUT);
+	if (axl_hash_items (loop->timers) == 0)
+		loop->timer_tick = now;
+
+	/* register timer */
+	timer->id      = loop->timer_next_id++;
+	timer->expires = now + timer->period;
+	axl_hash_insert_full (loop->timers, INT_TO_PTR (timer->id), NULL, timer, axl_free);
+	__turbulence_loop_timer_insert (loop, timer);
+	id = timer->id;
+	vortex_mutex_unlock (&loop->timer_mutex);
+
+	if (wakeup) {
+		vortex_async_queue_push (loop->queue, INT_TO_PTR (TBC_LOOP_TIMER_WAKEUP));
+#if defined(TBC_LOOP_HAVE_EPOLL)
+		__turbulence_loop_wakeup (loop);
+#endif
+	} /* end if */
+
+	return id;
+}
+
+/** 
+ * @brief Cancels a timer installed with \ref turbulence_loop_add_timer.
+ *
+ * @param loop The loop where the timer was installed.
+ *
+ * @param timer_id The timer id to cancel.
+ *
+ * @return axl_true if the timer was cancelled, otherwise axl_false
+ * (already expired or not found). If the handler is running at the
+ * same time it is called, it is not called again.
+ */
+axl_bool         turbulence_loop_cancel_timer (TurbulenceLoop * loop,
+					       int              timer_id)
+{
+	TurbulenceLoopTimer * timer;
+
+	v_return_val_if_fail (loop, axl_false);
+
+	vortex_mutex_lock (&loop->timer_mutex);
+	timer = axl_hash_get (loop->timers, INT_TO_PTR (timer_id));
+	if (timer == NULL || timer->cancelled) {
+		vortex_mutex_unlock (&loop->timer_mutex);
+		return axl_false;
+	} /* end if */
+
+	if (timer->slot) {
+		/* remove from the wheel and release */
+		__turbulence_loop_timer_unlink (timer);
+		axl_hash_remove (loop->timers, INT_TO_PTR (timer_id));
+	} else {
+		/* timer is about to be called: flag it to be
+		 * released by the loop */
+		timer->cancelled = axl_true;
+	} /* end if */
+	vortex_mutex_unlock (&loop->timer_mutex);
+
+	return axl_true;
+}
+
+/** 
+ * @brief Allows to get the number of timers installed on the provided
+ * loop.
+ *
+ * @param loop The loop to check.
+ *
+ * @return The number of timers installed.
+ */
+int              turbulence_loop_timers (TurbulenceLoop * loop)
+{
+	int count;
+
+	if (loop == NULL)
+		return 0;
+
+	vortex_mutex_lock (&loop->timer_mutex);
+	count = axl_hash_items (loop->timers);
+	vortex_mutex_unlock (&loop->timer_mutex);
+
+	return count;
+}
+
 /** 
  * @brief Allows to get how many descriptors are being watched on the
  * provided loop.
@@ -520,7 +1556,7 @@ int              turbulence_loop_watching (TurbulenceLoop * loop)
 	if (loop == NULL)
 		return 0;
 	/* return the current count */
-	return axl_list_length (loop->list);
+	return __turbulence_loop_count (loop);
 }
 
 /** 
@@ -540,6 +1576,9 @@ void             turbulence_loop_close (TurbulenceLoop * loop, axl_bool notify)
 	/* now finish log manager */
 	if (notify && loop->queue != NULL) {
 		vortex_async_queue_push (loop->queue, INT_TO_PTR (-4));
+#if defined(TBC_LOOP_HAVE_EPOLL)
+		__turbulence_loop_wakeup (loop);
+#endif
 		vortex_thread_destroy (&loop->thread, axl_false);
 	} /* end if */	
 	
@@ -552,8 +1591,23 @@ void             turbulence_loop_close (TurbulenceLoop * loop, axl_bool notify)
 	vortex_async_queue_unref (loop->queue);
 	loop->queue = NULL;
 
-	__vortex_io_waiting_default_destroy (loop->fileset);
-	loop->fileset = NULL;
+	if (loop->watched)
+		axl_hash_free (loop->watched);
+	loop->watched = NULL;
+
+	/* release timers */
+	axl_hash_free (loop->timers);
+	loop->timers = NULL;
+	vortex_mutex_destroy (&loop->timer_mutex);
+
+	if (loop->epoll_fd >= 0)
+		close (loop->epoll_fd);
+	loop->epoll_fd = -1;
+
+	if (loop->wakeup[0] >= 0) {
+		close (loop->wakeup[0]);
+		close (loop->wakeup[1]);
+	} /* end if */
 
 	axl_free (loop);
 
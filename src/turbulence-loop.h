@@ -59,12 +59,34 @@ void             turbulence_loop_watch_descriptor (TurbulenceLoop        * loop,
 						   axlPointer              ptr,
 						   axlPointer              ptr2);
 
+void             turbulence_loop_watch_write (TurbulenceLoop        * loop,
+					      int                     descriptor,
+					      TurbulenceLoopOnWrite   on_write,
+					      axlPointer              ptr,
+					      axlPointer              ptr2);
+
+void             turbulence_loop_block_descriptor (TurbulenceLoop        * loop,
+						   int                     descriptor,
+						   axl_bool                block);
+
 void             turbulence_loop_unwatch_descriptor (TurbulenceLoop        * loop,
 						     int                     descriptor,
 						     axl_bool                wait_until_unwatched);
 
 int              turbulence_loop_watching (TurbulenceLoop * loop);
 
+int              turbulence_loop_add_timer (TurbulenceLoop        * loop,
+					    long                    milliseconds,
+					    axl_bool                periodic,
+					    TurbulenceLoopOnTimer   on_timer,
+					    axlPointer              ptr,
+					    axlPointer              ptr2);
+
+axl_bool         turbulence_loop_cancel_timer (TurbulenceLoop * loop,
+					       int              timer_id);
+
+int              turbulence_loop_timers (TurbulenceLoop * loop);
+
 void             turbulence_loop_close (TurbulenceLoop * loop, 
 					 axl_bool        notify);
 
@@ -442,6 +442,48 @@ TurbulenceModule           * turbulence_module_open_and_register (TurbulenceCtx
 	return module;
 }
 
+/** 
+ * @internal Maps the module located at the provided location without
+ * calling to its init function or registering it. The module is kept
+ * mapped so a later call to \ref turbulence_module_open_and_register
+ * (i.e. from a child created by the zygote process) finds it already
+ * loaded.
+ *
+ * @param ctx The context where the preload operation will take place.
+ * @param location The location where the module is found.
+ *
+ * @return axl_true if the module was mapped, otherwise axl_false.
+ */
+axl_bool           turbulence_module_preload (TurbulenceCtx * ctx, const char * location)
+{
+	TurbulenceModule * module;
+
+	if (ctx == NULL || location == NULL)
+		return axl_false;
+
+	/* map the module */
+	module = turbulence_module_open (ctx, location);
+	if (module == NULL) {
+		wrn ("unable to preload module: %s", location);
+		return axl_false;
+	} /* end if */
+
+	/* check module name */
+	if (! turbulence_run_check_no_load_module (ctx, turbulence_module_name (module))) {
+		wrn ("module %s skipped by plugin name", turbulence_module_name (module));
+		turbulence_module_free (module);
+		return axl_false;
+	} /* end if */
+
+	msg ("module preloaded: %s", location);
+
+	/* release the object but keep the module mapped */
+	module->skip_unmap = axl_true;
+	turbulence_module_free (module);
+
+	return axl_true;
+}
+
 /** 
  * @brief Allows to mark a module to not be unmapped when module is
  * closed.
@@ -109,16 +109,56 @@ typedef struct _TurbulencePPathState {
 
 	/* turbulence context */
 	TurbulenceCtx      * ctx;
+
+	/* channel start decisions memoized for the profile path and
+	 * profiles version (see __turbulence_conn_mgr_profiles_version)
+	 * they were taken with: key -> decision + 1 */
+	VortexMutex          mutex;
+	axlHash            * decisions;
+	TurbulencePPathDef * decisions_def;
+	int                  decisions_version;
+
+	/* set of active profiles: bit if_index is set if a profile
+	 * running on the connection matches that <if-success> item */
+	unsigned char      * active;
 } TurbulencePPathState;
 
+/** 
+ * @internal Max number of channel start decisions memoized per
+ * connection before dropping them.
+ */
+#define TBC_PPATH_DECISIONS_SIZE 64
+
+/** 
+ * @internal Checks if the <if-success> item has a profile running on
+ * the connection according to the set of active profiles.
+ */
+#define TBC_PPATH_ACTIVE(active, item) ((active)[(item)->if_index / 8] & (1 << ((item)->if_index % 8)))
+
+TurbulencePPathState * __turbulence_ppath_state_new (void)
+{
+	TurbulencePPathState * state = axl_new (TurbulencePPathState, 1);
+
+	if (state != NULL)
+		vortex_mutex_create (&state->mutex);
+	return state;
+}
+
 void __turbulence_ppath_state_free (axlPointer _state) {
 	TurbulencePPathState * state = _state;
 
 	if (state == NULL)
 		return;
 
+	/* release profile path selected */
+	__turbulence_ppath_unref (state->ctx, state->path_selected);
+
 	/* release allocation */
 	axl_free (state->requested_serverName);
+	if (state->decisions)
+		axl_hash_free (state->decisions);
+	axl_free (state->active);
+	vortex_mutex_destroy (&state->mutex);
 
 	/* clear references */
 	state->requested_serverName = NULL;
@@ -130,12 +170,307 @@ void __turbulence_ppath_state_free (axlPointer _state) {
 	return;
 }
 
+/** 
+ * @internal Max number of (src, dst, serverName) tuples remembered by
+ * the profile path selection cache.
+ */
+#define TBC_PPATH_CACHE_SIZE 4096
+
+typedef struct _TurbulencePPathCacheEntry TurbulencePPathCacheEntry;
+struct _TurbulencePPathCacheEntry {
+	/* "src|dst|serverName" */
+	char                      * key;
+	/* profile path selected (NULL: connection rejected) */
+	TurbulencePPathDef        * def;
+	/* LRU list: head is the most recently used */
+	TurbulencePPathCacheEntry * prev;
+	TurbulencePPathCacheEntry * next;
+};
+
 struct _TurbulencePPath {
 	/* list of profile paths found */
 	TurbulencePPathDef ** items;
-	
+
+	/* selection index: literal serverName -> NULL terminated
+	 * array with the profile paths that can match it (the ones
+	 * declaring that serverName plus the ones with a wildcard or
+	 * no serverName), in declaration order */
+	axlHash             * by_serverName;
+
+	/* profile paths checked when the serverName requested has no
+	 * entry in by_serverName */
+	TurbulencePPathDef ** generic;
+
+	/* selection cache: key -> TurbulencePPathCacheEntry */
+	VortexMutex                 cache_mutex;
+	axlHash                   * cache;
+	TurbulencePPathCacheEntry * cache_head;
+	TurbulencePPathCacheEntry * cache_tail;
+	/* increased on each flush so results computed before it are
+	 * not stored */
+	int                         cache_generation;
+	volatile int                cache_hits;
+	volatile int                cache_misses;
+
+	/* configuration document loaded by turbulence_ppath_reload
+	 * that definitions point to (NULL for the table loaded at
+	 * startup, which uses ctx->config) */
+	axlDoc                    * doc;
+
+	/* all profile paths can be selected at connection accept */
+	axl_bool                    all_rules_address_based;
+
+	/* references held by ctx->paths, connection states, childs,
+	 * spare pools and selections running (protected by
+	 * ctx->ppath_mutex). The table is released when it reaches 0 */
+	int                         refs;
+
+	/* next table replaced by turbulence_ppath_reload and still
+	 * referenced (protected by ctx->ppath_mutex) */
+	TurbulencePPath           * retired;
 };
 
+void __turbulence_ppath_free_paths (TurbulenceCtx * ctx, TurbulencePPath * paths);
+
+/** 
+ * @internal Returns the current profile path table with a reference
+ * acquired, which must be released with
+ * __turbulence_ppath_table_unref.
+ */
+TurbulencePPath * __turbulence_ppath_table_current (TurbulenceCtx * ctx)
+{
+	TurbulencePPath * paths;
+
+	vortex_mutex_lock (&ctx->ppath_mutex);
+	paths = ctx->paths;
+	if (paths != NULL)
+		paths->refs++;
+	vortex_mutex_unlock (&ctx->ppath_mutex);
+
+	return paths;
+}
+
+/** 
+ * @internal Releases a reference to the provided profile path
+ * table. Once the last one is released the table is removed from the
+ * replaced tables chain and deallocated along with its configuration
+ * document.
+ */
+void __turbulence_ppath_table_unref (TurbulenceCtx * ctx, TurbulencePPath * paths)
+{
+	TurbulencePPath * iterator;
+
+	if (ctx == NULL || paths == NULL)
+		return;
+
+	vortex_mutex_lock (&ctx->ppath_mutex);
+	paths->refs--;
+	if (paths->refs > 0) {
+		vortex_mutex_unlock (&ctx->ppath_mutex);
+		return;
+	} /* end if */
+
+	/* unlink from replaced tables */
+	iterator = ctx->paths;
+	while (iterator != NULL) {
+		if (iterator->retired == paths) {
+			iterator->retired = paths->retired;
+			break;
+		} /* end if */
+		iterator = iterator->retired;
+	} /* end while */
+	vortex_mutex_unlock (&ctx->ppath_mutex);
+
+	msg ("releasing profile path table (first profile path id: %d), no more references", 
+	     paths->items[0] ? paths->items[0]->id : -1);
+	__turbulence_ppath_free_paths (ctx, paths);
+	return;
+}
+
+/** 
+ * @internal Acquires a reference to the table holding the provided
+ * profile path so it isn't released by turbulence_ppath_reload while
+ * the definition is in use.
+ *
+ * @param ctx The context where the profile path was loaded.
+ * @param def The profile path definition (NULL is ignored).
+ */
+void __turbulence_ppath_ref (TurbulenceCtx * ctx, TurbulencePPathDef * def)
+{
+	if (ctx == NULL || def == NULL || def->paths == NULL)
+		return;
+
+	vortex_mutex_lock (&ctx->ppath_mutex);
+	def->paths->refs++;
+	vortex_mutex_unlock (&ctx->ppath_mutex);
+	return;
+}
+
+/** 
+ * @internal Releases a reference acquired with
+ * __turbulence_ppath_ref.
+ *
+ * @param ctx The context where the profile path was loaded.
+ * @param def The profile path definition (NULL is ignored).
+ */
+void __turbulence_ppath_unref (TurbulenceCtx * ctx, TurbulencePPathDef * def)
+{
+	if (def == NULL)
+		return;
+	__turbulence_ppath_table_unref (ctx, def->paths);
+	return;
+}
+
+/** 
+ * @internal Sets the profile path selected on the connection state
+ * holding a reference to it. Decisions memoized for the previous
+ * profile path are dropped.
+ */
+void __turbulence_ppath_state_select (TurbulencePPathState * state, TurbulencePPathDef * def)
+{
+	TurbulencePPathDef * previous = state->path_selected;
+
+	if (previous == def)
+		return;
+
+	__turbulence_ppath_ref (state->ctx, def);
+	vortex_mutex_lock (&state->mutex);
+	state->path_selected = def;
+	if (state->decisions)
+		axl_hash_free (state->decisions);
+	state->decisions     = NULL;
+	state->decisions_def = NULL;
+	vortex_mutex_unlock (&state->mutex);
+	__turbulence_ppath_unref (state->ctx, previous);
+
+	return;
+}
+
+/** 
+ * @internal Unlinks the entry from the LRU list (cache_mutex locked).
+ */
+void __turbulence_ppath_cache_unlink (TurbulencePPath * paths, TurbulencePPathCacheEntry * entry)
+{
+	if (entry->prev)
+		entry->prev->next = entry->next;
+	else
+		paths->cache_head = entry->next;
+	if (entry->next)
+		entry->next->prev = entry->prev;
+	else
+		paths->cache_tail = entry->prev;
+	entry->prev = NULL;
+	entry->next = NULL;
+	return;
+}
+
+/** 
+ * @internal Drops all cache entries (cache_mutex locked).
+ */
+void __turbulence_ppath_cache_clear (TurbulencePPath * paths)
+{
+	TurbulencePPathCacheEntry * entry;
+
+	while (paths->cache_head) {
+		entry             = paths->cache_head;
+		paths->cache_head = entry->next;
+		axl_free (entry->key);
+		axl_free (entry);
+	} /* end while */
+	paths->cache_tail = NULL;
+
+	/* keys are owned by entries */
+	axl_hash_free (paths->cache);
+	paths->cache = axl_hash_new (axl_hash_string, axl_hash_equal_string);
+	return;
+}
+
+/** 
+ * @internal Looks up the selection cached for the provided key.
+ *
+ * @param def Where the profile path cached is reported (NULL if the
+ * tuple was rejected).
+ *
+ * @param generation Where the cache generation is reported to be
+ * passed to __turbulence_ppath_cache_put on miss.
+ *
+ * @return axl_true on hit, otherwise axl_false.
+ */
+axl_bool __turbulence_ppath_cache_get (TurbulencePPath     * paths, 
+				       const char          * key, 
+				       TurbulencePPathDef ** def,
+				       int                 * generation)
+{
+	TurbulencePPathCacheEntry * entry;
+
+	vortex_mutex_lock (&paths->cache_mutex);
+	(* generation) = paths->cache_generation;
+	entry          = axl_hash_get (paths->cache, (axlPointer) key);
+	if (entry == NULL) {
+		paths->cache_misses++;
+		vortex_mutex_unlock (&paths->cache_mutex);
+		return axl_false;
+	} /* end if */
+
+	/* move to the head */
+	if (entry != paths->cache_head) {
+		__turbulence_ppath_cache_unlink (paths, entry);
+		entry->next = paths->cache_head;
+		paths->cache_head->prev = entry;
+		paths->cache_head = entry;
+	} /* end if */
+	paths->cache_hits++;
+	(* def) = entry->def;
+	vortex_mutex_unlock (&paths->cache_mutex);
+
+	return axl_true;
+}
+
+/** 
+ * @internal Stores the selection done for the provided key (which is
+ * owned by the cache after this call), evicting the least recently
+ * used entry when the cache is full.
+ */
+void __turbulence_ppath_cache_put (TurbulencePPath    * paths, 
+				   char               * key, 
+				   TurbulencePPathDef * def,
+				   int                  generation)
+{
+	TurbulencePPathCacheEntry * entry;
+
+	vortex_mutex_lock (&paths->cache_mutex);
+	if (generation != paths->cache_generation || axl_hash_exists (paths->cache, key)) {
+		/* flushed while selecting or already stored by another
+		 * thread */
+		vortex_mutex_unlock (&paths->cache_mutex);
+		axl_free (key);
+		return;
+	} /* end if */
+
+	/* evict least recently used */
+	if (axl_hash_items (paths->cache) >= TBC_PPATH_CACHE_SIZE) {
+		entry = paths->cache_tail;
+		__turbulence_ppath_cache_unlink (paths, entry);
+		axl_hash_remove (paths->cache, entry->key);
+		axl_free (entry->key);
+		axl_free (entry);
+	} /* end if */
+
+	entry       = axl_new (TurbulencePPathCacheEntry, 1);
+	entry->key  = key;
+	entry->def  = def;
+	entry->next = paths->cache_head;
+	if (paths->cache_head)
+		paths->cache_head->prev = entry;
+	paths->cache_head = entry;
+	if (paths->cache_tail == NULL)
+		paths->cache_tail = entry;
+	axl_hash_insert (paths->cache, entry->key, entry);
+	vortex_mutex_unlock (&paths->cache_mutex);
+
+	return;
+}
+
 TurbulencePPathItem * __turbulence_ppath_get_item (TurbulenceCtx * ctx, axlNode * node)
 {
 	axlNode             * child;
@@ -211,6 +546,7 @@ int  __turbulence_ppath_mask_items (TurbulenceCtx        * ctx,
 				    int                    channel_num,
 				    VortexConnection     * connection,
 				    const char           * profile_content, 
+				    const unsigned char  * active,
 				    int                    level)
 {
 	int                   iterator;
@@ -349,6 +685,26 @@ int  __turbulence_ppath_mask_items (TurbulenceCtx        * ctx,
 				msg2 ("  <if-success level=%d>: profile alias %s => %s not found", 
 				      level, profile_alias, turbulence_expr_get_expression (item->profile));
 			} /* end if */
+
+			/* check the set of active profiles if available
+			 * rather than matching every profile running */
+			if (active != NULL) {
+				if (TBC_PPATH_ACTIVE (active, item) && 
+				    (item->connmark == NULL || vortex_connection_get_data (connection, item->connmark))) {
+					msg2 ("  <if-success level=%d>: profile running matches %s (active profiles set)", 
+					      level, turbulence_expr_get_expression (item->profile));
+					if (! __turbulence_ppath_mask_items (ctx, 
+									     item->ppath_items, 
+									     state, uri, serverName, channel_num, connection, profile_content, active, level + 1)) {
+						/* profile allowed, do not filter */
+						return axl_false;
+					} /* end if */
+				} /* end if */
+
+				/* next item to process */
+				iterator++;
+				continue;
+			} /* end if */
 		
 			/* get current profiles running on the connection */
 			profiles = turbulence_conn_mgr_profiles_stats (ctx, connection);
@@ -389,7 +745,7 @@ int  __turbulence_ppath_mask_items (TurbulenceCtx        * ctx,
 				match_by_alias:
 					if (! __turbulence_ppath_mask_items (ctx, 
 									     item->ppath_items, 
-									     state, uri, serverName, channel_num, connection, profile_content, level + 1)) {
+									     state, uri, serverName, channel_num, connection, profile_content, active, level + 1)) {
 						/* profile allowed, do not filter */
 						axl_hash_cursor_free (profiles);
 						return axl_false;
@@ -414,6 +770,122 @@ int  __turbulence_ppath_mask_items (TurbulenceCtx        * ctx,
 	return axl_true;
 }
 
+/** 
+ * @internal Updates the set of active profiles with the profiles
+ * running on the connection (state->mutex locked).
+ */
+void __turbulence_ppath_mask_active (TurbulenceCtx        * ctx,
+				     TurbulencePPathState * state,
+				     VortexConnection     * connection)
+{
+	TurbulencePPathDef * def = state->path_selected;
+	axlHashCursor      * profiles;
+	const char         * uri;
+	int                  iterator;
+
+	axl_free (state->active);
+	state->active = axl_new (unsigned char, def->if_count / 8 + 1);
+
+	profiles = turbulence_conn_mgr_profiles_stats (ctx, connection);
+	if (profiles == NULL)
+		return;
+	axl_hash_cursor_first (profiles);
+	while (axl_hash_cursor_has_item (profiles)) {
+		uri = axl_hash_cursor_get_key (profiles);
+		for (iterator = 0; iterator < def->if_count; iterator++) {
+			if (turbulence_expr_match (def->if_items[iterator]->profile, uri))
+				state->active[iterator / 8] |= (1 << (iterator % 8));
+		} /* end for */
+		axl_hash_cursor_next (profiles);
+	} /* end while */
+	axl_hash_cursor_free (profiles);
+
+	return;
+}
+
+/** 
+ * @internal Runs __turbulence_ppath_mask_items memoizing its decision
+ * per connection. Decisions depend on the profile requested, the
+ * serverName, connection marks (connmark, preconnmark and profile
+ * aliases) and the channels running. Marks are part of the key and
+ * decisions are dropped when a channel is added or removed, so
+ * channel starts repeated by the peer do not evaluate the profile
+ * path again.
+ */
+int  __turbulence_ppath_mask_memo (TurbulenceCtx        * ctx,
+				   TurbulencePPathState * state,
+				   const char           * uri, 
+				   const char           * serverName,
+				   int                    channel_num,
+				   VortexConnection     * connection,
+				   const char           * profile_content)
+{
+	TurbulencePPathDef * def = state->path_selected;
+	int                  version;
+	int                  result;
+	int                  iterator;
+	int                  length;
+	char               * marks;
+	char               * key;
+	const char         * profile_alias;
+
+	/* connection not registered: nothing to invalidate
+	 * decisions */
+	version = __turbulence_conn_mgr_profiles_version (ctx, connection);
+	if (version < 0 || uri == NULL) {
+		return __turbulence_ppath_mask_items (ctx, def->ppath_items, state, uri, serverName, 
+						      channel_num, connection, profile_content, NULL, 1);
+	} /* end if */
+
+	/* build marks status */
+	length = 0;
+	while (def->marks[length])
+		length++;
+	marks = axl_new (char, length + def->if_count + 1);
+	for (iterator = 0; iterator < length; iterator++)
+		marks[iterator] = vortex_connection_get_data (connection, def->marks[iterator]) ? '1' : '0';
+	for (iterator = 0; iterator < def->if_count; iterator++) {
+		profile_alias = axl_hash_get (ctx->profile_attr_alias, 
+					      (axlPointer) turbulence_expr_get_expression (def->if_items[iterator]->profile));
+		if (profile_alias == NULL)
+			marks[length + iterator] = '-';
+		else
+			marks[length + iterator] = PTR_TO_INT (vortex_connection_get_data (connection, profile_alias)) > 0 ? '1' : '0';
+	} /* end for */
+	key = axl_strdup_printf ("%d\n%s\n%s\n%s", channel_num > 0, uri, 
+				 (channel_num > 0 && serverName) ? serverName : "", marks);
+	axl_free (marks);
+
+	vortex_mutex_lock (&state->mutex);
+
+	/* drop decisions taken with other channels running */
+	if (state->decisions == NULL || state->decisions_def != def || state->decisions_version != version ||
+	    axl_hash_items (state->decisions) >= TBC_PPATH_DECISIONS_SIZE) {
+		if (state->decisions)
+			axl_hash_free (state->decisions);
+		state->decisions         = axl_hash_new (axl_hash_string, axl_hash_equal_string);
+		state->decisions_def     = def;
+		state->decisions_version = version;
+		__turbulence_ppath_mask_active (ctx, state, connection);
+	} /* end if */
+
+	result = PTR_TO_INT (axl_hash_get (state->decisions, key));
+	if (result > 0) {
+		vortex_mutex_unlock (&state->mutex);
+		msg2 ("  Profile path [%s] decision memoized for profile=%s: %d", 
+		      turbulence_ppath_get_name (def), uri, result - 1);
+		axl_free (key);
+		return result - 1;
+	} /* end if */
+
+	result = __turbulence_ppath_mask_items (ctx, def->ppath_items, state, uri, serverName, 
+						channel_num, connection, profile_content, state->active, 1);
+	axl_hash_insert_full (state->decisions, key, axl_free, INT_TO_PTR (result + 1), NULL);
+	vortex_mutex_unlock (&state->mutex);
+
+	return result;
+}
+
 /** 
  * @internal Mask function that allows to control how profiles are
  * handled and sequenced by the client according to the state of the
@@ -475,9 +947,7 @@ axl_bool  __turbulence_ppath_mask (VortexConnection  * connection,
 
 	/* check if the profile provided is found in the <allow> or
 	 * <if-success> configuration */
-	if (! __turbulence_ppath_mask_items (ctx, 
-					     state->path_selected->ppath_items, 
-					     state, uri, serverName, channel_num, connection, profile_content, 1)) {
+	if (! __turbulence_ppath_mask_memo (ctx, state, uri, serverName, channel_num, connection, profile_content)) {
 
 		/* only drop a message if the channel number have a
 		 * valid value. Profile mask is also executed at
@@ -665,7 +1135,7 @@ void __turbulence_ppath_still_not_selected (TurbulenceCtx * ctx, VortexConnectio
 	TurbulencePPathState * state;
 
 	/* create state object */
-	state                = axl_new (TurbulencePPathState, 1);
+	state                = __turbulence_ppath_state_new ();
 	if (state == NULL)
 		return;
 
@@ -681,6 +1151,73 @@ void __turbulence_ppath_still_not_selected (TurbulenceCtx * ctx, VortexConnectio
 	return;
 }
 	
+/** 
+ * @internal Finds the first profile path matching the provided
+ * connection values.
+ *
+ * @return The profile path found or NULL if none matches.
+ */
+TurbulencePPathDef * __turbulence_ppath_find (TurbulenceCtx      * ctx, 
+					      TurbulencePPath    * paths,
+					      VortexConnection   * connection,
+					      const char         * src,
+					      const char         * dst,
+					      const char         * serverName)
+{
+	TurbulencePPathDef   * def = NULL;
+	TurbulencePPathDef  ** candidates = NULL;
+	int                    iterator;
+	axl_bool               src_status;
+	axl_bool               dst_status;
+	axl_bool               serverName_status;
+
+	/* get candidate profile paths from the selection index:
+	 * profile paths declaring another literal serverName can't
+	 * match so they are skipped */
+	if (serverName && serverName[0] && paths->by_serverName)
+		candidates = axl_hash_get (paths->by_serverName, (axlPointer) serverName);
+	if (candidates == NULL)
+		candidates = paths->generic;
+
+	iterator = 0;
+	msg ("Checking profile path match for conn-id=%d, requested serverName=%s", 
+	     vortex_connection_get_id (connection), serverName && serverName[0] ? serverName : "''");
+	while (candidates[iterator] != NULL) {
+		/* get the profile path def */
+		def = candidates[iterator];
+
+		/* get src status */
+		src_status        = __turbulence_ppath_handle_connection_match_src (connection, def->src, src);
+
+		/* get dst status */
+		dst_status        = __turbulence_ppath_handle_connection_match_src (connection, def->dst, dst);
+
+		/* get serverName status */
+		serverName_status = __turbulence_ppath_handle_connection_match_src (connection, def->serverName, serverName);
+
+		/* match found */
+		if (src_status && dst_status && serverName_status) {
+			msg ("MATCH: profile path found, setting default state: %s, connection id=%d, src=%s local_addr=%s serverName=%s ", 
+			     def->path_name ? def->path_name : "(no path name defined)",
+			     vortex_connection_get_id (connection), src, dst, serverName ? serverName : "");
+			break;
+		} else {
+			/* show profile path not mached */
+			msg2 ("profile path do not match: %s, for connection id=%d, src=%s local_addr=%s serverName='%s' (src_status:%d, dst_status:%d, serverName_status:%d) ", 
+			      def->path_name ? def->path_name : "(no path name defined)",
+			      vortex_connection_get_id (connection), src, dst, serverName ? serverName : "",
+			      src_status, dst_status, serverName_status);
+		} /* end if */
+
+		/* next profile path definition */
+		iterator++;
+		def = NULL;
+
+	} /* end while */
+
+	return def;
+}
+
 /** 
  * @internal Function that allows to select a profile path for a
  * connection. The variable on_connect signals if the connection
@@ -710,12 +1247,17 @@ axl_bool __turbulence_ppath_select (TurbulenceCtx      * ctx,
 	/* get turbulence context */
 	TurbulencePPathState * state;
 	TurbulencePPathDef   * def = NULL;
-	int                    iterator;
 	const char           * src;
 	const char           * dst;
-	axl_bool               src_status;
-	axl_bool               dst_status;
-	axl_bool               serverName_status;
+	char                 * key;
+	int                    generation;
+	/* get the table once (with a reference acquired):
+	 * turbulence_ppath_reload may publish a new one while this
+	 * selection (and child creation) is running */
+	TurbulencePPath      * paths = __turbulence_ppath_table_current (ctx);
+
+	if (paths == NULL)
+		return axl_false;
 
 	if (on_connect) {
 		/* called to select profile path at connection time:
@@ -723,67 +1265,38 @@ axl_bool __turbulence_ppath_select (TurbulenceCtx      * ctx,
 		   only select if all profile path references to src=
 		   and dst= */
 		msg ("Profile path selection called at <on connect> (before any BEEP exchange) signaled and all_rules_address_based:%d", 
-		     ctx->all_rules_address_based);
-		if (! ctx->all_rules_address_based)  {
+		     paths->all_rules_address_based);
+		if (! paths->all_rules_address_based)  {
 			/* configure a profile mask to select an appropriate ppath state in the next channel
 			   start request where the remote BEEP peer has a chance to select a serverName value */
 			__turbulence_ppath_still_not_selected (ctx, connection);
 
+			__turbulence_ppath_table_unref (ctx, paths);
 			return axl_true; /* signal no profile path still selected */
 		} /* end if */
 	} /* end if */
 
 	/* try to find a profile path that match with the provided
-	 * source */
-	iterator = 0;
+	 * source, checking first selections cached */
 	src      = vortex_connection_get_host (connection);
 	dst      = vortex_connection_get_local_addr (connection);
-	msg ("Checking: %-30s %-30s Profile path match for conn-id=%d", "Ppath. serveName", "requested serverName", 
-	     vortex_connection_get_id (connection));
-	while (ctx->paths->items[iterator] != NULL) {
-		/* get the profile path def */
-		def = ctx->paths->items[iterator];
-
-		msg ("checking: %-30s %-30s %s",
-		     def->serverName ? __TBC_EXP_STR__(def->serverName) : "''",
-		     serverName && strlen (serverName) > 0 ? serverName : "''",
-		     def->path_name  ? def->path_name : "(no path name defined)");
-		     
-
-		/* get src status */
-		src_status        = __turbulence_ppath_handle_connection_match_src (connection, def->src, src);
-
-		/* get dst status */
-		dst_status        = __turbulence_ppath_handle_connection_match_src (connection, def->dst, dst);
-
-		/* get serverName status */
-		serverName_status = __turbulence_ppath_handle_connection_match_src (connection, def->serverName, serverName);
-
-		/* match found */
-		if (src_status && dst_status && serverName_status) {
-			msg ("MATCH: profile path found, setting default state: %s, connection id=%d, src=%s local_addr=%s serverName=%s ", 
-			     def->path_name ? def->path_name : "(no path name defined)",
-			     vortex_connection_get_id (connection), src, dst, serverName ? serverName : "");
-			break;
-		} else {
-			/* show profile path not mached */
-			msg2 ("profile path do not match: %s, for connection id=%d, src=%s local_addr=%s serverName='%s' (src_status:%d, dst_status:%d, serverName_status:%d) ", 
-			      def->path_name ? def->path_name : "(no path name defined)",
-			      vortex_connection_get_id (connection), src, dst, serverName ? serverName : "",
-			      src_status, dst_status, serverName_status);
-		} /* end if */
-
-		/* next profile path definition */
-		iterator++;
-		def = NULL;
-
-	} /* end while */
+	key      = axl_strdup_printf ("%s|%s|%s", src ? src : "", dst ? dst : "", serverName ? serverName : "");
+	if (__turbulence_ppath_cache_get (paths, key, &def, &generation)) {
+		msg ("profile path selection cached: %s, connection id=%d, src=%s local_addr=%s serverName=%s",
+		     def && def->path_name ? def->path_name : "(none)",
+		     vortex_connection_get_id (connection), src, dst, serverName ? serverName : "");
+		axl_free (key);
+	} else {
+		def = __turbulence_ppath_find (ctx, paths, connection, src, dst, serverName);
+		__turbulence_ppath_cache_put (paths, key, def, generation);
+	} /* end if */
 	
 	if (def == NULL) {
 		/* no profile path def was found, rejecting
 		 * connection */
 		error ("no profile path def match, rejecting connection: id=%d, src=%s", 
 		       vortex_connection_get_id (connection), src);
+		__turbulence_ppath_table_unref (ctx, paths);
 		return axl_false;
 	} /* end if */
 
@@ -793,6 +1306,7 @@ axl_bool __turbulence_ppath_select (TurbulenceCtx      * ctx,
 			/* configure a profile mask to select an appropriate ppath state in the next channel
 			   start request where the remote BEEP peer has a chance to select a serverName value */
 			__turbulence_ppath_still_not_selected (ctx, connection);
+			__turbulence_ppath_table_unref (ctx, paths);
 			return axl_true;
 		} /* end if */
 	} /* end if */
@@ -801,12 +1315,12 @@ axl_bool __turbulence_ppath_select (TurbulenceCtx      * ctx,
 	   state created */
 	state  = vortex_connection_get_data (connection, TURBULENCE_PPATH_STATE);
 	if (state != NULL) {
-		state->path_selected = def;
+		__turbulence_ppath_state_select (state, def);
 	} else {
 		/* create and store */
-		state                = axl_new (TurbulencePPathState, 1);
-		state->path_selected = def;
+		state                = __turbulence_ppath_state_new ();
 		state->ctx           = ctx;
+		__turbulence_ppath_state_select (state, def);
 		vortex_connection_set_data_full (connection, 
 						 /* the key and its associated value */
 						 TURBULENCE_PPATH_STATE, state,
@@ -858,7 +1372,8 @@ axl_bool __turbulence_ppath_select (TurbulenceCtx      * ctx,
 		}
 
 	} /* end if */
-	
+
+	__turbulence_ppath_table_unref (ctx, paths);
 	return axl_true;
 }
 
@@ -886,10 +1401,10 @@ void   __turbulence_ppath_set_state (TurbulenceCtx    * ctx,
 	} /* end if */
 
 	/* create and store */
-	state                       = axl_new (TurbulencePPathState, 1);
-	state->path_selected        = def;
+	state                       = __turbulence_ppath_state_new ();
 	state->ctx                  = ctx;
 	state->requested_serverName = requested_serverName ? axl_strdup (requested_serverName) : NULL;
+	__turbulence_ppath_state_select (state, def);
 	vortex_connection_set_data_full (conn, 
 					 /* the key and its associated value */
 					 TURBULENCE_PPATH_STATE, state,
@@ -1000,6 +1515,9 @@ axl_bool  __turbulence_ppath_handle_connection_on_connect (VortexConnection * co
 		msg ("CHILD: Detected onConnect() on child process having a predefined profile path..");
 		/* set profile path currently selected on child */
 		__turbulence_ppath_set_state (ctx, connection, turbulence_ppath_get_id (ctx->child->ppath), NULL);
+
+		/* greeting timeout counts from now */
+		__turbulence_conn_mgr_accepted (ctx, connection);
 		return axl_true;
 	}
 
@@ -1007,7 +1525,13 @@ axl_bool  __turbulence_ppath_handle_connection_on_connect (VortexConnection * co
 	/* call to select a profile path: serverName = NULL ("") && on_connect = axl_true */
 	msg ("Call to select a profile path at connection time (pre <greetings />), conn-id=%d", 
 	     vortex_connection_get_id (connection));
-	return __turbulence_ppath_select ((TurbulenceCtx *) data, connection, -1, NULL, NULL, -1, "", NULL, axl_true);
+	if (! __turbulence_ppath_select ((TurbulenceCtx *) data, connection, -1, NULL, NULL, -1, "", NULL, axl_true))
+		return axl_false;
+
+	/* greeting timeout counts from now (peers that never send
+	 * their greetings are closed too) */
+	__turbulence_conn_mgr_accepted (ctx, connection);
+	return axl_true;
 }
 
 
@@ -1108,60 +1632,179 @@ void __turbulence_ppath_check_user (TurbulenceCtx      * ctx,
 }
 
 
+void __turbulence_ppath_collect_mark (axlList * marks, char * mark)
+{
+	int iterator;
+
+	if (mark == NULL)
+		return;
+	for (iterator = 0; iterator < axl_list_length (marks); iterator++) {
+		if (axl_cmp (axl_list_get_nth (marks, iterator), mark))
+			return;
+	} /* end for */
+	axl_list_append (marks, mark);
+	return;
+}
+
 /** 
- * @internal Prepares the runtime execution to provide profile path
- * support according to the current configuration.
- * 
+ * @internal Collects <if-success> items and distinct mark names found
+ * under the provided items into the lists provided.
  */
-int  turbulence_ppath_init (TurbulenceCtx * ctx)
+void __turbulence_ppath_collect_items (TurbulencePPathItem ** items, axlList * if_items, axlList * marks)
+{
+	int iterator = 0;
+
+	while (items != NULL && items[iterator] != NULL) {
+		__turbulence_ppath_collect_mark (marks, items[iterator]->connmark);
+		__turbulence_ppath_collect_mark (marks, items[iterator]->preconnmark);
+		if (items[iterator]->type == PROFILE_IF) {
+			items[iterator]->if_index = axl_list_length (if_items);
+			axl_list_append (if_items, items[iterator]);
+			__turbulence_ppath_collect_items (items[iterator]->ppath_items, if_items, marks);
+		} /* end if */
+
+		/* next item */
+		iterator++;
+	} /* end while */
+
+	return;
+}
+
+/** 
+ * @internal Prepares the profile path definition to memoize channel
+ * start decisions (see __turbulence_ppath_mask_memo).
+ */
+void __turbulence_ppath_prepare_memo (TurbulencePPathDef * def)
+{
+	axlList * if_items = axl_list_new (axl_list_always_return_1, NULL);
+	axlList * marks    = axl_list_new (axl_list_always_return_1, NULL);
+	int       iterator;
+
+	__turbulence_ppath_collect_items (def->ppath_items, if_items, marks);
+
+	def->if_count = axl_list_length (if_items);
+	def->if_items = axl_new (TurbulencePPathItem *, def->if_count + 1);
+	for (iterator = 0; iterator < def->if_count; iterator++)
+		def->if_items[iterator] = axl_list_get_nth (if_items, iterator);
+
+	def->marks    = axl_new (char *, axl_list_length (marks) + 1);
+	for (iterator = 0; iterator < axl_list_length (marks); iterator++)
+		def->marks[iterator] = axl_list_get_nth (marks, iterator);
+
+	axl_list_free (if_items);
+	axl_list_free (marks);
+	return;
+}
+
+/** 
+ * @internal Builds the profile path selection index used by
+ * __turbulence_ppath_select. Profile paths declaring a literal
+ * serverName (no wildcard, list or negation) are only checked for
+ * connections requesting that serverName, so each literal gets its
+ * own candidate array merged, in declaration order, with the profile
+ * paths that may match any serverName. This keeps first match
+ * semantics while skipping every other virtual host.
+ */
+void __turbulence_ppath_index_build (TurbulenceCtx * ctx, TurbulencePPath * paths)
+{
+	TurbulencePPathDef ** candidates;
+	const char          * literal;
+	int                   count = 0;
+	int                   iterator;
+	int                   iterator2;
+	int                   position;
+
+	while (paths->items[count] != NULL)
+		count++;
+
+	/* profile paths that may match any serverName */
+	paths->generic = axl_new (TurbulencePPathDef *, count + 1);
+	position       = 0;
+	for (iterator = 0; iterator < count; iterator++) {
+		if (turbulence_expr_get_literal (paths->items[iterator]->serverName) == NULL)
+			paths->generic[position++] = paths->items[iterator];
+	} /* end for */
+
+	/* one candidate array for each literal serverName */
+	paths->by_serverName = axl_hash_new (axl_hash_string, axl_hash_equal_string);
+	for (iterator = 0; iterator < count; iterator++) {
+		literal = turbulence_expr_get_literal (paths->items[iterator]->serverName);
+		if (literal == NULL || axl_hash_exists (paths->by_serverName, (axlPointer) literal))
+			continue;
+
+		candidates = axl_new (TurbulencePPathDef *, count + 1);
+		position   = 0;
+		for (iterator2 = 0; iterator2 < count; iterator2++) {
+			if (turbulence_expr_get_literal (paths->items[iterator2]->serverName) == NULL ||
+			    axl_cmp (turbulence_expr_get_literal (paths->items[iterator2]->serverName), literal))
+				candidates[position++] = paths->items[iterator2];
+		} /* end for */
+
+		/* key is owned by the serverName expression */
+		axl_hash_insert_full (paths->by_serverName, (axlPointer) literal, NULL, candidates, axl_free);
+	} /* end for */
+
+	msg ("profile path selection index built: %d profile paths, %d literal serverNames", 
+	     count, axl_hash_items (paths->by_serverName));
+	return;
+}
+
+/** 
+ * @internal Builds a profile path table (definitions, selection index
+ * and selection cache) from the provided configuration document,
+ * which is referenced by the definitions so it must be kept until the
+ * table is released.
+ *
+ * @return A new table or NULL if the document declares no profile
+ * path.
+ */
+TurbulencePPath * __turbulence_ppath_build (TurbulenceCtx * ctx, axlDoc * doc)
 {
-	/* get turbulence context */
 	axlNode            * node; 
 	axlNode            * pdef;
+	TurbulencePPath    * paths;
 	TurbulencePPathDef * definition;
 	int                  iterator;
 	int                  iterator2;
-	VortexCtx          * vortex_ctx = turbulence_ctx_get_vortex_ctx (ctx);
-
-	/* check turbulence context received */
-	v_return_val_if_fail (ctx, axl_false);
 
-	/* init profile path attr alias hash */
-	ctx->profile_attr_alias = axl_hash_new (axl_hash_string, axl_hash_equal_string);
-	
 	/* parse all profile path configurations */
-	pdef = axl_doc_get (turbulence_config_get (ctx), "/turbulence/profile-path-configuration/path-def");
+	pdef = axl_doc_get (doc, "/turbulence/profile-path-configuration/path-def");
 	if (pdef == NULL) {
 		error ("No profile path configuration was found, you must set at least one profile path.");
-		return axl_false;
+		return NULL;
 	} /* end if */
 	
 	/* get the parent node */
 	node = axl_node_get_parent (pdef);
 	
 	/* create the turbulence ppath */
-	ctx->paths        = axl_new (TurbulencePPath, 1);
-	ctx->paths->items = axl_new (TurbulencePPathDef *, axl_node_get_child_num (node) + 1);
+	paths        = axl_new (TurbulencePPath, 1);
+	paths->items = axl_new (TurbulencePPathDef *, axl_node_get_child_num (node) + 1);
+	paths->refs  = 1;
 
 	/* flag profile path rules as only ip based and change this
 	   value as long as we read rules */
-	ctx->all_rules_address_based = axl_true;
+	paths->all_rules_address_based = axl_true;
 
 	/* now parse each profile path def found */
 	iterator = 0;
 	while (pdef != NULL) {
 
 		/* get the reference to the profile path */
-		ctx->paths->items[iterator] = axl_new (TurbulencePPathDef, 1);
-		definition                  = ctx->paths->items[iterator];
+		paths->items[iterator] = axl_new (TurbulencePPathDef, 1);
+		definition             = paths->items[iterator];
 
 		/* set unique ppath id */
 		definition->id              = ctx->ppath_next_id;
+		definition->paths           = paths;
 		ctx->ppath_next_id++;
 
 		/* set node */
 		definition->node = pdef;
 
+		/* mutex used to serialize child creation */
+		vortex_mutex_create (&definition->create_mutex);
+
 		/* catch all data from the profile path def header */
 		if (HAS_ATTR (pdef, "path-name")) {
 			/* catch the ppath name */
@@ -1191,7 +1834,7 @@ int  turbulence_ppath_init (TurbulenceCtx * ctx)
 		   posible to apply profile path policy on server
 		   accept handler rather waiting client greetings
 		   reception */
-		if (ctx->all_rules_address_based) {
+		if (paths->all_rules_address_based) {
 			/* if has server-Name defined and its value is
 			   different .* (which means all serverName
 			   allowed including empty value). The following signals all rules are address based if: 
@@ -1202,7 +1845,7 @@ int  turbulence_ppath_init (TurbulenceCtx * ctx)
 
 			if ((HAS_ATTR (pdef, "server-name")) && 
 			    (! HAS_ATTR_VALUE (pdef, "server-name", ".*"))) {
-				ctx->all_rules_address_based = axl_false;
+				paths->all_rules_address_based = axl_false;
 			} /* end if */
 		} /* end if */
 
@@ -1237,6 +1880,89 @@ int  turbulence_ppath_init (TurbulenceCtx * ctx)
 		else
 			definition->child_limit = -1;
 
+		/* set spare child pool configuration if any */
+		if (HAS_ATTR (pdef, "min-spare-childs"))
+			definition->min_spare_childs = vortex_support_strtod (ATTR_VALUE (pdef, "min-spare-childs"), NULL);
+		if (HAS_ATTR (pdef, "max-spare-childs"))
+			definition->max_spare_childs = vortex_support_strtod (ATTR_VALUE (pdef, "max-spare-childs"), NULL);
+		if (definition->min_spare_childs < 0)
+			definition->min_spare_childs = 0;
+		if (definition->max_spare_childs < definition->min_spare_childs)
+			definition->max_spare_childs = definition->min_spare_childs;
+		if (definition->min_spare_childs > 0 && ! definition->separate) {
+			wrn ("min-spare-childs=%d declared on profile path %s without separate=\"yes\", ignoring it",
+			     definition->min_spare_childs, definition->path_name ? definition->path_name : "");
+			definition->min_spare_childs = 0;
+			definition->max_spare_childs = 0;
+		} /* end if */
+
+		/* set number of childs to balance connections when
+		 * reusing childs */
+		definition->children_per_ppath = 1;
+		if (HAS_ATTR (pdef, "children-per-ppath"))
+			definition->children_per_ppath = vortex_support_strtod (ATTR_VALUE (pdef, "children-per-ppath"), NULL);
+		if (definition->children_per_ppath < 1)
+			definition->children_per_ppath = 1;
+		if (definition->children_per_ppath > 1 && ! (definition->separate && definition->reuse)) {
+			wrn ("children-per-ppath=%d declared on profile path %s without separate=\"yes\" and reuse=\"yes\", ignoring it",
+			     definition->children_per_ppath, definition->path_name ? definition->path_name : "");
+			definition->children_per_ppath = 1;
+		} /* end if */
+		definition->balance_cpu = HAS_ATTR_VALUE (pdef, "balance-cpu", "yes");
+
+		/* set admission queue used when child limits are
+		 * reached */
+		if (HAS_ATTR (pdef, "admission-queue"))
+			definition->admission_limit = vortex_support_strtod (ATTR_VALUE (pdef, "admission-queue"), NULL);
+		definition->admission_timeout = 5000;
+		if (HAS_ATTR (pdef, "admission-timeout"))
+			definition->admission_timeout = vortex_support_strtod (ATTR_VALUE (pdef, "admission-timeout"), NULL);
+		if (definition->admission_limit < 0 || definition->admission_timeout <= 0)
+			definition->admission_limit = 0;
+		if (definition->admission_limit > 0 && ! definition->separate) {
+			wrn ("admission-queue=%d declared on profile path %s without separate=\"yes\", ignoring it",
+			     definition->admission_limit, definition->path_name ? definition->path_name : "");
+			definition->admission_limit = 0;
+		} /* end if */
+		if (definition->admission_limit > 0)
+			definition->admission_list = axl_list_new (axl_list_always_return_1, NULL);
+
+		/* set child creation rate limit */
+		if (HAS_ATTR (pdef, "spawn-rate") && definition->separate) {
+			definition->spawn_bucket.rate  = vortex_support_strtod (ATTR_VALUE (pdef, "spawn-rate"), NULL);
+			definition->spawn_bucket.burst = definition->spawn_bucket.rate;
+			if (HAS_ATTR (pdef, "spawn-burst"))
+				definition->spawn_bucket.burst = vortex_support_strtod (ATTR_VALUE (pdef, "spawn-burst"), NULL);
+			if (definition->spawn_bucket.rate <= 0)
+				definition->spawn_bucket.rate = 0;
+			if (definition->spawn_bucket.burst < 1)
+				definition->spawn_bucket.burst = 1;
+		} /* end if */
+
+		/* set child recycling thresholds */
+		if (HAS_ATTR (pdef, "recycle-conns"))
+			definition->recycle_conns = vortex_support_strtod (ATTR_VALUE (pdef, "recycle-conns"), NULL);
+		if (HAS_ATTR (pdef, "recycle-age"))
+			definition->recycle_age = vortex_support_strtod (ATTR_VALUE (pdef, "recycle-age"), NULL);
+		if (HAS_ATTR (pdef, "recycle-rss"))
+			definition->recycle_rss = vortex_support_strtod (ATTR_VALUE (pdef, "recycle-rss"), NULL);
+		if ((definition->recycle_conns > 0 || definition->recycle_age > 0 || definition->recycle_rss > 0) && 
+		    ! (definition->separate && definition->reuse)) {
+			wrn ("recycle-conns, recycle-age or recycle-rss declared on profile path %s without separate=\"yes\" and reuse=\"yes\", ignoring them",
+			     definition->path_name ? definition->path_name : "");
+			definition->recycle_conns = 0;
+			definition->recycle_age   = 0;
+			definition->recycle_rss   = 0;
+		} /* end if */
+
+		/* set greeting and idle timeouts (-1: use global default) */
+		definition->greeting_timeout = -1;
+		definition->idle_timeout     = -1;
+		if (HAS_ATTR (pdef, "greeting-timeout"))
+			definition->greeting_timeout = vortex_support_strtod (ATTR_VALUE (pdef, "greeting-timeout"), NULL);
+		if (HAS_ATTR (pdef, "idle-timeout"))
+			definition->idle_timeout = vortex_support_strtod (ATTR_VALUE (pdef, "idle-timeout"), NULL);
+
 		/* check for chroot value */
 		definition->chroot   = ATTR_VALUE (pdef, "chroot");
 
@@ -1284,11 +2010,73 @@ int  turbulence_ppath_init (TurbulenceCtx * ctx)
 			} /* end if */
 		} /* end if */
 		
+		/* prepare channel start decisions memoization */
+		__turbulence_ppath_prepare_memo (definition);
+		
 		/* get next profile path def */
 		iterator++;
 		pdef = axl_node_get_next (pdef);
 	} /* end while */
 
+	/* build selection index */
+	__turbulence_ppath_index_build (ctx, paths);
+
+	/* init selection cache */
+	vortex_mutex_create (&paths->cache_mutex);
+	paths->cache = axl_hash_new (axl_hash_string, axl_hash_equal_string);
+	
+	msg ("profile path definition ok (all rules address based status: %d)..", paths->all_rules_address_based);
+
+	return paths;
+}
+
+/** 
+ * @internal Vortex thread pool event that reloads profile paths once
+ * a HUP signal was received (see turbulence_reload_config). The
+ * signal handler only flags the reload so the configuration is
+ * parsed and childs are created by a regular thread.
+ */
+axl_bool __turbulence_ppath_reload_event (VortexCtx * vortex_ctx, axlPointer user_data, axlPointer user_data2)
+{
+	TurbulenceCtx * ctx = user_data;
+
+	/* childs do not reload profile paths */
+	if (ctx->is_exiting || ctx->child != NULL)
+		return axl_true; /* remove event */
+
+	if (! ctx->ppath_reload_pending)
+		return axl_false; /* keep event */
+	ctx->ppath_reload_pending = axl_false;
+
+	/* install new profile paths (or drop selections cached
+	 * if they can't be loaded) */
+	if (! turbulence_ppath_reload (ctx))
+		turbulence_ppath_cache_flush (ctx);
+
+	return axl_false; /* keep event */
+}
+
+/** 
+ * @internal Prepares the runtime execution to provide profile path
+ * support according to the current configuration.
+ * 
+ */
+int  turbulence_ppath_init (TurbulenceCtx * ctx)
+{
+	VortexCtx          * vortex_ctx = turbulence_ctx_get_vortex_ctx (ctx);
+
+	/* check turbulence context received */
+	v_return_val_if_fail (ctx, axl_false);
+
+	/* init profile path attr alias hash */
+	ctx->profile_attr_alias = axl_hash_new (axl_hash_string, axl_hash_equal_string);
+
+	/* parse all profile path configurations */
+	ctx->paths = __turbulence_ppath_build (ctx, turbulence_config_get (ctx));
+	if (ctx->paths == NULL)
+		return axl_false;
+	ctx->all_rules_address_based = ctx->paths->all_rules_address_based;
+
 	/* install server connection accepted */
 	vortex_listener_set_on_connection_accepted (vortex_ctx, 
 						    __turbulence_ppath_handle_connection_on_connect, 
@@ -1297,8 +2085,9 @@ int  turbulence_ppath_init (TurbulenceCtx * ctx)
 						    CONNECTION_STAGE_PROCESS_GREETINGS_FEATURES,
 						    __turbulence_ppath_handle_connection_on_greetings,
 						    ctx);
-	
-	msg ("profile path definition ok (all rules address based status: %d)..", ctx->all_rules_address_based);
+
+	/* check for pending profile path reloads */
+	vortex_thread_pool_new_event (vortex_ctx, 1000000, __turbulence_ppath_reload_event, ctx, NULL);
 
 	/* return ok code */
 	return axl_true;
@@ -1334,53 +2123,88 @@ void __turbulence_ppath_free_item (TurbulencePPathItem * item)
 }
 
 /** 
- * @internal Terminates the profile path module, cleanup all memory
- * used.
+ * @internal Releases a profile path table and the configuration
+ * document it owns (if any).
  */
-void turbulence_ppath_cleanup (TurbulenceCtx * ctx)
+void __turbulence_ppath_free_paths (TurbulenceCtx * ctx, TurbulencePPath * paths)
 {
 	int iterator;
 	int iterator2;
 	TurbulencePPathDef * def;
 
-	/* terminate profile paths */
-	if (ctx->paths != NULL) {
+	/* for each profile path item iterator */
+	iterator = 0;
+	while (paths->items[iterator] != NULL) {
+		/* get the definition */
+		def       = paths->items[iterator];
 
-		/* for each profile path item iterator */
-		iterator = 0;
-		while (ctx->paths->items[iterator] != NULL) {
-			/* get the definition */
-			def       = ctx->paths->items[iterator];
+		/* free profile path name definition */
+		axl_free (def->path_name);
+		turbulence_expr_free (def->serverName);
+		turbulence_expr_free (def->src);
+		turbulence_expr_free (def->dst);
+
+		iterator2 = 0;
+		while (def->ppath_items != NULL && def->ppath_items[iterator2] != NULL) {
+			
+			/* free the item */
+			__turbulence_ppath_free_item (def->ppath_items[iterator2]);
+
+			/* next iterator */
+			iterator2++;
+		} /* end while */
+
+		/* free the definition itself and its items */
+		vortex_mutex_destroy (&def->create_mutex);
+		axl_list_free (def->admission_list);
+		axl_free (def->ppath_items);
+		axl_free (def->if_items);
+		axl_free (def->marks);
+		axl_free (def);
+		
+		/* next profile path def */
+		iterator++;
+	} /* end if */
 
-			/* free profile path name definition */
-			axl_free (def->path_name);
-			turbulence_expr_free (def->serverName);
-			turbulence_expr_free (def->src);
-			turbulence_expr_free (def->dst);
+	/* free selection index */
+	if (paths->by_serverName)
+		axl_hash_free (paths->by_serverName);
+	axl_free (paths->generic);
 
-			iterator2 = 0;
-			while (def->ppath_items[iterator2] != NULL) {
-				
-				/* free the item */
-				__turbulence_ppath_free_item (def->ppath_items[iterator2]);
+	/* free selection cache */
+	if (paths->cache) {
+		__turbulence_ppath_cache_clear (paths);
+		axl_hash_free (paths->cache);
+		vortex_mutex_destroy (&paths->cache_mutex);
+	} /* end if */
 
-				/* next iterator */
-				iterator2++;
-			} /* end while */
+	/* free configuration loaded by turbulence_ppath_reload */
+	if (paths->doc != NULL)
+		axl_doc_free (paths->doc);
 
-			/* free the definition itself and its items */
-			axl_free (def->ppath_items);
-			axl_free (def);
-			
-			/* next profile path def */
-			iterator++;
-		} /* end if */
+	/* free profile path array */
+	axl_free (paths->items);
+	axl_free (paths);
 
-		/* free profile path array */
-		axl_free (ctx->paths->items);
-		axl_free (ctx->paths);
-		ctx->paths = NULL;
-	} /* end if */
+	return;
+}
+
+/** 
+ * @internal Terminates the profile path module, cleanup all memory
+ * used.
+ */
+void turbulence_ppath_cleanup (TurbulenceCtx * ctx)
+{
+	TurbulencePPath * paths;
+
+	/* release current profile paths: tables still referenced
+	 * (connections, childs) are released with their last
+	 * reference */
+	vortex_mutex_lock (&ctx->ppath_mutex);
+	paths      = ctx->paths;
+	ctx->paths = NULL;
+	vortex_mutex_unlock (&ctx->ppath_mutex);
+	__turbulence_ppath_table_unref (ctx, paths);
 
 	/* free profile attr alias hash */
 	axl_hash_free (ctx->profile_attr_alias);
@@ -1389,6 +2213,173 @@ void turbulence_ppath_cleanup (TurbulenceCtx * ctx)
 	return;
 }
 
+/** 
+ * @brief Drops all profile path selections cached so next
+ * connections are matched again against profile path
+ * definitions. Called on configuration reload.
+ *
+ * @param ctx The turbulence context where the operation takes place.
+ */
+void turbulence_ppath_cache_flush (TurbulenceCtx * ctx)
+{
+	TurbulencePPath * paths;
+
+	if (ctx == NULL)
+		return;
+	paths = __turbulence_ppath_table_current (ctx);
+	if (paths == NULL)
+		return;
+
+	if (paths->cache) {
+		vortex_mutex_lock (&paths->cache_mutex);
+		__turbulence_ppath_cache_clear (paths);
+		paths->cache_generation++;
+		vortex_mutex_unlock (&paths->cache_mutex);
+	} /* end if */
+
+	__turbulence_ppath_table_unref (ctx, paths);
+	return;
+}
+
+/** 
+ * @brief Allows to get profile path selection cache stats.
+ *
+ * @param ctx The turbulence context where the operation takes place.
+ *
+ * @param hits Optional reference where selections served by the cache
+ * are reported.
+ *
+ * @param misses Optional reference where selections that required
+ * checking profile path definitions are reported.
+ *
+ * @param items Optional reference where current cache entries are
+ * reported.
+ */
+void turbulence_ppath_cache_stats (TurbulenceCtx * ctx, 
+				   int           * hits, 
+				   int           * misses,
+				   int           * items)
+{
+	TurbulencePPath * paths;
+
+	if (hits)
+		(* hits) = 0;
+	if (misses)
+		(* misses) = 0;
+	if (items)
+		(* items) = 0;
+	if (ctx == NULL)
+		return;
+	paths = __turbulence_ppath_table_current (ctx);
+	if (paths == NULL)
+		return;
+
+	if (paths->cache) {
+		vortex_mutex_lock (&paths->cache_mutex);
+		if (hits)
+			(* hits) = paths->cache_hits;
+		if (misses)
+			(* misses) = paths->cache_misses;
+		if (items)
+			(* items) = axl_hash_items (paths->cache);
+		vortex_mutex_unlock (&paths->cache_mutex);
+	} /* end if */
+
+	__turbulence_ppath_table_unref (ctx, paths);
+	return;
+}
+
+/** 
+ * @internal Recreates the selection cache mutex and drops entries
+ * inherited after a child process creation.
+ */
+void __turbulence_ppath_cache_reinit (TurbulenceCtx * ctx)
+{
+	if (ctx->paths == NULL || ctx->paths->cache == NULL)
+		return;
+
+	vortex_mutex_create (&ctx->paths->cache_mutex);
+	__turbulence_ppath_cache_clear (ctx->paths);
+	ctx->paths->cache_hits   = 0;
+	ctx->paths->cache_misses = 0;
+	return;
+}
+
+/** 
+ * @brief Reloads profile path definitions from the configuration file
+ * without stopping the server.
+ *
+ * The configuration is parsed and the new profile paths are built
+ * apart from the ones in use, which are replaced in a single pointer
+ * update: connections being selected or already running keep the
+ * definition they got while new connections are matched against the
+ * new ones. Childs created for previous definitions finish as their
+ * connections close (spare childs are terminated right away).
+ *
+ * Replaced definitions (and the configuration they were loaded from)
+ * are released once the last connection, child or spare pool using
+ * them finishes.
+ *
+ * On HUP, this function is not called from the signal handler but
+ * from a vortex thread pool event (see turbulence_reload_config).
+ *
+ * @param ctx The turbulence context where the operation takes place.
+ *
+ * @return axl_true if the new profile paths were installed, otherwise
+ * axl_false is returned (current ones are kept).
+ */
+axl_bool turbulence_ppath_reload (TurbulenceCtx * ctx)
+{
+	axlDoc          * doc;
+	TurbulencePPath * paths;
+	TurbulencePPath * previous;
+
+	if (ctx == NULL || ctx->paths == NULL || ctx->config_path == NULL)
+		return axl_false;
+
+	/* profile paths are only selected by the main process */
+	if (ctx->child != NULL)
+		return axl_false;
+
+	/* load configuration */
+	doc = turbulence_config_parse (ctx, ctx->config_path);
+	if (doc == NULL) {
+		error ("Unable to reload profile paths, failed to load %s, keeping current ones", ctx->config_path);
+		return axl_false;
+	} /* end if */
+
+	/* build new profile paths */
+	paths = __turbulence_ppath_build (ctx, doc);
+	if (paths == NULL) {
+		error ("Unable to reload profile paths from %s, keeping current ones", ctx->config_path);
+		axl_doc_free (doc);
+		return axl_false;
+	} /* end if */
+	paths->doc = doc;
+
+	/* publish: ensure the table is completely written before
+	 * it is visible to connection threads */
+	vortex_mutex_lock (&ctx->ppath_mutex);
+	previous       = ctx->paths;
+	paths->retired = previous;
+	TBC_MEMORY_BARRIER ();
+	ctx->paths                   = paths;
+	ctx->all_rules_address_based = paths->all_rules_address_based;
+	vortex_mutex_unlock (&ctx->ppath_mutex);
+
+	msg ("profile paths reloaded from %s (first profile path id: %d)", 
+	     ctx->config_path, paths->items[0] ? paths->items[0]->id : -1);
+
+	/* childs running previous profile paths */
+	__turbulence_process_retire_childs (ctx);
+
+	/* release the reference held by ctx->paths: the previous
+	 * table is released now unless it is still used */
+	__turbulence_ppath_table_unref (ctx, previous);
+
+	return axl_true;
+}
+
 /** 
  * @internal Change to the effective user id and group id configured
  * in the profile path configuration (if any).
@@ -1452,17 +2443,76 @@ TurbulencePPathDef * turbulence_ppath_selected (VortexConnection * conn)
  */ 
 TurbulencePPathDef * turbulence_ppath_find_by_id (TurbulenceCtx * ctx, int ppath_id)
 {
-	int iterator;
+	int               iterator;
+	TurbulencePPath * paths;
 
 	if (ctx == NULL)
 		return NULL;
 
-	/* for each profile path item iterator */
+	/* check current profile paths and then the ones replaced by
+	 * a reload (still used by childs and connections) */
+	vortex_mutex_lock (&ctx->ppath_mutex);
+	paths = ctx->paths;
+	while (paths != NULL) {
+		/* for each profile path item iterator */
+		iterator = 0;
+		while (paths->items && paths->items[iterator] != NULL) {
+			/* check profile path id */
+			if (paths->items[iterator]->id == ppath_id) {
+				vortex_mutex_unlock (&ctx->ppath_mutex);
+				return paths->items[iterator];
+			} /* end if */
+
+			/* next position */
+			iterator++;
+		}
+
+		/* next table */
+		paths = paths->retired;
+	} /* end while */
+	vortex_mutex_unlock (&ctx->ppath_mutex);
+
+	return NULL;
+}
+
+/** 
+ * @internal Returns the id of the first profile path of the table
+ * holding the provided definition. Childs use it to number the
+ * profile paths they load in the same way as the parent.
+ */
+int                  __turbulence_ppath_id_base (TurbulenceCtx * ctx, TurbulencePPathDef * ppath_def)
+{
+	if (ppath_def == NULL || ppath_def->paths == NULL || ppath_def->paths->items[0] == NULL)
+		return 1;
+
+	/* the table is kept while the definition is in use */
+	return ppath_def->paths->items[0]->id;
+}
+
+/** 
+ * @internal Allows to iterate over all profile path definitions of a
+ * table, in the order they were declared. The table must be held by
+ * the caller (see __turbulence_ppath_table_current) so a reload
+ * doesn't release it while iterating.
+ *
+ * @param paths The profile path table to iterate.
+ * @param position The position (starting from 0) of the profile path.
+ *
+ * @return The profile path definition or NULL if the position is out
+ * of range.
+ */
+TurbulencePPathDef * __turbulence_ppath_get_nth (TurbulencePPath * paths, int position)
+{
+	int               iterator;
+
+	if (paths == NULL || paths->items == NULL || position < 0)
+		return NULL;
+
+	/* walk until the requested position checking list end */
 	iterator = 0;
-	while (ctx->paths && ctx->paths->items && ctx->paths->items[iterator] != NULL) {
-		/* check profile path id */
-		if (ctx->paths->items[iterator]->id == ppath_id)
-			return ctx->paths->items[iterator];
+	while (paths->items[iterator] != NULL) {
+		if (iterator == position)
+			return paths->items[iterator];
 
 		/* next position */
 		iterator++;
@@ -1580,7 +2630,7 @@ void                 __turbulence_ppath_set_selected (VortexConnection   * conn,
 
 	/* get current state and replace profile path */
 	state     = vortex_connection_get_data (conn, TURBULENCE_PPATH_STATE);
-	state->path_selected = ppath_def;
+	__turbulence_ppath_state_select (state, ppath_def);
 	return;
 }
 
@@ -43,6 +43,17 @@ int  turbulence_ppath_init (TurbulenceCtx * ctx);
 
 void turbulence_ppath_cleanup (TurbulenceCtx * ctx);
 
+void turbulence_ppath_cache_flush (TurbulenceCtx * ctx);
+
+void turbulence_ppath_cache_stats (TurbulenceCtx * ctx, 
+				   int           * hits, 
+				   int           * misses,
+				   int           * items);
+
+void __turbulence_ppath_cache_reinit (TurbulenceCtx * ctx);
+
+axl_bool turbulence_ppath_reload (TurbulenceCtx * ctx);
+
 void turbulence_ppath_change_user_id (TurbulenceCtx      * ctx, 
 				      TurbulencePPathDef * ppath_def);
 
@@ -54,6 +65,23 @@ TurbulencePPathDef * turbulence_ppath_selected (VortexConnection * conn);
 TurbulencePPathDef * turbulence_ppath_find_by_id (TurbulenceCtx * ctx, 
 						  int             ppath_id);
 
+TurbulencePPath    * __turbulence_ppath_table_current (TurbulenceCtx * ctx);
+
+void                 __turbulence_ppath_table_unref   (TurbulenceCtx   * ctx,
+						       TurbulencePPath * paths);
+
+TurbulencePPathDef * __turbulence_ppath_get_nth (TurbulencePPath * paths,
+						 int               position);
+
+int                  __turbulence_ppath_id_base (TurbulenceCtx      * ctx,
+						 TurbulencePPathDef * ppath_def);
+
+void                 __turbulence_ppath_ref     (TurbulenceCtx      * ctx,
+						 TurbulencePPathDef * ppath_def);
+
+void                 __turbulence_ppath_unref   (TurbulenceCtx      * ctx,
+						 TurbulencePPathDef * ppath_def);
+
 int                  turbulence_ppath_get_id   (TurbulencePPathDef * ppath_def);
 
 const char         * turbulence_ppath_get_name (TurbulencePPathDef * ppath_def);
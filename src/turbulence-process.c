@@ -34,6 +34,10 @@
  *      Email address:
  *         info@aspl.es - http://www.aspl.es/turbulence
  */
+#if defined(__linux__) && ! defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #include <turbulence-process.h>
 
 /* include private headers */
@@ -44,6 +48,12 @@
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <poll.h>
+#if defined(__linux__)
+#include <sys/prctl.h>
+#endif
 
 
 /** 
@@ -60,6 +70,42 @@ const char * turbulence_child_cmd_prefix = NULL;
 
 extern axl_bool __turbulence_module_no_unmap;
 
+/** 
+ * @internal Max number of sockets (and connection status records)
+ * sent to a child in a single message, and max size of the records
+ * sent together (the child receives them at once).
+ */
+#define TBC_HANDOFF_BATCH  16
+#define TBC_HANDOFF_BUFFER (TBC_CONN_STATUS_MAX * 2)
+
+/** 
+ * @internal Max time (milliseconds) the parent waits for a child to
+ * read a record sent partially before closing its control
+ * connection.
+ */
+#define TBC_HANDOFF_WAIT 5000
+
+/** 
+ * @internal Period (microseconds) used to check connections in the
+ * admission queues (admission-timeout and closed connections).
+ * Connections are resumed when a child finishes or a creation slot is
+ * released, so this only bounds notifications missed.
+ */
+#define TBC_ADMISSION_POLL 100000
+
+/** 
+ * @internal Min number of slots of the shared memory segment where
+ * childs publish their counters (global-child-limit is used if
+ * bigger).
+ */
+#define TBC_STATS_MIN_SLOTS 128
+
+/** 
+ * @internal Max time (milliseconds) the main process waits for the
+ * zygote process to reply a spawn request before disabling it.
+ */
+#define TBC_ZYGOTE_REPLY_WAIT 5000
+
 /** 
  * @internal Macro used to block sigchild and lock the mutex
  * associated to child processes.
@@ -99,6 +145,14 @@ void turbulence_process_init         (TurbulenceCtx * ctx, axl_bool reinit)
 
 	/* init mutex */
 	vortex_mutex_create (&ctx->child_process_mutex);
+
+	/* zygote process not started */
+	ctx->zygote_pid        = -1;
+	ctx->zygote_connection = -1;
+	vortex_mutex_create (&ctx->zygote_mutex);
+
+	/* child stats slots */
+	vortex_mutex_create (&ctx->stats_mutex);
 	return;
 }
 
@@ -113,16 +167,13 @@ axlPointer __turbulence_process_finished (TurbulenceCtx * ctx)
 
 		/* check if the conn manager has connections watched
 		 * at this time */
-		vortex_mutex_lock (&ctx->conn_mgr_mutex);
-		if (axl_hash_items (ctx->conn_mgr_hash) > 0) {
+		if (turbulence_conn_mgr_count (ctx) > 0) {
 			msg ("CHILD: cancelled child process termination because new connections are now handled, tries=%d, delay=%d, reader connections=%d, tbc conn mgr=%d",
 			      tries, delay, 
 			      vortex_reader_connections_watched (vortex_ctx), 
-			      axl_hash_items (ctx->conn_mgr_hash));
-			vortex_mutex_unlock (&ctx->conn_mgr_mutex);
+			      turbulence_conn_mgr_count (ctx));
 			return NULL;
 		} /* end if */
-		vortex_mutex_unlock (&ctx->conn_mgr_mutex);
 		
 		/* finish current thread if turbulence is existing */
 		if (ctx->is_exiting) {
@@ -135,7 +186,7 @@ axlPointer __turbulence_process_finished (TurbulenceCtx * ctx)
 			msg ("CHILD: delay child process termination to ensure the parent has no pending connections, tries=%d, delay=%d, reader connections=%d, tbc conn mgr=%d, is-existing=%d",
 			     tries, delay,
 			     vortex_reader_connections_watched (vortex_ctx), 
-			     axl_hash_items (ctx->conn_mgr_hash),
+			     turbulence_conn_mgr_count (ctx),
 			     ctx->is_exiting);
 		} /* end if */
 
@@ -344,6 +395,118 @@ axl_bool __turbulence_process_create_parent_connection (TurbulenceChild * child)
 	return (child->child_connection > 0);
 }
 
+/** 
+ * @internal Sends the provided sockets to the child in a single
+ * message, along with the data provided (one or several buffers).
+ * Sockets are not closed.
+ */
+axl_bool __turbulence_process_send_sockets (TurbulenceChild * child,
+					    VORTEX_SOCKET   * sockets,
+					    int               count,
+					    struct iovec    * vec,
+					    int               vec_count)
+{
+	struct msghdr        msg;
+	char                 ccmsg[CMSG_SPACE(sizeof(int) * TBC_HANDOFF_BATCH)];
+	struct cmsghdr     * cmsg;
+	struct iovec         local[TBC_HANDOFF_BATCH];
+	struct pollfd        wait_fd;
+	int                  total;
+	int                  written;
+	int                  ready;
+	int                  iterator;
+#if ! defined(SHOW_FORMAT_BUGS)
+	TurbulenceCtx      * ctx = child->ctx;
+#endif
+
+	if (count <= 0 || count > TBC_HANDOFF_BATCH || vec_count <= 0 || vec_count > TBC_HANDOFF_BATCH)
+		return axl_false;
+
+	/* clear structures */
+	memset (&msg, 0, sizeof (struct msghdr));
+	memset (ccmsg, 0, sizeof (ccmsg));
+
+	/* configure destination */
+	msg.msg_namelen        = 0;
+	msg.msg_iov            = vec;
+	msg.msg_iovlen         = vec_count;
+
+	msg.msg_control        = ccmsg;
+	msg.msg_controllen     = CMSG_SPACE(sizeof(int) * count);
+
+	cmsg = CMSG_FIRSTHDR(&msg);
+	cmsg->cmsg_level       = SOL_SOCKET;
+	cmsg->cmsg_type        = SCM_RIGHTS;
+	cmsg->cmsg_len         = CMSG_LEN(sizeof(int) * count);
+	memcpy (CMSG_DATA(cmsg), sockets, sizeof(int) * count);
+
+	msg.msg_controllen     = cmsg->cmsg_len;
+	msg.msg_flags = 0;
+
+	/* the child receives records with MSG_WAITALL: a record sent
+	 * partially would make it read the next message as the rest
+	 * of the record, so the content left is sent without the
+	 * sockets (already delivered with the first byte) */
+	total = 0;
+	for (iterator = 0; iterator < vec_count; iterator++) {
+		local[iterator] = vec[iterator];
+		total          += vec[iterator].iov_len;
+	} /* end for */
+	msg.msg_iov = local;
+
+	do {
+		written = sendmsg (child->child_connection, &msg, MSG_NOSIGNAL);
+	} while (written < 0 && errno == EINTR);
+	if (written < 0)
+		return axl_false;
+
+	while (written < total) {
+		/* skip content already sent */
+		while (msg.msg_iovlen > 0 && written >= (int) msg.msg_iov[0].iov_len) {
+			written -= msg.msg_iov[0].iov_len;
+			total   -= msg.msg_iov[0].iov_len;
+			msg.msg_iov++;
+			msg.msg_iovlen--;
+		} /* end while */
+		if (msg.msg_iovlen == 0)
+			break;
+		msg.msg_iov[0].iov_base  = ((char *) msg.msg_iov[0].iov_base) + written;
+		msg.msg_iov[0].iov_len  -= written;
+		total                   -= written;
+
+		/* wait the child to read */
+		wait_fd.fd      = child->child_connection;
+		wait_fd.events  = POLLOUT;
+		wait_fd.revents = 0;
+		ready           = poll (&wait_fd, 1, TBC_HANDOFF_WAIT);
+		if (ready == 0 || (ready < 0 && errno != EINTR)) {
+			written = -1;
+			break;
+		} /* end if */
+
+		msg.msg_control    = NULL;
+		msg.msg_controllen = 0;
+		do {
+			written = sendmsg (child->child_connection, &msg, MSG_NOSIGNAL);
+		} while (written < 0 && errno == EINTR);
+		if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			written = 0;
+		if (written < 0)
+			break;
+	} /* end while */
+
+	if (written < 0) {
+		/* control stream is out of sync: close it so the child
+		 * finishes (the descriptor is released with the child) */
+		error ("PARENT: failed to send complete record to child pid=%d, closing its control connection, errno: %d", 
+		       child->pid, errno);
+		shutdown (child->child_connection, SHUT_RDWR);
+		return axl_false;
+	} /* end if */
+
+	return axl_true;
+}
+
 /** 
  * @internal Function used to send the provided socket to the provided
  * child.
@@ -363,11 +526,6 @@ axl_bool turbulence_process_send_socket (VORTEX_SOCKET     socket,
 					 const char      * ancillary_data, 
 					 int               size)
 {
-	struct msghdr        msg;
-	int                * int_ptr;
-	char                 ccmsg[CMSG_SPACE(sizeof(socket))];
-
-	struct cmsghdr     * cmsg;
 	struct iovec         vec; 
 
 	/* send at least one byte */
@@ -377,34 +535,13 @@ axl_bool turbulence_process_send_socket (VORTEX_SOCKET     socket,
 	TurbulenceCtx      * ctx = child->ctx;
 #endif
 
-	/* clear structures */
-	memset (&msg, 0, sizeof (struct msghdr));
-
-	/* configure destination */
-	msg.msg_namelen        = 0;
-
 	vec.iov_base   = (char *) str;
 	vec.iov_len    = ancillary_data == NULL ? 1 : size;
-	msg.msg_iov    = &vec;
-	msg.msg_iovlen = 1;
-
-	msg.msg_control        = ccmsg;
-	msg.msg_controllen     = sizeof(ccmsg);
-
-	cmsg = CMSG_FIRSTHDR(&msg);
-	cmsg->cmsg_level       = SOL_SOCKET;
-	cmsg->cmsg_type        = SCM_RIGHTS;
-	cmsg->cmsg_len         = CMSG_LEN(sizeof(socket));
-	int_ptr                = (int*)CMSG_DATA(cmsg);
-	(*int_ptr)             = socket;
-
-	msg.msg_controllen     = cmsg->cmsg_len;
-	msg.msg_flags = 0;
 	
-	rv = (sendmsg (child->child_connection, &msg, 0) != -1);
+	rv = __turbulence_process_send_sockets (child, &socket, 1, &vec, 1);
 	if (rv)  {
-		msg ("PARENT: Socket %d sent to child via %d (ancillary data: %s), closing (status: %d)..", 
-		     socket, child->child_connection, ancillary_data, rv);
+		msg ("PARENT: Socket %d sent to child via %d (command: '%c', size: %d), closing (status: %d)..", 
+		     socket, child->child_connection, str[0], (int) vec.iov_len, rv);
 		/* close the socket  */
 		vortex_close_socket (socket); 
 	} else {
@@ -415,27 +552,26 @@ axl_bool turbulence_process_send_socket (VORTEX_SOCKET     socket,
 }
 
 /** 
- * @brief Allows to receive a socket from the parent on the child
- * provided. In the case the function works, the socket references is
- * updated with the socket descriptor.
- *
- * @param socket A reference where to set socket received. It cannot be NULL.
- * @param child Child receiving the socket. 
+ * @internal Support for turbulence_process_receive_socket that
+ * receives the socket and its ancillary data into the buffer
+ * provided by the caller (no allocation done).
  *
- * @return The function returns axl_false in the case of failure,
- * otherwise axl_true is returned.
+ * @param size Reference where the amount of bytes written in buffer
+ * is reported.
  */
-axl_bool turbulence_process_receive_socket (VORTEX_SOCKET    * _socket, 
-					    TurbulenceChild  * child, 
-					    char            ** ancillary_data, 
-					    int              * size,
-					    const char       * label)
+axl_bool __turbulence_process_receive_socket_common (VORTEX_SOCKET    * _socket, 
+						     int                max_sockets,
+						     int              * count,
+						     TurbulenceChild  * child, 
+						     char             * buffer,
+						     int                buffer_size,
+						     int              * size,
+						     const char       * label)
 {
 	struct msghdr    msg;
 	struct iovec     iov;
-	char             buf[1024];
 	int              status;
-	char             ccmsg[CMSG_SPACE(sizeof(int))];
+	char             ccmsg[CMSG_SPACE(sizeof(int) * TBC_HANDOFF_BATCH)];
 	struct           cmsghdr *cmsg;
 	TurbulenceCtx  * ctx;
 
@@ -450,8 +586,8 @@ axl_bool turbulence_process_receive_socket (VORTEX_SOCKET    * _socket,
 	/* get context reference */
 	ctx = child->ctx;
 	
-	iov.iov_base = buf;
-	iov.iov_len = 1023;
+	iov.iov_base = buffer;
+	iov.iov_len  = buffer_size;
 
 	memset (&msg, 0, sizeof (struct msghdr));	
 	msg.msg_name       = 0;
@@ -459,7 +595,7 @@ axl_bool turbulence_process_receive_socket (VORTEX_SOCKET    * _socket,
 	msg.msg_iov        = &iov;
 	msg.msg_iovlen     = 1;
 	msg.msg_control    = ccmsg;
-	msg.msg_controllen = sizeof(ccmsg); 
+	msg.msg_controllen = CMSG_SPACE(sizeof(int) * max_sockets); 
 	
 	status = recvmsg (child->child_connection, &msg, 0);
 	if (status == -1) {
@@ -492,10 +628,6 @@ axl_bool turbulence_process_receive_socket (VORTEX_SOCKET    * _socket,
 		} /* end if */
 
 		(*_socket) = -1;
-		if (ancillary_data)
-			(*ancillary_data) = NULL;
-		if (size)
-			(*size) = 0;
 		return axl_false;
 	}
 
@@ -506,19 +638,58 @@ axl_bool turbulence_process_receive_socket (VORTEX_SOCKET    * _socket,
 		return axl_false;
 	}
 
+	/* report data received on the message */
+	(*size)   = status;
+
+	/* set sockets received */
+	int_ptr    = (int *) CMSG_DATA(cmsg);
+	(*count)   = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof (int);
+	if ((*count) > max_sockets)
+		(*count) = max_sockets;
+	(*_socket) = -1;
+	if ((*count) > 0)
+		memcpy (_socket, int_ptr, sizeof (int) * (*count));
+
+	msg ("%s: Process received socket %d (sockets: %d), checking to send received signal...", label, (*_socket), (*count));
+	return axl_true;
+}
+
+/** 
+ * @brief Allows to receive a socket from the parent on the child
+ * provided. In the case the function works, the socket references is
+ * updated with the socket descriptor.
+ *
+ * @param socket A reference where to set socket received. It cannot be NULL.
+ * @param child Child receiving the socket. 
+ *
+ * @return The function returns axl_false in the case of failure,
+ * otherwise axl_true is returned.
+ */
+axl_bool turbulence_process_receive_socket (VORTEX_SOCKET    * _socket, 
+					    TurbulenceChild  * child, 
+					    char            ** ancillary_data, 
+					    int              * size,
+					    const char       * label)
+{
+	char             buf[1024];
+	int              status = 0;
+	int              count  = 0;
+
+	if (ancillary_data)
+		(*ancillary_data) = NULL;
+	if (! __turbulence_process_receive_socket_common (_socket, 1, &count, child, buf, 1023, &status, label)) {
+		if (size)
+			(*size) = 0;
+		return axl_false;
+	} /* end if */
+
 	/* report data received on the message */
 	if (size)
 		(*size)   = status;
 	if (ancillary_data) {
 		(*ancillary_data) = axl_new (char, status + 1);
-		memcpy (*ancillary_data, iov.iov_base, status);
+		memcpy (*ancillary_data, buf, status);
 	}
-
-	/* set socket received */
-	int_ptr    = (int *) CMSG_DATA(cmsg);
-	(*_socket) = (*int_ptr);
-
-	msg ("%s: Process received socket %d, checking to send received signal...", label, (*_socket));
 	return axl_true;
 }
 
@@ -570,6 +741,209 @@ char * turbulence_process_connection_status_string (axl_bool          handle_sta
 				  skip_conn_recover);
 }
 
+/** 
+ * @internal Connection status record version and header size
+ * (command, version and 16 bits total length).
+ */
+#define TBC_CONN_STATUS_VERSION 1
+#define TBC_CONN_STATUS_HEADER  4
+
+axl_bool __turbulence_process_put_int (char * buffer, int buffer_size, int * pos, int value)
+{
+	unsigned char * ptr = (unsigned char *) buffer + (*pos);
+
+	if ((*pos) + 4 > buffer_size)
+		return axl_false;
+	ptr[0] = (value >> 24) & 0xff;
+	ptr[1] = (value >> 16) & 0xff;
+	ptr[2] = (value >> 8)  & 0xff;
+	ptr[3] = value         & 0xff;
+	(*pos) += 4;
+	return axl_true;
+}
+
+axl_bool __turbulence_process_put_str (char * buffer, int buffer_size, int * pos, const char * value)
+{
+	unsigned char * ptr    = (unsigned char *) buffer + (*pos);
+	int             length = value ? strlen (value) : 0;
+
+	/* length, content and trailing \0 */
+	if (length > 0xffff || (*pos) + 2 + length + 1 > buffer_size)
+		return axl_false;
+	ptr[0] = (length >> 8) & 0xff;
+	ptr[1] = length        & 0xff;
+	if (length > 0)
+		memcpy (ptr + 2, value, length);
+	ptr[2 + length] = 0;
+	(*pos) += 2 + length + 1;
+	return axl_true;
+}
+
+axl_bool __turbulence_process_get_int (const char * buffer, int size, int * pos, int * value)
+{
+	const unsigned char * ptr = (const unsigned char *) buffer + (*pos);
+
+	if ((*pos) + 4 > size)
+		return axl_false;
+	(*value) = (int) (((unsigned int) ptr[0] << 24) | ((unsigned int) ptr[1] << 16) | 
+			  ((unsigned int) ptr[2] << 8) | (unsigned int) ptr[3]);
+	(*pos) += 4;
+	return axl_true;
+}
+
+axl_bool __turbulence_process_get_str (const char * buffer, int size, int * pos, const char ** value)
+{
+	const unsigned char * ptr = (const unsigned char *) buffer + (*pos);
+	int                   length;
+
+	if ((*pos) + 2 > size)
+		return axl_false;
+	length = (ptr[0] << 8) | ptr[1];
+	if ((*pos) + 2 + length + 1 > size || ptr[2 + length] != 0)
+		return axl_false;
+
+	/* empty strings are reported as NULL */
+	(*value) = length > 0 ? (const char *) (ptr + 2) : NULL;
+	(*pos) += 2 + length + 1;
+	return axl_true;
+}
+
+/** 
+ * @internal Builds the binary record that represents the status of
+ * the BEEP session so the receiving child can reconstruct the
+ * connection. This is what is sent (as ancillary data along with the
+ * socket) for each connection handed off to a child already
+ * created. Strings are length prefixed so they are carried without
+ * escaping.
+ *
+ * The record is: 'n' command, version, total length (16 bits), the
+ * integer fields (32 bits, network byte order) and the string fields
+ * (16 bits length, content and \0).
+ *
+ * @param buffer The buffer where the record is written.
+ *
+ * @param buffer_size Buffer size (\ref TBC_CONN_STATUS_MAX is enough
+ * unless profile content is really big).
+ *
+ * @return Record size or -1 if it does not fit into the buffer.
+ */
+int      turbulence_process_connection_status_encode (char            * buffer,
+						      int               buffer_size,
+						      axl_bool          handle_start_reply,
+						      int               channel_num,
+						      const char      * profile,
+						      const char      * profile_content,
+						      VortexEncoding    encoding,
+						      const char      * serverName,
+						      int               msg_no,
+						      int               seq_no,
+						      int               seq_no_expected,
+						      int               ppath_id,
+						      int               has_tls,
+						      int               fix_server_name,
+						      const char      * remote_host,
+						      const char      * remote_port,
+						      const char      * remote_host_ip,
+						      int               skip_conn_recover)
+{
+	int pos   = TBC_CONN_STATUS_HEADER;
+	int flags = (has_tls ? 1 : 0) | (fix_server_name ? 2 : 0) | (skip_conn_recover ? 4 : 0);
+
+	if (buffer == NULL || buffer_size < TBC_CONN_STATUS_HEADER)
+		return -1;
+	if (buffer_size > 0xffff)
+		buffer_size = 0xffff;
+
+	if (! __turbulence_process_put_int (buffer, buffer_size, &pos, handle_start_reply) ||
+	    ! __turbulence_process_put_int (buffer, buffer_size, &pos, channel_num) ||
+	    ! __turbulence_process_put_int (buffer, buffer_size, &pos, encoding) ||
+	    ! __turbulence_process_put_int (buffer, buffer_size, &pos, msg_no) ||
+	    ! __turbulence_process_put_int (buffer, buffer_size, &pos, seq_no) ||
+	    ! __turbulence_process_put_int (buffer, buffer_size, &pos, seq_no_expected) ||
+	    ! __turbulence_process_put_int (buffer, buffer_size, &pos, ppath_id) ||
+	    ! __turbulence_process_put_int (buffer, buffer_size, &pos, flags) ||
+	    ! __turbulence_process_put_str (buffer, buffer_size, &pos, profile) ||
+	    ! __turbulence_process_put_str (buffer, buffer_size, &pos, profile_content) ||
+	    ! __turbulence_process_put_str (buffer, buffer_size, &pos, serverName) ||
+	    ! __turbulence_process_put_str (buffer, buffer_size, &pos, remote_host) ||
+	    ! __turbulence_process_put_str (buffer, buffer_size, &pos, remote_port) ||
+	    ! __turbulence_process_put_str (buffer, buffer_size, &pos, remote_host_ip))
+		return -1;
+
+	/* header */
+	buffer[0] = 'n';
+	buffer[1] = TBC_CONN_STATUS_VERSION;
+	buffer[2] = (pos >> 8) & 0xff;
+	buffer[3] = pos        & 0xff;
+	return pos;
+}
+
+/** 
+ * @internal Returns the total length of the record that starts with
+ * the header provided (at least \ref TBC_CONN_STATUS_HEADER bytes) or
+ * -1 if it is not a connection status record.
+ */
+int __turbulence_process_connection_status_length (const char * buffer)
+{
+	const unsigned char * ptr = (const unsigned char *) buffer;
+
+	if (ptr[0] != 'n' || ptr[1] != TBC_CONN_STATUS_VERSION)
+		return -1;
+	return (ptr[2] << 8) | ptr[3];
+}
+
+/** 
+ * @internal Decodes a record created by
+ * turbulence_process_connection_status_encode. No memory is
+ * allocated: strings inside status point into the buffer provided
+ * (empty strings are reported as NULL).
+ *
+ * @return axl_true if the record is valid and complete, otherwise
+ * axl_false.
+ */
+axl_bool turbulence_process_connection_status_decode (const char           * buffer,
+						      int                    size,
+						      TurbulenceConnStatus * status)
+{
+	int pos = TBC_CONN_STATUS_HEADER;
+	int value;
+	int flags;
+
+	if (buffer == NULL || status == NULL || size < TBC_CONN_STATUS_HEADER)
+		return axl_false;
+	if (__turbulence_process_connection_status_length (buffer) != size)
+		return axl_false;
+
+	if (! __turbulence_process_get_int (buffer, size, &pos, &value))
+		return axl_false;
+	status->handle_start_reply = value;
+	if (! __turbulence_process_get_int (buffer, size, &pos, &status->channel_num))
+		return axl_false;
+	if (! __turbulence_process_get_int (buffer, size, &pos, &value))
+		return axl_false;
+	status->encoding = value;
+	if (! __turbulence_process_get_int (buffer, size, &pos, &status->msg_no) ||
+	    ! __turbulence_process_get_int (buffer, size, &pos, &status->seq_no) ||
+	    ! __turbulence_process_get_int (buffer, size, &pos, &status->seq_no_expected) ||
+	    ! __turbulence_process_get_int (buffer, size, &pos, &status->ppath_id) ||
+	    ! __turbulence_process_get_int (buffer, size, &pos, &flags))
+		return axl_false;
+	status->has_tls           = (flags & 1) ? 1 : 0;
+	status->fix_server_name   = (flags & 2) ? 1 : 0;
+	status->skip_conn_recover = (flags & 4) ? axl_true : axl_false;
+
+	if (! __turbulence_process_get_str (buffer, size, &pos, &status->profile) ||
+	    ! __turbulence_process_get_str (buffer, size, &pos, &status->profile_content) ||
+	    ! __turbulence_process_get_str (buffer, size, &pos, &status->serverName) ||
+	    ! __turbulence_process_get_str (buffer, size, &pos, &status->remote_host) ||
+	    ! __turbulence_process_get_str (buffer, size, &pos, &status->remote_port) ||
+	    ! __turbulence_process_get_str (buffer, size, &pos, &status->remote_host_ip))
+		return axl_false;
+
+	/* all record consumed */
+	return (pos == size);
+}
+
 void turbulence_process_send_connection_to_child (TurbulenceCtx    * ctx, 
 						  TurbulenceChild  * child, 
 						  VortexConnection * conn, 
@@ -584,29 +958,37 @@ void turbulence_process_send_connection_to_child (TurbulenceCtx    * ctx,
 	VORTEX_SOCKET        client_socket;
 	VortexChannel      * channel0    = vortex_connection_get_channel (conn, 0);
 	TurbulencePPathDef * ppath       = turbulence_ppath_selected (conn);
-	char               * conn_status;
-
-	/* build connection status string */
-	conn_status = turbulence_process_connection_status_string (handle_start_reply, 
-								   channel_num,
-								   profile,
-								   profile_content,
-								   encoding,
-								   serverName,
-								   vortex_frame_get_msgno (frame),
-								   vortex_channel_get_next_seq_no (channel0),
-								   vortex_channel_get_next_expected_seq_no (channel0),
-								   turbulence_ppath_get_id (ppath),
-								   vortex_connection_is_tlsficated (conn),
-								   /* notify if we have to fix the serverName */
-								   axl_cmp (serverName, vortex_connection_get_server_name (conn)),
-								   /* get host, port and host ip */
-								   vortex_connection_get_host (conn), vortex_connection_get_port (conn), 
-								   vortex_connection_get_host_ip (conn),
-								   /* if proxied, skip recover on child */
-								   turbulence_conn_mgr_proxy_on_parent (conn));
+	char                 conn_status[TBC_CONN_STATUS_MAX];
+	int                  size;
+
+	/* build connection status record */
+	size = turbulence_process_connection_status_encode (conn_status, TBC_CONN_STATUS_MAX,
+							    handle_start_reply, 
+							    channel_num,
+							    profile,
+							    profile_content,
+							    encoding,
+							    serverName,
+							    vortex_frame_get_msgno (frame),
+							    vortex_channel_get_next_seq_no (channel0),
+							    vortex_channel_get_next_expected_seq_no (channel0),
+							    turbulence_ppath_get_id (ppath),
+							    vortex_connection_is_tlsficated (conn),
+							    /* notify if we have to fix the serverName */
+							    axl_cmp (serverName, vortex_connection_get_server_name (conn)),
+							    /* get host, port and host ip */
+							    vortex_connection_get_host (conn), vortex_connection_get_port (conn), 
+							    vortex_connection_get_host_ip (conn),
+							    /* if proxied, skip recover on child */
+							    turbulence_conn_mgr_proxy_on_parent (conn));
+	if (size <= 0) {
+		error ("PARENT: unable to build connection status record for conn-id=%d (too big?), closing connection",
+		       vortex_connection_get_id (conn));
+		vortex_connection_shutdown (conn);
+		return;
+	} /* end if */
 	
-	msg ("Sending connection to child already created, ancillary data ('%s') size: %d", conn_status, (int) strlen (conn_status));
+	msg ("Sending connection to child already created, connection status record size: %d", size);
 
 	/* socket that is know handled by the child process */
 	client_socket = vortex_connection_get_socket (conn);
@@ -619,20 +1001,14 @@ void turbulence_process_send_connection_to_child (TurbulenceCtx    * ctx,
 
 	/* send the socket descriptor to the child to avoid holding a
 	   bucket in the parent */
-	if (! turbulence_process_send_socket (client_socket, child, conn_status, strlen (conn_status))) {
+	if (! turbulence_process_send_socket (client_socket, child, conn_status, size)) {
 		error ("PARENT: Something failed while sending socket (%d) to child pid %d already created, error (code %d): %s",
 		       client_socket, child->pid, errno, vortex_errno_get_last_error ());
 
-		/* release ancillary data */
-		axl_free (conn_status);
-
 		/* close connection */
 		vortex_connection_shutdown (conn);
 		return;
 	}
-
-	/* release ancillary data */
-	axl_free (conn_status);
 	
 	/* terminate the connection */
 	vortex_connection_shutdown (conn);
@@ -654,48 +1030,51 @@ axl_bool turbulence_process_send_proxy_connection_to_child (TurbulenceCtx    * c
 {
 	VortexChannel      * channel0    = vortex_connection_get_channel (conn, 0);
 	TurbulencePPathDef * ppath       = turbulence_ppath_selected (conn);
-	char               * conn_status;
-
-	/* build connection status string */
-	conn_status = turbulence_process_connection_status_string (handle_start_reply, 
-								   channel_num,
-								   profile,
-								   profile_content,
-								   encoding,
-								   serverName,
-								   vortex_frame_get_msgno (frame),
-								   vortex_channel_get_next_seq_no (channel0),
-								   vortex_channel_get_next_expected_seq_no (channel0),
-								   turbulence_ppath_get_id (ppath),
-								   vortex_connection_is_tlsficated (conn),
-								   /* notify if we have to fix the serverName */
-								   axl_cmp (serverName, vortex_connection_get_server_name (conn)),
-								   /* host and port */
-								   vortex_connection_get_host (conn), vortex_connection_get_port (conn),
-								   vortex_connection_get_host_ip (conn),
-								   /* if proxied, skip recover on child */
-								   turbulence_conn_mgr_proxy_on_parent (conn));
+	char                 conn_status[TBC_CONN_STATUS_MAX];
+	int                  size;
+
+	/* build connection status record */
+	size = turbulence_process_connection_status_encode (conn_status, TBC_CONN_STATUS_MAX,
+							    handle_start_reply, 
+							    channel_num,
+							    profile,
+							    profile_content,
+							    encoding,
+							    serverName,
+							    vortex_frame_get_msgno (frame),
+							    vortex_channel_get_next_seq_no (channel0),
+							    vortex_channel_get_next_expected_seq_no (channel0),
+							    turbulence_ppath_get_id (ppath),
+							    vortex_connection_is_tlsficated (conn),
+							    /* notify if we have to fix the serverName */
+							    axl_cmp (serverName, vortex_connection_get_server_name (conn)),
+							    /* host and port */
+							    vortex_connection_get_host (conn), vortex_connection_get_port (conn),
+							    vortex_connection_get_host_ip (conn),
+							    /* if proxied, skip recover on child */
+							    turbulence_conn_mgr_proxy_on_parent (conn));
+	if (size <= 0) {
+		error ("PARENT: (PROXY) unable to build connection status record for conn-id=%d (too big?), closing connection",
+		       vortex_connection_get_id (conn));
+		vortex_connection_shutdown (conn);
+		vortex_close_socket (client_socket);
+		return axl_false;
+	} /* end if */
 	
-	msg ("PARENT: (PROXY) Sending connection to child already created, ancillary data ('%s') size: %d", conn_status, (int) strlen (conn_status));
+	msg ("PARENT: (PROXY) Sending connection to child already created, connection status record size: %d", size);
 
 	/* send the socket descriptor to the child to avoid holding a
 	   bucket in the parent */
-	if (! turbulence_process_send_socket (client_socket, child, conn_status, strlen (conn_status))) {
+	if (! turbulence_process_send_socket (client_socket, child, conn_status, size)) {
 		error ("PARENT: Something failed while sending socket (%d) to child pid %d already created, error (code %d): %s",
 		       client_socket, child->pid, errno, vortex_errno_get_last_error ());
 
-		/* release ancillary data */
-		axl_free (conn_status);
-
 		/* close connection */
 		vortex_connection_shutdown (conn);
 		vortex_close_socket (client_socket);
 		return axl_false;
 	}
 
-	/* release ancillary data */
-	axl_free (conn_status);
-
 	/* report ok operation */
 	return axl_true;
 }
@@ -943,110 +1322,177 @@ void     turbulence_process_connection_recover_status (char            * conn_st
 	return;
 }
 
-VortexConnection * __turbulence_process_handle_connection_received (TurbulenceCtx      * ctx, 
-								    TurbulencePPathDef * ppath,
-								    VORTEX_SOCKET        _socket, 
-								    char               * conn_status)
+/** 
+ * @internal Sends to the parent the connection closed notifications
+ * pending (one 'c' byte each) without blocking. Must be called with
+ * the child mutex acquired.
+ *
+ * @return axl_true if notifications are still pending (control
+ * connection full), otherwise axl_false.
+ */
+axl_bool __turbulence_process_flush_conn_closed (TurbulenceCtx * ctx, TurbulenceChild * child)
 {
-	axl_bool           handle_start_reply = axl_false;
-	int                channel_num        = -1;
-	const char       * profile            = NULL;
-	const char       * profile_content    = NULL;
-	const char       * serverName         = NULL;
-	VortexEncoding     encoding           = EncodingNone;
-	VortexConnection * conn               = NULL;
-	int                msg_no             = -1;
-	int                seq_no             = -1;
-	int                seq_no_expected    = -1;
-	int                ppath_id           = -1;
-	int                has_tls            = 0;
-	VortexFrame      * frame              = NULL;
-	VortexChannel    * channel0;
-	int                fix_server_name    = 0;
-	const char       * remote_host        = NULL;
-	const char       * remote_port        = NULL;
-	const char       * remote_host_ip     = NULL;
+	char buffer[64];
+	int  size;
+	int  written;
+
+	while (child->closes_pending > 0) {
+		size = child->closes_pending;
+		if (size > (int) sizeof (buffer))
+			size = sizeof (buffer);
+		memset (buffer, 'c', size);
+
+		written = send (child->child_connection, buffer, size, MSG_NOSIGNAL | MSG_DONTWAIT);
+		if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+			return axl_true;
+		if (written <= 0) {
+			/* parent is gone */
+			wrn ("CHILD: failed to notify parent about %d connections closed, errno: %d", 
+			     child->closes_pending, errno);
+			child->closes_pending = 0;
+			return axl_false;
+		} /* end if */
+		child->closes_pending -= written;
+	} /* end while */
 
-	/* check connection status after continue */
-	if (conn_status == NULL || strlen (conn_status) == 0) {
-		error ("CHILD: internal server error, received conn_status string NULL or empty, socket=%d (ppath: %s), unable to initialize connection on child",
-		       _socket, turbulence_ppath_get_name (ppath));
-		vortex_close_socket (_socket);
-		return NULL;
-	} /* end if */
+	return axl_false;
+}
 
-	/* call to recover data from string */
-	msg ("CHILD: processing conn_status received: [%s]", conn_status);
-	turbulence_process_connection_recover_status (conn_status, 
-						      &handle_start_reply,
-						      &channel_num,
-						      &profile, 
-						      &profile_content,
-						      &encoding,
-						      &serverName,
-						      &msg_no,
-						      &seq_no,
-						      &seq_no_expected,
-						      &ppath_id,
-						      &has_tls,
-						      &remote_host,
-						      &remote_port,
-						      &remote_host_ip,
-						      &fix_server_name);
+/** 
+ * @internal Child loop handler called once the control connection
+ * can be written to send connection closed notifications pending.
+ */
+axl_bool __turbulence_process_conn_closed_ready (TurbulenceLoop * loop, 
+						 TurbulenceCtx  * ctx,
+						 int              descriptor, 
+						 axlPointer       ptr, 
+						 axlPointer       ptr2)
+{
+	TurbulenceChild * child = ptr;
+	axl_bool          pending;
 
-	msg ("CHILD: Received conn_status: handle_start_reply=%d, channel_num=%d, profile=%s, profile_content=%s, encoding=%d, serverName=%s, msg_no=%d, seq_no=%d, ppath_id=%d, has_tls=%d, fix_server_name=%d, remote_host=%s, remote_port=%s, remote_host_ip=%s",
-	     handle_start_reply, channel_num, 
-	     profile ? profile : "", 
-	     profile_content ? profile_content : "", encoding, 
-	     serverName ? serverName : "",
-	     msg_no,
-	     seq_no,
-	     ppath_id, has_tls, fix_server_name,
-	     remote_host ? remote_host : "", 
-	     remote_port ? remote_port : "",
-	     remote_host_ip ? remote_host_ip : "");
+	vortex_mutex_lock (&child->mutex);
+	pending = __turbulence_process_flush_conn_closed (ctx, child);
+	if (! pending)
+		child->closes_watching = axl_false;
+	vortex_mutex_unlock (&child->mutex);
 
-	/* create a connection and register it on local vortex
-	   reader */
-	conn = vortex_connection_new_empty (TBC_VORTEX_CTX (ctx), _socket, VortexRoleListener);
-	if (conn == NULL) {
-		error ("CHILD: internal server error, unable to create connection object at child (socket=%d, role=listener)", _socket);
-		return NULL;
-	}
+	return pending;
+}
 
-	/* setup host and port manually */
-	if (remote_host && remote_port) {
-		/* call to setup host and port */
-		vortex_connection_set_host_and_port (conn, remote_host, remote_port, remote_host_ip);
-	}
+/** 
+ * @internal Notifies the parent (through the child control
+ * connection) that a connection handled by this child was closed, so
+ * it can balance connections across childs of the same profile path
+ * (children-per-ppath).
+ */
+void __turbulence_process_notify_conn_closed (VortexConnection * conn, axlPointer _ctx)
+{
+	TurbulenceCtx   * ctx = _ctx;
+	TurbulenceChild * child;
+
+	if (ctx->child == NULL || ctx->child->child_connection <= 0)
+		return;
+	child = ctx->child;
+
+	/* never block the child: notifications not sent are kept
+	 * until the control connection can be written (the parent
+	 * reads these bytes from its notify loop) */
+	vortex_mutex_lock (&child->mutex);
+	child->closes_pending++;
+	if (__turbulence_process_flush_conn_closed (ctx, child) && ! child->closes_watching && child->child_conn_loop) {
+		child->closes_watching = axl_true;
+		turbulence_loop_watch_write (child->child_conn_loop, child->child_connection, 
+					     __turbulence_process_conn_closed_ready, child, NULL);
+	} /* end if */
+	vortex_mutex_unlock (&child->mutex);
+	return;
+}
+
+/** 
+ * @internal Same as __turbulence_process_notify_conn_closed but for
+ * connections received from the parent that could not be restored
+ * (only if the parent is tracking connections for this profile
+ * path).
+ */
+void __turbulence_process_notify_conn_failed (TurbulenceCtx * ctx, TurbulencePPathDef * ppath)
+{
+	if (ctx->child && ppath && ppath->children_per_ppath > 1)
+		__turbulence_process_notify_conn_closed (NULL, ctx);
+	return;
+}
+
+/** 
+ * @internal Restores at the child the connection received from the
+ * parent (socket) with the status provided.
+ */
+VortexConnection * __turbulence_process_restore_connection (TurbulenceCtx        * ctx, 
+							    TurbulencePPathDef   * ppath,
+							    VORTEX_SOCKET          _socket, 
+							    TurbulenceConnStatus * status)
+{
+	VortexConnection * conn               = NULL;
+	VortexFrame      * frame              = NULL;
+	VortexChannel    * channel0;
+
+	msg ("CHILD: Received conn_status: handle_start_reply=%d, channel_num=%d, profile=%s, profile_content=%s, encoding=%d, serverName=%s, msg_no=%d, seq_no=%d, ppath_id=%d, has_tls=%d, fix_server_name=%d, remote_host=%s, remote_port=%s, remote_host_ip=%s",
+	     status->handle_start_reply, status->channel_num, 
+	     status->profile ? status->profile : "", 
+	     status->profile_content ? status->profile_content : "", status->encoding, 
+	     status->serverName ? status->serverName : "",
+	     status->msg_no,
+	     status->seq_no,
+	     status->ppath_id, status->has_tls, status->fix_server_name,
+	     status->remote_host ? status->remote_host : "", 
+	     status->remote_port ? status->remote_port : "",
+	     status->remote_host_ip ? status->remote_host_ip : "");
+
+	/* create a connection and register it on local vortex
+	   reader */
+	conn = vortex_connection_new_empty (TBC_VORTEX_CTX (ctx), _socket, VortexRoleListener);
+	if (conn == NULL) {
+		error ("CHILD: internal server error, unable to create connection object at child (socket=%d, role=listener)", _socket);
+		__turbulence_process_notify_conn_failed (ctx, ppath);
+		return NULL;
+	}
+
+	/* notify parent once the connection is closed */
+	if (ctx->child && ppath && ppath->children_per_ppath > 1)
+		vortex_connection_set_on_close_full (conn, __turbulence_process_notify_conn_closed, ctx);
+
+	/* setup host and port manually */
+	if (status->remote_host && status->remote_port) {
+		/* call to setup host and port */
+		vortex_connection_set_host_and_port (conn, status->remote_host, status->remote_port, status->remote_host_ip);
+	}
 
 	/* notify about the connection received and setup serverName
 	 * if required by the parent server */
 	msg ("CHILD: New connection id=%d (%s:%s) accepted on child pid=%d", 
 	     vortex_connection_get_id (conn), vortex_connection_get_host (conn), vortex_connection_get_port (conn), getpid ());
-	if (fix_server_name && serverName) {
+	if (status->fix_server_name && status->serverName) {
 		msg ("CHILD: setting connection-id=%d serverName=%s as indicated by parent process", 
-		     vortex_connection_get_id (conn), serverName);
+		     vortex_connection_get_id (conn), status->serverName);
 		/* setup server name */
-		vortex_connection_set_server_name (conn, serverName);
+		vortex_connection_set_server_name (conn, status->serverName);
 	} /* end if */
 
 	/* set profile path state */
-	__turbulence_ppath_set_state (ctx, conn, ppath_id, serverName);
+	__turbulence_ppath_set_state (ctx, conn, status->ppath_id, status->serverName);
 
 	/* set TLS status */
-	if (has_tls > 0) {
+	if (status->has_tls > 0) {
 		vortex_connection_set_data (conn, "tls-fication:status", INT_TO_PTR (axl_true));
 		msg ("CHILD: flagging the connection to have tls enabled (for profile path activation, fake TLS socket), conn-id=%d (%d)",
 		     vortex_connection_get_id (conn), vortex_connection_is_tlsficated (conn));
 	} 
 
-	if (handle_start_reply) {
+	if (status->handle_start_reply) {
 		/* build a fake frame to simulate the frame received from the
 		   parent */
 		frame = vortex_frame_create (TBC_VORTEX_CTX (ctx), 
 					     VORTEX_FRAME_TYPE_MSG,
-					     0, msg_no, axl_false, -1, 0, 0, NULL);
+					     0, status->msg_no, axl_false, -1, 0, 0, NULL);
 		/* update channel 0 status */
 		channel0 = vortex_connection_get_channel (conn, 0);
 		if (channel0 == NULL) {
@@ -1061,14 +1507,14 @@ VortexConnection * __turbulence_process_handle_connection_received (TurbulenceCt
 		} /* end if */
 
 		/* call to set channel state */
-		__vortex_channel_set_state (channel0, msg_no, seq_no, seq_no_expected, 0);
+		__vortex_channel_set_state (channel0, status->msg_no, status->seq_no, status->seq_no_expected, 0);
 	}
 
 	/* call to register */
 	if (! __turbulence_process_common_new_connection (ctx, conn, ppath,
-							  handle_start_reply, channel_num,
-							  profile, profile_content,
-							  encoding, serverName, frame)) {
+							  status->handle_start_reply, status->channel_num,
+							  status->profile, status->profile_content,
+							  status->encoding, status->serverName, frame)) {
 		/* nullify conn on error */
 		conn = NULL;
 	}
@@ -1078,6 +1524,111 @@ VortexConnection * __turbulence_process_handle_connection_received (TurbulenceCt
 	return conn;
 }
 
+/** 
+ * @internal Restores at the child the connection received from the
+ * parent (socket) with the status provided as a string (child init
+ * string, see turbulence_process_connection_status_string).
+ */
+VortexConnection * __turbulence_process_handle_connection_received (TurbulenceCtx      * ctx, 
+								    TurbulencePPathDef * ppath,
+								    VORTEX_SOCKET        _socket, 
+								    char               * conn_status)
+{
+	TurbulenceConnStatus status;
+
+	/* check connection status after continue */
+	if (conn_status == NULL || strlen (conn_status) == 0) {
+		error ("CHILD: internal server error, received conn_status string NULL or empty, socket=%d (ppath: %s), unable to initialize connection on child",
+		       _socket, turbulence_ppath_get_name (ppath));
+		vortex_close_socket (_socket);
+		__turbulence_process_notify_conn_failed (ctx, ppath);
+		return NULL;
+	} /* end if */
+
+	/* call to recover data from string */
+	msg ("CHILD: processing conn_status received: [%s]", conn_status);
+	memset (&status, 0, sizeof (TurbulenceConnStatus));
+	turbulence_process_connection_recover_status (conn_status, 
+						      &status.handle_start_reply,
+						      &status.channel_num,
+						      &status.profile, 
+						      &status.profile_content,
+						      &status.encoding,
+						      &status.serverName,
+						      &status.msg_no,
+						      &status.seq_no,
+						      &status.seq_no_expected,
+						      &status.ppath_id,
+						      &status.fix_server_name,
+						      &status.remote_host,
+						      &status.remote_port,
+						      &status.remote_host_ip,
+						      &status.has_tls);
+
+	return __turbulence_process_restore_connection (ctx, ppath, _socket, &status);
+}
+
+/** 
+ * @internal Broadcast record version and header size (command,
+ * version and 16 bits total length). The record is followed by the
+ * content size and the profile, while the content is read from the
+ * descriptor sent along with the record.
+ */
+#define TBC_BROADCAST_VERSION 1
+#define TBC_BROADCAST_HEADER  4
+
+/** 
+ * @internal Returns the length of the broadcast record found in the
+ * buffer or -1 if it is not a broadcast record.
+ */
+int __turbulence_process_broadcast_length (const char * buffer)
+{
+	const unsigned char * ptr = (const unsigned char *) buffer;
+
+	if (ptr[0] != 'b' || ptr[1] != TBC_BROADCAST_VERSION)
+		return -1;
+	return (ptr[2] << 8) | ptr[3];
+}
+
+/** 
+ * @internal Handles a broadcast record received from the parent,
+ * mapping the content from the descriptor received (not closed).
+ */
+axl_bool __turbulence_process_broadcast_received (TurbulenceCtx * ctx, const char * record, int length, int fd)
+{
+	int          pos          = TBC_BROADCAST_HEADER;
+	int          message_size = 0;
+	int          profile_size;
+	const char * profile;
+	void       * content;
+
+	/* decode content size and profile */
+	if (! __turbulence_process_get_int (record, length, &pos, &message_size) || message_size < 0 || pos + 2 > length)
+		return axl_false;
+	profile_size = (((const unsigned char *) record)[pos] << 8) | ((const unsigned char *) record)[pos + 1];
+	profile      = record + pos + 2;
+	if (pos + 2 + profile_size + 1 > length || profile_size == 0)
+		return axl_false;
+
+	/* map content (empty messages have nothing to map) */
+	content = "";
+	if (message_size > 0) {
+		content = mmap (NULL, message_size, PROT_READ, MAP_SHARED, fd, 0);
+		if (content == MAP_FAILED) {
+			error ("CHILD: unable to map broadcast content (size: %d), errno: %d:%s", 
+			       message_size, errno, vortex_errno_get_last_error ());
+			return axl_false;
+		} /* end if */
+	} /* end if */
+
+	msg ("CHILD: broadcast relayed by parent on profile %s (size: %d)", profile, message_size);
+	turbulence_conn_mgr_broadcast_msg (ctx, content, message_size, profile, NULL, NULL);
+
+	if (message_size > 0)
+		munmap (content, message_size);
+	return axl_true;
+}
+
 /** 
  * @internal Function called each time a notification from the parent
  * is received on the child.
@@ -1088,23 +1639,39 @@ axl_bool turbulence_process_parent_notify (TurbulenceLoop * loop,
 					   axlPointer       ptr, 
 					   axlPointer       ptr2)
 {
-	int                _socket         = -1;
-	TurbulenceChild  * child          = (TurbulenceChild *) ptr;
-	char             * ancillary_data = NULL;
-	const char       * label          = ctx->child ? "CHILD" : "PARENT";
+	VORTEX_SOCKET          sockets[TBC_HANDOFF_BATCH];
+	int                    count          = 0;
+	TurbulenceChild      * child          = (TurbulenceChild *) ptr;
+	char                   ancillary_data[TBC_HANDOFF_BUFFER];
+	int                    size           = 0;
+	int                    offset         = 0;
+	int                    length         = -1;
+	int                    iterator       = 0;
+	TurbulenceConnStatus   status;
+	const char           * label          = ctx->child ? "CHILD" : "PARENT";
 	
 	msg ("%s: notification on control connection, read content", label);
 
-	/* receive socket */
-	if (! turbulence_process_receive_socket (&_socket, child, &ancillary_data, NULL, label)) {
+	/* receive sockets (without allocating ancillary data): the
+	 * parent may send several connections in one message */
+	if (! __turbulence_process_receive_socket_common (sockets, TBC_HANDOFF_BATCH, &count, child, 
+							  ancillary_data, TBC_HANDOFF_BUFFER, &size, label)) {
 		error ("%s: Failed to receive socket.. (turbulence_process_receive_socket failed)", label);
+
+		/* a child without connections (for example, a spare
+		 * child never used) has nothing left to do once the
+		 * parent control connection is lost */
+		if (ctx->child && turbulence_conn_mgr_count (ctx) == 0) {
+			msg ("CHILD: parent control connection lost without connections to handle, finishing..");
+			vortex_listener_unlock (TBC_VORTEX_CTX (ctx));
+		} /* end if */
 		return axl_false; /* close parent notification socket */
 	}
 
 	/* check content received */
-	if (ancillary_data == NULL || strlen (ancillary_data) == 0 || _socket <= 0) {
-		error ("%s: Ancillary data is null (%p) or empty or socket returned is not valid (%d)",
-		       label, ancillary_data, _socket);
+	if (size <= 0 || count <= 0 || sockets[0] <= 0) {
+		error ("%s: Ancillary data is empty (size: %d) or socket returned is not valid (%d, sockets: %d)",
+		       label, size, count > 0 ? sockets[0] : -1, count);
 		goto release_content;
 	}
 
@@ -1115,23 +1682,81 @@ axl_bool turbulence_process_parent_notify (TurbulenceLoop * loop,
 		   current process (due to fork call) but the parent
 		   still send us this socket to avoid having a file
 		   descriptor used bucket. */
-		wrn ("%s: closing socket=%d because it is already owned by the child process (due to fork call)", label, _socket);
+		wrn ("%s: closing socket=%d because it is already owned by the child process (due to fork call)", label, sockets[0]);
 	} else if (ancillary_data[0] == 'n') {
-		/* received notification if a new, unknown connection,
-		   register it */
-		msg ("%s: Received socket %d, and ancillary_data[0]='%c' (processing)", 
-		     label, _socket, ancillary_data[0]);
-		__turbulence_process_handle_connection_received (ctx, child->ppath, _socket, ancillary_data + 1);
-		_socket = -1; /* avoid socket be closed */
+		/* received notification of new, unknown connections
+		   (one connection status record for each socket),
+		   register them */
+		while (iterator < count) {
+			/* complete the record in case it was not
+			 * received at once */
+			if (offset + TBC_CONN_STATUS_HEADER > size &&
+			    offset + TBC_CONN_STATUS_HEADER <= TBC_HANDOFF_BUFFER &&
+			    recv (descriptor, ancillary_data + size, offset + TBC_CONN_STATUS_HEADER - size, MSG_WAITALL) == (offset + TBC_CONN_STATUS_HEADER - size))
+				size = offset + TBC_CONN_STATUS_HEADER;
+			length = (offset + TBC_CONN_STATUS_HEADER <= size) ? __turbulence_process_connection_status_length (ancillary_data + offset) : -1;
+			if (length > 0 && offset + length > size && offset + length <= TBC_HANDOFF_BUFFER &&
+			    recv (descriptor, ancillary_data + size, offset + length - size, MSG_WAITALL) == (offset + length - size))
+				size = offset + length;
+
+			if (length <= 0 || offset + length > size ||
+			    ! turbulence_process_connection_status_decode (ancillary_data + offset, length, &status)) {
+				error ("%s: Received invalid connection status record (offset: %d, size: %d, expected: %d), closing %d sockets",
+				       label, offset, size, length, count - iterator);
+				while (iterator < count) {
+					__turbulence_process_notify_conn_failed (ctx, child->ppath);
+					iterator++;
+				} /* end while */
+				goto release_content;
+			} /* end if */
+
+			msg ("%s: Received socket %d (%d/%d), and ancillary_data[0]='%c' (processing)", 
+			     label, sockets[iterator], iterator + 1, count, ancillary_data[offset]);
+			__turbulence_process_restore_connection (ctx, child->ppath, sockets[iterator], &status);
+			sockets[iterator] = -1; /* avoid socket be closed */
+
+			/* next record */
+			offset += length;
+			iterator++;
+		} /* end while */
+	} else if (ancillary_data[0] == 'b') {
+		/* received broadcasts relayed by the parent (one
+		 * record for each descriptor with the content),
+		 * send them on local connections */
+		while (iterator < count) {
+			if (offset + TBC_BROADCAST_HEADER > size &&
+			    offset + TBC_BROADCAST_HEADER <= TBC_HANDOFF_BUFFER &&
+			    recv (descriptor, ancillary_data + size, offset + TBC_BROADCAST_HEADER - size, MSG_WAITALL) == (offset + TBC_BROADCAST_HEADER - size))
+				size = offset + TBC_BROADCAST_HEADER;
+			length = (offset + TBC_BROADCAST_HEADER <= size) ? __turbulence_process_broadcast_length (ancillary_data + offset) : -1;
+			if (length > 0 && offset + length > size && offset + length <= TBC_HANDOFF_BUFFER &&
+			    recv (descriptor, ancillary_data + size, offset + length - size, MSG_WAITALL) == (offset + length - size))
+				size = offset + length;
+
+			if (length <= 0 || offset + length > size ||
+			    ! __turbulence_process_broadcast_received (ctx, ancillary_data + offset, length, sockets[iterator])) {
+				error ("%s: Received invalid broadcast record (offset: %d, size: %d, expected: %d), skipping %d broadcasts",
+				       label, offset, size, length, count - iterator);
+				goto release_content;
+			} /* end if */
+
+			/* next record */
+			offset += length;
+			iterator++;
+		} /* end while */
 	} else {
-		msg ("%s: Unknown command, socket received (%d), ancillary data: %s", 
-		     label, _socket, ancillary_data);
+		msg ("%s: Unknown command, sockets received (%d), command: '%c'", 
+		     label, count, ancillary_data[0]);
 	}
 
-	/* release data received */
+	/* release sockets not used */
  release_content:
-	axl_free (ancillary_data);
-	vortex_close_socket (_socket);
+	iterator = 0;
+	while (iterator < count) {
+		if (sockets[iterator] > 0)
+			vortex_close_socket (sockets[iterator]);
+		iterator++;
+	} /* end while */
 
 	return axl_true; /* don't close descriptor */
 }
@@ -1194,7 +1819,9 @@ int __turbulence_process_release_parent_connections (TurbulenceCtx    * ctx,
 				       ctx, child_conn, NULL);
 
 	/* release temporal listener created by the parent for
-	 * master<->child link  */
+	 * master<->child link (not defined for the zygote process) */
+	if (child == NULL)
+		return 0;
 	conn          = child->conn_mgr;
 	client_socket = vortex_connection_get_socket (conn);
 	msg ("CHILD: Setting close on exec on socket: %d (conn id: %d, role: %d)", client_socket, 
@@ -1233,6 +1860,92 @@ void __turbulence_process_prepare_logging (TurbulenceCtx * ctx, axl_bool is_pare
 	return;
 }
 
+/** 
+ * @internal Creates a pipe closed on exec: childs are created
+ * concurrently so a child must not inherit the log pipes created for
+ * another one (see __turbulence_process_keep_log_pipes).
+ */
+int __turbulence_process_pipe (int * fds)
+{
+#if defined(__linux__) && defined(O_CLOEXEC)
+	return pipe2 (fds, O_CLOEXEC);
+#else
+	if (pipe (fds) != 0)
+		return -1;
+	fcntl (fds[0], F_SETFD, fcntl (fds[0], F_GETFD) | FD_CLOEXEC);
+	fcntl (fds[1], F_SETFD, fcntl (fds[1], F_GETFD) | FD_CLOEXEC);
+	return 0;
+#endif
+}
+
+/** 
+ * @internal Creates the pipes used to transport child logs to the
+ * parent (only when log is enabled).
+ */
+void __turbulence_process_open_log_pipes (TurbulenceCtx * ctx, int * general_log, int * error_log, int * access_log, int * vortex_log)
+{
+	if (! turbulence_log_is_enabled (ctx))
+		return;
+
+	if (__turbulence_process_pipe (general_log) != 0)
+		error ("unable to create pipe to transport general log, this will cause these logs to be lost");
+	if (__turbulence_process_pipe (error_log) != 0)
+		error ("unable to create pipe to transport error log, this will cause these logs to be lost");
+	if (__turbulence_process_pipe (access_log) != 0)
+		error ("unable to create pipe to transport access log, this will cause these logs to be lost");
+	if (__turbulence_process_pipe (vortex_log) != 0)
+		error ("unable to create pipe to transport vortex log, this will cause these logs to be lost");
+	return;
+}
+
+/** 
+ * @internal Called by the child (after fork, before exec) to keep
+ * the log pipes created for it: the child init string references
+ * both ends of each pipe.
+ */
+void __turbulence_process_keep_log_pipes (int * general_log, int * error_log, int * access_log, int * vortex_log)
+{
+	int   iterator;
+	int * pipes[4];
+
+	pipes[0] = general_log;
+	pipes[1] = error_log;
+	pipes[2] = access_log;
+	pipes[3] = vortex_log;
+	for (iterator = 0; iterator < 4; iterator++) {
+		if (pipes[iterator][0] >= 0)
+			fcntl (pipes[iterator][0], F_SETFD, fcntl (pipes[iterator][0], F_GETFD) & ~FD_CLOEXEC);
+		if (pipes[iterator][1] >= 0)
+			fcntl (pipes[iterator][1], F_SETFD, fcntl (pipes[iterator][1], F_GETFD) & ~FD_CLOEXEC);
+	} /* end for */
+	return;
+}
+
+/** 
+ * @internal Closes the pipes created by
+ * __turbulence_process_open_log_pipes when the child they were
+ * created for couldn't be started.
+ */
+void __turbulence_process_close_log_pipes (int * general_log, int * error_log, int * access_log, int * vortex_log)
+{
+	int   iterator;
+	int * pipes[4];
+
+	pipes[0] = general_log;
+	pipes[1] = error_log;
+	pipes[2] = access_log;
+	pipes[3] = vortex_log;
+	for (iterator = 0; iterator < 4; iterator++) {
+		if (pipes[iterator][0] >= 0)
+			vortex_close_socket (pipes[iterator][0]);
+		if (pipes[iterator][1] >= 0)
+			vortex_close_socket (pipes[iterator][1]);
+		pipes[iterator][0] = -1;
+		pipes[iterator][1] = -1;
+	} /* end for */
+	return;
+}
+
 /** 
  * @internal Allows to check child limit (global and profile path
  * limits).
@@ -1253,7 +1966,7 @@ axl_bool turbulence_process_check_child_limit (TurbulenceCtx      * ctx,
 {
 	msg ("Checking global child limit: %d before creating process.", ctx->global_child_limit);
 
-	if (axl_hash_items (ctx->child_process) >= ctx->global_child_limit) {
+	if ((axl_hash_items (ctx->child_process) + ctx->childs_starting) >= ctx->global_child_limit) {
 		error ("Child limit reached (%d), unable to accept connection on child process, closing conn-id=%d", 
 		       ctx->global_child_limit, vortex_connection_get_id (conn));
 
@@ -1276,151 +1989,661 @@ axl_bool turbulence_process_check_child_limit (TurbulenceCtx      * ctx,
 	return axl_false; /* limit NOT reached */
 }
 
-axl_bool __turbulence_process_show_conn_keys (axlPointer key, axlPointer data, axlPointer user_data)
+/** 
+ * @internal Same check as turbulence_process_check_child_limit but
+ * without a connection involved (no log and nothing closed). Must be
+ * called with the child process mutex acquired.
+ *
+ * @return axl_true in the case the limit was reached, otherwise
+ * axl_false is returned.
+ */
+axl_bool __turbulence_process_child_limit_reached (TurbulenceCtx      * ctx,
+						   TurbulencePPathDef * def)
 {
-#if ! defined(SHOW_FORMAT_BUGS)
-	TurbulenceCtx * ctx = user_data;
-#endif
+	/* global limit */
+	if ((axl_hash_items (ctx->child_process) + ctx->childs_starting) >= ctx->global_child_limit)
+		return axl_true;
 
-	msg ("PARENT: found key %s", (const char *) key);
+	/* profile path limit */
+	if (def && def->child_limit > 0 && def->childs_running >= def->child_limit)
+		return axl_true;
 
-	return axl_false; /* don't stop the process */
+	return axl_false;
 }
 
+/** 
+ * @internal Connection waiting in a profile path admission queue
+ * (admission-queue) along with the values required to create its
+ * child once it is admitted. Protected by the child process mutex.
+ */
+typedef struct _TurbulenceAdmission {
+	TurbulenceCtx      * ctx;
+	VortexConnection   * conn;
+	TurbulencePPathDef * def;
+
+	/* values received by turbulence_process_create_child */
+	axl_bool             handle_start_reply;
+	int                  channel_num;
+	char               * profile;
+	char               * profile_content;
+	VortexEncoding       encoding;
+	char               * serverName;
+	VortexFrame        * frame;
+
+	/* when the connection was queued */
+	struct timeval       start;
+
+	/* a task to resume the connection is already scheduled */
+	axl_bool             resuming;
+} TurbulenceAdmission;
+
+axl_bool __turbulence_process_create_child (TurbulenceCtx       * ctx, 
+					    VortexConnection    * conn, 
+					    TurbulencePPathDef  * def,
+					    axl_bool              handle_start_reply,
+					    int                   channel_num,
+					    const char          * profile,
+					    const char          * profile_content,
+					    VortexEncoding        encoding,
+					    char                * serverName,
+					    VortexFrame         * frame,
+					    TurbulenceAdmission * admission);
 
 /** 
- * @internal Function used to send child init string to the child
- * process.
+ * @internal Releases a connection that left the admission queue.
  */
-axl_bool __turbulence_process_send_child_init_string (TurbulenceCtx       * ctx,
-						      TurbulenceChild     * child,
-						      VortexConnection    * conn,
-						      int                   client_socket,
-						      TurbulencePPathDef  * def,
-						      axl_bool              handle_start_reply,
-						      int                   channel_num,
-						      const char          * profile,
-						      const char          * profile_content,
-						      VortexEncoding        encoding,
-						      char                * serverName,
-						      VortexFrame         * frame,
-						      int                 * general_log,
-						      int                 * error_log,
-						      int                 * access_log,
-						      int                 * vortex_log)
+void __turbulence_process_admission_free (TurbulenceAdmission * admission)
 {
-	VortexChannel * channel0;
-	char          * conn_status;
-	char          * child_init_string;
-	int             length;
-	int             written;
-	char          * aux;
-	int             tries = 0;
-
-	if (turbulence_ppath_get_id (def) <= 0) {
-		error ("PARENT: profile path id isn't a valid number %d, unable to send child init string..", 
-		       turbulence_ppath_get_id (def));
-		return axl_false;
-	}
+	vortex_connection_unref (admission->conn, "admission-queue");
+	__turbulence_ppath_unref (admission->ctx, admission->def);
+	axl_free (admission->profile);
+	axl_free (admission->profile_content);
+	axl_free (admission->serverName);
+	if (admission->frame)
+		vortex_frame_unref (admission->frame);
+	axl_free (admission);
+	return;
+}
 
-#if defined(__TURBULENCE_ENABLE_DEBUG_CODE__)
-	if (serverName && axl_cmp (serverName, "dk534jd.fail.aspl.es")) {
-		error ("PARENT: found serverName=%s that must trigger failure..", serverName);
-		return axl_false;
-	} /* end if */
-#endif
+/** 
+ * @internal Task that creates the child for a connection waiting in
+ * the admission queue (or closes it if admission-timeout expired),
+ * leaving it queued if limits are still reached.
+ */
+axlPointer __turbulence_process_admission_resume (axlPointer _admission)
+{
+	TurbulenceAdmission * admission = _admission;
+
+	/* still waiting: resumed again later */
+	if (__turbulence_process_create_child (admission->ctx, admission->conn, admission->def,
+					       admission->handle_start_reply, admission->channel_num,
+					       admission->profile, admission->profile_content,
+					       admission->encoding, admission->serverName, admission->frame,
+					       admission))
+		return NULL;
 
-	/* build connection status string */
-	channel0    = vortex_connection_get_channel (conn, 0);
-	conn_status = turbulence_process_connection_status_string (handle_start_reply, 
-								   channel_num,
-								   profile,
-								   profile_content,
-								   encoding,
-								   serverName,
-								   vortex_frame_get_msgno (frame),
-								   vortex_channel_get_next_seq_no (channel0),
-								   vortex_channel_get_next_expected_seq_no (channel0),
-								   turbulence_ppath_get_id (def),
-								   vortex_connection_is_tlsficated (conn),
-								   /* notify if we have to fix the serverName */
-								   axl_cmp (serverName, vortex_connection_get_server_name (conn)),
-								   /* provide host and port */
-								   vortex_connection_get_host (conn), vortex_connection_get_port (conn),
-								   vortex_connection_get_host_ip (conn),
-								   /* if proxied, skip recover on child */
-								   turbulence_conn_mgr_proxy_on_parent (conn));
-	if (conn_status == NULL) {
-		error ("PARENT: failled to create child, unable to allocate conn status string");
-		return axl_false;
-	}
-	msg ("PARENT: conn_status value: %s (profile path id: %d, 4th postiion from the end)", conn_status, turbulence_ppath_get_id (def));
+	__turbulence_process_admission_free (admission);
+	return NULL;
+}
 
-	/* prepare child init string: 
-	 *
-	 * 0) conn socket : the connection socket that will handle the child 
-	 * 1) general_log[0] : read end for general log 
-	 * 2) general_log[1] : write end for general log 
-	 * 3) error_log[0] : read end for error log 
-	 * 4) error_log[1] : write end for error log 
-	 * 5) access_log[0] : read end for access log 
-	 * 6) access_log[1] : write end for access log 
-	 * 7) vortex_log[0] : read end for vortex log 
-	 * 8) vortex_log[1] : write end for vortex log 
-	 * 9) child->socket_control_path : path to the socket_control_path
-	 * 10) ppath_id : profile path identification to be used on child (the profile path activated for this child)
-	 * 11) conn_status : connection status description to recover it at the child
-	 * 12) conn_mgr_host : host where the connection mgr is locatd (BEEP master<->child link)
-	 * 13) conn_mgr_port : port where the connection mgr is locatd (BEEP master<->child link)
-	 * POSITION INDEX:                       0    1    2    3    4    5    6    7    8    9   10   11   12   13*/
- 	child_init_string = axl_strdup_printf ("%d;_;%d;_;%d;_;%d;_;%d;_;%d;_;%d;_;%d;_;%d;_;%s;_;%d;_;%s;_;%s;_;%s",
-					       /* 0  */ client_socket,
-					       /* 1  */ general_log[0],
-					       /* 2  */ general_log[1],
-					       /* 3  */ error_log[0],
-					       /* 4  */ error_log[1],
-					       /* 5  */ access_log[0],
-					       /* 6  */ access_log[1],
-					       /* 7  */ vortex_log[0],
-					       /* 8  */ vortex_log[1],
-					       /* 9  */ child->socket_control_path,
-					       /* 10 */ turbulence_ppath_get_id (def),
-					       /* 11 */ conn_status,
-					       /* 12 */ vortex_connection_get_local_addr (child->conn_mgr),
-					       /* 13 */ vortex_connection_get_local_port (child->conn_mgr));
-	axl_free (conn_status);
-	if (child_init_string == NULL) {
-		error ("PARENT: failled to create child, unable to allocate memory for child init string");
-		return axl_false;
-	} /* end if */
+/** 
+ * @internal Schedules a task to resume the connection waiting in the
+ * admission queue. Must be called with the child process mutex
+ * acquired.
+ */
+void __turbulence_process_admission_schedule (TurbulenceAdmission * admission)
+{
+	if (admission->resuming)
+		return;
+	admission->resuming = axl_true;
+	vortex_thread_pool_new_task (admission->ctx->vortex_ctx, __turbulence_process_admission_resume, admission);
+	return;
+}
 
-	msg ("PARENT: created child init string: %s, handle_start_reply=%d", child_init_string, handle_start_reply);
-	vortex_hash_foreach (vortex_connection_get_data_hash (conn), __turbulence_process_show_conn_keys, ctx);
+/** 
+ * @internal Returns how long (milliseconds) the connection has been
+ * waiting in the admission queue.
+ */
+long __turbulence_process_admission_elapsed (TurbulenceAdmission * admission)
+{
+	struct timeval now;
 
-	/* get child init string length */
-	length = strlen (child_init_string);
+	gettimeofday (&now, NULL);
+	return ((now.tv_sec - admission->start.tv_sec) * 1000) + ((now.tv_usec - admission->start.tv_usec) / 1000);
+}
 
-	/* first send bytes to read */
-	aux     = axl_strdup_printf ("%d\n", length);
-	length  = strlen (aux);
+/** 
+ * @internal Resumes the connection at the head of the profile path
+ * admission queue if child limits allow to create a new child. Must
+ * be called with the child process mutex acquired.
+ */
+void __turbulence_process_admission_wakeup (TurbulencePPathDef * def)
+{
+	TurbulenceAdmission * head;
 
-	written = 0;
-	while (tries < 100) {
-		written = write (child->child_connection, aux, length);
-		if (written == length)
-			break;
-		tries++;
-		if (errno == 107) {
-			wrn ("PARENT: child still not ready, waiting 10ms (socket: %d), reconnecting..", child->child_connection);
-			turbulence_sleep (ctx, 10000);
-			vortex_close_socket (child->child_connection);
-			if (! __turbulence_process_create_child_connection (child)) {
-				error ("PARENT: error after reconnecting to child process, errno: %d:%s", errno, vortex_errno_get_last_error ());
-				break;
-			} /* end if */
-		}
+	if (def->admission_list == NULL || axl_list_length (def->admission_list) == 0)
+		return;
+	head = axl_list_get_first (def->admission_list);
+	if (! __turbulence_process_child_limit_reached (head->ctx, def))
+		__turbulence_process_admission_schedule (head);
+	return;
+}
 
-		/* if fails, check if the parent process is finishing to avoid waiting */
+/** 
+ * @internal Same as __turbulence_process_admission_wakeup for all
+ * profile paths, used when the global child limit changes (a child
+ * slot was released). Must be called with the child process mutex
+ * acquired.
+ */
+void __turbulence_process_admission_wakeup_all (TurbulenceCtx * ctx)
+{
+	TurbulencePPathDef * def;
+	TurbulencePPath    * paths;
+	int                  iterator = 0;
+
+	/* hold the table: a reload may replace it meanwhile */
+	paths = __turbulence_ppath_table_current (ctx);
+	while ((def = __turbulence_ppath_get_nth (paths, iterator)) != NULL) {
+		__turbulence_process_admission_wakeup (def);
+		iterator++;
+	} /* end while */
+	__turbulence_ppath_table_unref (ctx, paths);
+	return;
+}
+
+/** 
+ * @internal Event that checks connections waiting in admission
+ * queues: the ones admitted (notifications missed), closed or
+ * waiting more than admission-timeout are resumed. Removed once
+ * there are no connections waiting.
+ */
+axl_bool __turbulence_process_admission_event (VortexCtx * vortex_ctx, axlPointer user_data, axlPointer user_data2)
+{
+	TurbulenceCtx       * ctx = user_data;
+	TurbulenceAdmission * admission;
+	int                   iterator;
+
+	TBC_PROCESS_LOCK_CHILD ();
+	if (ctx->admissions == NULL || axl_list_length (ctx->admissions) == 0) {
+		ctx->admission_event = axl_false;
+		TBC_PROCESS_UNLOCK_CHILD ();
+		return axl_true; /* remove event */
+	} /* end if */
+
+	iterator = 0;
+	while (iterator < axl_list_length (ctx->admissions)) {
+		admission = axl_list_get_nth (ctx->admissions, iterator);
+		if (ctx->is_exiting || ! vortex_connection_is_ok (admission->conn, axl_false) ||
+		    __turbulence_process_admission_elapsed (admission) >= admission->def->admission_timeout)
+			__turbulence_process_admission_schedule (admission);
+
+		/* next position */
+		iterator++;
+	} /* end while */
+
+	/* first connection of each queue */
+	__turbulence_process_admission_wakeup_all (ctx);
+	TBC_PROCESS_UNLOCK_CHILD ();
+
+	return axl_false; /* keep event */
+}
+
+/** 
+ * @internal Queues the connection in the profile path admission
+ * queue (admission-queue) when child limits are reached. Queued
+ * connections are not read and no thread waits for them: they are
+ * resumed (__turbulence_process_admission_resume) when a child
+ * finishes or a creation slot is released, or when admission-timeout
+ * expires. Connections are admitted in arrival order. Must be called
+ * with the profile path creation mutex and the child process mutex
+ * acquired.
+ *
+ * If the queue is not configured or it is full, the function returns
+ * inmediately and turbulence_process_check_child_limit closes the
+ * connection as usual.
+ *
+ * @return axl_true if the connection was queued, otherwise axl_false
+ * (child limits must be checked).
+ */
+axl_bool __turbulence_process_admission_queue (TurbulenceCtx      * ctx,
+					       VortexConnection   * conn,
+					       TurbulencePPathDef * def,
+					       axl_bool             handle_start_reply,
+					       int                  channel_num,
+					       const char         * profile,
+					       const char         * profile_content,
+					       VortexEncoding       encoding,
+					       char               * serverName,
+					       VortexFrame        * frame)
+{
+	TurbulenceAdmission * admission;
+	int                   depth;
+
+	/* nothing to wait for */
+	if (def->admission_list == NULL)
+		return axl_false;
+	if (axl_list_length (def->admission_list) == 0 && ! __turbulence_process_child_limit_reached (ctx, def))
+		return axl_false;
+
+	/* queue full */
+	if (axl_list_length (def->admission_list) >= def->admission_limit) {
+		def->admission_rejected++;
+		wrn ("PARENT: admission queue full (%d) for profile path %s, unable to queue conn-id=%d", 
+		     def->admission_limit, def->path_name ? def->path_name : "", vortex_connection_get_id (conn));
+		return axl_false;
+	} /* end if */
+
+	/* keep values required to create the child later */
+	admission = axl_new (TurbulenceAdmission, 1);
+	if (admission == NULL)
+		return axl_false;
+	if (! vortex_connection_ref (conn, "admission-queue")) {
+		axl_free (admission);
+		return axl_false;
+	} /* end if */
+	__turbulence_ppath_ref (ctx, def);
+	admission->ctx                = ctx;
+	admission->conn               = conn;
+	admission->def                = def;
+	admission->handle_start_reply = handle_start_reply;
+	admission->channel_num        = channel_num;
+	admission->profile            = axl_strdup (profile);
+	admission->profile_content    = axl_strdup (profile_content);
+	admission->encoding           = encoding;
+	admission->serverName         = axl_strdup (serverName);
+	admission->frame              = frame ? vortex_frame_copy (frame) : NULL;
+	gettimeofday (&admission->start, NULL);
+
+	/* do not read the connection until it is admitted */
+	vortex_connection_block (conn, axl_true);
+
+	/* queue connection */
+	axl_list_append (def->admission_list, admission);
+	if (ctx->admissions == NULL)
+		ctx->admissions = axl_list_new (axl_list_always_return_1, NULL);
+	axl_list_append (ctx->admissions, admission);
+	depth = axl_list_length (def->admission_list);
+	def->admission_queued++;
+	if (depth > def->admission_max_depth)
+		def->admission_max_depth = depth;
+	msg ("PARENT: child limit reached, conn-id=%d waiting for a child on profile path %s (queue depth: %d)", 
+	     vortex_connection_get_id (conn), def->path_name ? def->path_name : "", depth);
+
+	/* check queued connections periodically */
+	if (! ctx->admission_event) {
+		ctx->admission_event = axl_true;
+		vortex_thread_pool_new_event (ctx->vortex_ctx, TBC_ADMISSION_POLL, __turbulence_process_admission_event, ctx, NULL);
+	} /* end if */
+
+	return axl_true;
+}
+
+/** 
+ * @internal Checks if the connection resumed from the admission queue
+ * can leave it. Must be called with the profile path creation mutex
+ * and the child process mutex acquired.
+ *
+ * @return 1 if the connection must keep waiting, 0 if it left the
+ * queue (child limits must be checked: it was admitted or
+ * admission-timeout expired) or -1 if it left the queue and must be
+ * closed (turbulence finishing or connection closed while waiting).
+ */
+int __turbulence_process_admission_leave (TurbulenceCtx * ctx, TurbulenceAdmission * admission)
+{
+	TurbulencePPathDef * def     = admission->def;
+	long                 elapsed = __turbulence_process_admission_elapsed (admission);
+	int                  result  = 0;
+
+	/* new tasks can be scheduled from now */
+	admission->resuming = axl_false;
+
+	if (ctx->is_exiting || ! vortex_connection_is_ok (admission->conn, axl_false)) {
+		result = -1;
+	} else if (axl_list_get_first (def->admission_list) != admission || __turbulence_process_child_limit_reached (ctx, def)) {
+		/* not admitted yet */
+		if (elapsed < def->admission_timeout)
+			return 1;
+
+		def->admission_timeouts++;
+		wrn ("PARENT: conn-id=%d waited %ld ms for a child on profile path %s, admission timeout reached", 
+		     vortex_connection_get_id (admission->conn), elapsed, def->path_name ? def->path_name : "");
+	} /* end if */
+
+	/* update wait stats */
+	def->admission_wait_total += elapsed;
+	if (elapsed > def->admission_wait_max)
+		def->admission_wait_max = elapsed;
+
+	/* leave the queue and let next connection check limits */
+	axl_list_remove_ptr (def->admission_list, admission);
+	axl_list_remove_ptr (ctx->admissions, admission);
+	__turbulence_process_admission_wakeup (def);
+
+	/* read the connection again */
+	vortex_connection_block (admission->conn, axl_false);
+
+	return result;
+}
+
+/** 
+ * @brief Allows to get admission queue stats for the provided
+ * profile path (see admission-queue attribute) to help sizing
+ * child-limit and global-child-limit. Any of the output parameters
+ * can be NULL.
+ *
+ * @param ctx The turbulence context where the profile path is running.
+ *
+ * @param def The profile path to get stats from.
+ *
+ * @param depth Connections currently waiting for a child.
+ *
+ * @param max_depth Max number of connections found waiting at the same time.
+ *
+ * @param queued Total number of connections that had to wait.
+ *
+ * @param timeouts Connections closed after admission-timeout.
+ *
+ * @param rejected Connections closed because the queue was full.
+ *
+ * @param wait_avg Average wait time (milliseconds) of queued connections.
+ *
+ * @param wait_max Max wait time (milliseconds).
+ *
+ * @return axl_true if stats were reported, axl_false if the profile
+ * path has no admission queue configured.
+ */
+axl_bool turbulence_process_admission_stats (TurbulenceCtx      * ctx,
+					     TurbulencePPathDef * def,
+					     int                * depth,
+					     int                * max_depth,
+					     int                * queued,
+					     int                * timeouts,
+					     int                * rejected,
+					     long               * wait_avg,
+					     long               * wait_max)
+{
+	if (ctx == NULL || def == NULL || def->admission_list == NULL)
+		return axl_false;
+
+	TBC_PROCESS_LOCK_CHILD ();
+	if (depth)
+		(* depth)     = axl_list_length (def->admission_list);
+	if (max_depth)
+		(* max_depth) = def->admission_max_depth;
+	if (queued)
+		(* queued)    = def->admission_queued;
+	if (timeouts)
+		(* timeouts)  = def->admission_timeouts;
+	if (rejected)
+		(* rejected)  = def->admission_rejected;
+	if (wait_avg)
+		(* wait_avg)  = def->admission_queued > 0 ? def->admission_wait_total / def->admission_queued : 0;
+	if (wait_max)
+		(* wait_max)  = def->admission_wait_max;
+	TBC_PROCESS_UNLOCK_CHILD ();
+
+	return axl_true;
+}
+
+axl_bool __turbulence_process_show_conn_keys (axlPointer key, axlPointer data, axlPointer user_data)
+{
+#if ! defined(SHOW_FORMAT_BUGS)
+	TurbulenceCtx * ctx = user_data;
+#endif
+
+	msg ("PARENT: found key %s", (const char *) key);
+
+	return axl_false; /* don't stop the process */
+}
+
+
+/** 
+ * @internal Creates the shared memory segment where childs publish
+ * their counters: a file under the runtime datadir mapped by the
+ * parent and opened by each child using the path received in its
+ * init string. Must be called with the stats mutex acquired.
+ */
+axl_bool __turbulence_process_stats_init (TurbulenceCtx * ctx)
+{
+	int    fd;
+	size_t size;
+	void * segment;
+
+	if (ctx->stats_segment)
+		return axl_true;
+
+	ctx->stats_slots = ctx->global_child_limit > TBC_STATS_MIN_SLOTS ? ctx->global_child_limit : TBC_STATS_MIN_SLOTS;
+	ctx->stats_path  = axl_strdup_printf ("%s%s%s%sstats-%d.tbc",
+					      turbulence_runtime_datadir (ctx),
+					      VORTEX_FILE_SEPARATOR,
+					      "turbulence",
+					      VORTEX_FILE_SEPARATOR,
+					      getpid ());
+	size             = TBC_STATS_SLOT_SIZE () * ctx->stats_slots;
+
+	fd = ctx->stats_path ? open (ctx->stats_path, O_RDWR | O_CREAT | O_TRUNC, 0600) : -1;
+	if (fd < 0 || ftruncate (fd, size) != 0) {
+		error ("PARENT: unable to create child stats segment %s, childs will not publish counters, errno: %d:%s", 
+		       ctx->stats_path ? ctx->stats_path : "", errno, vortex_errno_get_last_error ());
+		if (fd >= 0)
+			close (fd);
+		/* do not try again */
+		ctx->stats_slots = -1;
+		return axl_false;
+	} /* end if */
+
+	segment = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close (fd);
+	if (segment == MAP_FAILED) {
+		error ("PARENT: unable to map child stats segment %s, errno: %d:%s", 
+		       ctx->stats_path, errno, vortex_errno_get_last_error ());
+		ctx->stats_slots = -1;
+		return axl_false;
+	} /* end if */
+
+	ctx->stats_segment = segment;
+	ctx->stats_used    = axl_new (char, ctx->stats_slots);
+	msg ("PARENT: created child stats segment %s (%d slots)", ctx->stats_path, ctx->stats_slots);
+	return axl_true;
+}
+
+/** 
+ * @internal Assigns a free slot of the stats segment to the child
+ * (child->stats_slot is -1 if none is available). The slot is
+ * released when the child is finished (turbulence_child_unref).
+ */
+void __turbulence_process_stats_acquire (TurbulenceCtx * ctx, TurbulenceChild * child)
+{
+	int iterator;
+
+	child->stats_slot = -1;
+
+	vortex_mutex_lock (&ctx->stats_mutex);
+	if (ctx->stats_slots >= 0 && __turbulence_process_stats_init (ctx)) {
+		iterator = 0;
+		while (iterator < ctx->stats_slots) {
+			if (! ctx->stats_used[iterator]) {
+				ctx->stats_used[iterator] = 1;
+				memset (TBC_STATS_SLOT (ctx->stats_segment, iterator), 0, sizeof (TurbulenceStatsSlot));
+				child->stats_slot = iterator;
+				break;
+			} /* end if */
+			iterator++;
+		} /* end while */
+	} /* end if */
+	vortex_mutex_unlock (&ctx->stats_mutex);
+
+	return;
+}
+
+/** 
+ * @internal Releases the slot of the stats segment assigned to the
+ * child (if any) so it can be used by a new child.
+ */
+void __turbulence_process_stats_release (TurbulenceCtx * ctx, TurbulenceChild * child)
+{
+	vortex_mutex_lock (&ctx->stats_mutex);
+	if (ctx->stats_used && child->stats_slot >= 0 && child->stats_slot < ctx->stats_slots)
+		ctx->stats_used[child->stats_slot] = 0;
+	child->stats_slot = -1;
+	vortex_mutex_unlock (&ctx->stats_mutex);
+
+	return;
+}
+
+/** 
+ * @internal Function used to send child init string to the child
+ * process.
+ */
+axl_bool __turbulence_process_send_child_init_string (TurbulenceCtx       * ctx,
+						      TurbulenceChild     * child,
+						      VortexConnection    * conn,
+						      int                   client_socket,
+						      TurbulencePPathDef  * def,
+						      axl_bool              handle_start_reply,
+						      int                   channel_num,
+						      const char          * profile,
+						      const char          * profile_content,
+						      VortexEncoding        encoding,
+						      char                * serverName,
+						      VortexFrame         * frame,
+						      int                 * general_log,
+						      int                 * error_log,
+						      int                 * access_log,
+						      int                 * vortex_log)
+{
+	VortexChannel * channel0;
+	char          * conn_status;
+	char          * child_init_string;
+	int             length;
+	int             written;
+	char          * aux;
+	int             tries = 0;
+
+	if (turbulence_ppath_get_id (def) <= 0) {
+		error ("PARENT: profile path id isn't a valid number %d, unable to send child init string..", 
+		       turbulence_ppath_get_id (def));
+		return axl_false;
+	}
+
+#if defined(__TURBULENCE_ENABLE_DEBUG_CODE__)
+	if (serverName && axl_cmp (serverName, "dk534jd.fail.aspl.es")) {
+		error ("PARENT: found serverName=%s that must trigger failure..", serverName);
+		return axl_false;
+	} /* end if */
+#endif
+
+	/* build connection status string */
+	if (conn != NULL) {
+		channel0    = vortex_connection_get_channel (conn, 0);
+		conn_status = turbulence_process_connection_status_string (handle_start_reply, 
+									   channel_num,
+									   profile,
+									   profile_content,
+									   encoding,
+									   serverName,
+									   vortex_frame_get_msgno (frame),
+									   vortex_channel_get_next_seq_no (channel0),
+									   vortex_channel_get_next_expected_seq_no (channel0),
+									   turbulence_ppath_get_id (def),
+									   vortex_connection_is_tlsficated (conn),
+									   /* notify if we have to fix the serverName */
+									   axl_cmp (serverName, vortex_connection_get_server_name (conn)),
+									   /* provide host and port */
+									   vortex_connection_get_host (conn), vortex_connection_get_port (conn),
+									   vortex_connection_get_host_ip (conn),
+									   /* if proxied, skip recover on child */
+									   turbulence_conn_mgr_proxy_on_parent (conn));
+	} else {
+		/* spare child: there is no connection to be
+		 * restored, so signal the child to skip it */
+		conn_status = turbulence_process_connection_status_string (axl_false, -1, NULL, NULL, EncodingNone, NULL,
+									   -1, -1, -1, turbulence_ppath_get_id (def),
+									   axl_false, axl_false, "", "", "",
+									   /* skip recover on child */
+									   axl_true);
+	} /* end if */
+	if (conn_status == NULL) {
+		error ("PARENT: failled to create child, unable to allocate conn status string");
+		return axl_false;
+	}
+	msg ("PARENT: conn_status value: %s (profile path id: %d, 4th postiion from the end)", conn_status, turbulence_ppath_get_id (def));
+
+	/* get the slot where the child will publish its counters */
+	__turbulence_process_stats_acquire (ctx, child);
+
+	/* prepare child init string: 
+	 *
+	 * 0) conn socket : the connection socket that will handle the child 
+	 * 1) general_log[0] : read end for general log 
+	 * 2) general_log[1] : write end for general log 
+	 * 3) error_log[0] : read end for error log 
+	 * 4) error_log[1] : write end for error log 
+	 * 5) access_log[0] : read end for access log 
+	 * 6) access_log[1] : write end for access log 
+	 * 7) vortex_log[0] : read end for vortex log 
+	 * 8) vortex_log[1] : write end for vortex log 
+	 * 9) child->socket_control_path : path to the socket_control_path
+	 * 10) ppath_id : profile path identification to be used on child (the profile path activated for this child)
+	 * 11) conn_status : connection status description to recover it at the child
+	 * 12) conn_mgr_host : host where the connection mgr is locatd (BEEP master<->child link)
+	 * 13) conn_mgr_port : port where the connection mgr is locatd (BEEP master<->child link)
+	 * 14) stats_path : shared memory segment where the child publishes its counters (- if none)
+	 * 15) stats_slot : slot assigned to the child inside stats_path
+	 * 16) ppath_id_base : id of the first profile path (so the child numbers profile paths as the parent after a reload)
+	 * POSITION INDEX:                       0    1    2    3    4    5    6    7    8    9   10   11   12   13   14   15   16*/
+ 	child_init_string = axl_strdup_printf ("%d;_;%d;_;%d;_;%d;_;%d;_;%d;_;%d;_;%d;_;%d;_;%s;_;%d;_;%s;_;%s;_;%s;_;%s;_;%d;_;%d",
+					       /* 0  */ client_socket,
+					       /* 1  */ general_log[0],
+					       /* 2  */ general_log[1],
+					       /* 3  */ error_log[0],
+					       /* 4  */ error_log[1],
+					       /* 5  */ access_log[0],
+					       /* 6  */ access_log[1],
+					       /* 7  */ vortex_log[0],
+					       /* 8  */ vortex_log[1],
+					       /* 9  */ child->socket_control_path,
+					       /* 10 */ turbulence_ppath_get_id (def),
+					       /* 11 */ conn_status,
+					       /* 12 */ vortex_connection_get_local_addr (child->conn_mgr),
+					       /* 13 */ vortex_connection_get_local_port (child->conn_mgr),
+					       /* 14 */ child->stats_slot >= 0 ? ctx->stats_path : "-",
+					       /* 15 */ child->stats_slot,
+					       /* 16 */ __turbulence_ppath_id_base (ctx, def));
+	axl_free (conn_status);
+	if (child_init_string == NULL) {
+		error ("PARENT: failled to create child, unable to allocate memory for child init string");
+		return axl_false;
+	} /* end if */
+
+	msg ("PARENT: created child init string: %s, handle_start_reply=%d", child_init_string, handle_start_reply);
+	if (conn != NULL)
+		vortex_hash_foreach (vortex_connection_get_data_hash (conn), __turbulence_process_show_conn_keys, ctx);
+
+	/* get child init string length */
+	length = strlen (child_init_string);
+
+	/* first send bytes to read */
+	aux     = axl_strdup_printf ("%d\n", length);
+	length  = strlen (aux);
+
+	written = 0;
+	while (tries < 100) {
+		written = write (child->child_connection, aux, length);
+		if (written == length)
+			break;
+		tries++;
+		if (errno == 107) {
+			wrn ("PARENT: child still not ready, waiting 10ms (socket: %d), reconnecting..", child->child_connection);
+			turbulence_sleep (ctx, 10000);
+			vortex_close_socket (child->child_connection);
+			if (! __turbulence_process_create_child_connection (child)) {
+				error ("PARENT: error after reconnecting to child process, errno: %d:%s", errno, vortex_errno_get_last_error ());
+				break;
+			} /* end if */
+		}
+
+		/* if fails, check if the parent process is finishing to avoid waiting */
 		if (ctx->is_exiting) {
 			axl_free (aux);
 			return axl_false;
@@ -1428,45 +2651,2082 @@ axl_bool __turbulence_process_send_child_init_string (TurbulenceCtx       * ctx,
 	} /* end while */
 	axl_free (aux);
 
-	/* check errors */
-	if (written != length) {
-		error ("PARENT: failed to send init child string, expected to write %d bytes but %d were written, errno: %d:%s",
-		       length, written, errno, vortex_errno_get_last_error ());
-		return axl_false;
-	}
+	/* check errors */
+	if (written != length) {
+		error ("PARENT: failed to send init child string, expected to write %d bytes but %d were written, errno: %d:%s",
+		       length, written, errno, vortex_errno_get_last_error ());
+		return axl_false;
+	}
+
+	/* get child init string length (again) */
+	length = strlen (child_init_string);
+	/* msg ("PARENT: sending init child string length %d: %s", length, child_init_string); */
+
+	/* send content */
+	written = write (child->child_connection, child_init_string, length);
+	axl_free (child_init_string);
+
+	if (length != written) {
+		error ("PARENT: failed to send init child string, expected to write %d bytes but %d were written",
+		       length, written);
+		return axl_false;
+	}
+	
+	msg ("PARENT: child init string sent to child");
+	return axl_true;
+}
+
+/** 
+ * @internal Executes turbulence binary (after fork) in the provided
+ * mode ("--child" or "--zygote"), passing the control path, the
+ * configuration file and current debug options. This function never
+ * returns.
+ *
+ * @param ctx The context of the process just forked.
+ *
+ * @param mode The command line flag that selects the mode.
+ *
+ * @param control_path The socket control path passed to the flag.
+ */
+void __turbulence_process_exec (TurbulenceCtx       * ctx,
+				const char          * mode,
+				const char          * control_path)
+{
+	int                error_code;
+	char            ** cmds;
+	int                iterator = 0;
+	axl_bool           skip_thread_pool_wait = axl_false;
+	axl_bool           enable_debug          = axl_false;
+
+	/* call to start turbulence process */
+	msg ("CHILD: Starting child process with: %s %s %s %s --config %s", 
+	     turbulence_child_cmd_prefix ? turbulence_child_cmd_prefix : "", 
+	     turbulence_bin_path ? turbulence_bin_path : "", mode, control_path, ctx->config_path);
+
+	/* get debug was requested */
+	enable_debug = ! PTR_TO_INT (turbulence_ctx_get_data (ctx, "debug-was-not-requested"));
+
+	/* prepare child cmd prefix if defined */
+	if (turbulence_child_cmd_prefix) {
+		msg ("CHILD: found child cmd prefix: '%s', processing..", turbulence_child_cmd_prefix);
+		cmds = axl_split (turbulence_child_cmd_prefix, 1, " ");
+		if (cmds == NULL) {
+			error ("CHILD: failed to allocate memory for commands");
+			exit (-1);
+		} /* end if */
+
+		/* count positions */
+		while (cmds[iterator] != 0)
+			iterator++;
+
+		/* expand to include additional commands */
+		cmds = axl_realloc (cmds, sizeof (char*) * (iterator + 14 + 1));
+
+		cmds[iterator] = (char *) turbulence_bin_path;
+		iterator++;
+		cmds[iterator] = (char *) mode;
+		iterator++;
+		cmds[iterator] = (char *) control_path;
+		iterator++;
+		cmds[iterator] = "--config";
+		iterator++;
+		cmds[iterator] = ctx->config_path;
+		iterator++;
+		if (turbulence_log_enabled (ctx)) {
+			cmds[iterator] = "--debug";
+			iterator++;
+		}
+		if (turbulence_log2_enabled (ctx)) {
+			cmds[iterator] = "--debug2";
+			iterator++;
+		} 
+		if (turbulence_log3_enabled (ctx)) {
+			cmds[iterator] = "--debug3";
+			iterator++;
+		}
+		if (ctx->console_color_debug) {
+			cmds[iterator] = "--color-debug";
+			iterator++;
+		}
+		if (__turbulence_module_no_unmap) {
+			cmds[iterator] = "--no-unmap-modules";
+			iterator++;
+		}
+		/* get skip thread pool wait */
+		vortex_conf_get (TBC_VORTEX_CTX(ctx), VORTEX_SKIP_THREAD_POOL_WAIT, &skip_thread_pool_wait);
+		if (! skip_thread_pool_wait) {
+			cmds[iterator] = "--wait-thread-pool";
+			iterator++;
+		}
+
+		if (enable_debug && vortex_log_is_enabled (ctx->vortex_ctx)) {
+			cmds[iterator] = "--vortex-debug";
+			iterator++;
+		}
+		if (enable_debug && vortex_log2_is_enabled (ctx->vortex_ctx)) {
+			cmds[iterator] = "--vortex-debug2";
+			iterator++;
+		}
+		if (enable_debug && vortex_color_log_is_enabled (ctx->vortex_ctx)) {
+			cmds[iterator] = "--vortex-debug-color";
+			iterator++;
+		}
+
+		cmds[iterator] = NULL;
+
+		/* run command with prefix */
+		error_code = execvp (cmds[0], cmds);
+	} else {
+
+		/* run command without prefixes */
+		error_code = execlp (
+			/* configure command to run turbulence */
+			turbulence_bin_path, "turbulence", mode, control_path,
+			/* pass configuration file used */
+			"--config", ctx->config_path,
+			/* pass debug options to child */
+			turbulence_log_enabled (ctx) ? "--debug" : "", 
+			turbulence_log2_enabled (ctx) ? "--debug2" : "", 
+			turbulence_log3_enabled (ctx) ? "--debug3" : "", 
+			ctx->console_color_debug ? "--color-debug" : "",
+			/* pass vortex debug options */
+			(enable_debug && vortex_log_is_enabled (ctx->vortex_ctx)) ? "--vortex-debug" : "",
+			(enable_debug && vortex_log2_is_enabled (ctx->vortex_ctx)) ? "--vortex-debug2" : "",
+			(enable_debug && vortex_color_log_is_enabled (ctx->vortex_ctx)) ? "--vortex-debug-color" : "",
+			/* unmap modules support */
+			__turbulence_module_no_unmap ? "--no-unmap-modules" : "",
+			/* always last parameter */
+			NULL);
+	}
+	
+	error ("CHILD: unable to create child process, error found was: %d: errno: %s", error_code, vortex_errno_get_last_error ());
+	exit (-1);
+
+	return;
+}
+
+/** 
+ * @internal Child side of the child creation process (after fork):
+ * releases parent connections (but the one provided, if any) and
+ * executes turbulence binary in child mode. This function never
+ * returns.
+ *
+ * @param ctx The context of the process just forked.
+ *
+ * @param child The child object created for the new process.
+ *
+ * @param conn Optional connection that originated the child process
+ * (NULL for spare childs).
+ *
+ * @param proxy_on_parent Signals if the connection will be proxied
+ * by the parent.
+ */
+void __turbulence_process_exec_child (TurbulenceCtx       * ctx,
+				      TurbulenceChild     * child,
+				      VortexConnection    * conn,
+				      axl_bool              proxy_on_parent)
+{
+	/* reconfigure pids */
+	ctx->pid = getpid ();
+
+	/* release connections received from parent (including
+	   sockets) */
+	msg ("CHILD: calling to release all (parent) connections but conn-id=%d", 
+	     conn ? vortex_connection_get_id (conn) : -1);
+	__turbulence_process_release_parent_connections (ctx, proxy_on_parent ? NULL : conn, child);   
+
+	/* run turbulence in child mode */
+	__turbulence_process_exec (ctx, "--child", child->socket_control_path);
+
+	/**** CHILD PROCESS CREATION FINISHED ****/
+	return;
+}
+
+/** 
+ * @internal Reads a line terminated by \n from the provided socket,
+ * placing it (without the \n) into the buffer.
+ *
+ * @return The line length or -1 if it fails or the line does not fit
+ * into the buffer.
+ */
+int __turbulence_process_zygote_read_line (int socket, char * buffer, int size)
+{
+	int iterator = 0;
+
+	while (iterator < (size - 1)) {
+		if (recv (socket, buffer + iterator, 1, 0) != 1)
+			return -1;
+		if (buffer[iterator] == '\n') {
+			buffer[iterator] = 0;
+			return iterator;
+		} /* end if */
+
+		/* next position */
+		iterator++;
+	} /* end while */
+
+	return -1;
+}
+
+/** 
+ * @internal Sends a spawn request to the zygote process: the child
+ * control path terminated by \n, passing the provided descriptors
+ * (log pipe write ends) as ancillary data.
+ */
+axl_bool __turbulence_process_zygote_send_request (TurbulenceCtx * ctx,
+						   const char    * control_path,
+						   int           * fds,
+						   int             fds_num)
+{
+	struct msghdr        msg;
+	char                 ccmsg[CMSG_SPACE(sizeof (int) * 4)];
+	struct cmsghdr     * cmsg;
+	struct iovec         vec;
+	char               * request;
+	int                  length;
+	int                  rv;
+
+	request = axl_strdup_printf ("%s\n", control_path);
+	if (request == NULL)
+		return axl_false;
+	length  = strlen (request);
+
+	/* clear structures */
+	memset (&msg, 0, sizeof (struct msghdr));
+
+	vec.iov_base   = request;
+	vec.iov_len    = length;
+	msg.msg_iov    = &vec;
+	msg.msg_iovlen = 1;
+
+	if (fds_num > 0) {
+		msg.msg_control    = ccmsg;
+		msg.msg_controllen = sizeof (ccmsg);
+
+		cmsg = CMSG_FIRSTHDR(&msg);
+		cmsg->cmsg_level   = SOL_SOCKET;
+		cmsg->cmsg_type    = SCM_RIGHTS;
+		cmsg->cmsg_len     = CMSG_LEN(sizeof (int) * fds_num);
+		memcpy (CMSG_DATA(cmsg), fds, sizeof (int) * fds_num);
+
+		msg.msg_controllen = cmsg->cmsg_len;
+	} /* end if */
+
+	/* do not get SIGPIPE if the zygote is gone */
+	rv = sendmsg (ctx->zygote_connection, &msg, MSG_NOSIGNAL);
+	axl_free (request);
+
+	return (rv == length);
+}
+
+/** 
+ * @internal Receives a spawn request at the zygote process.
+ *
+ * @return The number of descriptors received (placed into fds) or -1
+ * if the parent closed the connection or the request is wrong.
+ */
+int __turbulence_process_zygote_receive_request (TurbulenceCtx * ctx,
+						 int             control,
+						 char          * path,
+						 int             size,
+						 int           * fds)
+{
+	struct msghdr        msg;
+	char                 ccmsg[CMSG_SPACE(sizeof (int) * 4)];
+	struct cmsghdr     * cmsg;
+	struct iovec         vec;
+	int                  fds_num = 0;
+	int                  iterator;
+
+	/* clear structures */
+	memset (&msg, 0, sizeof (struct msghdr));
+
+	/* read first byte (descriptors are attached to it) */
+	vec.iov_base       = path;
+	vec.iov_len        = 1;
+	msg.msg_iov        = &vec;
+	msg.msg_iovlen     = 1;
+	msg.msg_control    = ccmsg;
+	msg.msg_controllen = sizeof (ccmsg);
+
+	if (recvmsg (control, &msg, 0) != 1)
+		return -1;
+
+	cmsg = CMSG_FIRSTHDR(&msg);
+	if (cmsg && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+		fds_num = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof (int);
+		if (fds_num > 4)
+			fds_num = 4;
+		memcpy (fds, CMSG_DATA(cmsg), sizeof (int) * fds_num);
+	} /* end if */
+
+	/* read the rest of the control path */
+	if (path[0] == '\n' || __turbulence_process_zygote_read_line (control, path + 1, size - 1) < 0) {
+		error ("ZYGOTE: received wrong spawn request, closing descriptors received");
+		for (iterator = 0; iterator < fds_num; iterator++)
+			vortex_close_socket (fds[iterator]);
+		return -1;
+	} /* end if */
+
+	return fds_num;
+}
+
+/** 
+ * @brief Runs the child zygote process (turbulence --zygote
+ * control_path). The zygote loads and validates the configuration and
+ * maps all modules once and then waits for spawn requests from the
+ * main process, creating each child with a fork (no exec). 
+ *
+ * Childs are created with a double fork so they are reparented to
+ * the main process (child subreaper) which keeps handling them as
+ * usual (SIGCHLD, kill on exit).
+ *
+ * @param ctx The turbulence context of the zygote process (vortex
+ * context is not initialized yet).
+ *
+ * @param control_path The socket control path used to receive spawn
+ * requests from the main process.
+ *
+ * @param config The configuration file to load.
+ *
+ * @return The function only returns inside each child created,
+ * returning its socket control path (to be used as --child value) or
+ * NULL when the zygote finishes (main process closed the
+ * connection).
+ */
+char            * turbulence_process_zygote_run (TurbulenceCtx * ctx, 
+						 const char    * control_path,
+						 const char    * config)
+{
+	int           control;
+	char          path[4096];
+	char          reply[100];
+	int           fds[4];
+	int           fds_num;
+	int           iterator;
+	int           pid;
+	int           child_pid;
+	int           status;
+	struct stat   config_stat;
+	time_t        config_mtime = 0;
+
+	msg ("ZYGOTE: starting zygote process with control path: %s", control_path);
+
+	/* wait for the main process to connect */
+	control = __turbulence_process_local_unix_fd (control_path, axl_false, ctx);
+	if (control < 0) {
+		error ("ZYGOTE: unable to create control connection, finishing zygote");
+		return NULL;
+	} /* end if */
+
+	/* load and validate configuration once for all childs */
+	if (! turbulence_config_load (ctx, config)) {
+		vortex_close_socket (control);
+		return NULL;
+	} /* end if */
+	if (stat (config, &config_stat) == 0)
+		config_mtime = config_stat.st_mtime;
+
+	/* map modules into memory */
+	turbulence_run_preload_modules (ctx);
+
+	while (axl_true) {
+		/* wait for the next request */
+		for (iterator = 0; iterator < 4; iterator++)
+			fds[iterator] = -1;
+		fds_num = __turbulence_process_zygote_receive_request (ctx, control, path, sizeof (path), fds);
+		if (fds_num < 0) 
+			break;
+
+		msg ("ZYGOTE: received spawn request for child control path: %s (log descriptors: %d)", path, fds_num);
+
+		/* reload configuration if it was changed */
+		if (stat (config, &config_stat) == 0 && config_stat.st_mtime != config_mtime) {
+			msg ("ZYGOTE: configuration file %s was modified, reloading", config);
+			axl_doc_free (ctx->config);
+			ctx->config = NULL;
+			axl_free (ctx->config_path);
+			ctx->config_path = NULL;
+			if (! turbulence_config_load (ctx, config)) {
+				for (iterator = 0; iterator < fds_num; iterator++)
+					vortex_close_socket (fds[iterator]);
+				break;
+			} /* end if */
+			config_mtime = config_stat.st_mtime;
+		} /* end if */
+
+		pid = fork ();
+		if (pid == 0) {
+			/* intermediate process: create the child and
+			 * finish so the child is reparented */
+			child_pid = fork ();
+			if (child_pid == 0) {
+				/**** CHILD CODE ****/
+				vortex_close_socket (control);
+				return axl_strdup (path);
+			} /* end if */
+
+			/* notify child pid and the log descriptors it
+			 * has (same values as the zygote) */
+			axl_stream_printf_buffer (reply, sizeof (reply), NULL, "%d;%d;%d;%d;%d\n", 
+						  child_pid, fds[0], fds[1], fds[2], fds[3]);
+			if (write (control, reply, strlen (reply)) != (int) strlen (reply))
+				error ("ZYGOTE: failed to notify child pid=%d to main process", child_pid);
+			_exit (0);
+		} else if (pid < 0) {
+			error ("ZYGOTE: failed to create child process, errno: %d:%s", errno, vortex_errno_get_last_error ());
+			if (write (control, "-1\n", 3) != 3)
+				error ("ZYGOTE: failed to notify spawn failure to main process");
+		} /* end if */
+
+		/* descriptors are now owned by the child */
+		for (iterator = 0; iterator < fds_num; iterator++)
+			vortex_close_socket (fds[iterator]);
+
+		/* reap intermediate process */
+		if (pid > 0)
+			waitpid (pid, &status, 0);
+	} /* end while */
+
+	msg ("ZYGOTE: main process closed control connection, finishing zygote");
+	vortex_close_socket (control);
+	return NULL;
+}
+
+/** 
+ * @internal Reads the reply to a spawn request sent to the zygote
+ * process ("pid;fd;fd;fd;fd\n"), waiting at most
+ * TBC_ZYGOTE_REPLY_WAIT.
+ *
+ * @return The reply length (without the trailing \n, which is
+ * replaced by 0) or -1 if it fails or the zygote doesn't reply on
+ * time.
+ */
+int __turbulence_process_zygote_read_reply (int socket, char * buffer, int size)
+{
+	struct pollfd   wait_fd;
+	struct timeval  start;
+	struct timeval  now;
+	int             pending;
+	int             length = 0;
+	int             result;
+	char          * end;
+
+	gettimeofday (&start, NULL);
+	while (length < (size - 1)) {
+		/* remaining time */
+		gettimeofday (&now, NULL);
+		pending = TBC_ZYGOTE_REPLY_WAIT - (((now.tv_sec - start.tv_sec) * 1000) + ((now.tv_usec - start.tv_usec) / 1000));
+		if (pending <= 0)
+			return -1;
+
+		wait_fd.fd      = socket;
+		wait_fd.events  = POLLIN;
+		wait_fd.revents = 0;
+		result          = poll (&wait_fd, 1, pending);
+		if (result < 0 && errno == EINTR)
+			continue;
+		if (result <= 0)
+			return -1;
+
+		/* read all content available (the zygote writes the
+		 * reply at once) */
+		result = recv (socket, buffer + length, size - 1 - length, 0);
+		if (result < 0 && errno == EINTR)
+			continue;
+		if (result <= 0)
+			return -1;
+		length += result;
+		buffer[length] = 0;
+
+		end = strchr (buffer, '\n');
+		if (end != NULL) {
+			(* end) = 0;
+			return (int) (end - buffer);
+		} /* end if */
+	} /* end while */
+
+	return -1;
+}
+
+/** 
+ * @internal Asks the zygote process to create a new child that will
+ * connect to the socket control path of the provided child
+ * object. On failure the zygote is disabled so childs are created by
+ * fork/exec from then on. Must be called with the child process mutex
+ * acquired.
+ *
+ * @param child_logs Log pipe descriptors as seen by the child (same
+ * layout as the child init string, positions 1 to 8), filled by the
+ * function.
+ *
+ * @return The child pid or -1 if it fails.
+ */
+int __turbulence_process_zygote_spawn (TurbulenceCtx    * ctx,
+				       TurbulenceChild  * child,
+				       int              * general_log,
+				       int              * error_log,
+				       int              * access_log,
+				       int              * vortex_log,
+				       int              * child_logs)
+{
+	char         reply[100];
+	char      ** items;
+	int          fds[4];
+	int          fds_num = 4;
+	int          iterator;
+	int          pid     = -1;
+
+	vortex_mutex_lock (&ctx->zygote_mutex);
+	if (ctx->zygote_connection < 0) {
+		vortex_mutex_unlock (&ctx->zygote_mutex);
+		return -1;
+	} /* end if */
+
+	/* pass log pipe write ends (only if all are available) */
+	fds[0] = general_log[1];
+	fds[1] = error_log[1];
+	fds[2] = access_log[1];
+	fds[3] = vortex_log[1];
+	for (iterator = 0; iterator < 4; iterator++) {
+		if (fds[iterator] < 0)
+			fds_num = 0;
+	} /* end for */
+
+	if (__turbulence_process_zygote_send_request (ctx, child->socket_control_path, fds, fds_num) &&
+	    __turbulence_process_zygote_read_reply (ctx->zygote_connection, reply, sizeof (reply)) > 0) {
+		items = axl_split (reply, 1, ";");
+		if (items && items[0] && items[1] && items[2] && items[3] && items[4]) {
+			pid = atoi (items[0]);
+
+			/* write ends as seen by the child */
+			for (iterator = 0; iterator < 4; iterator++)
+				child_logs[(iterator * 2) + 1] = atoi (items[iterator + 1]);
+		} /* end if */
+		axl_freev (items);
+	} /* end if */
+
+	if (pid <= 0) {
+		error ("PARENT: child zygote failed to create child process or didn't reply on time, disabling zygote (childs will be created by fork/exec)");
+		vortex_close_socket (ctx->zygote_connection);
+		ctx->zygote_connection = -1;
+		pid = -1;
+
+		/* a stuck zygote wouldn't notice the control
+		 * connection was closed */
+		if (ctx->zygote_pid > 0)
+			kill (ctx->zygote_pid, SIGTERM);
+	} /* end if */
+
+	vortex_mutex_unlock (&ctx->zygote_mutex);
+	return pid;
+}
+
+/** 
+ * @internal Starts the child zygote process if it is enabled by
+ * configuration (<child-zygote value="yes" />). Called by the main
+ * process before starting listeners.
+ *
+ * @param ctx The context where the zygote will be started.
+ */
+void turbulence_process_zygote_start (TurbulenceCtx * ctx)
+{
+	axlNode        * node;
+	char           * control_path;
+	char           * temp_dir;
+	int              pid;
+	int              iterator = 0;
+
+	/* only main process can create childs */
+	if (ctx == NULL || ctx->child)
+		return;
+
+	/* check configuration */
+	node = axl_doc_get (ctx->config, "/turbulence/global-settings/child-zygote");
+	if (node == NULL || ! HAS_ATTR_VALUE (node, "value", "yes"))
+		return;
+
+#if defined(PR_SET_CHILD_SUBREAPER)
+	/* make childs created by the zygote to be reparented to this
+	 * process (rather than init) so they are handled as usual */
+	if (prctl (PR_SET_CHILD_SUBREAPER, 1, 0, 0, 0) != 0) {
+		error ("PARENT: unable to configure child subreaper, child zygote disabled, errno: %d:%s", 
+		       errno, vortex_errno_get_last_error ());
+		return;
+	} /* end if */
+#else
+	wrn ("PARENT: child-zygote is not supported on this platform (child subreaper not available), childs will be created by fork/exec");
+	return;
+#endif
+
+	/* create control path */
+	control_path = axl_strdup_printf ("%s%s%s%szygote-%d.tbc",
+					  turbulence_runtime_datadir (ctx),
+					  VORTEX_FILE_SEPARATOR,
+					  "turbulence",
+					  VORTEX_FILE_SEPARATOR,
+					  getpid ());
+	if (control_path == NULL)
+		return;
+
+	/* check base dir for control path exists */
+	temp_dir = turbulence_base_dir (control_path);
+	if (temp_dir && ! vortex_support_file_test (temp_dir, FILE_EXISTS)) {
+		wrn ("run time directory %s do not exists, creating..", temp_dir);
+		if (! turbulence_create_dir (temp_dir)) {
+			error ("Unable to create directory to hold zygote socket connection, child zygote disabled");
+			axl_free (temp_dir);
+			axl_free (control_path);
+			return;
+		} /* end if */
+	} /* end if */
+	axl_free (temp_dir);
+
+	/* call to fork */
+	pid = fork ();
+	if (pid == 0) {
+		/**** ZYGOTE CODE ****/
+		ctx->pid = getpid ();
+		__turbulence_process_release_parent_connections (ctx, NULL, NULL);
+		__turbulence_process_exec (ctx, "--zygote", control_path);
+		return;
+	} else if (pid < 0) {
+		error ("PARENT: unable to create child zygote process, errno: %d:%s", errno, vortex_errno_get_last_error ());
+		axl_free (control_path);
+		return;
+	} /* end if */
+
+	/* connect to the zygote (it does the bind) */
+	while (iterator < 25) {
+		if (vortex_support_file_test (control_path, FILE_EXISTS)) {
+			ctx->zygote_connection = __turbulence_process_local_unix_fd (control_path, axl_true, ctx);
+			if (ctx->zygote_connection > 0)
+				break;
+		} /* end if */
+
+		/* next position but wait a bit */
+		iterator++;
+		turbulence_sleep (ctx, 200000);
+	} /* end while */
+
+	if (ctx->zygote_connection <= 0) {
+		error ("PARENT: unable to connect to child zygote process pid=%d, child zygote disabled", pid);
+		ctx->zygote_connection = -1;
+		kill (pid, SIGTERM);
+		waitpid (pid, NULL, 0);
+		axl_free (control_path);
+		return;
+	} /* end if */
+
+	/* do not pass zygote connection to childs created by
+	 * fork/exec */
+	fcntl (ctx->zygote_connection, F_SETFD, fcntl (ctx->zygote_connection, F_GETFD) | FD_CLOEXEC);
+	ctx->zygote_pid = pid;
+
+	msg ("PARENT: started child zygote process pid=%d (control path: %s)", pid, control_path);
+	axl_free (control_path);
+	return;
+}
+
+/** 
+ * @internal Stops the child zygote process (if running), waiting for
+ * it to finish.
+ */
+void __turbulence_process_zygote_stop (TurbulenceCtx * ctx)
+{
+	int status;
+
+	if (ctx->zygote_pid <= 0)
+		return;
+
+	/* zygote finishes once its control connection is closed */
+	vortex_mutex_lock (&ctx->zygote_mutex);
+	if (ctx->zygote_connection >= 0)
+		vortex_close_socket (ctx->zygote_connection);
+	ctx->zygote_connection = -1;
+	vortex_mutex_unlock (&ctx->zygote_mutex);
+
+	msg ("waiting child zygote process (%d) to finish...", ctx->zygote_pid);
+	waitpid (ctx->zygote_pid, &status, 0);
+	ctx->zygote_pid = -1;
+
+	return;
+}
+
+typedef struct _TurbulenceHandoff {
+	VORTEX_SOCKET   socket;
+	int             size;
+	char          * record;
+} TurbulenceHandoff;
+
+/** 
+ * @internal Releases a connection queued to be sent to a child
+ * (closing its socket if it was not sent).
+ */
+void __turbulence_process_handoff_free (TurbulenceHandoff * item)
+{
+	if (item->socket > 0)
+		vortex_close_socket (item->socket);
+	axl_free (item);
+	return;
+}
+
+/** 
+ * @internal Queues the provided connection to be sent to a child
+ * already created (reused, spare or created by the zygote process).
+ * The connection is released from the parent (or proxied) right now
+ * while its socket and status record wait in the child handoff
+ * queue. Call __turbulence_process_handoff_flush (without holding
+ * child process mutexes) to send it.
+ */
+void __turbulence_process_handoff_connection (TurbulenceCtx       * ctx, 
+					      TurbulenceChild     * child,
+					      VortexConnection    * conn, 
+					      axl_bool              proxy_on_parent,
+					      axl_bool              handle_start_reply,
+					      int                   channel_num,
+					      const char          * profile,
+					      const char          * profile_content,
+					      VortexEncoding        encoding,
+					      char                * serverName,
+					      VortexFrame         * frame)
+{
+	VORTEX_SOCKET        client_socket;
+	VortexChannel      * channel0    = vortex_connection_get_channel (conn, 0);
+	TurbulencePPathDef * ppath       = turbulence_ppath_selected (conn);
+	TurbulenceHandoff  * item;
+	char                 conn_status[TBC_CONN_STATUS_MAX];
+	int                  size;
+
+	/* build connection status record */
+	size = turbulence_process_connection_status_encode (conn_status, TBC_CONN_STATUS_MAX,
+							    handle_start_reply, 
+							    channel_num,
+							    profile,
+							    profile_content,
+							    encoding,
+							    serverName,
+							    vortex_frame_get_msgno (frame),
+							    vortex_channel_get_next_seq_no (channel0),
+							    vortex_channel_get_next_expected_seq_no (channel0),
+							    turbulence_ppath_get_id (ppath),
+							    vortex_connection_is_tlsficated (conn),
+							    /* notify if we have to fix the serverName */
+							    axl_cmp (serverName, vortex_connection_get_server_name (conn)),
+							    /* get host, port and host ip */
+							    vortex_connection_get_host (conn), vortex_connection_get_port (conn), 
+							    vortex_connection_get_host_ip (conn),
+							    /* if proxied, skip recover on child */
+							    proxy_on_parent);
+	if (size <= 0) {
+		error ("PARENT: unable to build connection status record for conn-id=%d (too big?), closing connection",
+		       vortex_connection_get_id (conn));
+		vortex_connection_shutdown (conn);
+		return;
+	} /* end if */
+
+	if (proxy_on_parent) {
+		/* setup the proxy on parent code creating a
+		 * new client socket */
+		client_socket = turbulence_conn_mgr_setup_proxy_on_parent (ctx, conn);
+		if (client_socket < 0) {
+			error ("PARENT: unable to setup proxy on parent for conn-id=%d, closing connection", vortex_connection_get_id (conn));
+			vortex_connection_shutdown (conn);
+			return;
+		} /* end if */
+	} else {
+		/* socket that is know handled by the child process */
+		client_socket = vortex_connection_get_socket (conn);
+		vortex_connection_set_close_socket (conn, axl_false);
+
+		/* unwatch the connection from the parent to avoid
+		   receiving more content which now handled by the
+		   child and terminate the connection (the socket is
+		   kept open until sent) */
+		vortex_reader_unwatch_connection (CONN_CTX (conn), conn);
+		vortex_connection_shutdown (conn);
+	} /* end if */
+
+	/* queue socket and record (both allocated together) */
+	item = (TurbulenceHandoff *) axl_new (char, sizeof (TurbulenceHandoff) + size);
+	if (item == NULL) {
+		error ("PARENT: unable to allocate memory to send socket %d to child pid %d, closing", client_socket, child->pid);
+		vortex_close_socket (client_socket);
+		return;
+	} /* end if */
+	item->socket = client_socket;
+	item->size   = size;
+	item->record = (char *) (item + 1);
+	memcpy (item->record, conn_status, size);
+
+	vortex_mutex_lock (&child->mutex);
+	if (child->handoff_queue == NULL)
+		child->handoff_queue = axl_list_new (axl_list_always_return_1, (axlDestroyFunc) __turbulence_process_handoff_free);
+	axl_list_append (child->handoff_queue, item);
+	vortex_mutex_unlock (&child->mutex);
+
+	/* account connection for recycle-conns */
+	child->conns_served++;
+
+	msg ("PARENT: queued socket %d (record size: %d) to be sent to child pid %d", client_socket, size, child->pid);
+	return;
+}
+
+/** 
+ * @internal Sends connections queued for the provided child. Several
+ * connections (up to TBC_HANDOFF_BATCH) are sent in a single message
+ * (sockets and their status records). If another thread is already
+ * sending, the function returns right away: connections queued are
+ * sent by that thread, so they are coalesced when they arrive faster
+ * than they can be sent. Must be called without holding child
+ * process mutexes (and with a reference to the child).
+ */
+void __turbulence_process_handoff_flush (TurbulenceCtx * ctx, TurbulenceChild * child)
+{
+	axlList           * queue;
+	axlListCursor     * cursor;
+	TurbulenceHandoff * items[TBC_HANDOFF_BATCH];
+	VORTEX_SOCKET       sockets[TBC_HANDOFF_BATCH];
+	struct iovec        vec[TBC_HANDOFF_BATCH];
+	int                 count;
+	int                 size;
+	int                 iterator;
+
+	vortex_mutex_lock (&child->mutex);
+	if (child->handoff_flushing) {
+		vortex_mutex_unlock (&child->mutex);
+		return;
+	} /* end if */
+	child->handoff_flushing = axl_true;
+
+	while (child->handoff_queue && axl_list_length (child->handoff_queue) > 0) {
+		/* take current queue */
+		queue                = child->handoff_queue;
+		child->handoff_queue = NULL;
+		vortex_mutex_unlock (&child->mutex);
+
+		cursor = axl_list_cursor_new (queue);
+		axl_list_cursor_first (cursor);
+		while (axl_list_cursor_has_item (cursor)) {
+			/* build next batch */
+			count = 0;
+			size  = 0;
+			while (axl_list_cursor_has_item (cursor) && count < TBC_HANDOFF_BATCH) {
+				items[count] = axl_list_cursor_get (cursor);
+				if (count > 0 && (size + items[count]->size) > TBC_HANDOFF_BUFFER)
+					break;
+				/* the child handles all records of a message
+				 * with the same command */
+				if (count > 0 && items[count]->record[0] != items[0]->record[0])
+					break;
+				sockets[count]      = items[count]->socket;
+				vec[count].iov_base = items[count]->record;
+				vec[count].iov_len  = items[count]->size;
+				size               += items[count]->size;
+				count++;
+				axl_list_cursor_next (cursor);
+			} /* end while */
+
+			if (__turbulence_process_send_sockets (child, sockets, count, vec, count)) {
+				msg ("PARENT: sent %d sockets to child pid %d via %d (size: %d)", count, child->pid, child->child_connection, size);
+			} else {
+				error ("PARENT: failed to send %d sockets to child pid %d, closing them, error (code %d): %s", 
+				       count, child->pid, errno, vortex_errno_get_last_error ());
+			} /* end if */
+
+			/* sockets are now owned by the child (or lost),
+			 * close them */
+			iterator = 0;
+			while (iterator < count) {
+				vortex_close_socket (items[iterator]->socket);
+				items[iterator]->socket = -1;
+				iterator++;
+			} /* end while */
+		} /* end while */
+		axl_list_cursor_free (cursor);
+		axl_list_free (queue);
+
+		vortex_mutex_lock (&child->mutex);
+	} /* end while */
+
+	child->handoff_flushing = axl_false;
+	vortex_mutex_unlock (&child->mutex);
+	return;
+}
+
+/** 
+ * @internal Checks if the provided profile path is found in the list
+ * of profile path names (NULL list matches all).
+ */
+axl_bool __turbulence_process_ppath_selected (TurbulencePPathDef * ppath, char ** names)
+{
+	int iterator = 0;
+
+	if (names == NULL)
+		return axl_true;
+	if (ppath == NULL)
+		return axl_false;
+	while (names[iterator]) {
+		if (axl_cmp (names[iterator], turbulence_ppath_get_name (ppath)))
+			return axl_true;
+		iterator++;
+	} /* end while */
+	return axl_false;
+}
+
+int __turbulence_process_broadcast_filter (VortexConnection * conn, axlPointer user_data)
+{
+	/* filter connections not running a selected profile path */
+	return ! __turbulence_process_ppath_selected (turbulence_ppath_selected (conn), user_data);
+}
+
+/** 
+ * @internal Function used by turbulence_process_broadcast_msg to
+ * select childs.
+ */
+axl_bool __turbulence_process_broadcast_select (axlPointer key, axlPointer data, axlPointer user_data, axlPointer user_data2)
+{
+	TurbulenceChild  * child  = data;
+	char            ** names  = user_data;
+	axlList          * childs = user_data2;
+
+	if (child->child_connection > 0 && __turbulence_process_ppath_selected (child->ppath, names) && turbulence_child_ref (child))
+		axl_list_append (childs, child);
+	return axl_false; /* keep foreach looping */
+}
+
+/** 
+ * @internal Creates an unlinked file under the runtime datadir with
+ * the provided content, returning its descriptor (or -1 if it
+ * fails). Childs receive the descriptor and map the content so it
+ * is written once no matter how many childs receive it.
+ */
+int __turbulence_process_broadcast_content (TurbulenceCtx * ctx, const void * message, int message_size)
+{
+	char       * path;
+	int          fd;
+	int          written = 0;
+	int          result;
+
+	path = axl_strdup_printf ("%s%s%s%sbroadcast-XXXXXX",
+				  turbulence_runtime_datadir (ctx),
+				  VORTEX_FILE_SEPARATOR,
+				  "turbulence",
+				  VORTEX_FILE_SEPARATOR);
+	fd = path ? mkstemp (path) : -1;
+	if (fd < 0) {
+		error ("PARENT: unable to create broadcast content file %s, errno: %d:%s", 
+		       path ? path : "", errno, vortex_errno_get_last_error ());
+		axl_free (path);
+		return -1;
+	} /* end if */
+
+	/* remove the name: the file lives while a descriptor is open */
+	unlink (path);
+	axl_free (path);
+	fcntl (fd, F_SETFD, fcntl (fd, F_GETFD) | FD_CLOEXEC);
+
+	while (written < message_size) {
+		result = write (fd, ((const char *) message) + written, message_size - written);
+		if (result <= 0) {
+			if (result < 0 && errno == EINTR)
+				continue;
+			error ("PARENT: unable to write broadcast content, errno: %d:%s", errno, vortex_errno_get_last_error ());
+			close (fd);
+			return -1;
+		} /* end if */
+		written += result;
+	} /* end while */
+
+	return fd;
+}
+
+/** 
+ * @brief Broadcast the provided message over all channels running
+ * the provided profile on connections handled by the parent and by
+ * all childs (or only those running the selected profile paths).
+ *
+ * The parent sends the message on its own connections (see \ref
+ * turbulence_conn_mgr_broadcast_msg) and relays it to each child
+ * through the child control connection, where each child sends it
+ * on the connections it handles. The content is written once into
+ * an unlinked file whose descriptor is passed to childs, which map
+ * it, so it isn't copied for each child. Several broadcasts pending
+ * for the same child are sent in a single control message.
+ *
+ * The function is only available on the parent process. On childs it
+ * only reaches connections handled by the calling process.
+ *
+ * @param ctx Turbulence context where the operation will take place.
+ *
+ * @param message The message to broadcast.
+ *
+ * @param message_size The message size to broadcast.
+ *
+ * @param profile The profile that channels must run to receive the message.
+ *
+ * @param ppaths Optional comma separated list of profile path names
+ * (path-name attribute) to select connections and childs. NULL
+ * selects all.
+ *
+ * @return Number of childs the message was relayed to or -1 if it
+ * fails.
+ */
+int               turbulence_process_broadcast_msg (TurbulenceCtx * ctx,
+						    const void    * message,
+						    int             message_size,
+						    const char    * profile,
+						    const char    * ppaths)
+{
+	char             ** names = NULL;
+	axlList           * childs;
+	axlListCursor     * cursor;
+	TurbulenceChild   * child;
+	TurbulenceHandoff * item;
+	char                record[TBC_CONN_STATUS_MAX];
+	int                 size;
+	int                 fd;
+	int                 result = 0;
+
+	v_return_val_if_fail (ctx && message && message_size >= 0 && profile, -1);
+
+	if (ppaths) {
+		names = axl_split (ppaths, 1, ",");
+		if (names)
+			axl_stream_clean_split (names);
+	} /* end if */
+
+	/* local connections */
+	turbulence_conn_mgr_broadcast_msg (ctx, message, message_size, profile, 
+					   names ? __turbulence_process_broadcast_filter : NULL, names);
+	if (ctx->child) {
+		axl_freev (names);
+		return 0;
+	} /* end if */
+
+	/* build broadcast record */
+	size = TBC_BROADCAST_HEADER;
+	if (! __turbulence_process_put_int (record, sizeof (record), &size, message_size) ||
+	    ! __turbulence_process_put_str (record, sizeof (record), &size, profile) ||
+	    size > TBC_HANDOFF_BUFFER) {
+		error ("PARENT: unable to build broadcast record for profile %s (too big?)", profile);
+		axl_freev (names);
+		return -1;
+	} /* end if */
+	record[0] = 'b';
+	record[1] = TBC_BROADCAST_VERSION;
+	record[2] = (size >> 8) & 0xff;
+	record[3] = size & 0xff;
+
+	/* select childs */
+	childs = axl_list_new (axl_list_always_return_1, NULL);
+	TBC_PROCESS_LOCK_CHILD ();
+	axl_hash_foreach2 (ctx->child_process, __turbulence_process_broadcast_select, names, childs);
+	TBC_PROCESS_UNLOCK_CHILD ();
+	axl_freev (names);
+
+	if (axl_list_length (childs) == 0) {
+		axl_list_free (childs);
+		return 0;
+	} /* end if */
+
+	/* write content once */
+	fd = __turbulence_process_broadcast_content (ctx, message, message_size);
+
+	cursor = axl_list_cursor_new (childs);
+	axl_list_cursor_first (cursor);
+	while (axl_list_cursor_has_item (cursor)) {
+		child = axl_list_cursor_get (cursor);
+
+		/* queue record along with a descriptor to the content
+		 * (sent with connections pending, if any) */
+		item = (fd >= 0) ? (TurbulenceHandoff *) axl_new (char, sizeof (TurbulenceHandoff) + size) : NULL;
+		if (item) {
+			item->socket = dup (fd);
+			item->size   = size;
+			item->record = (char *) (item + 1);
+			memcpy (item->record, record, size);
+			if (item->socket < 0) {
+				axl_free (item);
+				item = NULL;
+			} /* end if */
+		} /* end if */
+
+		if (item) {
+			vortex_mutex_lock (&child->mutex);
+			if (child->handoff_queue == NULL)
+				child->handoff_queue = axl_list_new (axl_list_always_return_1, (axlDestroyFunc) __turbulence_process_handoff_free);
+			axl_list_append (child->handoff_queue, item);
+			vortex_mutex_unlock (&child->mutex);
+
+			__turbulence_process_handoff_flush (ctx, child);
+			result++;
+		} else {
+			error ("PARENT: unable to relay broadcast to child pid %d", child->pid);
+		} /* end if */
+
+		turbulence_child_unref (child);
+		axl_list_cursor_next (cursor);
+	} /* end while */
+	axl_list_cursor_free (cursor);
+	axl_list_free (childs);
+
+	if (fd >= 0)
+		close (fd);
+
+	msg ("PARENT: broadcast on profile %s relayed to %d childs", profile, result);
+	return result;
+}
+
+/** 
+ * @internal Function used by __turbulence_process_spare_count
+ */
+axl_bool __turbulence_process_spare_count_foreach (axlPointer key, axlPointer data, axlPointer user_data, axlPointer user_data2) 
+{
+	TurbulencePPathDef  * ppath      = user_data;
+	int                 * count      = user_data2;
+	TurbulenceChild     * child      = data;
+
+	if (child->spare && turbulence_ppath_get_id (child->ppath) == turbulence_ppath_get_id (ppath))
+		(*count)++;
+	return axl_false; /* keep foreach looping */
+}
+
+/** 
+ * @internal Returns the number of idle spare childs the provided
+ * profile path has. Must be called with the child process mutex
+ * acquired.
+ */
+int __turbulence_process_spare_count (TurbulenceCtx * ctx, TurbulencePPathDef * def)
+{
+	int count = 0;
+
+	axl_hash_foreach2 (ctx->child_process, __turbulence_process_spare_count_foreach, def, &count);
+	return count;
+}
+
+/** 
+ * @internal Function used by __turbulence_process_get_spare_child
+ */
+axl_bool __find_spare (axlPointer key, axlPointer data, axlPointer user_data, axlPointer user_data2) 
+{
+	TurbulencePPathDef  * ppath      = user_data;
+	TurbulenceChild     * child      = data;
+	TurbulenceChild    ** result     = user_data2;
+	
+	if (child->spare && turbulence_ppath_get_id (child->ppath) == turbulence_ppath_get_id (ppath)) {
+		(*result) = child;
+		return axl_true; /* found child, stop foreach */
+	} /* end if */
+	return axl_false; /* keep foreach looping */
+}
+
+/** 
+ * @internal Returns an idle spare child for the provided profile
+ * path or NULL if the pool is empty. Must be called with the child
+ * process mutex acquired.
+ */
+TurbulenceChild * __turbulence_process_get_spare_child (TurbulenceCtx      * ctx, 
+							TurbulencePPathDef * def)
+{
+	TurbulenceChild * result = NULL;
+
+	axl_hash_foreach2 (ctx->child_process, __find_spare, def, &result);
+	return result;
+}
+
+/** 
+ * @internal Handler called by the child notify loop when a child
+ * running a profile path with children-per-ppath > 1 reports
+ * connections closed (one 'c' byte per connection).
+ */
+axl_bool __turbulence_process_child_notify (TurbulenceLoop * loop, 
+					    TurbulenceCtx  * ctx,
+					    int              descriptor, 
+					    axlPointer       ptr, 
+					    axlPointer       ptr2)
+{
+	TurbulenceChild * child = ptr;
+	char              buffer[64];
+	int               size;
+	int               iterator;
+
+	size = recv (descriptor, buffer, sizeof (buffer), 0);
+	if (size <= 0) {
+		/* child finished, release reference acquired by
+		 * __turbulence_process_watch_child (descriptor is
+		 * closed by the loop) */
+		msg ("PARENT: child pid=%d closed notify connection, stop watching", child->pid);
+		turbulence_child_unref (child);
+		return axl_false;
+	} /* end if */
+
+	TBC_PROCESS_LOCK_CHILD ();
+	iterator = 0;
+	while (iterator < size) {
+		if (buffer[iterator] == 'c' && child->conn_count > 0)
+			child->conn_count--;
+		iterator++;
+	} /* end while */
+
+	/* let connections waiting check limits again */
+	if (child->ppath)
+		__turbulence_process_admission_wakeup (child->ppath);
+	TBC_PROCESS_UNLOCK_CHILD ();
+
+	return axl_true;
+}
+
+/** 
+ * @internal Starts watching child control connection to receive
+ * connection closed notifications, used to balance connections
+ * across childs of the same profile path. Only done for profile
+ * paths with children-per-ppath > 1. Must be called with the child
+ * process mutex acquired.
+ */
+void __turbulence_process_watch_child (TurbulenceCtx * ctx, TurbulenceChild * child)
+{
+	int descriptor;
+
+	if (child->ppath == NULL || child->ppath->children_per_ppath <= 1)
+		return;
+
+	/* create notify loop on first use */
+	if (ctx->child_notify_loop == NULL) {
+		ctx->child_notify_loop = turbulence_loop_create (ctx);
+		if (ctx->child_notify_loop == NULL) {
+			error ("PARENT: unable to create child notify loop, connection balancing for pid=%d disabled", child->pid);
+			return;
+		} /* end if */
+	} /* end if */
+
+	/* the loop owns its own descriptor (it is closed when the
+	 * child finishes) */
+	descriptor = dup (child->child_connection);
+	if (descriptor < 0) {
+		error ("PARENT: unable to dup child control connection for pid=%d, errno: %d", child->pid, errno);
+		return;
+	} /* end if */
+	fcntl (descriptor, F_SETFD, fcntl (descriptor, F_GETFD) | FD_CLOEXEC);
+
+	turbulence_child_ref (child);
+	turbulence_loop_watch_descriptor (ctx->child_notify_loop, descriptor, 
+					  __turbulence_process_child_notify, child, NULL);
+	return;
+}
+
+/** 
+ * @internal Reads CPU ticks (user + system) consumed by the provided
+ * process from /proc/<pid>/stat.
+ *
+ * @return axl_true if ticks were read (platforms without /proc
+ * always return axl_false).
+ */
+axl_bool __turbulence_process_read_cpu_ticks (int pid, long * ticks)
+{
+	char             path[64];
+	char             buffer[512];
+	char           * stat;
+	FILE           * file;
+	unsigned long    utime = 0;
+	unsigned long    stime = 0;
+	size_t           size;
+
+	snprintf (path, sizeof (path), "/proc/%d/stat", pid);
+	file = fopen (path, "r");
+	if (file == NULL)
+		return axl_false;
+	size = fread (buffer, 1, sizeof (buffer) - 1, file);
+	fclose (file);
+	buffer[size] = 0;
+
+	/* skip pid and command name (it may contain spaces) */
+	stat = strrchr (buffer, ')');
+	if (stat == NULL || sscanf (stat + 1, " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", &utime, &stime) != 2)
+		return axl_false;
+
+	(* ticks) = (long) (utime + stime);
+	return axl_true;
+}
+
+/** 
+ * @internal Reads resident memory (KB) of the provided process from
+ * /proc/<pid>/statm.
+ *
+ * @return axl_true if the value was read (platforms without /proc
+ * always return axl_false).
+ */
+axl_bool __turbulence_process_read_rss (int pid, long * rss)
+{
+	char             path[64];
+	FILE           * file;
+	unsigned long    size;
+	unsigned long    resident;
+	axl_bool         result = axl_false;
+
+	snprintf (path, sizeof (path), "/proc/%d/statm", pid);
+	file = fopen (path, "r");
+	if (file == NULL)
+		return axl_false;
+	if (fscanf (file, "%lu %lu", &size, &resident) == 2) {
+		(* rss) = (long) ((resident * sysconf (_SC_PAGESIZE)) / 1024);
+		result  = axl_true;
+	} /* end if */
+	fclose (file);
+	return result;
+}
+
+typedef struct _TurbulenceChildSample {
+	int                  pid;
+	axl_bool             cpu;
+	axl_bool             rss;
+	long                 ticks;
+	long                 rss_value;
+} TurbulenceChildSample;
+
+typedef struct _TurbulenceChildSampling {
+	TurbulencePPathDef    * def;
+	TurbulenceChildSample * samples;
+	int                     count;
+	int                     size;
+	struct timeval          now;
+} TurbulenceChildSampling;
+
+/** 
+ * @internal Function used by __turbulence_process_sample_childs to
+ * collect childs that must be sampled.
+ */
+axl_bool __turbulence_process_sample_collect (axlPointer key, axlPointer data, axlPointer user_data) 
+{
+	TurbulenceChildSampling * sampling = user_data;
+	TurbulenceChild         * child    = data;
+	TurbulenceChildSample   * sample;
+	axl_bool                  cpu;
+	axl_bool                  rss;
+
+	if (sampling->count >= sampling->size)
+		return axl_true; /* stop foreach */
+	if (turbulence_ppath_get_id (child->ppath) != turbulence_ppath_get_id (sampling->def) || child->spare || child->draining)
+		return axl_false; /* keep foreach looping */
+
+	/* sampled at most once per second */
+	cpu = sampling->def->balance_cpu && 
+		(child->cpu_sample.tv_sec == 0 || (sampling->now.tv_sec - child->cpu_sample.tv_sec) >= 1);
+	rss = sampling->def->recycle_rss > 0 &&
+		(child->rss_sample.tv_sec == 0 || (sampling->now.tv_sec - child->rss_sample.tv_sec) >= 1);
+	if (! cpu && ! rss)
+		return axl_false; /* keep foreach looping */
+
+	sample      = &sampling->samples[sampling->count++];
+	sample->pid = child->pid;
+	sample->cpu = cpu;
+	sample->rss = rss;
+	return axl_false; /* keep foreach looping */
+}
+
+/** 
+ * @internal Updates cpu_load (fraction of one CPU used since last
+ * sample, see balance-cpu) and rss (resident memory, see recycle-rss)
+ * of childs running the provided profile path. Pids are collected
+ * with the child process mutex acquired but /proc is read without
+ * it. Must be called without the child process mutex.
+ */
+void __turbulence_process_sample_childs (TurbulenceCtx * ctx, TurbulencePPathDef * def)
+{
+	TurbulenceChildSampling   sampling;
+	TurbulenceChildSample   * sample;
+	TurbulenceChild         * child;
+	struct timeval            now;
+	double                    elapsed;
+	long                      clk_tck;
+	int                       iterator;
+
+	if (def == NULL || ! def->reuse || (! def->balance_cpu && def->recycle_rss <= 0))
+		return;
+
+	/* collect pids */
+	memset (&sampling, 0, sizeof (TurbulenceChildSampling));
+	sampling.def = def;
+	gettimeofday (&sampling.now, NULL);
+	TBC_PROCESS_LOCK_CHILD ();
+	sampling.size = axl_hash_items (ctx->child_process);
+	if (sampling.size > 0) {
+		sampling.samples = axl_new (TurbulenceChildSample, sampling.size);
+		axl_hash_foreach (ctx->child_process, __turbulence_process_sample_collect, &sampling);
+	} /* end if */
+	TBC_PROCESS_UNLOCK_CHILD ();
+
+	if (sampling.count == 0) {
+		axl_free (sampling.samples);
+		return;
+	} /* end if */
+
+	/* read /proc */
+	for (iterator = 0; iterator < sampling.count; iterator++) {
+		sample = &sampling.samples[iterator];
+		if (sample->cpu && ! __turbulence_process_read_cpu_ticks (sample->pid, &sample->ticks))
+			sample->cpu = axl_false;
+		if (sample->rss && ! __turbulence_process_read_rss (sample->pid, &sample->rss_value))
+			sample->rss = axl_false;
+	} /* end for */
+
+	/* update childs still running */
+	gettimeofday (&now, NULL);
+	clk_tck = sysconf (_SC_CLK_TCK);
+	TBC_PROCESS_LOCK_CHILD ();
+	for (iterator = 0; iterator < sampling.count; iterator++) {
+		sample = &sampling.samples[iterator];
+		child  = axl_hash_get (ctx->child_process, INT_TO_PTR (sample->pid));
+		if (child == NULL)
+			continue;
+
+		if (sample->cpu) {
+			elapsed = (now.tv_sec - child->cpu_sample.tv_sec) + ((now.tv_usec - child->cpu_sample.tv_usec) / 1000000.0);
+			if (child->cpu_sample.tv_sec != 0 && clk_tck > 0 && elapsed > 0)
+				child->cpu_load = ((double) (sample->ticks - child->cpu_ticks) / clk_tck) / elapsed;
+			child->cpu_ticks  = sample->ticks;
+			child->cpu_sample = now;
+		} /* end if */
+
+		if (sample->rss) {
+			child->rss        = sample->rss_value;
+			child->rss_sample = now;
+		} /* end if */
+	} /* end for */
+	TBC_PROCESS_UNLOCK_CHILD ();
+
+	axl_free (sampling.samples);
+	return;
+}
+
+/** 
+ * @internal Checks profile path recycle thresholds (recycle-conns,
+ * recycle-age and recycle-rss) for the provided child. Once one is
+ * reached, the child is marked as draining: no more connections are
+ * sent to it (a new child is created for them) and it finishes once
+ * its connections are closed. Must be called with the child process
+ * mutex acquired.
+ *
+ * @return axl_true if the child is draining (must not be used),
+ * otherwise axl_false.
+ */
+axl_bool __turbulence_process_child_recycle (TurbulenceCtx * ctx, TurbulenceChild * child)
+{
+	TurbulencePPathDef * def    = child->ppath;
+	const char         * reason = NULL;
+
+	if (child->draining)
+		return axl_true;
+
+	/* idle childs have nothing to drain */
+	if (def == NULL || child->spare)
+		return axl_false;
+	if (def->recycle_conns <= 0 && def->recycle_age <= 0 && def->recycle_rss <= 0)
+		return axl_false;
+
+	if (def->recycle_conns > 0 && child->conns_served >= def->recycle_conns)
+		reason = "recycle-conns";
+	else if (def->recycle_age > 0 && child->started > 0 && ((long) time (NULL) - child->started) >= def->recycle_age)
+		reason = "recycle-age";
+	else if (def->recycle_rss > 0 && child->rss >= ((long) def->recycle_rss * 1024))
+		reason = "recycle-rss";
+
+	if (reason == NULL)
+		return axl_false;
+
+	/* keep using the child until a replacement can be created */
+	if (__turbulence_process_child_limit_reached (ctx, def))
+		return axl_false;
+
+	wrn ("PARENT: %s reached for child pid=%d of profile path %s (conns served: %d, age: %ld secs, rss: %ld KB), draining it", 
+	     reason, child->pid, def->path_name ? def->path_name : "(empty)", 
+	     child->conns_served, (long) time (NULL) - child->started, child->rss);
+	child->draining = axl_true;
+	return axl_true;
+}
+
+/** 
+ * @internal Refills the spawn token bucket according to the time
+ * elapsed since its last refill.
+ */
+void __turbulence_process_spawn_refill (TurbulenceSpawnBucket * bucket, struct timeval * now)
+{
+	double elapsed;
+
+	if (bucket->rate <= 0)
+		return;
+
+	if (bucket->last.tv_sec == 0) {
+		/* first use: bucket full */
+		bucket->tokens = bucket->burst;
+	} else {
+		elapsed = (now->tv_sec - bucket->last.tv_sec) + ((now->tv_usec - bucket->last.tv_usec) / 1000000.0);
+		if (elapsed > 0)
+			bucket->tokens += elapsed * bucket->rate;
+		if (bucket->tokens > bucket->burst)
+			bucket->tokens = bucket->burst;
+	} /* end if */
+	bucket->last = (* now);
+	return;
+}
+
+/** 
+ * @internal Returns microseconds to wait until the provided bucket
+ * has a token available (0 if available now).
+ */
+long __turbulence_process_spawn_bucket_delay (TurbulenceSpawnBucket * bucket)
+{
+	if (bucket->rate <= 0 || bucket->tokens >= 1.0)
+		return 0;
+	return (long) (((1.0 - bucket->tokens) / bucket->rate) * 1000000) + 1;
+}
+
+/** 
+ * @internal Checks child creation rate limits (child-spawn-rate and
+ * profile path spawn-rate). Must be called with the child process
+ * mutex acquired.
+ *
+ * @return 0 if a child can be created now, otherwise the number of
+ * microseconds to wait.
+ */
+long __turbulence_process_spawn_delay (TurbulenceCtx      * ctx,
+				       TurbulencePPathDef * def)
+{
+	struct timeval now;
+	long           delay;
+	long           ppath_delay = 0;
+
+	gettimeofday (&now, NULL);
+	__turbulence_process_spawn_refill (&ctx->spawn_bucket, &now);
+	delay = __turbulence_process_spawn_bucket_delay (&ctx->spawn_bucket);
+	if (def) {
+		__turbulence_process_spawn_refill (&def->spawn_bucket, &now);
+		ppath_delay = __turbulence_process_spawn_bucket_delay (&def->spawn_bucket);
+	} /* end if */
 
-	/* get child init string length (again) */
-	length = strlen (child_init_string);
-	/* msg ("PARENT: sending init child string length %d: %s", length, child_init_string); */
+	return delay > ppath_delay ? delay : ppath_delay;
+}
 
-	/* send content */
-	written = write (child->child_connection, child_init_string, length);
-	axl_free (child_init_string);
+/** 
+ * @internal Takes a token from the spawn buckets before creating a
+ * child (__turbulence_process_spawn_delay must have returned 0). Must
+ * be called with the child process mutex acquired.
+ */
+void __turbulence_process_spawn_consume (TurbulenceCtx      * ctx,
+					 TurbulencePPathDef * def)
+{
+	if (ctx->spawn_bucket.rate > 0)
+		ctx->spawn_bucket.tokens -= 1.0;
+	if (def && def->spawn_bucket.rate > 0)
+		def->spawn_bucket.tokens -= 1.0;
+	return;
+}
 
-	if (length != written) {
-		error ("PARENT: failed to send init child string, expected to write %d bytes but %d were written",
-		       length, written);
-		return axl_false;
-	}
+/** 
+ * @internal Accounts a child creation delayed or avoided due to
+ * spawn rate limits. Must be called with the child process mutex
+ * acquired.
+ */
+void __turbulence_process_spawn_throttled (TurbulenceCtx      * ctx,
+					   TurbulencePPathDef * def)
+{
+	ctx->spawn_bucket.throttled++;
+	if (def)
+		def->spawn_bucket.throttled++;
+	return;
+}
+
+/** 
+ * @brief Allows to get the number of child creations that were
+ * delayed or sent to a running child because child-spawn-rate (or
+ * spawn-rate for a profile path) was exceeded.
+ *
+ * @param ctx The turbulence context where childs are created.
+ *
+ * @param def Optional profile path. If NULL, the global count is
+ * returned.
+ *
+ * @return Number of child creations throttled.
+ */
+int               turbulence_process_spawn_throttled (TurbulenceCtx      * ctx,
+						      TurbulencePPathDef * def)
+{
+	int result;
+
+	if (ctx == NULL)
+		return 0;
+
+	TBC_PROCESS_LOCK_CHILD ();
+	result = def ? def->spawn_bucket.throttled : ctx->spawn_bucket.throttled;
+	TBC_PROCESS_UNLOCK_CHILD ();
+
+	return result;
+}
+
+typedef struct _TurbulenceChildSelect {
+	TurbulenceCtx      * ctx;
+	TurbulencePPathDef * def;
+	TurbulenceChild    * child;
+	double               load;
+	int                  count;
+} TurbulenceChildSelect;
+
+/** 
+ * @internal Function used by __turbulence_process_select_reuse_child
+ */
+axl_bool __turbulence_process_select_foreach (axlPointer key, axlPointer data, axlPointer user_data) 
+{
+	TurbulenceChildSelect * selection = user_data;
+	TurbulenceChild       * child     = data;
+	double                  load;
+
+	if (turbulence_ppath_get_id (child->ppath) != turbulence_ppath_get_id (selection->def))
+		return axl_false; /* keep foreach looping */
+
+	/* skip childs being recycled */
+	if (__turbulence_process_child_recycle (selection->ctx, child))
+		return axl_false; /* keep foreach looping */
+
+	/* least connections, optionally weighted by recent CPU use */
+	load = child->conn_count;
+	if (selection->def->balance_cpu)
+		load = (child->conn_count + 1) * (1.0 + child->cpu_load);
+
+	if (selection->child == NULL || load < selection->load) {
+		selection->child = child;
+		selection->load  = load;
+	} /* end if */
+	selection->count++;
+
+	return axl_false; /* keep foreach looping */
+}
+
+/** 
+ * @internal Selects the child that will handle a new connection for
+ * a profile path with reuse enabled and children-per-ppath > 1. Must
+ * be called with the child process mutex acquired.
+ *
+ * @return The least loaded child or NULL if a new child must be
+ * created (children-per-ppath not reached yet).
+ */
+TurbulenceChild * __turbulence_process_select_reuse_child (TurbulenceCtx      * ctx,
+							   TurbulencePPathDef * def)
+{
+	TurbulenceChildSelect selection;
+
+	memset (&selection, 0, sizeof (TurbulenceChildSelect));
+	selection.ctx = ctx;
+	selection.def = def;
+	axl_hash_foreach (ctx->child_process, __turbulence_process_select_foreach, &selection);
+
+	/* start another child while below children-per-ppath (and
+	 * limits allow it) */
+	if (selection.count < def->children_per_ppath && ! __turbulence_process_child_limit_reached (ctx, def)) {
+		if (selection.child == NULL || __turbulence_process_spawn_delay (ctx, def) == 0)
+			return NULL;
+
+		/* spawn rate exceeded: use a running child */
+		__turbulence_process_spawn_throttled (ctx, def);
+	} /* end if */
+
+	if (selection.child)
+		msg ("PARENT: selected child pid=%d (conns: %d, cpu: %.2f) out of %d for profile path %s",
+		     selection.child->pid, selection.child->conn_count, selection.child->cpu_load, 
+		     selection.count, def->path_name ? def->path_name : "(empty)");
+	return selection.child;
+}
+
+/** 
+ * @internal Reserves a child slot (counted against
+ * global-child-limit) so the child can be created without holding
+ * the child process mutex. Must be called with the child process
+ * mutex acquired, after checking limits.
+ */
+void __turbulence_process_reserve_child (TurbulenceCtx * ctx)
+{
+	ctx->childs_starting++;
+	return;
+}
+
+/** 
+ * @internal Releases a child slot reserved with
+ * __turbulence_process_reserve_child when the child creation failed.
+ */
+void __turbulence_process_release_child (TurbulenceCtx * ctx)
+{
+	TBC_PROCESS_LOCK_CHILD ();
+	ctx->childs_starting--;
+
+	/* the slot may be used by a connection waiting */
+	__turbulence_process_admission_wakeup_all (ctx);
+	TBC_PROCESS_UNLOCK_CHILD ();
+	return;
+}
+
+/** 
+ * @internal Registers a child created outside the child process
+ * mutex into the child table, releasing the slot reserved. This is
+ * the only part of the child creation done with the child process
+ * mutex acquired.
+ *
+ * @return axl_true if the child was registered, axl_false if it
+ * already finished (the reference is released in such case).
+ */
+axl_bool __turbulence_process_register_child (TurbulenceCtx      * ctx,
+					      TurbulenceChild    * child,
+					      TurbulencePPathDef * def)
+{
+	int      pid    = child->pid;
+	axl_bool result = axl_true;
+
+	TBC_PROCESS_LOCK_CHILD ();
+	ctx->childs_starting--;
+
+	/* register the child process identifier */
+	axl_hash_insert_full (ctx->child_process,
+			      /* store child pid */
+			      INT_TO_PTR (pid), NULL,
+			      /* data and destroy func */
+			      child, (axlDestroyFunc) turbulence_child_unref);
+
+	/* update number of childs running this profile path */
+	def->childs_running++;
+	child->started = (long) time (NULL);
+
+	/* receive connection closed notifications */
+	__turbulence_process_watch_child (ctx, child);
+
+	/* the child was not in the table while it was created: if it
+	 * already finished, its SIGCHLD found nothing to remove */
+	if (kill (pid, 0) != 0 && errno == ESRCH) {
+		wrn ("PARENT: child pid=%d finished before being registered, removing it", pid);
+		def->childs_running--;
+		axl_hash_remove (ctx->child_process, INT_TO_PTR (pid));
+		__turbulence_process_admission_wakeup (def);
+		result = axl_false;
+	} else if (ctx->is_exiting) {
+		/* childs were already killed */
+		wrn ("PARENT: child pid=%d registered while turbulence is finishing, killing it", pid);
+		kill (pid, SIGTERM);
+	} /* end if */
+
+	TBC_PROCESS_UNLOCK_CHILD ();
+	return result;
+}
+
+/** 
+ * @internal Starts a child process for the provided profile path
+ * without any connection (connections are sent later through its
+ * control socket). The child is created by the zygote process if
+ * it is running, otherwise by fork/exec. Must be called with the
+ * profile path create_mutex acquired and a child slot reserved (see
+ * __turbulence_process_register_child), but without the child
+ * process mutex.
+ *
+ * @return A reference to the child started (not registered yet) or
+ * NULL if it fails.
+ */
+TurbulenceChild * __turbulence_process_start_idle_child (TurbulenceCtx      * ctx,
+							 TurbulencePPathDef * def)
+{
+	int                pid;
+	TurbulenceChild  * child;
 	
-	msg ("PARENT: child init string sent to child");
+	/* pipes to communicate logs from child to parent */
+	int                general_log[2] = {-1, -1};
+	int                error_log[2]   = {-1, -1};
+	int                access_log[2]  = {-1, -1};
+	int                vortex_log[2]  = {-1, -1};
+
+	/* log pipes as seen by the child process */
+	int                child_logs[8]  = {-1, -1, -1, -1, -1, -1, -1, -1};
+
+	/* enable SIGCHLD handling */
+	turbulence_signal_sigchld (ctx, axl_true);
+
+	/* create pipes to receive child logs */
+	__turbulence_process_open_log_pipes (ctx, general_log, error_log, access_log, vortex_log);
+
+	/* create control socket path */
+	child = turbulence_child_new (ctx, def);
+	if (child == NULL) {
+		__turbulence_process_close_log_pipes (general_log, error_log, access_log, vortex_log);
+		return NULL;
+	} /* end if */
+
+	/* try to create the child from the zygote process */
+	pid = __turbulence_process_zygote_spawn (ctx, child, general_log, error_log, access_log, vortex_log, child_logs);
+	if (pid < 0) {
+		/* call to fork: child inherits log pipes */
+		pid = fork ();
+		if (pid < 0) {
+			error ("PARENT: unable to create child process for profile path %s, errno: %d:%s", 
+			       def->path_name ? def->path_name : "(empty)", errno, vortex_errno_get_last_error ());
+			__turbulence_process_close_log_pipes (general_log, error_log, access_log, vortex_log);
+			turbulence_child_unref (child);
+			return NULL;
+		} /* end if */
+		if (pid == 0) {
+			/**** CHILD CODE ****/
+			__turbulence_process_keep_log_pipes (general_log, error_log, access_log, vortex_log);
+			__turbulence_process_exec_child (ctx, child, NULL, axl_false);
+			return NULL;
+		} /* end if */
+
+		memcpy (child_logs,     general_log, sizeof (general_log));
+		memcpy (child_logs + 2, error_log,   sizeof (error_log));
+		memcpy (child_logs + 4, access_log,  sizeof (access_log));
+		memcpy (child_logs + 6, vortex_log,  sizeof (vortex_log));
+	} /* end if */
+
+	/* update child pid */
+	child->pid = pid;
+
+	/* create child connection and send child init string
+	 * (without connection to restore) */
+	if (! __turbulence_process_create_child_connection (child) ||
+	    ! __turbulence_process_send_child_init_string (ctx, child, NULL, -1, def, 
+							   axl_false, -1, NULL, NULL, EncodingNone, NULL, NULL,
+							   child_logs, child_logs + 2, child_logs + 4, child_logs + 6)) {
+		error ("PARENT: unable to start child pid=%d for profile path %s, killing it", 
+		       pid, def->path_name ? def->path_name : "(empty)");
+		if (pid > 0)
+			kill (pid, SIGTERM);
+		__turbulence_process_close_log_pipes (general_log, error_log, access_log, vortex_log);
+		turbulence_child_unref (child);
+		return NULL;
+	} /* end if */
+
+	/* register pipes to receive child logs */
+	__turbulence_process_prepare_logging (ctx, axl_true, general_log, error_log, access_log, vortex_log);
+
+	return child;
+}
+
+/** 
+ * @internal Creates a child process for the provided profile path
+ * that is started without any connection (a spare child). The child
+ * completes its startup (config, modules, privileges) and waits for
+ * connections on its control socket.
+ *
+ * @return axl_true if the spare child was created, otherwise
+ * axl_false (limits reached, turbulence exiting or failure).
+ */
+axl_bool __turbulence_process_create_spare_child (TurbulenceCtx      * ctx,
+						  TurbulencePPathDef * def)
+{
+	int                pid;
+	TurbulenceChild  * child;
+
+	vortex_mutex_lock (&def->create_mutex);
+	TBC_PROCESS_LOCK_CHILD ();
+
+	/* check if we are exiting or limits do not allow more
+	 * childs */
+	if (ctx->is_exiting || __turbulence_process_child_limit_reached (ctx, def)) {
+		TBC_PROCESS_UNLOCK_CHILD ();
+		vortex_mutex_unlock (&def->create_mutex);
+		return axl_false;
+	} /* end if */
+	__turbulence_process_reserve_child (ctx);
+	TBC_PROCESS_UNLOCK_CHILD ();
+
+	child = __turbulence_process_start_idle_child (ctx, def);
+	if (child == NULL) {
+		__turbulence_process_release_child (ctx);
+		vortex_mutex_unlock (&def->create_mutex);
+		return axl_false;
+	} /* end if */
+	child->spare = axl_true;
+	pid          = child->pid;
+
+	if (! __turbulence_process_register_child (ctx, child, def)) {
+		vortex_mutex_unlock (&def->create_mutex);
+		return axl_false;
+	} /* end if */
+	vortex_mutex_unlock (&def->create_mutex);
+
+	msg ("PARENT=%d: Created spare child process pid=%d, selected-ppath=%s (childs: %d)", 
+	     getpid (), pid, def->path_name ? def->path_name : "(empty)", turbulence_process_child_count (ctx));
 	return axl_true;
 }
 
+typedef struct _TurbulenceSpareRefill {
+	TurbulenceCtx      * ctx;
+	TurbulencePPathDef * def;
+} TurbulenceSpareRefill;
+
+/** 
+ * @internal Thread that creates spare childs for a profile path until
+ * its pool reaches min-spare-childs (or max-spare-childs after the
+ * pool was found empty).
+ */
+axlPointer __turbulence_process_spare_refill_run (TurbulenceSpareRefill * data)
+{
+	TurbulenceCtx      * ctx    = data->ctx;
+	TurbulencePPathDef * def    = data->def;
+	int                  target;
+	int                  spares;
+	long                 delay;
+
+	/* release data (the profile path reference is kept until the
+	 * refill finishes) */
+	axl_free (data);
+
+	while (axl_true) {
+		TBC_PROCESS_LOCK_CHILD ();
+
+		/* get pool size to reach */
+		target = def->spare_burst ? def->max_spare_childs : def->min_spare_childs;
+
+		/* with reuse="yes" all connections go to the same
+		 * child, so only the first one is pre-started */
+		if (def->reuse)
+			target = turbulence_process_get_child_from_ppath (ctx, def, axl_false) ? 0 : 1;
+
+		spares = __turbulence_process_spare_count (ctx, def);
+		if (ctx->is_exiting || spares >= target || __turbulence_process_child_limit_reached (ctx, def)) {
+			/* pool complete, finish refill */
+			def->spare_refilling = axl_false;
+			def->spare_burst     = axl_false;
+			TBC_PROCESS_UNLOCK_CHILD ();
+			break;
+		} /* end if */
+
+		/* spare childs are also subject to spawn rate */
+		delay = __turbulence_process_spawn_delay (ctx, def);
+		if (delay > 0) {
+			__turbulence_process_spawn_throttled (ctx, def);
+			TBC_PROCESS_UNLOCK_CHILD ();
+			turbulence_sleep (ctx, delay);
+			continue;
+		} /* end if */
+		__turbulence_process_spawn_consume (ctx, def);
+		TBC_PROCESS_UNLOCK_CHILD ();
+
+		msg ("PARENT: refilling spare childs for profile path %s (spares=%d, target=%d)", 
+		     def->path_name ? def->path_name : "(empty)", spares, target);
+		if (! __turbulence_process_create_spare_child (ctx, def)) {
+			TBC_PROCESS_LOCK_CHILD ();
+			def->spare_refilling = axl_false;
+			def->spare_burst     = axl_false;
+			TBC_PROCESS_UNLOCK_CHILD ();
+			break;
+		} /* end if */
+	} /* end while */
+
+	/* release reference acquired by __turbulence_process_spare_refill */
+	__turbulence_ppath_unref (ctx, def);
+
+	return NULL;
+}
+
+/** 
+ * @internal Requests to refill the spare pool of the provided profile
+ * path. Childs are created in a separate thread so the caller is not
+ * delayed. Must be called with the child process mutex acquired.
+ *
+ * @param burst If axl_true, the pool is refilled up to
+ * max-spare-childs rather min-spare-childs.
+ */
+void __turbulence_process_spare_refill (TurbulenceCtx      * ctx, 
+					TurbulencePPathDef * def,
+					axl_bool             burst)
+{
+	VortexThread            thread;
+	TurbulenceSpareRefill * data;
+
+	if (def == NULL || def->min_spare_childs <= 0 || ctx->is_exiting)
+		return;
+
+	/* record burst request (picked up by running refill) */
+	if (burst)
+		def->spare_burst = axl_true;
+	if (def->spare_refilling)
+		return;
+
+	/* create refill data */
+	data = axl_new (TurbulenceSpareRefill, 1);
+	if (data == NULL)
+		return;
+	data->ctx = ctx;
+	data->def = def;
+
+	/* keep the profile path while the refill thread runs */
+	__turbulence_ppath_ref (ctx, def);
+
+	def->spare_refilling = axl_true;
+	if (! vortex_thread_create (&thread,
+				    (VortexThreadFunc) __turbulence_process_spare_refill_run,
+				    data, VORTEX_THREAD_CONF_DETACHED, VORTEX_THREAD_CONF_END)) {
+		error ("Failed to create thread to refill spare childs (code %d) %s",
+		       errno, vortex_errno_get_last_error ());
+		def->spare_refilling = axl_false;
+		__turbulence_ppath_unref (ctx, def);
+		axl_free (data);
+	} /* end if */
+	return;
+}
+
+/** 
+ * @internal Starts spare child pools for all profile paths
+ * configured with min-spare-childs. Called by the main process once
+ * listeners are started.
+ *
+ * @param ctx The context where the spare childs will be created.
+ */
+void turbulence_process_spare_childs_start (TurbulenceCtx * ctx)
+{
+	TurbulencePPathDef * def;
+	TurbulencePPath    * paths;
+	int                  iterator;
+
+	/* only main process can create childs */
+	if (ctx == NULL || ctx->child)
+		return;
+
+	/* hold the table: a reload may replace it meanwhile (spare
+	 * refills keep their own reference) */
+	paths    = __turbulence_ppath_table_current (ctx);
+	iterator = 0;
+	while ((def = __turbulence_ppath_get_nth (paths, iterator)) != NULL) {
+		if (def->separate && def->min_spare_childs > 0) {
+			msg ("PARENT: starting spare child pool for profile path %s (min-spare-childs=%d, max-spare-childs=%d)",
+			     def->path_name ? def->path_name : "(empty)", def->min_spare_childs, def->max_spare_childs);
+			TBC_PROCESS_LOCK_CHILD ();
+			__turbulence_process_spare_refill (ctx, def, axl_false);
+			TBC_PROCESS_UNLOCK_CHILD ();
+		} /* end if */
+
+		/* next position */
+		iterator++;
+	} /* end while */
+
+	__turbulence_ppath_table_unref (ctx, paths);
+	return;
+}
+
 /** 
  * @internal Allows to create a child process running listener connection
- * provided.
+ * provided (see turbulence_process_create_child).
+ *
+ * @param admission The connection resumed from the admission queue
+ * or NULL for new connections.
+ *
+ * @return axl_true if the connection resumed is still waiting in the
+ * admission queue (so it must not be released), otherwise axl_false.
  */
-void turbulence_process_create_child (TurbulenceCtx       * ctx, 
-				      VortexConnection    * conn, 
-				      TurbulencePPathDef  * def,
-				      axl_bool              handle_start_reply,
-				      int                   channel_num,
-				      const char          * profile,
-				      const char          * profile_content,
-				      VortexEncoding        encoding,
-				      char                * serverName,
-				      VortexFrame         * frame)
+axl_bool __turbulence_process_create_child (TurbulenceCtx       * ctx, 
+					    VortexConnection    * conn, 
+					    TurbulencePPathDef  * def,
+					    axl_bool              handle_start_reply,
+					    int                   channel_num,
+					    const char          * profile,
+					    const char          * profile_content,
+					    VortexEncoding        encoding,
+					    char                * serverName,
+					    VortexFrame         * frame,
+					    TurbulenceAdmission * admission)
 {
 	int                pid;
 	TurbulenceChild  * child;
@@ -1478,18 +4738,21 @@ void turbulence_process_create_child (TurbulenceCtx       * ctx,
 	int                access_log[2]  = {-1, -1};
 	int                vortex_log[2]  = {-1, -1};
 	const char       * ppath_name;
-	int                error_code;
-	char            ** cmds;
-	int                iterator = 0;
-	axl_bool           skip_thread_pool_wait = axl_false;
-	axl_bool           enable_debug          = axl_false;
+	long               delay;
+	int                status;
+	axl_bool           use_zygote;
+	/* connection resumed from the admission queue already
+	 * admitted (it is not queued again) */
+	axl_bool           admitted       = axl_false;
 	/* get current proxy on parent setting */
 	axl_bool           proxy_on_parent = turbulence_conn_mgr_proxy_on_parent (conn);
 
-	if (ctx->is_exiting) {
+	/* connections resumed from the admission queue are checked
+	 * below (they must leave the queue first) */
+	if (ctx->is_exiting && admission == NULL) {
 		error ("Unable to create child process, turbulence is finishing..");
 		vortex_connection_shutdown (conn);
-		return;
+		return axl_false;
 	} /* end if */
 
 	/* check if we are main process (only main process can create
@@ -1498,7 +4761,7 @@ void turbulence_process_create_child (TurbulenceCtx       * ctx,
 		error ("Internal runtime error, child process %d is trying to create another subchild, closing conn-id=%d", 
 		       ctx->pid, vortex_connection_get_id (conn));
 		vortex_connection_shutdown (conn);
-		return;
+		return axl_false;
 	} /* end if */
 
 	/* get profile path name */
@@ -1506,16 +4769,45 @@ void turbulence_process_create_child (TurbulenceCtx       * ctx,
 
 	msg2 ("Calling to create child process to handle profile path: %s..", ppath_name);
 
+	/* update childs load and memory used to select or recycle
+	 * them (read before acquiring the child process mutex) */
+	__turbulence_process_sample_childs (ctx, def);
+
+	/* serialize child creation for this profile path (childs for
+	 * other profile paths are created in parallel) */
+	vortex_mutex_lock (&def->create_mutex);
 	TBC_PROCESS_LOCK_CHILD ();
 
+	/* connection resumed from the admission queue: check if it
+	 * can leave the queue */
+	if (admission != NULL) {
+		status = __turbulence_process_admission_leave (ctx, admission);
+		if (status > 0) {
+			/* keep waiting */
+			TBC_PROCESS_UNLOCK_CHILD ();
+			vortex_mutex_unlock (&def->create_mutex);
+			return axl_true;
+		} /* end if */
+		if (status < 0) {
+			TBC_PROCESS_UNLOCK_CHILD ();
+			vortex_mutex_unlock (&def->create_mutex);
+
+			error ("PARENT: conn-id=%d closed or turbulence finishing while waiting for a child", vortex_connection_get_id (conn));
+			vortex_connection_shutdown (conn);
+			return axl_false;
+		} /* end if */
+		admitted = axl_true;
+	} /* end if */
+
 	/* recheck again if we are exiting */
 	if (ctx->is_exiting) {
 		/* unlock */
 		TBC_PROCESS_UNLOCK_CHILD ();
+		vortex_mutex_unlock (&def->create_mutex);
 
 		error ("Unable to create child process, turbulence is finishing..");
 		vortex_connection_shutdown (conn);
-		return;
+		return axl_false;
 	} /* end if */
 
 	/* enable SIGCHLD handling */
@@ -1526,38 +4818,116 @@ void turbulence_process_create_child (TurbulenceCtx       * ctx,
 	/* check if child associated to the given profile path is
 	   defined and if reuse flag is enabled */
 	child = turbulence_process_get_child_from_ppath (ctx, def, axl_false);
+	if (def->reuse && child && def->children_per_ppath > 1)
+		child = __turbulence_process_select_reuse_child (ctx, def);
 	if (def->reuse && child) {
 		msg ("Found child process reuse flag and child already created (%p), sending connection id=%d, frame msgno=%d",
 		     child, vortex_connection_get_id (conn), vortex_frame_get_msgno (frame));
 
-		if (proxy_on_parent) {
-			/* setup the proxy on parent code creating a
-			 * new client socket */
-			client_socket = turbulence_conn_mgr_setup_proxy_on_parent (ctx, conn);
+		/* child pre-started by the spare pool is now in use */
+		child->spare = axl_false;
 
-			/* send the connection to the child process */
-			turbulence_process_send_proxy_connection_to_child (
-				ctx, child, conn, client_socket,handle_start_reply, channel_num,
-				profile, profile_content, encoding, serverName, frame);
-		} else {
-		     
-			/* reuse profile path */
-			turbulence_process_send_connection_to_child (ctx, child, conn, 
-								     handle_start_reply, channel_num,
-								     profile, profile_content,
-								     encoding, serverName, frame);
-		} /* end if */
+		/* reuse profile path */
+		__turbulence_process_handoff_connection (ctx, child, conn, proxy_on_parent,
+							 handle_start_reply, channel_num,
+							 profile, profile_content,
+							 encoding, serverName, frame);
+		child->conn_count++;
+		turbulence_child_ref (child);
 		TBC_PROCESS_UNLOCK_CHILD ();
-		return;
+		vortex_mutex_unlock (&def->create_mutex);
+
+		/* send it (along with others queued for this child) */
+		__turbulence_process_handoff_flush (ctx, child);
+		turbulence_child_unref (child);
+		return axl_false;
 	}
 
-	/* check limits here before continue */
-	if (turbulence_process_check_child_limit (ctx, conn, def)) {
-		/* unlock before shutting down connection */
-		TBC_PROCESS_UNLOCK_CHILD ();
-		return;
+	/* check for an idle child already started by the spare pool
+	 * of this profile path */
+	if (! def->reuse && def->min_spare_childs > 0) {
+		child = __turbulence_process_get_spare_child (ctx, def);
+		if (child) {
+			msg ("PARENT: Using spare child pid=%d for conn-id=%d, proxy_on_parent=%d", 
+			     child->pid, vortex_connection_get_id (conn), proxy_on_parent);
+
+			/* child is no longer idle */
+			child->spare = axl_false;
+
+			__turbulence_process_handoff_connection (ctx, child, conn, proxy_on_parent,
+								 handle_start_reply, channel_num,
+								 profile, profile_content,
+								 encoding, serverName, frame);
+
+			/* replace the child taken from the pool */
+			__turbulence_process_spare_refill (ctx, def, axl_false);
+			turbulence_child_ref (child);
+			TBC_PROCESS_UNLOCK_CHILD ();
+			vortex_mutex_unlock (&def->create_mutex);
+
+			__turbulence_process_handoff_flush (ctx, child);
+			turbulence_child_unref (child);
+			return axl_false;
+		} /* end if */
+
+		/* pool empty (burst): refill up to max-spare-childs
+		 * while this connection creates its own child */
+		__turbulence_process_spare_refill (ctx, def, axl_true);
 	} /* end if */
 
+	while (axl_true) {
+		/* queue the connection if limits are reached and the
+		 * profile path has an admission queue (it is resumed
+		 * later without holding this thread) */
+		if (! admitted && __turbulence_process_admission_queue (ctx, conn, def, handle_start_reply, channel_num,
+									 profile, profile_content, encoding, serverName, frame)) {
+			TBC_PROCESS_UNLOCK_CHILD ();
+			vortex_mutex_unlock (&def->create_mutex);
+			return axl_false;
+		} /* end if */
+
+		/* check limits here before continue */
+		if (turbulence_process_check_child_limit (ctx, conn, def)) {
+			/* unlock before shutting down connection */
+			TBC_PROCESS_UNLOCK_CHILD ();
+			vortex_mutex_unlock (&def->create_mutex);
+			return axl_false;
+		} /* end if */
+
+		/* check child creation rate */
+		delay = __turbulence_process_spawn_delay (ctx, def);
+		if (delay == 0)
+			break;
+
+		/* spawn rate exceeded: wait for the next token and
+		 * check limits again */
+		__turbulence_process_spawn_throttled (ctx, def);
+		msg ("PARENT: child spawn rate exceeded, conn-id=%d waiting %ld us to create a child for profile path: %s", 
+		     vortex_connection_get_id (conn), delay, ppath_name);
+		TBC_PROCESS_UNLOCK_CHILD ();
+		vortex_mutex_unlock (&def->create_mutex);
+
+		turbulence_sleep (ctx, delay);
+
+		vortex_mutex_lock (&def->create_mutex);
+		TBC_PROCESS_LOCK_CHILD ();
+		if (ctx->is_exiting || ! vortex_connection_is_ok (conn, axl_false)) {
+			TBC_PROCESS_UNLOCK_CHILD ();
+			vortex_mutex_unlock (&def->create_mutex);
+
+			error ("PARENT: conn-id=%d closed or turbulence finishing while waiting to create a child", vortex_connection_get_id (conn));
+			vortex_connection_shutdown (conn);
+			return axl_false;
+		} /* end if */
+	} /* end while */
+	__turbulence_process_spawn_consume (ctx, def);
+
+	/* reserve a child slot: the child is created without the
+	 * child process mutex, which is only acquired again to
+	 * register it */
+	__turbulence_process_reserve_child (ctx);
+	TBC_PROCESS_UNLOCK_CHILD ();
+
 	/* show some logs about what will happen */
 	if (child == NULL) 
 		msg ("PARENT: Creating a child process (first instance), proxy_on_parent=%d, conn-id=%d", 
@@ -1566,26 +4936,65 @@ void turbulence_process_create_child (TurbulenceCtx       * ctx,
  		msg ("PARENT: Child defined, but not reusing child processes (reuse=no flag), proxy_on_parent=%d, conn-id=%d", 
 		     proxy_on_parent, vortex_connection_get_id (conn));
 
-	if (turbulence_log_is_enabled (ctx)) {
-		if (pipe (general_log) != 0)
-			error ("unable to create pipe to transport general log, this will cause these logs to be lost");
-		if (pipe (error_log) != 0)
-			error ("unable to create pipe to transport error log, this will cause these logs to be lost");
-		if (pipe (access_log) != 0)
-			error ("unable to create pipe to transport access log, this will cause these logs to be lost");
-		if (pipe (vortex_log) != 0)
-			error ("unable to create pipe to transport vortex log, this will cause these logs to be lost");
+	/* with the zygote process running, childs do not inherit the
+	 * connection: the child is started idle and the connection is
+	 * sent through its control socket */
+	vortex_mutex_lock (&ctx->zygote_mutex);
+	use_zygote = ctx->zygote_connection >= 0;
+	vortex_mutex_unlock (&ctx->zygote_mutex);
+	if (use_zygote) {
+		child = __turbulence_process_start_idle_child (ctx, def);
+		if (child == NULL) {
+			__turbulence_process_release_child (ctx);
+			vortex_mutex_unlock (&def->create_mutex);
+
+			vortex_connection_shutdown (conn);
+			return axl_false;
+		} /* end if */
+
+		/* the connection that originated the child */
+		pid                 = child->pid;
+		child->conn_count   = 1;
+		child->conns_served = 1;
+		turbulence_child_ref (child);
+		if (! __turbulence_process_register_child (ctx, child, def)) {
+			vortex_mutex_unlock (&def->create_mutex);
+			turbulence_child_unref (child);
+
+			error ("PARENT: child pid=%d created from zygote finished before receiving conn-id=%d, closing it", 
+			       pid, vortex_connection_get_id (conn));
+			vortex_connection_shutdown (conn);
+			return axl_false;
+		} /* end if */
+
+		__turbulence_process_handoff_connection (ctx, child, conn, proxy_on_parent,
+							 handle_start_reply, channel_num,
+							 profile, profile_content,
+							 encoding, serverName, frame);
+		vortex_mutex_unlock (&def->create_mutex);
+
+		__turbulence_process_handoff_flush (ctx, child);
+		turbulence_child_unref (child);
+
+		msg ("PARENT=%d: Created child process pid=%d from zygote (childs: %d)", getpid (), pid, turbulence_process_child_count (ctx));
+		return axl_false;
 	} /* end if */
 
+	/* create pipes to receive child logs */
+	__turbulence_process_open_log_pipes (ctx, general_log, error_log, access_log, vortex_log);
+
 	/* create control socket path */
 	child        = turbulence_child_new (ctx, def);
 	if (child == NULL) {
-		/* unlock child process mutex */
-		TBC_PROCESS_UNLOCK_CHILD ();
+		__turbulence_process_close_log_pipes (general_log, error_log, access_log, vortex_log);
+
+		/* release child slot and creation mutex */
+		__turbulence_process_release_child (ctx);
+		vortex_mutex_unlock (&def->create_mutex);
 
 		/* close connection that would handle child process */
 		vortex_connection_shutdown (conn);
-		return;
+		return axl_false;
 	} /* end if */
 
 	/* unregister from connection manager */
@@ -1595,6 +5004,20 @@ void turbulence_process_create_child (TurbulenceCtx       * ctx,
 
 	/* call to fork */
 	pid = fork ();
+	if (pid < 0) {
+		error ("PARENT: unable to create child process for profile path %s, errno: %d:%s, closing conn-id=%d", 
+		       def->path_name ? def->path_name : "(empty)", errno, vortex_errno_get_last_error (),
+		       vortex_connection_get_id (conn));
+		__turbulence_process_close_log_pipes (general_log, error_log, access_log, vortex_log);
+
+		/* release child slot and creation mutex */
+		__turbulence_process_release_child (ctx);
+		vortex_mutex_unlock (&def->create_mutex);
+
+		vortex_connection_shutdown (conn);
+		turbulence_child_unref (child);
+		return axl_false;
+	} /* end if */
 	if (pid != 0) {
 		msg ("PARENT: child process created pid=%d, selected-ppath=%s", pid, def->path_name ? def->path_name : "(empty)");
 
@@ -1621,11 +5044,13 @@ void turbulence_process_create_child (TurbulenceCtx       * ctx,
 		if (! __turbulence_process_create_child_connection (child)) {
 			error ("Unable to create child process connection to pass sockets for pid=%d", pid);
 		
-			TBC_PROCESS_UNLOCK_CHILD ();
+			__turbulence_process_close_log_pipes (general_log, error_log, access_log, vortex_log);
+			__turbulence_process_release_child (ctx);
+			vortex_mutex_unlock (&def->create_mutex);
 
 			vortex_connection_shutdown (conn);
 			turbulence_child_unref (child);
-			return;
+			return axl_false;
 		}
 
 		/* send child init string through the control socket */
@@ -1634,11 +5059,13 @@ void turbulence_process_create_child (TurbulenceCtx       * ctx,
 								   profile, profile_content, 
 								   encoding, serverName, frame,
 								   general_log, error_log, access_log, vortex_log)) {
-			TBC_PROCESS_UNLOCK_CHILD ();
+			__turbulence_process_close_log_pipes (general_log, error_log, access_log, vortex_log);
+			__turbulence_process_release_child (ctx);
+			vortex_mutex_unlock (&def->create_mutex);
 
 			vortex_connection_shutdown (conn);
 			turbulence_child_unref (child);
-			return;
+			return axl_false;
 		} /* end if */
 
 		/** 
@@ -1649,11 +5076,13 @@ void turbulence_process_create_child (TurbulenceCtx       * ctx,
 			    ctx, child, conn, client_socket,handle_start_reply, channel_num,
 			    profile, profile_content, encoding, serverName, frame)) {
 			error ("PARENT: Unable to send socket associated to the connection that originated the child process (proxied)");
-			TBC_PROCESS_UNLOCK_CHILD ();
+			__turbulence_process_close_log_pipes (general_log, error_log, access_log, vortex_log);
+			__turbulence_process_release_child (ctx);
+			vortex_mutex_unlock (&def->create_mutex);
 
 			vortex_connection_shutdown (conn);
 			turbulence_child_unref (child);
-			return;
+			return axl_false;
 		} /* end if */
 
 		/** 
@@ -1662,11 +5091,13 @@ void turbulence_process_create_child (TurbulenceCtx       * ctx,
 		 */
 		if (! proxy_on_parent && ! turbulence_process_send_socket (client_socket, child, "s", 1)) {
 			error ("PARENT: Unable to send socket associated to the connection that originated the child process");
-			TBC_PROCESS_UNLOCK_CHILD ();
+			__turbulence_process_close_log_pipes (general_log, error_log, access_log, vortex_log);
+			__turbulence_process_release_child (ctx);
+			vortex_mutex_unlock (&def->create_mutex);
 
 			vortex_connection_shutdown (conn);
 			turbulence_child_unref (child);
-			return;
+			return axl_false;
 		}
 
 		/* terminate the connection */
@@ -1678,139 +5109,44 @@ void turbulence_process_create_child (TurbulenceCtx       * ctx,
 		/* register pipes to receive child logs */
 		__turbulence_process_prepare_logging (ctx, axl_true, general_log, error_log, access_log, vortex_log);
 
-		/* register the child process identifier */
-		axl_hash_insert_full (ctx->child_process,
-				      /* store child pid */
-				      INT_TO_PTR (pid), NULL,
-				      /* data and destroy func */
-				      child, (axlDestroyFunc) turbulence_child_unref);
-
-		/* update number of childs running this profile path */
-		def->childs_running++;
+		/* the connection that originated the child */
+		child->conn_count   = 1;
+		child->conns_served = 1;
 
-		TBC_PROCESS_UNLOCK_CHILD ();
+		/* register the child process identifier */
+		__turbulence_process_register_child (ctx, child, def);
+		vortex_mutex_unlock (&def->create_mutex);
 
 		/* record child */
 		msg ("PARENT=%d: Created child process pid=%d (childs: %d)", getpid (), pid, turbulence_process_child_count (ctx));
-		return;
+		return axl_false;
 	} /* end if */
 
 	/**** CHILD CODE ****/
-
-	/* reconfigure pids */
-	ctx->pid = getpid ();
-
-	/* release connections received from parent (including
-	   sockets) */
-	msg ("CHILD: calling to release all (parent) connections but conn-id=%d", 
-	     vortex_connection_get_id (conn));
-	__turbulence_process_release_parent_connections (ctx, proxy_on_parent ? NULL : conn, child);   
-
-	/* call to start turbulence process */
-	msg ("CHILD: Starting child process with: %s %s --child %s --config %s", 
-	     turbulence_child_cmd_prefix ? turbulence_child_cmd_prefix : "", 
-	     turbulence_bin_path ? turbulence_bin_path : "", child->socket_control_path, ctx->config_path);
-
-	/* get debug was requested */
-	enable_debug = ! PTR_TO_INT (turbulence_ctx_get_data (ctx, "debug-was-not-requested"));
-
-	/* prepare child cmd prefix if defined */
-	if (turbulence_child_cmd_prefix) {
-		msg ("CHILD: found child cmd prefix: '%s', processing..", turbulence_child_cmd_prefix);
-		cmds = axl_split (turbulence_child_cmd_prefix, 1, " ");
-		if (cmds == NULL) {
-			error ("CHILD: failed to allocate memory for commands");
-			exit (-1);
-		} /* end if */
-
-		/* count positions */
-		while (cmds[iterator] != 0)
-			iterator++;
-
-		/* expand to include additional commands */
-		cmds = axl_realloc (cmds, sizeof (char*) * (iterator + 14 + 1));
-
-		cmds[iterator] = (char *) turbulence_bin_path;
-		iterator++;
-		cmds[iterator] = "--child";
-		iterator++;
-		cmds[iterator] = child->socket_control_path;
-		iterator++;
-		cmds[iterator] = "--config";
-		iterator++;
-		cmds[iterator] = ctx->config_path;
-		iterator++;
-		if (turbulence_log_enabled (ctx)) {
-			cmds[iterator] = "--debug";
-			iterator++;
-		}
-		if (turbulence_log2_enabled (ctx)) {
-			cmds[iterator] = "--debug2";
-			iterator++;
-		} 
-		if (turbulence_log3_enabled (ctx)) {
-			cmds[iterator] = "--debug3";
-			iterator++;
-		}
-		if (ctx->console_color_debug) {
-			cmds[iterator] = "--color-debug";
-			iterator++;
-		}
-		if (__turbulence_module_no_unmap) {
-			cmds[iterator] = "--no-unmap-modules";
-			iterator++;
-		}
-		/* get skip thread pool wait */
-		vortex_conf_get (TBC_VORTEX_CTX(ctx), VORTEX_SKIP_THREAD_POOL_WAIT, &skip_thread_pool_wait);
-		if (! skip_thread_pool_wait) {
-			cmds[iterator] = "--wait-thread-pool";
-			iterator++;
-		}
-
-		if (enable_debug && vortex_log_is_enabled (ctx->vortex_ctx)) {
-			cmds[iterator] = "--vortex-debug";
-			iterator++;
-		}
-		if (enable_debug && vortex_log2_is_enabled (ctx->vortex_ctx)) {
-			cmds[iterator] = "--vortex-debug2";
-			iterator++;
-		}
-		if (enable_debug && vortex_color_log_is_enabled (ctx->vortex_ctx)) {
-			cmds[iterator] = "--vortex-debug-color";
-			iterator++;
-		}
-
-		cmds[iterator] = NULL;
-
-		/* run command with prefix */
-		error_code = execvp (cmds[0], cmds);
-	} else {
-
-		/* run command without prefixes */
-		error_code = execlp (
-			/* configure command to run turbulence */
-			turbulence_bin_path, "turbulence", "--child", child->socket_control_path,
-			/* pass configuration file used */
-			"--config", ctx->config_path,
-			/* pass debug options to child */
-			turbulence_log_enabled (ctx) ? "--debug" : "", 
-			turbulence_log2_enabled (ctx) ? "--debug2" : "", 
-			turbulence_log3_enabled (ctx) ? "--debug3" : "", 
-			ctx->console_color_debug ? "--color-debug" : "",
-			/* pass vortex debug options */
-			(enable_debug && vortex_log_is_enabled (ctx->vortex_ctx)) ? "--vortex-debug" : "",
-			(enable_debug && vortex_log2_is_enabled (ctx->vortex_ctx)) ? "--vortex-debug2" : "",
-			(enable_debug && vortex_color_log_is_enabled (ctx->vortex_ctx)) ? "--vortex-debug-color" : "",
-			/* unmap modules support */
-			__turbulence_module_no_unmap ? "--no-unmap-modules" : "",
-			/* always last parameter */
-			NULL);
-	}
-	
-	error ("CHILD: unable to create child process, error found was: %d: errno: %s", error_code, vortex_errno_get_last_error ());
-	exit (-1);
+	__turbulence_process_keep_log_pipes (general_log, error_log, access_log, vortex_log);
+	__turbulence_process_exec_child (ctx, child, conn, proxy_on_parent);
 
 	/**** CHILD PROCESS CREATION FINISHED ****/
+	return axl_false;
+}
+
+/** 
+ * @internal Allows to create a child process running listener connection
+ * provided.
+ */
+void turbulence_process_create_child (TurbulenceCtx       * ctx, 
+				      VortexConnection    * conn, 
+				      TurbulencePPathDef  * def,
+				      axl_bool              handle_start_reply,
+				      int                   channel_num,
+				      const char          * profile,
+				      const char          * profile_content,
+				      VortexEncoding        encoding,
+				      char                * serverName,
+				      VortexFrame         * frame)
+{
+	__turbulence_process_create_child (ctx, conn, def, handle_start_reply, channel_num,
+					   profile, profile_content, encoding, serverName, frame, NULL);
 	return;
 }
 
@@ -1832,6 +5168,73 @@ axl_bool __terminate_child (axlPointer key, axlPointer data, axlPointer user_dat
 	return axl_false; /* keep on iterating */
 }
 
+/** 
+ * @internal Function used by __turbulence_process_retire_childs.
+ */
+axl_bool __retire_child (axlPointer key, axlPointer data, axlPointer user_data, axlPointer user_data2)
+{
+	TurbulenceCtx   * ctx     = user_data;
+	int             * id_base = user_data2;
+	TurbulenceChild * child   = data;
+
+	/* child created for current profile paths */
+	if (child->ppath == NULL || turbulence_ppath_get_id (child->ppath) >= (* id_base))
+		return axl_false; /* keep on iterating */
+
+	if (child->spare) {
+		/* nothing to drain */
+		msg ("PARENT: terminating spare child pid=%d of replaced profile path %s", 
+		     child->pid, child->ppath->path_name ? child->ppath->path_name : "(empty)");
+		if (kill (child->pid, SIGTERM) != 0)
+			error ("failed to kill child (%d) error was: %d:%s",
+			       child->pid, errno, vortex_errno_get_last_error ());
+		return axl_false; /* keep on iterating */
+	} /* end if */
+
+	/* no more connections: it finishes once its connections are
+	 * closed */
+	msg ("PARENT: draining child pid=%d of replaced profile path %s", 
+	     child->pid, child->ppath->path_name ? child->ppath->path_name : "(empty)");
+	child->draining = axl_true;
+	return axl_false; /* keep on iterating */
+}
+
+/** 
+ * @internal Retires childs created for profile paths replaced by
+ * turbulence_ppath_reload: spare childs are terminated and the rest
+ * are drained. Spare pools are then started for the new profile paths
+ * (the zygote process, if running, reloads the configuration by
+ * itself once it is modified).
+ *
+ * @param ctx The context where the operation takes place.
+ */
+void __turbulence_process_retire_childs (TurbulenceCtx * ctx)
+{
+	TurbulencePPath    * paths;
+	int                  id_base;
+
+	/* only main process can create childs */
+	if (ctx == NULL || ctx->child)
+		return;
+
+	/* profile path ids always grow: childs with an id below the
+	 * first current profile path were created for replaced ones */
+	paths   = __turbulence_ppath_table_current (ctx);
+	id_base = turbulence_ppath_get_id (__turbulence_ppath_get_nth (paths, 0));
+	__turbulence_ppath_table_unref (ctx, paths);
+	if (id_base < 0)
+		return;
+
+	TBC_PROCESS_LOCK_CHILD ();
+	axl_hash_foreach2 (ctx->child_process, __retire_child, ctx, &id_base);
+	TBC_PROCESS_UNLOCK_CHILD ();
+
+	/* start spare pools for new profile paths */
+	turbulence_process_spare_childs_start (ctx);
+
+	return;
+}
+
 /** 
  * @internal Function that allows to check and kill childs started by
  * turbulence acording to user configuration.
@@ -1846,6 +5249,10 @@ void turbulence_process_kill_childs  (TurbulenceCtx * ctx)
 	int       status;
 	int       childs;
 
+	/* stop zygote process first so it isn't confused with
+	 * childs */
+	__turbulence_process_zygote_stop (ctx);
+
 	/* get user doc */
 	node = axl_doc_get (ctx->config, "/turbulence/global-settings/kill-childs-on-exit");
 	if (node == NULL) {
@@ -1942,7 +5349,8 @@ axl_bool turbulence_process_child_list_build (axlPointer _pid, axlPointer _child
  * @return A list (axlList) where each position contains a \ref
  * TurbulenceChild reference. Use axl_list_free to finish the list
  * returned. The function returns NULL if wrong reference received (it
- * is null or it does not represent a master process).
+ * is null or it does not represent a master process). Counters of
+ * each child can be read with \ref turbulence_process_child_stats.
  */
 axlList         * turbulence_process_child_list (TurbulenceCtx * ctx)
 {
@@ -2070,7 +5478,8 @@ axl_bool __find_ppath (axlPointer key, axlPointer data, axlPointer user_data, ax
 	TurbulenceChild     * child      = data;
 	TurbulenceChild    ** result     = user_data2;
 	
-	if (turbulence_ppath_get_id (child->ppath) == turbulence_ppath_get_id (ppath)) {
+	if (turbulence_ppath_get_id (child->ppath) == turbulence_ppath_get_id (ppath) && 
+	    ! __turbulence_process_child_recycle (child->ctx, child)) {
 		/* found child associated, updating reference and
 		   signaling to stop earch */
 		(*result) = child;
@@ -2114,13 +5523,93 @@ TurbulenceChild * turbulence_process_get_child_from_ppath (TurbulenceCtx * ctx,
 	return result;
 }
 
+/** 
+ * @brief Allows to get counters published by the provided child
+ * (connections, channels, bytes, CPU time and resident memory) with
+ * no communication with the child: they are read from the shared
+ * memory segment where the child publishes them every second.
+ *
+ * @param ctx The turbulence context where the child was created.
+ *
+ * @param child The child to get counters from.
+ *
+ * @param stats Reference where counters are copied.
+ *
+ * @return axl_true if counters were copied, otherwise axl_false is
+ * returned (child without slot or still not published).
+ */
+axl_bool          turbulence_process_child_stats (TurbulenceCtx        * ctx,
+						  TurbulenceChild      * child,
+						  TurbulenceChildStats * stats)
+{
+	TurbulenceStatsSlot * slot;
+	int                   seq;
+	int                   tries = 0;
+
+	if (ctx == NULL || child == NULL || stats == NULL)
+		return axl_false;
+	if (ctx->stats_segment == NULL || child->stats_slot < 0 || child->stats_slot >= ctx->stats_slots)
+		return axl_false;
+
+	/* retry while the child is updating its counters */
+	slot = TBC_STATS_SLOT (ctx->stats_segment, child->stats_slot);
+	while (tries < 100) {
+		seq = slot->seq;
+		TBC_MEMORY_BARRIER ();
+		if ((seq & 1) == 0) {
+			memcpy (stats, &slot->stats, sizeof (TurbulenceChildStats));
+			TBC_MEMORY_BARRIER ();
+			if (slot->seq == seq)
+				return stats->pid == child->pid;
+		} /* end if */
+		tries++;
+	} /* end while */
+
+	return axl_false;
+}
+
 /** 
  * @internal Function used to cleanup the process module.
  */
 void turbulence_process_cleanup      (TurbulenceCtx * ctx)
 {
+	TurbulenceAdmission * admission;
+
+	/* stop child notify loop */
+	turbulence_loop_close (ctx->child_notify_loop, axl_true);
+	ctx->child_notify_loop = NULL;
+
+	/* release connections still waiting for a child (the ones
+	 * being resumed are released by their task) */
+	if (ctx->admissions) {
+		while (axl_list_length (ctx->admissions) > 0) {
+			admission = axl_list_get_first (ctx->admissions);
+			axl_list_unlink_first (ctx->admissions);
+			axl_list_remove_ptr (admission->def->admission_list, admission);
+			if (! admission->resuming)
+				__turbulence_process_admission_free (admission);
+		} /* end while */
+		axl_list_free (ctx->admissions);
+		ctx->admissions = NULL;
+	} /* end if */
+
 	vortex_mutex_destroy (&ctx->child_process_mutex);
 	axl_hash_free (ctx->child_process);
+
+	/* remove child stats segment */
+	vortex_mutex_lock (&ctx->stats_mutex);
+	if (ctx->stats_segment) {
+		munmap (ctx->stats_segment, TBC_STATS_SLOT_SIZE () * ctx->stats_slots);
+		ctx->stats_segment = NULL;
+	} /* end if */
+	if (ctx->stats_path && ! ctx->child)
+		unlink (ctx->stats_path);
+	axl_free (ctx->stats_path);
+	ctx->stats_path = NULL;
+	axl_free (ctx->stats_used);
+	ctx->stats_used = NULL;
+	vortex_mutex_unlock (&ctx->stats_mutex);
+	vortex_mutex_destroy (&ctx->stats_mutex);
 	return;
 			      
 }
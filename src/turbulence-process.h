@@ -39,6 +39,12 @@
 
 #include <turbulence.h>
 
+/** 
+ * @internal Max size of a connection status record sent to a child
+ * (see turbulence_process_connection_status_encode).
+ */
+#define TBC_CONN_STATUS_MAX 8192
+
 void              turbulence_process_init         (TurbulenceCtx * ctx, 
 						   axl_bool        reinit);
 
@@ -59,6 +65,10 @@ int               turbulence_process_child_count  (TurbulenceCtx * ctx);
 
 axlList         * turbulence_process_child_list (TurbulenceCtx * ctx);
 
+axl_bool          turbulence_process_child_stats (TurbulenceCtx        * ctx,
+						  TurbulenceChild      * child,
+						  TurbulenceChildStats * stats);
+
 TurbulenceChild * turbulence_process_child_by_id (TurbulenceCtx * ctx, int pid);
 
 axl_bool          turbulence_process_child_exists  (TurbulenceCtx * ctx, int pid);
@@ -71,6 +81,41 @@ TurbulenceChild * turbulence_process_get_child_from_ppath (TurbulenceCtx      *
 
 void              turbulence_process_check_for_finish (TurbulenceCtx * ctx);
 
+axl_bool          turbulence_process_admission_stats (TurbulenceCtx      * ctx,
+						      TurbulencePPathDef * def,
+						      int                * depth,
+						      int                * max_depth,
+						      int                * queued,
+						      int                * timeouts,
+						      int                * rejected,
+						      long               * wait_avg,
+						      long               * wait_max);
+
+int               turbulence_process_spawn_throttled (TurbulenceCtx      * ctx,
+						      TurbulencePPathDef * def);
+
+void              turbulence_process_spare_childs_start (TurbulenceCtx * ctx);
+
+void              __turbulence_process_retire_childs (TurbulenceCtx * ctx);
+
+void              __turbulence_process_admission_wakeup (TurbulencePPathDef * def);
+
+void              __turbulence_process_admission_wakeup_all (TurbulenceCtx * ctx);
+
+void              __turbulence_process_stats_release (TurbulenceCtx * ctx, TurbulenceChild * child);
+
+int               turbulence_process_broadcast_msg (TurbulenceCtx * ctx,
+						    const void    * message,
+						    int             message_size,
+						    const char    * profile,
+						    const char    * ppaths);
+
+void              turbulence_process_zygote_start (TurbulenceCtx * ctx);
+
+char            * turbulence_process_zygote_run   (TurbulenceCtx * ctx, 
+						   const char    * control_path,
+						   const char    * config);
+
 void              turbulence_process_cleanup      (TurbulenceCtx * ctx);
 
 /* internal API */
@@ -126,6 +171,29 @@ void             turbulence_process_connection_recover_status (char            *
 							       const char     ** remote_host_ip,
 							       int             * has_tls);
 
+int              turbulence_process_connection_status_encode (char            * buffer,
+							      int               buffer_size,
+							      axl_bool          handle_start_reply,
+							      int               channel_num,
+							      const char      * profile,
+							      const char      * profile_content,
+							      VortexEncoding    encoding,
+							      const char      * serverName,
+							      int               msg_no,
+							      int               seq_no,
+							      int               seq_no_expected,
+							      int               ppath_id,
+							      int               has_tls,
+							      int               fix_server_name,
+							      const char      * remote_host,
+							      const char      * remote_port,
+							      const char      * remote_host_ip,
+							      int               skip_conn_recover);
+
+axl_bool         turbulence_process_connection_status_decode (const char           * buffer,
+							      int                    size,
+							      TurbulenceConnStatus * status);
+
 axl_bool turbulence_process_send_socket (VORTEX_SOCKET     socket, 
 					 TurbulenceChild * child, 
 					 const char      * ancillary_data, 
@@ -89,18 +89,12 @@ axl_bool turbulence_run_check_no_load_module (TurbulenceCtx * ctx,
 }
 
 /** 
- * @brief Tries to load all modules found at the directory already
- * located. In fact the function searches for xml files that points to
- * modules to be loaded.
- * 
- * @param ctx Turbulence context.
- *
- * @param path The path that was used to open the dirHandle.
- *
- * @param dirHandle The directory that will be inspected for modules.
- *
+ * @internal Implementation used by
+ * turbulence_run_load_modules_from_path. If preload is axl_true,
+ * modules found are only mapped into memory (no init, no
+ * registration): used by the child zygote process.
  */
-void turbulence_run_load_modules_from_path (TurbulenceCtx * ctx, const char * path, DIR * dirHandle)
+void __turbulence_run_load_modules_from_path (TurbulenceCtx * ctx, const char * path, DIR * dirHandle, axl_bool preload)
 {
 	struct dirent    * entry;
 	char             * fullpath = NULL;
@@ -165,7 +159,10 @@ void turbulence_run_load_modules_from_path (TurbulenceCtx * ctx, const char * pa
 		axl_free (temp);
 
 		/* load the module man!!! */
-		turbulence_module_open_and_register (ctx, location);
+		if (preload)
+			turbulence_module_preload (ctx, location);
+		else
+			turbulence_module_open_and_register (ctx, location);
 
 	next:
 		/* free the document */
@@ -185,12 +182,28 @@ void turbulence_run_load_modules_from_path (TurbulenceCtx * ctx, const char * pa
 }
 
 /** 
- * @internal Loads all paths from the configuration, calling to load all
- * modules inside those paths.
+ * @brief Tries to load all modules found at the directory already
+ * located. In fact the function searches for xml files that points to
+ * modules to be loaded.
  * 
- * @param doc The turbulence run time configuration.
+ * @param ctx Turbulence context.
+ *
+ * @param path The path that was used to open the dirHandle.
+ *
+ * @param dirHandle The directory that will be inspected for modules.
+ *
  */
-void turbulence_run_load_modules (TurbulenceCtx * ctx, axlDoc * doc)
+void turbulence_run_load_modules_from_path (TurbulenceCtx * ctx, const char * path, DIR * dirHandle)
+{
+	__turbulence_run_load_modules_from_path (ctx, path, dirHandle, axl_false);
+	return;
+}
+
+/** 
+ * @internal Implementation used by turbulence_run_load_modules and
+ * turbulence_run_preload_modules.
+ */
+void __turbulence_run_load_modules (TurbulenceCtx * ctx, axlDoc * doc, axl_bool preload)
 {
 	axlNode     * directory;
 	const char  * path;
@@ -221,7 +234,7 @@ void turbulence_run_load_modules (TurbulenceCtx * ctx, axlDoc * doc)
 
 		/* directory found, now search for modules activated */
 		msg ("found mod directory: %s", path);
-		turbulence_run_load_modules_from_path (ctx, path, dirHandle);
+		__turbulence_run_load_modules_from_path (ctx, path, dirHandle, preload);
 		
 		/* close the directory handle */
 		closedir (dirHandle);
@@ -234,6 +247,49 @@ void turbulence_run_load_modules (TurbulenceCtx * ctx, axlDoc * doc)
 	return;
 }
 
+/** 
+ * @internal Loads all paths from the configuration, calling to load all
+ * modules inside those paths.
+ * 
+ * @param doc The turbulence run time configuration.
+ */
+void turbulence_run_load_modules (TurbulenceCtx * ctx, axlDoc * doc)
+{
+	__turbulence_run_load_modules (ctx, doc, axl_false);
+	return;
+}
+
+/** 
+ * @internal Maps into memory all modules that would be loaded by
+ * turbulence_run_load_modules without calling to their init
+ * functions. Used by the child zygote process so childs created from
+ * it find modules already loaded.
+ *
+ * @param ctx Turbulence context with the configuration already
+ * loaded.
+ */
+void turbulence_run_preload_modules (TurbulenceCtx * ctx)
+{
+	axlError * error = NULL;
+
+	/* load module pointer dtd */
+	if (ctx->module_dtd == NULL) {
+		ctx->module_dtd = axl_dtd_parse (MOD_TURBULENCE_DTD, -1, &error);
+		if (ctx->module_dtd == NULL) {
+			error ("unable to load mod-turbulence.dtd file: %s", axl_error_get (error));
+			axl_error_free (error);
+			return;
+		} /* end if */
+	} /* end if */
+
+	__turbulence_run_load_modules (ctx, turbulence_config_get (ctx), axl_true);
+
+	/* release dtd (it is loaded again by turbulence_run_config) */
+	axl_dtd_free (ctx->module_dtd);
+	ctx->module_dtd = NULL;
+	return;
+}
+
 axl_bool turbulence_run_config_start_listeners (TurbulenceCtx * ctx, axlDoc * doc)
 {
 	axlNode          * listener;
@@ -459,10 +515,18 @@ int  turbulence_run_config    (TurbulenceCtx * ctx)
 	/* start here log manager */
 	turbulence_log_manager_start (ctx);
 
+	/* start child zygote process if configured (only main
+	 * process, before listeners so they aren't inherited) */
+	turbulence_process_zygote_start (ctx);
+
 	/* get the first listener configuration */
 	if (! turbulence_run_config_start_listeners (ctx, doc))
 		return axl_false;
 
+	/* pre-start spare childs for profile paths that configure
+	 * them (only main process) */
+	turbulence_process_spare_childs_start (ctx);
+
 	/* turbulence started properly */
 	return axl_true;
 }
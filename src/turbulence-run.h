@@ -63,6 +63,8 @@ void turbulence_run_cleanup   (TurbulenceCtx * ctx);
 axl_bool turbulence_run_check_no_load_module (TurbulenceCtx * ctx, 
 					      const char    * module_to_check);
 
+void     turbulence_run_preload_modules (TurbulenceCtx * ctx);
+
 /** 
  * @}
  */
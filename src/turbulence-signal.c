@@ -87,13 +87,19 @@ int turbulence_signal_received (TurbulenceCtx * ctx, int _signal)
 		/* get child to reduce childs running */
 		child = axl_hash_get (ctx->child_process, INT_TO_PTR (pid));
 		if (child && child->ppath) {
-			/* decrease number of childs running */
+			/* decrease number of childs running and wake
+			 * up connections waiting for a child */
 			child->ppath->childs_running--;
+			__turbulence_process_admission_wakeup (child->ppath);
 		} /* end if */
 
 		/* remove pid from list */
 		axl_hash_remove (ctx->child_process, INT_TO_PTR (pid));
 
+		/* global child limit */
+		if (child)
+			__turbulence_process_admission_wakeup_all (ctx);
+
 		/* unlock */
 		vortex_mutex_unlock (&ctx->child_process_mutex);
 
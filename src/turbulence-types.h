@@ -77,6 +77,54 @@ typedef struct _TurbulenceModule TurbulenceModule;
  */
 typedef struct _TurbulenceChild  TurbulenceChild;
 
+/** 
+ * @internal Type representing the state of a connection handed off
+ * to a child process.
+ */
+typedef struct _TurbulenceConnStatus TurbulenceConnStatus;
+
+/** 
+ * @brief Counters published by a child process into the shared
+ * memory segment created by the parent (see \ref
+ * turbulence_process_child_stats). Updated by the child once per
+ * second.
+ */
+typedef struct _TurbulenceChildStats {
+	/** 
+	 * @brief Child process pid and the profile path id it runs.
+	 */
+	int    pid;
+	int    ppath_id;
+	/** 
+	 * @brief Connections currently handled and handled since
+	 * the child started.
+	 */
+	int    connections;
+	int    connections_total;
+	/** 
+	 * @brief Channels currently opened and opened since the
+	 * child started.
+	 */
+	int    channels;
+	int    channels_total;
+	/** 
+	 * @brief Bytes received and sent by all connections handled
+	 * (including connections already closed).
+	 */
+	long   bytes_in;
+	long   bytes_out;
+	/** 
+	 * @brief CPU time consumed (user + system, milliseconds) and
+	 * resident memory (KB, 0 where /proc isn't available).
+	 */
+	long   cpu_time;
+	long   rss;
+	/** 
+	 * @brief Time stamp (seconds since epoch) of the last update.
+	 */
+	long   updated;
+} TurbulenceChildStats;
+
 /** 
  * @brief Set of handlers that are supported by modules. This handler
  * descriptors are used by some functions to notify which handlers to
@@ -128,6 +128,34 @@ void __turbulence_acquire_limits (TurbulenceCtx * ctx)
 		ctx->global_child_limit = 100;
 	msg ("Configured global-child-limit=%d", ctx->max_complete_flag_limit);
 
+	/* get child creation rate limit */
+	value = turbulence_config_get_number (ctx, "/turbulence/global-settings/child-spawn-rate", "value");
+	if (value > 0) {
+		ctx->spawn_bucket.rate  = value;
+		ctx->spawn_bucket.burst = value;
+		value = turbulence_config_get_number (ctx, "/turbulence/global-settings/child-spawn-rate", "burst");
+		if (value > 0)
+			ctx->spawn_bucket.burst = value;
+		msg ("Configured child-spawn-rate=%d, burst=%d", (int) ctx->spawn_bucket.rate, (int) ctx->spawn_bucket.burst);
+	} /* end if */
+
+	/* get number of proxy on parent loops (0: one per core) */
+	value = turbulence_config_get_number (ctx, "/turbulence/global-settings/proxy-loops", "value");
+	if (value > 0) {
+		ctx->proxy_loops_count = value;
+		msg ("Configured proxy-loops=%d", ctx->proxy_loops_count);
+	} /* end if */
+
+	/* get default greeting and idle timeouts (0: disabled) */
+	value = turbulence_config_get_number (ctx, "/turbulence/global-settings/connection-timeouts", "greeting");
+	if (value > 0)
+		ctx->conn_mgr_greeting_timeout = value;
+	value = turbulence_config_get_number (ctx, "/turbulence/global-settings/connection-timeouts", "idle");
+	if (value > 0)
+		ctx->conn_mgr_idle_timeout = value;
+	if (ctx->conn_mgr_greeting_timeout > 0 || ctx->conn_mgr_idle_timeout > 0)
+		msg ("Configured connection-timeouts greeting=%d, idle=%d", ctx->conn_mgr_greeting_timeout, ctx->conn_mgr_idle_timeout);
+
 	/* get global child limit */
 	value = turbulence_config_get_number (ctx, "/turbulence/global-settings/max-incoming-complete-frame-limit", "value");
 	if (value > 0)
@@ -185,8 +213,9 @@ axl_bool  turbulence_init (TurbulenceCtx * ctx,
 #endif
 	vortex_support_add_domain_search_path     (vortex_ctx, "turbulence-data", ".");
 
-	/* load current turbulence configuration */
-	if (! turbulence_config_load (ctx, config)) {
+	/* load current turbulence configuration (already loaded on
+	 * childs created by the zygote process) */
+	if (ctx->config == NULL && ! turbulence_config_load (ctx, config)) {
 		/* unable to load configuration */
 		return axl_false;
 	}
@@ -249,6 +278,10 @@ axl_bool  turbulence_init (TurbulenceCtx * ctx,
  * @param value The signal number caught. This value is optional since
  * reloading can be triggered not only by a signal received (i.e.
  * SIGHUP).
+ *
+ * Profile paths aren't reloaded by this function (it may run inside
+ * the signal handler): they are flagged to be reloaded by a vortex
+ * thread pool event (see turbulence_ppath_reload).
  */
 void     turbulence_reload_config       (TurbulenceCtx * ctx, int value)
 {
@@ -268,6 +301,11 @@ void     turbulence_reload_config       (TurbulenceCtx * ctx, int value)
 	/* call to reload logs */
 	__turbulence_log_reopen (ctx);
 
+	/* flag profile paths to be reloaded: this is done by a
+	 * vortex thread pool event rather than here, which may run
+	 * inside the signal handler */
+	ctx->ppath_reload_pending = axl_true;
+
 	/* reload turbulence here, before modules
 	 * reloading */
 	turbulence_db_list_reload_module ();
@@ -288,6 +326,7 @@ void turbulence_exit (TurbulenceCtx * ctx,
 		      axl_bool        free_vortex_ctx)
 {
 	VortexCtx * vortex_ctx;
+	int         iterator;
 
 	/* do not perform any change if a null context is received */
 	v_return_if_fail (ctx);
@@ -339,8 +378,16 @@ void turbulence_exit (TurbulenceCtx * ctx,
 	/* cleanup process module */
 	turbulence_process_cleanup (ctx);
 
-	/* termiante proxy loop (if started) */
-	turbulence_loop_close (ctx->proxy_loop, axl_true);
+	/* termiante proxy loops (if started) */
+	if (ctx->proxy_loops) {
+		iterator = 0;
+		while (iterator < ctx->proxy_loops_count) {
+			turbulence_loop_close (ctx->proxy_loops[iterator].loop, axl_true);
+			iterator++;
+		} /* end while */
+		axl_free (ctx->proxy_loops);
+		ctx->proxy_loops = NULL;
+	} /* end if */
 
 	/* free mutex */
 	vortex_mutex_destroy (&ctx->exit_mutex);
@@ -1888,10 +1935,15 @@ void            turbulence_sleep           (TurbulenceCtx * ctx,
  *
  * <li><b>src</b>: a perl expression defining the source of the
  * connection. This can be used to only provide critical services to
- * local administrators.</li>
+ * local administrators. A comma separated list of addresses,
+ * networks (10.0.0.0/8, 2001:db8::/32) or ranges
+ * (192.168.1.10-192.168.1.50) is also accepted and matched against
+ * the binary address.</li>
  *
  * <li><b>dst</b>: a perl expression defining the destination of the
- * connection. This can be used to provide services on a particular local IP.</li>
+ * connection. This can be used to provide services on a particular
+ * local IP. Accepts the same address lists, networks and ranges as
+ * src.</li>
  *
  * <li><b>path-name</b>: an administrative flag that will help to
  * recognize the connection in future process (log
@@ -1910,7 +1962,10 @@ void            turbulence_sleep           (TurbulenceCtx * ctx,
  * <li><b>separate</b>: [yes|no] Default no. Allows to configure
  * Turbulence to create a child process to handle the connection that
  * matches current profile path. A new child process will be created
- * for each connection received. </li>
+ * for each connection received. Connections handled by child
+ * processes are not reached by \ref turbulence_conn_mgr_broadcast_msg
+ * called at the parent: use \ref turbulence_process_broadcast_msg to
+ * relay the message to every child. </li>
  *
  * <li><b>reuse</b>: [yes|no] Default no. Requires
  * separate="yes". Once a child process is created for the first
@@ -1932,6 +1987,80 @@ void            turbulence_sleep           (TurbulenceCtx * ctx,
  * number of child process that can be created due to this profile
  * path. Rembember to set at least child-limit="1" when reuse="yes",
  * though it is recommended to avoid using this flag when reuse="yes".</li>
+ *
+ * <li><b>min-spare-childs</b>: [child number] Default 0. Requires
+ * separate="yes". Number of idle child processes (already started,
+ * with modules loaded and waiting for connections) that are kept for
+ * this profile path, so a new connection is passed to a running
+ * child rather waiting for a child to be created. When reuse="yes",
+ * only the first child is started this way. Spare childs count for
+ * child-limit and global-child-limit.</li>
+ *
+ * <li><b>max-spare-childs</b>: [child number] Default is
+ * min-spare-childs value. Number of idle childs to create when a
+ * connection finds the spare pool empty (connection burst).</li>
+ *
+ * <li><b>children-per-ppath</b>: [child number] Default 1. Requires
+ * separate="yes" and reuse="yes". Number of childs created to handle
+ * connections for this profile path. Once all of them are running,
+ * each new connection is sent to the child handling fewer
+ * connections.</li>
+ *
+ * <li><b>balance-cpu</b>: [yes|no] Default no. When used with
+ * children-per-ppath, the number of connections of each child is
+ * weighted by its recent CPU usage to select the child that will
+ * handle a new connection (only available where /proc is
+ * found).</li>
+ *
+ * <li><b>admission-queue</b>: [connection number] Default 0. Requires
+ * separate="yes". Number of connections that can wait for a child
+ * when child-limit or global-child-limit is reached, rather being
+ * closed. Waiting connections are sent to a new child (in arrival
+ * order) as soon as a child finishes. Use
+ * turbulence_process_admission_stats to get queue depth and wait
+ * times to size limits.</li>
+ *
+ * <li><b>admission-timeout</b>: [milliseconds] Default 5000. Max time
+ * a connection waits in the admission queue before being
+ * closed.</li>
+ *
+ * <li><b>spawn-rate</b>: [childs per second] Default no limit. Requires
+ * separate="yes". Max number of childs created per second for this
+ * profile path (see also child-spawn-rate inside
+ * global-settings). When the rate is exceeded, connections with
+ * reuse="yes" are sent to a running child and the rest wait until a
+ * new child can be created.</li>
+ *
+ * <li><b>spawn-burst</b>: [child number] Default is spawn-rate
+ * value. Max number of childs created at once before spawn-rate
+ * applies.</li>
+ *
+ * <li><b>recycle-conns</b>: [connection number] Default 0 (no
+ * limit). Requires separate="yes" and reuse="yes". Once a child has
+ * handled this number of connections, new connections are sent to a
+ * new child and the old one finishes when its connections are
+ * closed. Useful to release memory leaked or fragmented by
+ * modules.</li>
+ *
+ * <li><b>recycle-age</b>: [seconds] Default 0 (no limit). Same as
+ * recycle-conns, but the child is replaced after running the
+ * provided time.</li>
+ *
+ * <li><b>recycle-rss</b>: [MB] Default 0 (no limit). Same as
+ * recycle-conns, but the child is replaced once its resident memory
+ * reaches the provided value (only available where /proc is
+ * found). Childs are not replaced while child-limit or
+ * global-child-limit do not allow to create a new child.</li>
+ *
+ * <li><b>greeting-timeout</b>: [seconds] Default is the greeting
+ * value configured at <connection-timeouts> (0, disabled, if not
+ * defined). Connections that do not open any channel during this
+ * period after being accepted are closed.</li>
+ *
+ * <li><b>idle-timeout</b>: [seconds] Default is the idle value
+ * configured at <connection-timeouts> (0, disabled, if not
+ * defined). Connections that do not send any content during this
+ * period are closed.</li>
  * 
  * </ol> 
  * 
@@ -1969,6 +2098,13 @@ void            turbulence_sleep           (TurbulenceCtx * ctx,
  * the connection in other to allow the connection to accept a profile
  * or the content of the following profiles.
  *
+ * Profile paths are loaded again from the configuration file when
+ * turbulence receives a HUP signal. New connections are matched
+ * against the new profile paths while connections already running
+ * keep the one they selected. Childs created for previous profile
+ * paths aren't used for new connections and finish once their
+ * connections are closed.
+ *
  * \section profile_path_flags_supported_by_allow_and_if_sucess 3.2 Profile path configuration: flags supported by <allow> and <if-success>
  *
  * The following are the flags supported by <b>&lt;allow></b> and
@@ -2046,6 +2182,55 @@ void            turbulence_sleep           (TurbulenceCtx * ctx,
  * killed. This is configured with <b><kill-childs-on-exit value="yes" /></b>
  * inside <global-settings> node.
  *
+ * Each child process is created by running turbulence binary again
+ * (fork + exec), so configuration and modules are loaded from
+ * scratch on every child. To reduce child creation cost, a zygote
+ * process can be enabled with <b><child-zygote value="yes" /></b>
+ * inside <global-settings> node. The zygote loads and validates the
+ * configuration and maps all modules once, and childs are then
+ * created by forking it (no exec). Childs still initialize vortex
+ * and modules after the fork (init functions are not called by the
+ * zygote). If the configuration file is modified, the zygote reloads
+ * it before creating the next child. This option is only available
+ * on Linux (childs are reparented to the main process using
+ * PR_SET_CHILD_SUBREAPER); if the zygote fails, childs are created
+ * as usual.
+ *
+ * To avoid a reconnect storm forking hundreds of childs in a second,
+ * child creation can be rate limited with <b><child-spawn-rate
+ * value="20" burst="40" /></b> inside <global-settings> node (childs
+ * per second and max childs created at once), and per profile path
+ * with spawn-rate and spawn-burst attributes. Connections that can't
+ * create a child are sent to a running child when reuse="yes",
+ * otherwise they wait until a child can be created.
+ *
+ * Connections proxied on the parent (for example TLS connections
+ * handled by a child) are served by several loop threads, each one
+ * handling part of the proxied connections (new connections are
+ * assigned to the loop with less connections). By default one loop
+ * per core is used, which can be changed with <b><proxy-loops
+ * value="4" /></b> inside <global-settings> node.
+ * Content that a child can't accept yet is queued by the parent,
+ * and reading from the remote peer is paused while too much content
+ * is pending (it is resumed once the child catches up).
+ *
+ * On Linux, proxied connections can also be moved with splice(2),
+ * without copying content to user space. This is opt-in and only
+ * valid for modules that pass content as is (no TLS, websocket
+ * framing or similar transformation done by the parent), so no
+ * module shipped with Turbulence enables it: a module enables it by
+ * setting "tbc:proxy:raw" along with "tbc:proxy:conn" on the
+ * connection (see \ref turbulence_conn_mgr_proxy_on_parent). TLS
+ * connections are never spliced.
+ *
+ * Connections that stay without opening a channel or without sending
+ * any content can be closed by configuring <b><connection-timeouts
+ * greeting="30" idle="600" /></b> inside <global-settings> node
+ * (seconds, 0 disables the check). Both values can be changed per
+ * profile path with greeting-timeout and idle-timeout
+ * attributes. Connections closed this way are reported by the
+ * connection list published by the connection manager.
+ *
  * \section turbulence_starting_without_profiles 3.5 Making turbulence to start without profiles defined
  *
  * By default Turbulence checks after module start up (init method) if
@@ -617,6 +617,61 @@ axl_bool  test_01a () {
 	/* compile and match */
 	MATCH_AND_CHECK("not  192.168.0.132  ,  192.168.0.*  ", "192.168.1.145", axl_true);
 
+	/* check literal expressions are detected (used to index
+	 * profile paths) */
+	expr = turbulence_expr_compile (ctx, "test.server", NULL);
+	if (! axl_cmp (turbulence_expr_get_literal (expr), "test.server")) {
+		printf ("Expected to find literal value for expression test.server..\n");
+		return axl_false;
+	} /* end if */
+	turbulence_expr_free (expr);
+
+	expr = turbulence_expr_compile (ctx, "*.test.server", NULL);
+	if (turbulence_expr_get_literal (expr) != NULL) {
+		printf ("Expected to not find literal value for expression *.test.server..\n");
+		return axl_false;
+	} /* end if */
+	turbulence_expr_free (expr);
+
+	expr = turbulence_expr_compile (ctx, "not test.server", NULL);
+	if (turbulence_expr_get_literal (expr) != NULL) {
+		printf ("Expected to not find literal value for expression not test.server..\n");
+		return axl_false;
+	} /* end if */
+	turbulence_expr_free (expr);
+
+	/* compile and match */
+	MATCH_AND_CHECK("192.168.0.132", "192.168.0.132", axl_true);
+
+	/* compile and match */
+	MATCH_AND_CHECK("192.168.0.132", "192.168.0.13", axl_false);
+
+	/* address rules: networks, ranges and IPv6 prefixes */
+	MATCH_AND_CHECK("10.0.0.0/8", "10.20.30.40", axl_true);
+	MATCH_AND_CHECK("10.0.0.0/8", "11.0.0.1", axl_false);
+	MATCH_AND_CHECK("10.0.0.0/8", "::ffff:10.0.0.1", axl_true);
+	MATCH_AND_CHECK("192.168.1.10-192.168.1.50", "192.168.1.50", axl_true);
+	MATCH_AND_CHECK("192.168.1.10-192.168.1.50", "192.168.1.51", axl_false);
+	MATCH_AND_CHECK(" 192.168.2.1, 10.0.0.0/8 , 192.168.1.10 - 192.168.1.50", "192.168.2.1", axl_true);
+	MATCH_AND_CHECK("2001:db8::/32", "2001:db8:1::5", axl_true);
+	MATCH_AND_CHECK("2001:db8::/32", "2001:db9::5", axl_false);
+	MATCH_AND_CHECK("not 10.0.0.0/8", "192.168.1.1", axl_true);
+	MATCH_AND_CHECK("not 10.0.0.0/8", "10.1.1.1", axl_false);
+	MATCH_AND_CHECK("10.0.0.0/8", "localhost", axl_false);
+
+	/* IPv4 mapped networks and invalid prefixes (not handled as
+	 * address rules so they do not match any address) */
+	MATCH_AND_CHECK("::ffff:10.0.0.0/104", "10.1.2.3", axl_true);
+	MATCH_AND_CHECK("::ffff:10.0.0.0/104", "11.1.2.3", axl_false);
+	MATCH_AND_CHECK("::ffff:10.0.0.0/128", "10.0.0.0", axl_true);
+	MATCH_AND_CHECK("::ffff:10.0.0.0/128", "10.0.0.1", axl_false);
+	MATCH_AND_CHECK("::ffff:10.0.0.0/64", "10.0.0.1", axl_false);
+	MATCH_AND_CHECK("::ffff:10.0.0.0/95", "10.0.0.1", axl_false);
+	MATCH_AND_CHECK("::ffff:10.0.0.0/33", "10.0.0.1", axl_false);
+	MATCH_AND_CHECK("10.0.0.0/33", "10.0.0.1", axl_false);
+	MATCH_AND_CHECK("2001:db8::/129", "2001:db8::1", axl_false);
+	MATCH_AND_CHECK("192.168.1.50-192.168.1.10", "192.168.1.20", axl_false);
+
 	/* free context */
 	turbulence_ctx_free (ctx);
 
@@ -862,6 +917,122 @@ axl_bool  test_02 (void)
 	return axl_true;
 }
 
+axl_bool test_02a_timer (TurbulenceLoop * loop, TurbulenceCtx * ctx, int timer_id, axlPointer ptr, axlPointer ptr2)
+{
+	int * count = ptr;
+
+	(*count)++;
+
+	/* periodic timer: stop after the limit provided */
+	return (*count) < PTR_TO_INT (ptr2);
+}
+
+axl_bool test_02a_write (TurbulenceLoop * loop, TurbulenceCtx * ctx, int descriptor, axlPointer ptr, axlPointer ptr2)
+{
+	int * count = ptr;
+
+	(*count)++;
+
+	/* keep watching for write */
+	return axl_true;
+}
+
+axl_bool test_02a_read (TurbulenceLoop * loop, TurbulenceCtx * ctx, int descriptor, axlPointer ptr, axlPointer ptr2)
+{
+	int  * count = ptr;
+	char   buffer[10];
+
+	if (recv (descriptor, buffer, sizeof (buffer), 0) > 0)
+		(*count)++;
+
+	return axl_true;
+}
+
+axl_bool  test_02a (void)
+{
+	TurbulenceLoop * loop;
+	int              once      = 0;
+	int              periodic  = 0;
+	int              cancelled = 0;
+	int              long_id;
+	int              id;
+	int              fds[2];
+	int              writes    = 0;
+	int              reads     = 0;
+
+	/* create loop (no descriptor watched, timers only) */
+	loop = turbulence_loop_create (ctx);
+	if (loop == NULL) {
+		printf ("ERROR: failed to create loop..\n");
+		return axl_false;
+	} /* end if */
+
+	/* one-shot, periodic (5 times), cancelled and long timer */
+	turbulence_loop_add_timer (loop, 50, axl_false, test_02a_timer, &once, INT_TO_PTR (1));
+	turbulence_loop_add_timer (loop, 20, axl_true, test_02a_timer, &periodic, INT_TO_PTR (5));
+	id      = turbulence_loop_add_timer (loop, 100, axl_false, test_02a_timer, &cancelled, INT_TO_PTR (1));
+	long_id = turbulence_loop_add_timer (loop, 3600000, axl_false, test_02a_timer, &cancelled, INT_TO_PTR (1));
+	if (turbulence_loop_timers (loop) != 4) {
+		printf ("ERROR: expected to find 4 timers but found %d..\n", turbulence_loop_timers (loop));
+		return axl_false;
+	} /* end if */
+
+	if (! turbulence_loop_cancel_timer (loop, id)) {
+		printf ("ERROR: expected to cancel timer %d..\n", id);
+		return axl_false;
+	} /* end if */
+	if (turbulence_loop_cancel_timer (loop, id)) {
+		printf ("ERROR: expected to fail cancelling timer %d twice..\n", id);
+		return axl_false;
+	} /* end if */
+
+	/* wait timers to expire */
+	test_common_microwait (600000);
+
+	printf ("Test 02-a: once=%d, periodic=%d, cancelled=%d, timers=%d\n", 
+		once, periodic, cancelled, turbulence_loop_timers (loop));
+	if (once != 1 || periodic != 5 || cancelled != 0) {
+		printf ("ERROR: expected once=1, periodic=5, cancelled=0..\n");
+		return axl_false;
+	} /* end if */
+
+	/* only the long timer must remain */
+	if (turbulence_loop_timers (loop) != 1 || ! turbulence_loop_cancel_timer (loop, long_id) || turbulence_loop_timers (loop) != 0) {
+		printf ("ERROR: expected to find only the long timer installed..\n");
+		return axl_false;
+	} /* end if */
+
+	/* descriptor watched for write and then for read: reads must
+	 * be notified too */
+	if (socketpair (AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+		printf ("ERROR: failed to create socket pair..\n");
+		return axl_false;
+	} /* end if */
+	turbulence_loop_watch_write (loop, fds[0], test_02a_write, &writes, NULL);
+	test_common_microwait (100000);
+	turbulence_loop_watch_descriptor (loop, fds[0], test_02a_read, &reads, NULL);
+	test_common_microwait (100000);
+	if (send (fds[1], "test", 4, 0) != 4) {
+		printf ("ERROR: failed to write into socket pair..\n");
+		return axl_false;
+	} /* end if */
+	test_common_microwait (200000);
+
+	printf ("Test 02-a: writes=%d, reads=%d\n", writes, reads);
+	if (writes == 0 || reads != 1) {
+		printf ("ERROR: expected write notifications and one read notification..\n");
+		return axl_false;
+	} /* end if */
+
+	/* descriptor is now closed by the loop */
+	turbulence_loop_unwatch_descriptor (loop, fds[0], axl_true);
+	close (fds[1]);
+
+	turbulence_loop_close (loop, axl_true);
+
+	return axl_true;
+}
+
 /** 
  * @brief Allows to check the sasl backend.
  * 
@@ -1593,6 +1764,213 @@ axl_bool test_07 (void) {
 	return axl_true;
 }
 
+axl_bool test_07a (void) {
+	TurbulenceCtx    * tCtx;
+	VortexCtx        * vCtx;
+	VortexConnection * conn;
+	int                greeting;
+	int                idle;
+	VORTEX_SOCKET      _socket;
+	char               buffer[1024];
+	int                bytes_read;
+
+	/* init vortex and turbulence */
+	INIT_AND_RUN_CONF ("test_07a.conf");
+
+	/* connect to local host without opening any channel */
+	conn = vortex_connection_new (vCtx, "127.0.0.1", "44010", NULL, NULL);
+	if (! vortex_connection_is_ok (conn, axl_false)) {
+		printf ("ERROR (1): expected to find proper connection after turbulence initialization..\n");
+		return axl_false;
+	} /* end if */
+
+	/* check nothing was reaped yet */
+	turbulence_conn_mgr_reaped (tCtx, &greeting, &idle);
+	if (greeting != 0 || idle != 0) {
+		printf ("ERROR (2): expected to find no connection reaped but found greeting=%d, idle=%d..\n", greeting, idle);
+		return axl_false;
+	} /* end if */
+
+	/* wait greeting-timeout (1 second) to expire */
+	test_common_microwait (1500000);
+
+	/* check connection was closed */
+	if (vortex_connection_is_ok (conn, axl_false)) {
+		printf ("ERROR (3): expected to find connection closed after greeting timeout..\n");
+		return axl_false;
+	} /* end if */
+
+	turbulence_conn_mgr_reaped (tCtx, &greeting, &idle);
+	if (greeting != 1 || idle != 0) {
+		printf ("ERROR (4): expected to find greeting=1, idle=0 but found greeting=%d, idle=%d..\n", greeting, idle);
+		return axl_false;
+	} /* end if */
+	printf ("Test 07-a: connection closed after greeting timeout (reaped greeting=%d, idle=%d)\n", greeting, idle);
+
+	vortex_connection_close (conn);
+
+	/* connect a raw socket that never sends its greetings */
+	_socket = vortex_connection_sock_connect (vCtx, "127.0.0.1", "44010", NULL, NULL);
+	if (_socket == VORTEX_INVALID_SOCKET) {
+		printf ("ERROR (5): expected to connect a raw socket to turbulence..\n");
+		return axl_false;
+	} /* end if */
+
+	/* wait greeting-timeout (1 second) to expire */
+	test_common_microwait (1500000);
+
+	/* read server greetings (if any) until the connection is
+	 * found closed */
+	while ((bytes_read = recv (_socket, buffer, sizeof (buffer), MSG_DONTWAIT)) > 0);
+	if (bytes_read != 0) {
+		printf ("ERROR (6): expected to find raw socket closed after greeting timeout but found recv=%d, errno=%d..\n", 
+			bytes_read, errno);
+		return axl_false;
+	} /* end if */
+	vortex_close_socket (_socket);
+
+	turbulence_conn_mgr_reaped (tCtx, &greeting, &idle);
+	if (greeting != 2 || idle != 0) {
+		printf ("ERROR (7): expected to find greeting=2, idle=0 but found greeting=%d, idle=%d..\n", greeting, idle);
+		return axl_false;
+	} /* end if */
+	printf ("Test 07-a: raw socket closed after greeting timeout (reaped greeting=%d, idle=%d)\n", greeting, idle);
+
+	/* finish turbulence */
+	test_common_exit (vCtx, tCtx);
+
+	return axl_true;
+}
+
+/** 
+ * @brief Check connection manager lookups, the profile path cache
+ * and profile path reload.
+ */
+axl_bool test_07b (void) {
+	TurbulenceCtx    * tCtx;
+	VortexCtx        * vCtx;
+	VortexConnection * conn;
+	int                hits;
+	int                misses;
+	int                items;
+	int                ppath_id;
+	TurbulencePPath  * paths;
+
+	/* init vortex and turbulence */
+	INIT_AND_RUN_CONF ("test_07.conf");
+
+	/* connect to local host */
+	conn = vortex_connection_new (vCtx, "127.0.0.1", "44010", NULL, NULL);
+	if (! vortex_connection_is_ok (conn, axl_false)) {
+		printf ("ERROR (1): expected to find proper connection after turbulence initialization..\n");
+		return axl_false;
+	} /* end if */
+
+	/* wait 30ms to allow turbulence registering created connections */
+	test_common_microwait (30000);
+
+	/* check count reported (without locking) is the same */
+	if (turbulence_conn_mgr_count (tCtx) != 3) {
+		printf ("ERROR (2): expected to find 3 connections counted, but found %d..\n", 
+			turbulence_conn_mgr_count (tCtx));
+		return axl_false;
+	}
+
+	/* check lookup by id */
+	if (turbulence_conn_mgr_find_by_id (tCtx, vortex_connection_get_id (conn)) != conn) {
+		printf ("ERROR (3): expected to find client connection by id %d..\n", 
+			vortex_connection_get_id (conn));
+		return axl_false;
+	}
+
+	/* close the connection */
+	vortex_connection_close (conn);
+
+	/* wait 30ms to allow turbulence registering created connections */
+	test_common_microwait (30000);
+
+	/* connect again from the same address: profile path
+	 * selection must be served by the cache */
+	conn = vortex_connection_new (vCtx, "127.0.0.1", "44010", NULL, NULL);
+	if (! vortex_connection_is_ok (conn, axl_false)) {
+		printf ("ERROR (4): expected to find proper connection after turbulence initialization..\n");
+		return axl_false;
+	} /* end if */
+	test_common_microwait (30000);
+
+	turbulence_ppath_cache_stats (tCtx, &hits, &misses, &items);
+	if (hits < 1 || misses < 1 || items != 1) {
+		printf ("ERROR (5): expected to find profile path cache hits and misses, but found hits=%d misses=%d items=%d..\n", 
+			hits, misses, items);
+		return axl_false;
+	}
+	vortex_connection_close (conn);
+
+	/* check flush drops entries */
+	turbulence_ppath_cache_flush (tCtx);
+	turbulence_ppath_cache_stats (tCtx, NULL, NULL, &items);
+	if (items != 0) {
+		printf ("ERROR (6): expected to find empty profile path cache after flush, but found %d items..\n", items);
+		return axl_false;
+	}
+
+	/* connect and keep the connection: it holds the profile path
+	 * it selected across the reload */
+	conn = vortex_connection_new (vCtx, "127.0.0.1", "44010", NULL, NULL);
+	if (! vortex_connection_is_ok (conn, axl_false)) {
+		printf ("ERROR (7): expected to find proper connection before profile path reload..\n");
+		return axl_false;
+	} /* end if */
+	test_common_microwait (30000);
+
+	/* reload profile paths: new definitions are installed while
+	 * previous ones are still found */
+	paths    = __turbulence_ppath_table_current (tCtx);
+	ppath_id = turbulence_ppath_get_id (__turbulence_ppath_get_nth (paths, 0));
+	__turbulence_ppath_table_unref (tCtx, paths);
+	if (! turbulence_ppath_reload (tCtx)) {
+		printf ("ERROR (8): expected to reload profile paths..\n");
+		return axl_false;
+	}
+	paths = __turbulence_ppath_table_current (tCtx);
+	if (turbulence_ppath_get_id (__turbulence_ppath_get_nth (paths, 0)) == ppath_id) {
+		printf ("ERROR (9): expected to find new profile path ids after reload, but found %d..\n", ppath_id);
+		return axl_false;
+	}
+	__turbulence_ppath_table_unref (tCtx, paths);
+	if (turbulence_ppath_find_by_id (tCtx, ppath_id) == NULL) {
+		printf ("ERROR (10): expected to find replaced profile path %d while still used..\n", ppath_id);
+		return axl_false;
+	}
+
+	/* close the connection: replaced profile paths are released
+	 * with their last reference */
+	vortex_connection_close (conn);
+	test_common_microwait (30000);
+	if (turbulence_ppath_find_by_id (tCtx, ppath_id) != NULL) {
+		printf ("ERROR (11): expected to find replaced profile path %d released..\n", ppath_id);
+		return axl_false;
+	}
+
+	/* connect again: matched against new profile paths */
+	conn = vortex_connection_new (vCtx, "127.0.0.1", "44010", NULL, NULL);
+	if (! vortex_connection_is_ok (conn, axl_false)) {
+		printf ("ERROR (12): expected to find proper connection after profile path reload..\n");
+		return axl_false;
+	} /* end if */
+	test_common_microwait (30000);
+	if (! vortex_connection_is_ok (conn, axl_false)) {
+		printf ("ERROR (13): expected to find connection accepted by reloaded profile paths..\n");
+		return axl_false;
+	} /* end if */
+	vortex_connection_close (conn);
+
+	/* finish turbulence */
+	test_common_exit (vCtx, tCtx);
+
+	return axl_true;
+}
+
 #define SIMPLE_URI_REGISTER(uri) do{                           \
 	vortex_profiles_register (vCtx, uri,                   \
 				  /* channel start handler */  \
@@ -1725,6 +2103,133 @@ axl_bool test_08 (void) {
 	return axl_true;
 }
 
+axl_bool test_08a (void) {
+	TurbulenceCtx    * tCtx;
+	VortexCtx        * vCtx;
+	VortexConnection * conn;
+	VortexConnection * listener;
+	VortexChannel    * channel;
+	VortexChannel    * channel2;
+	axlList          * list;
+
+	/* init vortex and turbulence */
+	if (! test_common_init (&vCtx, &tCtx, "test_08.conf")) 
+		return axl_false;
+
+	/* register here all profiles required by tests */
+	SIMPLE_URI_REGISTER("urn:aspl.es:beep:profiles:reg-test:profile-1");
+	SIMPLE_URI_REGISTER("urn:aspl.es:beep:profiles:reg-test:profile-2");
+	SIMPLE_URI_REGISTER("urn:aspl.es:beep:profiles:reg-test:profile-4");
+	SIMPLE_URI_REGISTER("http://iana.org/beep/SASL/PLAIN");
+
+	/* run configuration */
+	if (! turbulence_run_config (tCtx)) 
+		return axl_false;
+
+	/* create connection to local server */
+	conn = vortex_connection_new (vCtx, "127.0.0.1", "44010", NULL, NULL);
+	if (! vortex_connection_is_ok (conn, axl_false)) {
+		printf ("ERROR (1): expected to find proper connection after turbulence startup..\n");
+		return axl_false;
+	} /* end if */
+
+	/* get server side connection (used to set connection marks) */
+	list = turbulence_conn_mgr_conn_list (tCtx, VortexRoleListener, NULL);
+	if (axl_list_length (list) != 1) {
+		printf ("ERROR (2): expected to find 1 listener connection registered, but found %d..\n", 
+			axl_list_length (list));
+		return axl_false;
+	}
+	listener = axl_list_get_nth (list, 0);
+	axl_list_free (list);
+
+	/* profile 2 without profile 1 running: denied (and memoized) */
+	channel = SIMPLE_CHANNEL_CREATE ("urn:aspl.es:beep:profiles:reg-test:profile-2");
+	if (channel != NULL) {
+		printf ("ERROR (3): expected to find NULL channel reference (creation failure) but found proper result..\n");
+		return axl_false;
+	}
+
+	/* open profile 1: decisions must be dropped so profile 2 is
+	 * now allowed */
+	channel = SIMPLE_CHANNEL_CREATE ("urn:aspl.es:beep:profiles:reg-test:profile-1");
+	if (channel == NULL) {
+		printf ("ERROR (4): expected to find proper channel reference (create operation) but found NULL reference..\n");
+		return axl_false;
+	}
+	channel2 = SIMPLE_CHANNEL_CREATE ("urn:aspl.es:beep:profiles:reg-test:profile-2");
+	if (channel2 == NULL) {
+		printf ("ERROR (5): expected to find proper channel reference after profile 1 was started but found NULL reference..\n");
+		return axl_false;
+	}
+
+	/* repeat: served from memoized decision */
+	channel2 = SIMPLE_CHANNEL_CREATE ("urn:aspl.es:beep:profiles:reg-test:profile-2");
+	if (channel2 == NULL) {
+		printf ("ERROR (6): expected to find proper channel reference (memoized decision) but found NULL reference..\n");
+		return axl_false;
+	}
+
+	/* close profile 1: decisions must be dropped again so profile
+	 * 2 is denied */
+	if (! vortex_channel_close (channel, NULL)) {
+		printf ("ERROR (7): expected to close profile 1 channel..\n");
+		return axl_false;
+	}
+	channel2 = SIMPLE_CHANNEL_CREATE ("urn:aspl.es:beep:profiles:reg-test:profile-2");
+	if (channel2 != NULL) {
+		printf ("ERROR (8): expected to find NULL channel reference after profile 1 was closed but found proper result..\n");
+		return axl_false;
+	}
+
+	/* start SASL profile without connmark: profile 4 denied */
+	channel = SIMPLE_CHANNEL_CREATE ("http://iana.org/beep/SASL/PLAIN");
+	if (channel == NULL) {
+		printf ("ERROR (9): expected to find proper channel reference (create operation) but found NULL reference..\n");
+		return axl_false;
+	}
+	channel2 = SIMPLE_CHANNEL_CREATE ("urn:aspl.es:beep:profiles:reg-test:profile-4");
+	if (channel2 != NULL) {
+		printf ("ERROR (10): expected to find NULL channel reference without connmark but found proper result..\n");
+		return axl_false;
+	}
+
+	/* set connmark: no channel was added or removed, marks are
+	 * part of the key so profile 4 must be allowed */
+	vortex_connection_set_data (listener, "sasl:is:authenticated", INT_TO_PTR (axl_true));
+	channel2 = SIMPLE_CHANNEL_CREATE ("urn:aspl.es:beep:profiles:reg-test:profile-4");
+	if (channel2 == NULL) {
+		printf ("ERROR (11): expected to find proper channel reference after setting connmark but found NULL reference..\n");
+		return axl_false;
+	}
+
+	/* clear connmark: profile 4 denied again */
+	vortex_connection_set_data (listener, "sasl:is:authenticated", NULL);
+	channel2 = SIMPLE_CHANNEL_CREATE ("urn:aspl.es:beep:profiles:reg-test:profile-4");
+	if (channel2 != NULL) {
+		printf ("ERROR (12): expected to find NULL channel reference after clearing connmark but found proper result..\n");
+		return axl_false;
+	}
+
+	/* set connmark again: no channel was added or removed since
+	 * the previous denial */
+	vortex_connection_set_data (listener, "sasl:is:authenticated", INT_TO_PTR (axl_true));
+	channel2 = SIMPLE_CHANNEL_CREATE ("urn:aspl.es:beep:profiles:reg-test:profile-4");
+	if (channel2 == NULL) {
+		printf ("ERROR (13): expected to find proper channel reference after setting connmark again but found NULL reference..\n");
+		return axl_false;
+	}
+
+	/* terminate connection */
+	vortex_connection_shutdown (conn);
+	vortex_connection_close (conn);
+
+	/* finish turbulence */
+	test_common_exit (vCtx, tCtx);
+
+	return axl_true;
+}
+
 axl_bool test_09 (void) {
 	TurbulenceCtx    * tCtx;
 	VortexCtx        * vCtx;
@@ -2400,58 +2905,399 @@ VortexConnection * test_10_c_connect_and_check (VortexCtx * vCtx, TurbulenceCtx
 	VortexConnection * conn;
 	VortexChannel    * channel;
 
-	/* create connection */
-	conn = vortex_connection_new_full (vCtx, "127.0.0.1", "44010", 
-					   CONN_OPTS(VORTEX_SERVERNAME_FEATURE, "test-10.server", VORTEX_OPTS_END),
-					   NULL, NULL);
-	if (! vortex_connection_is_ok (conn, axl_false)) {
-		printf ("ERROR (1): expected to find proper connection after turbulence startup..\n");
-		exit (-1);
+	/* create connection */
+	conn = vortex_connection_new_full (vCtx, "127.0.0.1", "44010", 
+					   CONN_OPTS(VORTEX_SERVERNAME_FEATURE, "test-10.server", VORTEX_OPTS_END),
+					   NULL, NULL);
+	if (! vortex_connection_is_ok (conn, axl_false)) {
+		printf ("ERROR (1): expected to find proper connection after turbulence startup..\n");
+		exit (-1);
+	} /* end if */
+	
+	printf ("Test 10-c: connection id=%d (%p) created..\n", 
+		vortex_connection_get_id (conn), conn);
+
+	/* check to create profile 2 channel: MUST WORK */
+	channel = SIMPLE_CHANNEL_CREATE ("urn:aspl.es:beep:profiles:reg-test:profile-1");
+	if (channel_should_fail) {
+		printf ("Test 10-c: channel should fail...checking: %p\n", channel);
+		if (channel != NULL) {
+			printf ("ERROR (2): test-10-c: expected to find NULL channel reference (creation ok) but found failure..\n");
+			exit (-1);
+		}
+	} else {
+		printf ("Test 10-c: channel should NOT fail...checking: %p\n", channel);
+		if (channel == NULL) {
+			printf ("ERROR (2): test-10-c: expected to NOT find NULL channel reference (creation ok) but found failure..\n");
+			exit (-1);
+		}
+
+		/* check connection after created it */
+		if (! vortex_connection_is_ok (conn, axl_false)) {
+			printf ("ERROR (4): test-10-c: expected to find proper connection after turbulence startup..\n");
+			exit (-1);
+		} /* end if */
+
+	} /* end if */
+
+	printf ("Test 10-c: channel num=%d (%p) created..\n", 
+		vortex_channel_get_number (channel), channel);
+
+	/* now wait a bit 100ms */
+	turbulence_sleep (tCtxTest10prev, 100000);
+
+	return conn;
+}
+						     
+
+axl_bool test_10_c (void) {
+
+	VortexCtx        * vCtx;
+	VortexConnection * conn, * conn2, * conn3;
+
+	/* FIRST PART: init vortex and turbulence */
+	if (! test_common_init (&vCtx, &tCtxTest10prev, "test_10c.conf")) 
+		return axl_false;
+
+	/* run configuration */
+	if (! turbulence_run_config (tCtxTest10prev)) 
+		return axl_false;
+
+	/* install signal handling (handle child processes) */
+	turbulence_signal_install (tCtxTest10prev, axl_false, axl_false, test_10_prev_signal_handler);
+
+	/* create connection to local server */
+	printf ("Test 10-c: CREATE FIRST CONNECTION(1): creating child process..\n");
+	conn = test_10_c_connect_and_check (vCtx, tCtxTest10prev, axl_false);
+
+	/* now create a second child */
+	printf ("Test 10-c: CREATING SECOND CONNECTION(2): attempting to create a second child to see if it is allowed..\n");
+
+	/* second reference */
+	conn2 = test_10_c_connect_and_check (vCtx, tCtxTest10prev, axl_true);
+
+	printf ("Test 10-c: check childs (first: should be 1)..\n");
+	if (turbulence_process_child_count (tCtxTest10prev) != 1) {
+		printf ("ERROR (8): expected to find child count 1 but found %d..\n", turbulence_process_child_count (tCtxTest10prev));
+		return axl_false;
+	} /* end if */
+
+	/* ok, close connection not used */
+	vortex_connection_close (conn2);
+
+	printf ("Test 10-c: changing run time settings to accept 3 childs and check profile path limits..\n");
+	tCtxTest10prev->global_child_limit = 3;
+
+	printf ("Test 10-c: CREATING SECOND CONNECTION(3): creating a second connection again (it should work..)\n");
+
+	/* second reference */
+	conn2 = test_10_c_connect_and_check (vCtx, tCtxTest10prev, axl_false);
+
+
+	printf ("Test 10-c: check childs (second check, should be 2)..\n");
+	if (turbulence_process_child_count (tCtxTest10prev) != 2) {
+		printf ("ERROR (8): expected to find child count 1 but found %d..\n", turbulence_process_child_count (tCtxTest10prev));
+		return axl_false;
+	} /* end if */
+
+	printf ("Test 10-c: ok, now create a third connection that should fail because profile path limits..\n");
+
+	/* second reference */
+	conn3 = test_10_c_connect_and_check (vCtx, tCtxTest10prev, axl_true);
+
+	printf ("Test 10-c: check childs..\n");
+	if (turbulence_process_child_count (tCtxTest10prev) != 2) {
+		printf ("ERROR (8): expected to find child count 2 but found %d..\n", turbulence_process_child_count (tCtxTest10prev));
+		return axl_false;
+	} /* end if */
+	
+
+	/* close connection */
+	vortex_connection_close (conn3);
+	vortex_connection_close (conn2);
+	vortex_connection_close (conn);
+
+	/* finish turbulence */
+	test_common_exit (vCtx, tCtxTest10prev);
+
+	return axl_true;
+}
+
+
+axl_bool test_10_f_wait_childs (TurbulenceCtx * ctx, int expected)
+{
+	int tries = 0;
+
+	/* spare childs are created in background, wait for them */
+	while (tries < 100) {
+		if (turbulence_process_child_count (ctx) == expected)
+			return axl_true;
+		turbulence_sleep (ctx, 100000);
+		tries++;
+	} /* end while */
+
+	printf ("ERROR: expected to find child count %d but found %d..\n", expected, turbulence_process_child_count (ctx));
+	return axl_false;
+}
+
+axl_bool test_10_f (void) {
+
+	VortexCtx        * vCtx;
+	VortexConnection * conn;
+
+	/* FIRST PART: init vortex and turbulence */
+	if (! test_common_init (&vCtx, &tCtxTest10prev, "test_10f.conf")) 
+		return axl_false;
+
+	/* run configuration */
+	if (! turbulence_run_config (tCtxTest10prev)) 
+		return axl_false;
+
+	/* install signal handling (handle child processes) */
+	turbulence_signal_install (tCtxTest10prev, axl_false, axl_false, test_10_prev_signal_handler);
+
+	/* spare childs must be started without connections */
+	printf ("Test 10-f: checking spare childs started (should be 2)..\n");
+	if (! test_10_f_wait_childs (tCtxTest10prev, 2))
+		return axl_false;
+
+	/* create connection to local server: it must be handled by a
+	 * spare child */
+	printf ("Test 10-f: creating connection (must use a spare child)..\n");
+	conn = test_10_c_connect_and_check (vCtx, tCtxTest10prev, axl_false);
+
+	/* pool must be refilled: 1 busy + 2 spare */
+	printf ("Test 10-f: checking spare pool refilled (should be 3)..\n");
+	if (! test_10_f_wait_childs (tCtxTest10prev, 3))
+		return axl_false;
+
+	/* close connection */
+	vortex_connection_close (conn);
+
+	/* finish turbulence */
+	test_common_exit (vCtx, tCtxTest10prev);
+
+	return axl_true;
+}
+
+axl_bool test_10_g (void) {
+
+	VortexCtx        * vCtx;
+	VortexConnection * conn, * conn2;
+
+	/* FIRST PART: init vortex and turbulence */
+	if (! test_common_init (&vCtx, &tCtxTest10prev, "test_10g.conf")) 
+		return axl_false;
+
+	/* run configuration */
+	if (! turbulence_run_config (tCtxTest10prev)) 
+		return axl_false;
+
+	/* install signal handling (handle child processes) */
+	turbulence_signal_install (tCtxTest10prev, axl_false, axl_false, test_10_prev_signal_handler);
+
+#if defined(__linux__)
+	/* zygote must be running */
+	if (tCtxTest10prev->zygote_pid <= 0) {
+		printf ("ERROR: expected to find child zygote process running but found pid=%d..\n", tCtxTest10prev->zygote_pid);
+		return axl_false;
+	} /* end if */
+#endif
+
+	/* create connections to local server: each one is handled
+	 * by a child created from the zygote */
+	printf ("Test 10-g: creating first connection (child created by zygote)..\n");
+	conn = test_10_c_connect_and_check (vCtx, tCtxTest10prev, axl_false);
+
+	printf ("Test 10-g: creating second connection (child created by zygote)..\n");
+	conn2 = test_10_c_connect_and_check (vCtx, tCtxTest10prev, axl_false);
+
+	printf ("Test 10-g: check childs (should be 2)..\n");
+	if (! test_10_f_wait_childs (tCtxTest10prev, 2))
+		return axl_false;
+
+	/* close connections */
+	vortex_connection_close (conn2);
+	vortex_connection_close (conn);
+
+	/* finish turbulence */
+	test_common_exit (vCtx, tCtxTest10prev);
+
+	return axl_true;
+}
+
+axl_bool test_10_h_check_stats (TurbulenceCtx * ctx, int expected)
+{
+	axlList              * childs;
+	TurbulenceChildStats   stats;
+	int                    connections = 0;
+	int                    iterator;
+	int                    tries = 0;
+
+	/* childs publish their counters every second */
+	while (tries < 50) {
+		connections = 0;
+		childs      = turbulence_process_child_list (ctx);
+		iterator    = 0;
+		while (iterator < axl_list_length (childs)) {
+			if (turbulence_process_child_stats (ctx, axl_list_get_nth (childs, iterator), &stats))
+				connections += stats.connections;
+			iterator++;
+		} /* end while */
+		axl_list_free (childs);
+
+		if (connections == expected)
+			return axl_true;
+		turbulence_sleep (ctx, 100000);
+		tries++;
+	} /* end while */
+
+	printf ("ERROR: expected to find %d connections published by childs but found %d..\n", expected, connections);
+	return axl_false;
+}
+
+axl_bool test_10_h (void) {
+
+	VortexCtx        * vCtx;
+	VortexConnection * conn, * conn2, * conn3;
+
+	/* FIRST PART: init vortex and turbulence */
+	if (! test_common_init (&vCtx, &tCtxTest10prev, "test_10h.conf")) 
+		return axl_false;
+
+	/* run configuration */
+	if (! turbulence_run_config (tCtxTest10prev)) 
+		return axl_false;
+
+	/* install signal handling (handle child processes) */
+	turbulence_signal_install (tCtxTest10prev, axl_false, axl_false, test_10_prev_signal_handler);
+
+	/* first two connections create the two childs allowed by
+	 * children-per-ppath */
+	printf ("Test 10-h: creating first connection (first child)..\n");
+	conn = test_10_c_connect_and_check (vCtx, tCtxTest10prev, axl_false);
+
+	printf ("Test 10-h: creating second connection (second child)..\n");
+	conn2 = test_10_c_connect_and_check (vCtx, tCtxTest10prev, axl_false);
+
+	printf ("Test 10-h: check childs (should be 2)..\n");
+	if (! test_10_f_wait_childs (tCtxTest10prev, 2))
+		return axl_false;
+
+	/* third connection must be balanced to an existing child */
+	printf ("Test 10-h: creating third connection (must reuse a child)..\n");
+	conn3 = test_10_c_connect_and_check (vCtx, tCtxTest10prev, axl_false);
+
+	printf ("Test 10-h: check childs (still 2)..\n");
+	if (! test_10_f_wait_childs (tCtxTest10prev, 2))
+		return axl_false;
+
+	/* connections handled must be published by childs */
+	printf ("Test 10-h: check connections published by childs (should be 3)..\n");
+	if (! test_10_h_check_stats (tCtxTest10prev, 3))
+		return axl_false;
+
+	/* close connections */
+	vortex_connection_close (conn3);
+	vortex_connection_close (conn2);
+	vortex_connection_close (conn);
+
+	/* finish turbulence */
+	test_common_exit (vCtx, tCtxTest10prev);
+
+	return axl_true;
+}
+
+axlPointer test_10_i_close_later (VortexConnection * conn)
+{
+	/* let the next connection to reach the admission queue */
+	turbulence_sleep (tCtxTest10prev, 300000);
+	vortex_connection_close (conn);
+	return NULL;
+}
+
+axl_bool test_10_i (void) {
+
+	VortexCtx          * vCtx;
+	VortexConnection   * conn, * conn2, * conn3;
+	TurbulencePPathDef * def;
+	TurbulencePPath    * paths;
+	VortexThread         thread;
+	int                  depth, queued, timeouts;
+	long                 wait_max;
+
+	/* FIRST PART: init vortex and turbulence */
+	if (! test_common_init (&vCtx, &tCtxTest10prev, "test_10i.conf")) 
+		return axl_false;
+
+	/* run configuration */
+	if (! turbulence_run_config (tCtxTest10prev)) 
+		return axl_false;
+
+	/* install signal handling (handle child processes) */
+	turbulence_signal_install (tCtxTest10prev, axl_false, axl_false, test_10_prev_signal_handler);
+
+	/* get profile path with the admission queue */
+	paths = __turbulence_ppath_table_current (tCtxTest10prev);
+	def   = __turbulence_ppath_get_nth (paths, 0);
+	__turbulence_ppath_table_unref (tCtxTest10prev, paths);
+	if (def == NULL) {
+		printf ("ERROR: expected to find first profile path defined..\n");
+		return axl_false;
 	} /* end if */
-	
-	printf ("Test 10-c: connection id=%d (%p) created..\n", 
-		vortex_connection_get_id (conn), conn);
 
-	/* check to create profile 2 channel: MUST WORK */
-	channel = SIMPLE_CHANNEL_CREATE ("urn:aspl.es:beep:profiles:reg-test:profile-1");
-	if (channel_should_fail) {
-		printf ("Test 10-c: channel should fail...checking: %p\n", channel);
-		if (channel != NULL) {
-			printf ("ERROR (2): test-10-c: expected to find NULL channel reference (creation ok) but found failure..\n");
-			exit (-1);
-		}
-	} else {
-		printf ("Test 10-c: channel should NOT fail...checking: %p\n", channel);
-		if (channel == NULL) {
-			printf ("ERROR (2): test-10-c: expected to NOT find NULL channel reference (creation ok) but found failure..\n");
-			exit (-1);
-		}
+	printf ("Test 10-i: creating first connection (child-limit reached)..\n");
+	conn = test_10_c_connect_and_check (vCtx, tCtxTest10prev, axl_false);
 
-		/* check connection after created it */
-		if (! vortex_connection_is_ok (conn, axl_false)) {
-			printf ("ERROR (4): test-10-c: expected to find proper connection after turbulence startup..\n");
-			exit (-1);
-		} /* end if */
+	/* second connection waits admission-timeout and is closed */
+	printf ("Test 10-i: creating second connection (must wait and fail)..\n");
+	conn2 = test_10_c_connect_and_check (vCtx, tCtxTest10prev, axl_true);
 
+	if (! turbulence_process_admission_stats (tCtxTest10prev, def, &depth, NULL, &queued, &timeouts, NULL, NULL, &wait_max)) {
+		printf ("ERROR: expected to find admission queue stats..\n");
+		return axl_false;
+	} /* end if */
+	printf ("Test 10-i: admission stats: depth=%d, queued=%d, timeouts=%d, wait-max=%ld ms\n", depth, queued, timeouts, wait_max);
+	if (depth != 0 || queued != 1 || timeouts != 1 || wait_max < 2000) {
+		printf ("ERROR: expected depth=0, queued=1, timeouts=1, wait-max >= 2000..\n");
+		return axl_false;
 	} /* end if */
 
-	printf ("Test 10-c: channel num=%d (%p) created..\n", 
-		vortex_channel_get_number (channel), channel);
+	/* third connection waits until first child finishes */
+	printf ("Test 10-i: creating third connection (must wait for first child to finish)..\n");
+	if (! vortex_thread_create (&thread, 
+				    (VortexThreadFunc) test_10_i_close_later, conn, VORTEX_THREAD_CONF_END)) {
+		printf ("ERROR: expected to create thread but failure found..\n");
+		return axl_false;
+	} /* end if */
+	conn3 = test_10_c_connect_and_check (vCtx, tCtxTest10prev, axl_false);
+	vortex_thread_destroy (&thread, axl_false);
 
-	/* now wait a bit 100ms */
-	turbulence_sleep (tCtxTest10prev, 100000);
+	turbulence_process_admission_stats (tCtxTest10prev, def, &depth, NULL, &queued, &timeouts, NULL, NULL, NULL);
+	if (depth != 0 || queued != 2 || timeouts != 1) {
+		printf ("ERROR: expected depth=0, queued=2, timeouts=1 but found %d, %d, %d..\n", depth, queued, timeouts);
+		return axl_false;
+	} /* end if */
 
-	return conn;
+	/* close connections */
+	vortex_connection_close (conn3);
+	vortex_connection_close (conn2);
+
+	/* finish turbulence */
+	test_common_exit (vCtx, tCtxTest10prev);
+
+	return axl_true;
 }
-						     
 
-axl_bool test_10_c (void) {
+axl_bool test_10_j (void) {
 
-	VortexCtx        * vCtx;
-	VortexConnection * conn, * conn2, * conn3;
+	VortexCtx          * vCtx;
+	VortexConnection   * conn, * conn2;
+	TurbulencePPathDef * def;
+	TurbulencePPath    * paths;
 
 	/* FIRST PART: init vortex and turbulence */
-	if (! test_common_init (&vCtx, &tCtxTest10prev, "test_10c.conf")) 
+	if (! test_common_init (&vCtx, &tCtxTest10prev, "test_10j.conf")) 
 		return axl_false;
 
 	/* run configuration */
@@ -2461,64 +3307,96 @@ axl_bool test_10_c (void) {
 	/* install signal handling (handle child processes) */
 	turbulence_signal_install (tCtxTest10prev, axl_false, axl_false, test_10_prev_signal_handler);
 
-	/* create connection to local server */
-	printf ("Test 10-c: CREATE FIRST CONNECTION(1): creating child process..\n");
+	/* get profile path with spawn-rate="1" */
+	paths = __turbulence_ppath_table_current (tCtxTest10prev);
+	def   = __turbulence_ppath_get_nth (paths, 0);
+	__turbulence_ppath_table_unref (tCtxTest10prev, paths);
+	if (def == NULL) {
+		printf ("ERROR: expected to find first profile path defined..\n");
+		return axl_false;
+	} /* end if */
+
+	printf ("Test 10-j: creating first connection (first child)..\n");
 	conn = test_10_c_connect_and_check (vCtx, tCtxTest10prev, axl_false);
 
-	/* now create a second child */
-	printf ("Test 10-c: CREATING SECOND CONNECTION(2): attempting to create a second child to see if it is allowed..\n");
+	/* children-per-ppath="3" would create another child, but
+	 * spawn rate was consumed: it must reuse the first one */
+	printf ("Test 10-j: creating second connection (spawn rate exceeded, must reuse child)..\n");
+	conn2 = test_10_c_connect_and_check (vCtx, tCtxTest10prev, axl_false);
 
-	/* second reference */
-	conn2 = test_10_c_connect_and_check (vCtx, tCtxTest10prev, axl_true);
+	printf ("Test 10-j: check childs (should be 1)..\n");
+	if (! test_10_f_wait_childs (tCtxTest10prev, 1))
+		return axl_false;
 
-	printf ("Test 10-c: check childs (first: should be 1)..\n");
-	if (turbulence_process_child_count (tCtxTest10prev) != 1) {
-		printf ("ERROR (8): expected to find child count 1 but found %d..\n", turbulence_process_child_count (tCtxTest10prev));
+	if (turbulence_process_spawn_throttled (tCtxTest10prev, def) != 1 || turbulence_process_spawn_throttled (tCtxTest10prev, NULL) != 1) {
+		printf ("ERROR: expected to find 1 child spawn throttled but found %d (global %d)..\n", 
+			turbulence_process_spawn_throttled (tCtxTest10prev, def), turbulence_process_spawn_throttled (tCtxTest10prev, NULL));
 		return axl_false;
 	} /* end if */
 
-	/* ok, close connection not used */
+	/* close connections */
 	vortex_connection_close (conn2);
+	vortex_connection_close (conn);
 
-	printf ("Test 10-c: changing run time settings to accept 3 childs and check profile path limits..\n");
-	tCtxTest10prev->global_child_limit = 3;
+	/* finish turbulence */
+	test_common_exit (vCtx, tCtxTest10prev);
 
-	printf ("Test 10-c: CREATING SECOND CONNECTION(3): creating a second connection again (it should work..)\n");
+	return axl_true;
+}
 
-	/* second reference */
-	conn2 = test_10_c_connect_and_check (vCtx, tCtxTest10prev, axl_false);
+axl_bool test_10_k (void) {
 
+	VortexCtx          * vCtx;
+	VortexConnection   * conn, * conn2, * conn3;
 
-	printf ("Test 10-c: check childs (second check, should be 2)..\n");
-	if (turbulence_process_child_count (tCtxTest10prev) != 2) {
-		printf ("ERROR (8): expected to find child count 1 but found %d..\n", turbulence_process_child_count (tCtxTest10prev));
+	/* FIRST PART: init vortex and turbulence */
+	if (! test_common_init (&vCtx, &tCtxTest10prev, "test_10k.conf")) 
 		return axl_false;
-	} /* end if */
 
-	printf ("Test 10-c: ok, now create a third connection that should fail because profile path limits..\n");
+	/* run configuration */
+	if (! turbulence_run_config (tCtxTest10prev)) 
+		return axl_false;
 
-	/* second reference */
-	conn3 = test_10_c_connect_and_check (vCtx, tCtxTest10prev, axl_true);
+	/* install signal handling (handle child processes) */
+	turbulence_signal_install (tCtxTest10prev, axl_false, axl_false, test_10_prev_signal_handler);
 
-	printf ("Test 10-c: check childs..\n");
-	if (turbulence_process_child_count (tCtxTest10prev) != 2) {
-		printf ("ERROR (8): expected to find child count 2 but found %d..\n", turbulence_process_child_count (tCtxTest10prev));
+	/* first two connections are handled by the same child */
+	printf ("Test 10-k: creating first and second connections (same child)..\n");
+	conn  = test_10_c_connect_and_check (vCtx, tCtxTest10prev, axl_false);
+	conn2 = test_10_c_connect_and_check (vCtx, tCtxTest10prev, axl_false);
+
+	printf ("Test 10-k: check childs (should be 1)..\n");
+	if (! test_10_f_wait_childs (tCtxTest10prev, 1))
 		return axl_false;
-	} /* end if */
-	
 
-	/* close connection */
-	vortex_connection_close (conn3);
+	/* recycle-conns="2" reached: third connection must create a
+	 * new child while the first one drains */
+	printf ("Test 10-k: creating third connection (first child recycled)..\n");
+	conn3 = test_10_c_connect_and_check (vCtx, tCtxTest10prev, axl_false);
+
+	printf ("Test 10-k: check childs (should be 2)..\n");
+	if (! test_10_f_wait_childs (tCtxTest10prev, 2))
+		return axl_false;
+
+	/* once its connections are closed, the recycled child must
+	 * finish */
+	printf ("Test 10-k: closing connections of the recycled child..\n");
 	vortex_connection_close (conn2);
 	vortex_connection_close (conn);
 
+	printf ("Test 10-k: check childs (should be 1)..\n");
+	if (! test_10_f_wait_childs (tCtxTest10prev, 1))
+		return axl_false;
+
+	/* close connections */
+	vortex_connection_close (conn3);
+
 	/* finish turbulence */
 	test_common_exit (vCtx, tCtxTest10prev);
 
 	return axl_true;
 }
 
-
 int test_10_d_filter_conn (VortexConnection *conn, axlPointer user_data)
 {
 	VortexConnection * temp;
@@ -2557,6 +3435,7 @@ axl_bool test_10_d (void) {
 	VortexChannel    * channel;
 	VortexAsyncQueue * queue;
 	VortexFrame      * frame;
+	axlList          * failed;
 	
 	/* FIRST PART: init vortex and turbulence */
 	if (! test_common_init (&vCtx, &tCtx, "test_10d.conf")) 
@@ -2615,6 +3494,53 @@ axl_bool test_10_d (void) {
 
 	/* release frame */
 	vortex_frame_unref (frame);
+
+	/* now broadcast reporting failures */
+	printf ("Test 10-d: sending broadcast message (reporting failures)..\n");
+	failed = NULL;
+	if (! turbulence_conn_mgr_broadcast_msg_full (tCtx, 
+						      "This is a test 2",
+						      16, 
+						      "urn:aspl.es:beep:profiles:reg-test:profile-1",
+						      NULL, NULL, &failed)) {
+		printf ("ERROR (6): failed to broadcast message...\n");
+		return axl_false;
+	}
+	if (failed == NULL || axl_list_length (failed) != 0) {
+		printf ("ERROR (7): expected to find empty failed connections list..\n");
+		return axl_false;
+	}
+	axl_list_free (failed);
+
+	/* get reply */
+	frame = vortex_channel_get_reply (channel, queue);
+	if (frame == NULL || ! axl_cmp (vortex_frame_get_payload (frame), "This is a test 2")) {
+		printf ("ERROR (8): expected to find content 'This is a test 2'..\n");
+		return axl_false;
+	} /* end if */
+	vortex_frame_unref (frame);
+
+	/* cluster wide broadcast: no child is running so only local
+	 * connections are reached */
+	printf ("Test 10-d: sending cluster wide broadcast message..\n");
+	if (turbulence_process_broadcast_msg (tCtx, "This is a test 3", 16, 
+					      "urn:aspl.es:beep:profiles:reg-test:profile-1", NULL) != 0) {
+		printf ("ERROR (10): expected to reach no child process..\n");
+		return axl_false;
+	} /* end if */
+
+	frame = vortex_channel_get_reply (channel, queue);
+	if (frame == NULL || ! axl_cmp (vortex_frame_get_payload (frame), "This is a test 3")) {
+		printf ("ERROR (11): expected to find content 'This is a test 3'..\n");
+		return axl_false;
+	} /* end if */
+	vortex_frame_unref (frame);
+
+	/* broadcast on a profile not running must not send anything */
+	if (! turbulence_conn_mgr_broadcast_msg (tCtx, "skipped", 7, "urn:aspl.es:beep:profiles:not-running", NULL, NULL)) {
+		printf ("ERROR (9): failed to broadcast message on a profile not running...\n");
+		return axl_false;
+	}
 	vortex_async_queue_unref (queue);
 
 	/* terminate connection */
@@ -3938,6 +4864,9 @@ axl_bool test_15 (void) {
 	const char      * remote_host = "localhost";
 	const char      * remote_port = "1233";
 	const char      * remote_host_ip = "127.0.0.1";
+	char              record[TBC_CONN_STATUS_MAX];
+	int               size;
+	TurbulenceConnStatus status;
 
 	/* build connection status */
 	conn_status = turbulence_process_connection_status_string (axl_true,
@@ -4005,7 +4934,50 @@ axl_bool test_15 (void) {
 		return axl_false;
 	}
 
+	if (has_tls != 1 || fix_server_name != 0) {
+		printf ("ERROR (11): unexpected has_tls=%d or fix_server_name=%d values (expected 1 and 0)\n", has_tls, fix_server_name);
+		return axl_false;
+	}
+
 	axl_free (conn_status);
+
+	/* now check binary connection status record (strings with
+	 * separators must be carried as is) */
+	size = turbulence_process_connection_status_encode (record, sizeof (record),
+							    axl_true, 3,
+							    "urn:aspl.es:beep:profiles:reg-test:profile-15",
+							    "content;-;with;_;separators",
+							    EncodingNone,
+							    "test-15.server",
+							    17, 42301, 1234, 37, 1, 0, "localhost", "1233", "127.0.0.1", 0);
+	if (size <= 0 || ! turbulence_process_connection_status_decode (record, size, &status)) {
+		printf ("ERROR (12): failed to encode/decode connection status record (size: %d)\n", size);
+		return axl_false;
+	}
+
+	if (! status.handle_start_reply || status.channel_num != 3 || status.msg_no != 17 ||
+	    status.seq_no != 42301 || status.seq_no_expected != 1234 || status.ppath_id != 37 ||
+	    status.has_tls != 1 || status.fix_server_name != 0 || status.skip_conn_recover) {
+		printf ("ERROR (13): unexpected integer values found in connection status record\n");
+		return axl_false;
+	}
+
+	if (! axl_cmp (status.profile, "urn:aspl.es:beep:profiles:reg-test:profile-15") ||
+	    ! axl_cmp (status.profile_content, "content;-;with;_;separators") ||
+	    ! axl_cmp (status.serverName, "test-15.server") ||
+	    ! axl_cmp (status.remote_host, "localhost") ||
+	    ! axl_cmp (status.remote_port, "1233") ||
+	    ! axl_cmp (status.remote_host_ip, "127.0.0.1")) {
+		printf ("ERROR (14): unexpected string values found in connection status record\n");
+		return axl_false;
+	}
+
+	/* truncated records must be rejected */
+	if (turbulence_process_connection_status_decode (record, size - 1, &status)) {
+		printf ("ERROR (15): expected to reject truncated connection status record\n");
+		return axl_false;
+	}
+
 	return axl_true;
 }
 
@@ -5208,6 +6180,8 @@ axl_bool test_28 (void) {
 	VortexChannel    * channel;
 	VortexFrame      * frame;
 	char             * local_check;
+	int                iterator, active, total, value, value2;
+	long               bytes_to_child, bytes_to_conn, bytes_in, bytes_out;
 
 	/* websocket setup */
 	VortexWebsocketSetup * wss_setup;
@@ -5278,6 +6252,28 @@ axl_bool test_28 (void) {
 	vortex_frame_unref (frame);
 	axl_free (local_check);
 
+	/* check proxy loops stats */
+	iterator = 0;
+	active   = 0;
+	total    = 0;
+	bytes_to_child = 0;
+	bytes_to_conn  = 0;
+	while (iterator < turbulence_conn_mgr_proxy_loops (tCtx)) {
+		turbulence_conn_mgr_proxy_loop_stats (tCtx, iterator, &value, &value2, &bytes_in, &bytes_out);
+		active         += value;
+		total          += value2;
+		bytes_to_child += bytes_in;
+		bytes_to_conn  += bytes_out;
+		iterator++;
+	} /* end while */
+
+	printf ("Test 28: proxy loops=%d, active=%d, total=%d, bytes to child=%ld, bytes to conn=%ld\n",
+		turbulence_conn_mgr_proxy_loops (tCtx), active, total, bytes_to_child, bytes_to_conn);
+	if (turbulence_conn_mgr_proxy_loops (tCtx) < 1 || active != 1 || total != 1 || bytes_to_child <= 0 || bytes_to_conn <= 0) {
+		printf ("ERROR: (2.5): expected to find one connection proxied with content moved on both directions\n");
+		return axl_false;
+	} /* end if */
+
 	/* close connection */
 	vortex_connection_close (conn);
 
@@ -5296,6 +6292,141 @@ axl_bool test_28 (void) {
 
 #endif
 
+/** 
+ * @internal Flags connections accepted to be proxied on parent as raw
+ * connections (content is passed as is, using splice when
+ * available).
+ */
+int test_29_flag_raw (VortexCtx               * ctx, 
+		      VortexConnection        * conn, 
+		      VortexConnection       ** new_conn, 
+		      VortexConnectionStage     stage, 
+		      axlPointer                user_data)
+{
+	/* only accepted connections */
+	if (vortex_connection_get_role (conn) != VortexRoleListener)
+		return 1;
+
+	vortex_connection_set_data (conn, "tbc:proxy:conn", INT_TO_PTR (axl_true));
+	vortex_connection_set_data (conn, "tbc:proxy:raw", INT_TO_PTR (axl_true));
+	return 1;
+}
+
+axl_bool test_29 (void) {
+	VortexCtx        * vCtx;
+	VortexConnection * conn;
+	VortexChannel    * channel;
+	VortexAsyncQueue * queue;
+	VortexFrame      * frame;
+	int                iterator, active, total, value, value2;
+	long               bytes_to_child, bytes_to_conn, bytes_in, bytes_out;
+
+	printf ("Test 29: checking raw connections proxied on parent..\n");
+
+	/* FIRST PART: init vortex and turbulence */
+	if (! test_common_init (&vCtx, &tCtxTest10, "test_10.conf")) 
+		return axl_false;
+
+	/* flag connections accepted as raw proxied connections */
+	vortex_connection_set_connection_actions (turbulence_ctx_get_vortex_ctx (tCtxTest10), 
+						  CONNECTION_STAGE_POST_CREATED, 
+						  test_29_flag_raw, NULL);
+
+	/* run configuration */
+	if (! turbulence_run_config (tCtxTest10)) 
+		return axl_false;
+
+	/* create queue */
+	queue = vortex_async_queue_new ();
+
+	/* install signal handling */
+	turbulence_signal_install (tCtxTest10, axl_false, axl_false, test_10_signal_handler);
+
+	/* create connection to local server */
+	conn = vortex_connection_new_full (vCtx, "127.0.0.1", "44010", 
+					   CONN_OPTS(VORTEX_SERVERNAME_FEATURE, "test-10.server", VORTEX_OPTS_END),
+					   NULL, NULL);
+	if (! vortex_connection_is_ok (conn, axl_false)) {
+		printf ("ERROR (1): expected to find proper connection after turbulence startup..\n");
+		return axl_false;
+	} /* end if */
+
+	/* the channel start request is the first content the parent
+	 * reads for the child, so it has to be passed before
+	 * splicing the connection */
+	channel = SIMPLE_CHANNEL_CREATE ("urn:aspl.es:beep:profiles:reg-test:profile-1");
+	if (channel == NULL) {
+		printf ("ERROR (2): expected to find proper channel creation on the child but found failure..\n");
+		return axl_false;
+	}
+
+	/* check process created at this point */
+	if (turbulence_process_child_count (tCtxTest10) != 1) {
+		printf ("ERROR (3): expected to find child process count equal to 1 but found: %d..\n",
+			turbulence_process_child_count (tCtxTest10));
+		return axl_false;
+	} /* end if */
+
+	/* exchange several requests through the parent */
+	vortex_channel_set_received_handler (channel, vortex_channel_queue_reply, queue);
+	iterator = 0;
+	while (iterator < 10) {
+		if (! vortex_channel_send_msg (channel, "GET pid", 7, NULL)) {
+			printf ("ERROR (4): expected to send get pid request but found an error..\n");
+			return axl_false;
+		} /* end if */
+		frame = vortex_channel_get_reply (channel, queue);
+		if (frame == NULL) {
+			printf ("ERROR (5): expected to find reply for get pid request...\n");
+			return axl_false;
+		} /* end if */
+
+		/* reply must come from the child */
+		if (! turbulence_process_child_exists (tCtxTest10, vortex_support_strtod ((const char*) vortex_frame_get_payload (frame), NULL))) {
+			printf ("ERROR (6): expected to find child process %s to exist, but it wasn't found in the child list..\n",
+				(const char *) vortex_frame_get_payload (frame));
+			return axl_false;
+		} /* end if */
+		vortex_frame_unref (frame);
+
+		/* next */
+		iterator++;
+	} /* end while */
+
+	/* check proxy loops stats */
+	iterator = 0;
+	active   = 0;
+	total    = 0;
+	bytes_to_child = 0;
+	bytes_to_conn  = 0;
+	while (iterator < turbulence_conn_mgr_proxy_loops (tCtxTest10)) {
+		turbulence_conn_mgr_proxy_loop_stats (tCtxTest10, iterator, &value, &value2, &bytes_in, &bytes_out);
+		active         += value;
+		total          += value2;
+		bytes_to_child += bytes_in;
+		bytes_to_conn  += bytes_out;
+		iterator++;
+	} /* end while */
+
+	printf ("Test 29: proxy loops=%d, active=%d, total=%d, bytes to child=%ld, bytes to conn=%ld\n",
+		turbulence_conn_mgr_proxy_loops (tCtxTest10), active, total, bytes_to_child, bytes_to_conn);
+	if (active != 1 || total != 1 || bytes_to_child <= 0 || bytes_to_conn <= 0) {
+		printf ("ERROR (7): expected to find one connection proxied with content moved on both directions\n");
+		return axl_false;
+	} /* end if */
+
+	/* close connection */
+	vortex_connection_close (conn);
+
+	/* finish turbulence */
+	test_common_exit (vCtx, tCtxTest10);
+
+	/* finish queue */
+	vortex_async_queue_unref (queue);
+
+	return axl_true;
+}
+
 typedef axl_bool (* TurbulenceTestHandler) (void);
 
 /** 
@@ -5387,10 +6518,10 @@ int main (int argc, char ** argv)
 	printf ("**     CHILDREN: \n");
 	printf ("**     >> ./test_01 --child-cmd-prefix='libtool --mode=execute valgrind --leak-check=yes --show-reachable=yes --error-limit=no' [--debug]\n**\n");
 	printf ("** Providing --run-test=NAME will run only the provided regression test.\n");
-	printf ("** Available tests: test_01, test_01, test_01a, test_0b, test_02, test_03, test_03a, test_04, test_05, test_05a, test_06, test_06a\n");
-	printf ("**                  test_07, test_08, test_09, test_10prev, test_10, test_10a, test_10b, test_10c, test_10d, test_10e, test_11, test_12,\n");
-	printf ("**                  test_12a, test_12b, test_13, test_13a, test_13b, test_14, test_15, test_15a, test_16, test_17, test_18,\n");
-	printf ("**                  test_19, test_20, test_21, test_22, test_22a, test_23, test_24, test_25, test_26, test_27, test_28\n");
+	printf ("** Available tests: test_01, test_01, test_01a, test_0b, test_02, test_02a, test_03, test_03a, test_04, test_05, test_05a, test_06, test_06a\n");
+	printf ("**                  test_07, test_07a, test_07b, test_08, test_08a, test_09, test_10prev, test_10, test_10a, test_10b, test_10c, test_10d, test_10e, test_10f, test_10g, test_10h, test_10i, test_10j, test_10k, test_11,\n");
+	printf ("**                  test_12, test_12a, test_12b, test_13, test_13a, test_13b, test_14, test_15, test_15a, test_16, test_17, test_18,\n");
+	printf ("**                  test_19, test_20, test_21, test_22, test_22a, test_23, test_24, test_25, test_26, test_27, test_28, test_29\n");
 	printf ("** Report bugs to:\n**\n");
 	printf ("**     <vortex@lists.aspl.es> Vortex/Turbulence Mailing list\n**\n");
 
@@ -5446,6 +6577,9 @@ int main (int argc, char ** argv)
 	CHECK_TEST("test_02")
 	run_test (test_02, "Test 02: Turbulence misc functions");
 
+	CHECK_TEST("test_02a")
+	run_test (test_02a, "Test 02-a: Turbulence loop timers");
+
 	CHECK_TEST("test_03")
 	run_test (test_03, "Test 03: Sasl core backend (used by mod-sasl, tbc-sasl-conf)");
 
@@ -5473,9 +6607,18 @@ int main (int argc, char ** argv)
 	CHECK_TEST("test_07")
 	run_test (test_07, "Test 07: Turbulence local connection");
 
+	CHECK_TEST("test_07a")
+	run_test (test_07a, "Test 07-a: Turbulence greeting timeout");
+
+	CHECK_TEST("test_07b")
+	run_test (test_07b, "Test 07-b: Turbulence profile path cache and reload");
+
 	CHECK_TEST("test_08")
 	run_test (test_08, "Test 08: Turbulence profile path filtering (basic)");
 
+	CHECK_TEST("test_08a")
+	run_test (test_08a, "Test 08-a: Turbulence profile path decisions memoized");
+
 	CHECK_TEST("test_09")
 	run_test (test_09, "Test 09: Turbulence profile path filtering (serverName)");
 	
@@ -5502,6 +6645,24 @@ int main (int argc, char ** argv)
 	CHECK_TEST("test_10e")
         run_test (test_10_e, "Test 10-e: test child failing at creation time");
 
+	CHECK_TEST("test_10f")
+	run_test (test_10_f, "Test 10-f: check spare child pool (min-spare-childs)");
+
+	CHECK_TEST("test_10g")
+	run_test (test_10_g, "Test 10-g: check childs created by the zygote process (child-zygote)");
+
+	CHECK_TEST("test_10h")
+	run_test (test_10_h, "Test 10-h: check reuse connections balanced across childs (children-per-ppath)");
+
+	CHECK_TEST("test_10i")
+	run_test (test_10_i, "Test 10-i: check connections waiting for a child when limits are reached (admission-queue)");
+
+	CHECK_TEST("test_10j")
+	run_test (test_10_j, "Test 10-j: check child creation rate limit (spawn-rate)");
+
+	CHECK_TEST("test_10k")
+	run_test (test_10_k, "Test 10-k: check childs recycled after serving connections (recycle-conns)");
+
 	CHECK_TEST("test_11")
 	run_test (test_11, "Test 11: Check turbulence profile path selected");
 
@@ -5584,6 +6745,9 @@ int main (int argc, char ** argv)
 	run_test (test_28, "Test 28: Check proxy on parent retains host and port (of the connecting address)..");   
 #endif
 
+	CHECK_TEST("test_29")
+	run_test (test_29, "Test 29: Check raw connections proxied on parent..");
+
 	printf ("All tests passed OK!\n");
 
 	/* terminate */